@@ -13,7 +13,17 @@
 #include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 //Game Systems
+#include "Game/AssetResidency.hpp"
+#include "Game/AudioVoiceManager.hpp"
 #include "Game/Game.hpp"
+#include "Game/GameLog.hpp"
+#include "Game/GameplayData.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/MeshCooker.hpp"
+#include "Game/ModelRegistry.hpp"
+#include "Game/RenderResources.hpp"
+#include "Game/ResidencyStreaming.hpp"
+#include "Game/StartupProfiler.hpp"
 
 App* g_theApp = nullptr;
 
@@ -39,6 +49,8 @@ STATIC bool App::Command_Quit(EventArgs& args)
 //------------------------------------------------------------------------------------------------------------------------------
 void App::LoadGameBlackBoard()
 {
+	StartupPhaseScope phase("LoadGameBlackBoard");
+
 	const char* xmlDocPath = "Data/Gameplay/GameConfig.xml";
 	tinyxml2::XMLDocument gameconfig;
 	gameconfig.LoadFile(xmlDocPath);
@@ -60,11 +72,40 @@ void App::LoadGameBlackBoard()
 	}
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// gameplayData="xml" in GameConfig reads the unit XML directly, anything else uses the compiled pack
+//------------------------------------------------------------------------------------------------------------------------------
+void App::LoadGameplayData()
+{
+	StartupPhaseScope phase("LoadGameplayData");
+
+	bool useXml = g_gameConfigBlackboard.GetValue("gameplayData", "pack") == "xml";
+
+	std::vector<std::string> errors;
+	g_gameplayData = new GameplayData();
+	if (!g_gameplayData->Load(useXml, errors))
+	{
+		for (size_t errorIndex = 0; errorIndex < errors.size(); errorIndex++)
+		{
+			DebuggerPrintf("%s\n", errors[errorIndex].c_str());
+		}
+		ERROR_AND_DIE(Stringf(">> Error loading gameplay data, %u errors. First: %s ", (uint)errors.size(), errors.empty() ? "" : errors[0].c_str()));
+	}
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void App::StartUp()
 {
+	StartupPhaseScope phase("App::StartUp");
+	m_isHeadless = g_startupProfiler->IsBenchmarking();
+
 	LoadGameBlackBoard();
 
+	//First up so every system after it can log, last down
+	g_gameLog = new GameLog();
+	g_gameLog->LoadLevelsFromConfig();
+	g_gameLog->StartUp(g_gameConfigBlackboard.GetValue("logFile", "Data/Logs/Game.glog"));
+
 	g_eventSystem = new EventSystems();
 
 	//This is now being set in Main_Windows.cpp
@@ -74,6 +115,11 @@ void App::StartUp()
 
 	g_audio = new AudioSystem();
 
+	//Headless there is nobody to hear it, voices are still managed the same way
+	m_audioVoiceBackend = m_isHeadless ? (AudioVoiceBackend*)new NullAudioVoiceBackend() : new EngineAudioVoiceBackend();
+	g_audioVoices = new AudioVoiceManager(m_audioVoiceBackend);
+	g_audioVoices->LoadSettingsFromConfig();
+
 	g_devConsole = new DevConsole();
 	g_devConsole->Startup();
 
@@ -85,21 +131,75 @@ void App::StartUp()
 
 	g_RNG = new RandomNumberGenerator();
 
+	uint jobPhase = g_startupProfiler->BeginPhase("JobSystem::StartUp");
+	g_jobSystem = new JobSystem();
+	g_jobSystem->StartUp();
+	g_startupProfiler->EndPhase(jobPhase);
+
+	g_renderResources = new RenderResources(g_renderContext);
+	g_modelRegistry = new ModelRegistry();
+
+	m_residencyBackend = new RenderResidencyBackend();
+	g_assetResidency = new ResidencyManager(m_residencyBackend);
+	g_assetResidency->LoadBudgetFromConfig();
+
+	LoadGameplayData();
+
+	uint gamePhase = g_startupProfiler->BeginPhase("Game::StartUp");
 	m_game = new Game();
 	m_game->StartUp();
+	g_startupProfiler->EndPhase(gamePhase);
 	
 	g_eventSystem->SubscribeEventCallBackFn("Quit", Command_Quit);
+	g_eventSystem->SubscribeEventCallBackFn("StartupTrace", StartupProfiler::Command_StartupTrace);
+	g_eventSystem->SubscribeEventCallBackFn("CompileGameplayData", GameplayDataCompiler::Command_CompileGameplayData);
+	g_eventSystem->SubscribeEventCallBackFn("CheckCookedMeshes", MeshCooker::Command_CheckCookedMeshes);
+	g_eventSystem->SubscribeEventCallBackFn("Residency", ResidencyManager::Command_Residency);
+	g_eventSystem->SubscribeEventCallBackFn("AudioVoices", AudioVoiceManager::Command_AudioVoices);
+	g_eventSystem->SubscribeEventCallBackFn("Log", GameLog::Command_Log);
+	g_eventSystem->SubscribeEventCallBackFn("DecodeLog", GameLog::Command_DecodeLog);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void App::ShutDown()
 {
+	//The game's loaders wait on their jobs when they go, so it is deleted while the job system and everything else is up.
+	//A boot benchmark makes a new App per boot, so anything left here would leak once per boot
+	delete m_game;
+	m_game = nullptr;
+
+	//Their workers have to finish before the job system goes
+	delete g_assetResidency;
+	g_assetResidency = nullptr;
+
+	delete m_residencyBackend;
+	m_residencyBackend = nullptr;
+
+	delete g_modelRegistry;
+	g_modelRegistry = nullptr;
+
+	//Finish any outstanding jobs before the systems they use go away
+	delete g_jobSystem;
+	g_jobSystem = nullptr;
+
+	delete g_renderResources;
+	g_renderResources = nullptr;
+
+	delete g_gameplayData;
+	g_gameplayData = nullptr;
+
 	delete g_renderContext;
 	g_renderContext = nullptr;
 
 	delete g_inputSystem;
 	g_inputSystem = nullptr;
 
+	delete g_audioVoices;
+	g_audioVoices = nullptr;
+
+	delete m_audioVoiceBackend;
+	m_audioVoiceBackend = nullptr;
+
 	delete g_audio;
 	g_audio = nullptr;
 
@@ -115,7 +215,8 @@ void App::ShutDown()
 	delete g_RNG;
 	g_RNG = nullptr;
 
-	m_game->Shutdown();
+	delete g_gameLog;
+	g_gameLog = nullptr;
 
 	uint totalAllocs = (uint)gTotalAllocations;
 	uint totalAllocBytes = (uint)gTotalBytesAllocated;
@@ -129,9 +230,13 @@ void App::RunFrame()
 	BeginFrame();	
 	
 	Update();
-	Render();	
 
-	PostRender();
+	//A benchmark boot only measures loading, nothing is drawn
+	if (!m_isHeadless)
+	{
+		Render();
+		PostRender();
+	}
 
 	EndFrame();
 }
@@ -142,7 +247,7 @@ void App::BeginFrame()
 	uint thisFrame = (uint)gAllocatedThisFrame;
 	uint thisFrameBytes = (uint)gAllocatedBytesThisFrame;
 
-	DebuggerPrintf("Memory Allocations this Frame: %u, Bytes Allocated this Frame: %u \n", thisFrame, thisFrameBytes);
+	g_gameLog->Log(LOG_DEBUG, LOG_CATEGORY_MEMORY, "Memory Allocations this Frame: %u, Bytes Allocated this Frame: %u", thisFrame, thisFrameBytes);
 
 	gAllocatedThisFrame = 0U;
 	gAllocatedBytesThisFrame = 0U;
@@ -180,6 +285,7 @@ void App::Update()
 	deltaTime = Clamp(deltaTime, 0.0f, 0.1f);
 
 	g_devConsole->UpdateConsole(deltaTime);
+	g_gameLog->Update();
 
 	m_game->Update(deltaTime);
 
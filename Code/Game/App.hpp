@@ -5,6 +5,8 @@
 #include "Engine/Commons/EngineCommon.hpp"
 
 class Game;
+class AudioVoiceBackend;
+class RenderResidencyBackend;
 
 class App
 {
@@ -17,6 +19,7 @@ public:
 	static bool Command_Quit(EventArgs& args);
 
 	void				LoadGameBlackBoard();
+	void				LoadGameplayData();
 	void				StartUp();
 	void				ShutDown();
 	void				RunFrame();
@@ -51,8 +54,11 @@ private:
 	bool		m_isQuitting = false;
 	bool		m_isPaused = false;
 	bool		m_isSlowMo = false;
+	bool		m_isHeadless = false;
 
 	Game*		m_game = nullptr;
+	RenderResidencyBackend*	m_residencyBackend = nullptr;
+	AudioVoiceBackend*	m_audioVoiceBackend = nullptr;
 	
 	//Reference to the window handle as void*
 	void*		m_appWindowHandle = nullptr;
@@ -0,0 +1,380 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/AssetLoader.hpp"
+//Engine Systems
+#include "Engine/Commons/ErrorWarningAssert.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+//Game Systems
+#include "Game/MeshCooker.hpp"
+#include "Game/RenderResources.hpp"
+#include "Game/StartupProfiler.hpp"
+#include "Game/TextureCooker.hpp"
+//Others
+#include <algorithm>
+
+extern JobSystem* g_jobSystem;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string MakeAssetKey(eAssetType type, const std::string& path)
+{
+	return std::string(AssetLoader::GetTypeName(type)) + ":" + path;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+AssetLoader::~AssetLoader()
+{
+	//Workers write into the entries, so they all have to be done before anything is freed
+	g_jobSystem->WaitForCounter(&m_prepareJobs);
+
+	for (size_t assetIndex = 0; assetIndex < m_assets.size(); assetIndex++)
+	{
+		delete m_assets[assetIndex].m_image;
+		delete m_assets[assetIndex].m_mesh;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// <texture path/>, <shader path/>, <material path file textureRoot/> and <mesh path material/>. Materials are read once
+// everything is listed so a mesh can name a material before the manifest describes it
+//------------------------------------------------------------------------------------------------------------------------------
+bool AssetLoader::LoadManifest(const std::string& manifestPath, std::string& outError)
+{
+	if (m_isStarted)
+	{
+		outError = "Asset manifest " + manifestPath + " loaded after the loader started";
+		return false;
+	}
+
+	tinyxml2::XMLDocument manifestDoc;
+	manifestDoc.LoadFile(manifestPath.c_str());
+	if (manifestDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outError = "Could not read asset manifest " + manifestPath;
+		return false;
+	}
+
+	XMLElement* rootElement = manifestDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string elementName = element->Name();
+		std::string path = ParseXmlAttribute(*element, "path", "");
+		if (path == "")
+		{
+			outError = "Asset manifest " + manifestPath + " has a " + elementName + " with no path";
+			return false;
+		}
+
+		if (elementName == "texture")
+		{
+			AddAsset(ASSET_TEXTURE, path);
+		}
+		else if (elementName == "shader")
+		{
+			AddAsset(ASSET_SHADER, path);
+		}
+		else if (elementName == "material")
+		{
+			AssetEntry& material = m_assets[AddAsset(ASSET_MATERIAL, path)];
+			material.m_filePath = ParseXmlAttribute(*element, "file", path.c_str());
+			material.m_textureRoot = ParseXmlAttribute(*element, "textureRoot", material.m_textureRoot.c_str());
+		}
+		else if (elementName == "mesh")
+		{
+			uint mesh = AddAsset(ASSET_MESH, path);
+			std::string materialPath = ParseXmlAttribute(*element, "material", "");
+			if (materialPath != "")
+			{
+				AddDependency(mesh, AddAsset(ASSET_MATERIAL, materialPath));
+			}
+		}
+		else
+		{
+			outError = "Asset manifest " + manifestPath + " has an unknown asset type " + elementName;
+			return false;
+		}
+	}
+
+	//Materials are the only assets with dependencies found in their own data, adding them doesn't add more materials
+	size_t numAssets = m_assets.size();
+	for (size_t assetIndex = 0; assetIndex < numAssets; assetIndex++)
+	{
+		if (m_assets[assetIndex].m_type == ASSET_MATERIAL && !AddMaterialDependencies((uint)assetIndex, outError))
+			return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint AssetLoader::AddAsset(eAssetType type, const std::string& path)
+{
+	uint asset = FindAsset(type, path);
+	if (asset != INVALID_ASSET)
+		return asset;
+
+	if (m_isStarted)
+	{
+		ERROR_RECOVERABLE("Assets can't be added once the loader has started");
+		return INVALID_ASSET;
+	}
+
+	AssetEntry entry;
+	entry.m_type = type;
+	entry.m_path = path;
+	entry.m_filePath = path;
+	entry.m_textureRoot = MODEL_PATH;
+
+	asset = (uint)m_assets.size();
+	m_assets.push_back(entry);
+	m_lookup[MakeAssetKey(type, path)] = asset;
+	return asset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The graph has to stay acyclic, an asset in a cycle would never be created
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::AddDependency(uint asset, uint dependsOn)
+{
+	if (asset == dependsOn || asset == INVALID_ASSET || dependsOn == INVALID_ASSET)
+		return;
+
+	std::vector<uint>& dependencies = m_assets[asset].m_dependencies;
+	if (std::find(dependencies.begin(), dependencies.end(), dependsOn) != dependencies.end())
+		return;
+
+	dependencies.push_back(dependsOn);
+	m_assets[dependsOn].m_dependents.push_back(asset);
+	m_assets[asset].m_numUnmetDependencies++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint AssetLoader::FindAsset(eAssetType type, const std::string& path) const
+{
+	std::map<std::string, uint>::const_iterator itr = m_lookup.find(MakeAssetKey(type, path));
+	return itr == m_lookup.end() ? INVALID_ASSET : itr->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool AssetLoader::AddMaterialDependencies(uint material, std::string& outError)
+{
+	std::string filePath = m_assets[material].m_filePath;
+	std::string textureRoot = m_assets[material].m_textureRoot;
+
+	tinyxml2::XMLDocument materialDoc;
+	materialDoc.LoadFile(filePath.c_str());
+	if (materialDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outError = "Could not read material " + filePath;
+		return false;
+	}
+
+	XMLElement* rootElement = materialDoc.RootElement();
+	std::string shader = ParseXmlAttribute(*rootElement, "shader", "");
+	if (shader != "")
+	{
+		AddDependency(material, AddAsset(ASSET_SHADER, shader));
+	}
+
+	for (XMLElement* element = rootElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string source = ParseXmlAttribute(*element, "src", "");
+		if (source != "")
+		{
+			AddDependency(material, AddAsset(ASSET_TEXTURE, textureRoot + source));
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Textures and meshes go to the workers. Shaders and materials are only made by the render context, they have nothing to
+// do until their turn to be created
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::Start()
+{
+	if (m_isStarted)
+		return;
+
+	m_isStarted = true;
+	for (uint asset = 0; asset < (uint)m_assets.size(); asset++)
+	{
+		m_assets[asset].m_state = ASSET_STATE_PREPARING;
+
+		eAssetType type = m_assets[asset].m_type;
+		if (type == ASSET_TEXTURE || type == ASSET_MESH)
+		{
+			m_assets[asset].m_queuedTime = GetCurrentTimeSeconds();
+			g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, asset]() { PrepareAsset(asset); }, &m_prepareJobs);
+		}
+		else
+		{
+			m_preparedQueue.enqueue(asset);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::PrepareAsset(uint asset)
+{
+	AssetEntry& entry = m_assets[asset];
+	double startTime = GetCurrentTimeSeconds();
+	StartupProfiler::TakeBytesRead();
+
+	if (entry.m_type == ASSET_TEXTURE)
+	{
+		entry.m_image = CookedTexture::CreateImageFromSource(entry.m_path);
+	}
+	else if (entry.m_type == ASSET_MESH)
+	{
+		//Left null when it can't be cooked, the render context loads it from source at creation instead
+		std::string error;
+		entry.m_mesh = new CPUMesh();
+		if (!CookedMesh::LoadIntoCPUMesh(MODEL_PATH, MODEL_PATH + entry.m_path, *entry.m_mesh, error))
+		{
+			delete entry.m_mesh;
+			entry.m_mesh = nullptr;
+		}
+	}
+
+	double endTime = GetCurrentTimeSeconds();
+	entry.m_prepareSeconds = endTime - startTime;
+	g_startupProfiler->RecordAssetPrepare(entry.m_path, GetTypeName(entry.m_type), entry.m_queuedTime, startTime, endTime, StartupProfiler::TakeBytesRead());
+	m_preparedQueue.enqueue(asset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Always creates at least one asset when one is ready so a tiny budget still makes progress
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::Update(double budgetSeconds)
+{
+	uint asset;
+	while (m_preparedQueue.dequeue(&asset))
+	{
+		m_assets[asset].m_state = ASSET_STATE_PREPARED;
+		m_numPrepared++;
+		QueueIfReady(asset);
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	while (!m_readyToCreate.empty())
+	{
+		asset = m_readyToCreate.back();
+		m_readyToCreate.pop_back();
+		CreateAsset(asset);
+
+		if (GetCurrentTimeSeconds() - startTime >= budgetSeconds)
+			break;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::CreateAsset(uint asset)
+{
+	AssetEntry& entry = m_assets[asset];
+	double startTime = GetCurrentTimeSeconds();
+	bool succeeded = false;
+
+	switch (entry.m_type)
+	{
+	case ASSET_TEXTURE:
+	{
+		succeeded = entry.m_image != nullptr && g_renderResources->GetTexture(g_renderResources->CreateTexture(entry.m_path, *entry.m_image)) != nullptr;
+		delete entry.m_image;
+		entry.m_image = nullptr;
+	}
+	break;
+	case ASSET_SHADER:
+	{
+		succeeded = g_renderResources->GetShader(g_renderResources->ResolveShader(entry.m_path)) != nullptr;
+	}
+	break;
+	case ASSET_MATERIAL:
+	{
+		succeeded = g_renderResources->GetMaterial(g_renderResources->ResolveMaterial(entry.m_path)) != nullptr;
+	}
+	break;
+	case ASSET_MESH:
+	{
+		MeshHandle handle = entry.m_mesh != nullptr ? g_renderResources->CreateMesh(entry.m_path, *entry.m_mesh) : g_renderResources->ResolveMesh(entry.m_path);
+		succeeded = g_renderResources->GetMesh(handle) != nullptr;
+		delete entry.m_mesh;
+		entry.m_mesh = nullptr;
+	}
+	break;
+	default:
+	break;
+	}
+
+	double endTime = GetCurrentTimeSeconds();
+	entry.m_createSeconds = endTime - startTime;
+	g_startupProfiler->RecordAssetCreate(entry.m_path, GetTypeName(entry.m_type), startTime, endTime);
+	FinishAsset(asset, succeeded);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::FinishAsset(uint asset, bool succeeded)
+{
+	AssetEntry& entry = m_assets[asset];
+	entry.m_state = succeeded ? ASSET_STATE_CREATED : ASSET_STATE_FAILED;
+	m_numCreated++;
+
+	if (!succeeded)
+	{
+		m_numFailed++;
+		g_devConsole->PrintString(Rgba::RED, Stringf("Failed to load %s %s", GetTypeName(entry.m_type), entry.m_path.c_str()));
+	}
+
+	for (size_t dependentIndex = 0; dependentIndex < entry.m_dependents.size(); dependentIndex++)
+	{
+		uint dependent = entry.m_dependents[dependentIndex];
+		m_assets[dependent].m_numUnmetDependencies--;
+		QueueIfReady(dependent);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Both conditions become true exactly once, so whichever comes second queues the asset
+//------------------------------------------------------------------------------------------------------------------------------
+void AssetLoader::QueueIfReady(uint asset)
+{
+	const AssetEntry& entry = m_assets[asset];
+	if (entry.m_state == ASSET_STATE_PREPARED && entry.m_numUnmetDependencies == 0U)
+	{
+		m_readyToCreate.push_back(asset);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool AssetLoader::IsFinished() const
+{
+	return m_isStarted && m_numCreated == (uint)m_assets.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every asset is worth one step for its CPU side and one for its GPU side
+//------------------------------------------------------------------------------------------------------------------------------
+float AssetLoader::GetProgress() const
+{
+	if (m_assets.empty())
+		return m_isStarted ? 1.f : 0.f;
+
+	return (float)(m_numPrepared + m_numCreated) / (float)(m_assets.size() * 2U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC const char* AssetLoader::GetTypeName(eAssetType type)
+{
+	switch (type)
+	{
+	case ASSET_TEXTURE:		return "texture";
+	case ASSET_SHADER:		return "shader";
+	case ASSET_MATERIAL:	return "material";
+	case ASSET_MESH:		return "mesh";
+	default:				return "unknown";
+	}
+}
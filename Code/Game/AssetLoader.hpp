@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Async/AsyncQueue.hpp"
+//Game Systems
+#include "Game/JobSystem.hpp"
+//Others
+#include <map>
+#include <string>
+#include <vector>
+
+class CPUMesh;
+class Image;
+
+constexpr uint INVALID_ASSET = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eAssetType
+{
+	ASSET_TEXTURE,
+	ASSET_SHADER,
+	ASSET_MATERIAL,
+	ASSET_MESH,
+
+	NUM_ASSET_TYPES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Waiting until kicked off, preparing while a worker reads and decodes it, prepared once the CPU side is done, created
+// once its GPU object exists. Failed assets still count as created so nothing waiting on them stalls
+//------------------------------------------------------------------------------------------------------------------------------
+enum eAssetState
+{
+	ASSET_STATE_WAITING,
+	ASSET_STATE_PREPARING,
+	ASSET_STATE_PREPARED,
+	ASSET_STATE_CREATED,
+	ASSET_STATE_FAILED
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct AssetEntry
+{
+	eAssetType				m_type = ASSET_TEXTURE;
+	std::string				m_path;						//The name the asset is registered and looked up by
+	std::string				m_filePath;					//Where a material's XML is read from, the path unless it says otherwise
+	std::string				m_textureRoot;				//Prefix for the texture names a material refers to
+
+	eAssetState				m_state = ASSET_STATE_WAITING;
+	std::vector<uint>		m_dependencies;
+	std::vector<uint>		m_dependents;
+	uint					m_numUnmetDependencies = 0U;
+
+	//Filled in by the worker, handed to the GPU on the main thread
+	Image*					m_image = nullptr;
+	CPUMesh*				m_mesh = nullptr;
+
+	double					m_queuedTime = 0.0;
+	double					m_prepareSeconds = 0.0;
+	double					m_createSeconds = 0.0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Loads everything a manifest lists. Materials pull in the shader and textures their XML names, meshes wait on the material
+// the manifest gives them. Reading, decoding and cooking run on the job system all at once; the main thread only creates
+// GPU objects, in dependency order, for as long as the frame's budget allows
+//------------------------------------------------------------------------------------------------------------------------------
+class AssetLoader
+{
+public:
+	AssetLoader() {}
+	~AssetLoader();
+
+	bool					LoadManifest(const std::string& manifestPath, std::string& outError);
+	uint					AddAsset(eAssetType type, const std::string& path);
+	void					AddDependency(uint asset, uint dependsOn);
+
+	void					Start();
+	void					Update(double budgetSeconds);
+
+	bool					IsFinished() const;
+	float					GetProgress() const;
+	inline uint				GetNumAssets() const { return (uint)m_assets.size(); }
+	inline uint				GetNumCreated() const { return m_numCreated; }
+	inline uint				GetNumFailed() const { return m_numFailed; }
+	inline const AssetEntry&	GetAsset(uint asset) const { return m_assets[asset]; }
+
+	static const char*		GetTypeName(eAssetType type);
+
+private:
+	uint					FindAsset(eAssetType type, const std::string& path) const;
+	bool					AddMaterialDependencies(uint material, std::string& outError);
+
+	void					PrepareAsset(uint asset);
+	void					CreateAsset(uint asset);
+	void					FinishAsset(uint asset, bool succeeded);
+	void					QueueIfReady(uint asset);
+
+private:
+	std::vector<AssetEntry>		m_assets;			//Doesn't grow once started, workers hold indices into it
+	std::map<std::string, uint>	m_lookup;			//Type and path to index
+
+	bool					m_isStarted = false;
+	JobCounter				m_prepareJobs;
+	AsyncQueue<uint>		m_preparedQueue;		//Written by workers, drained by the main thread
+	std::vector<uint>		m_readyToCreate;		//Prepared with every dependency created
+
+	uint					m_numPrepared = 0U;
+	uint					m_numCreated = 0U;
+	uint					m_numFailed = 0U;
+};
@@ -0,0 +1,377 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/AssetResidency.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+//Others
+#include <algorithm>
+
+ResidencyManager* g_assetResidency = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t ResidencyAsset::GetBytes(uint mip) const
+{
+	uint64_t numBytes = 0U;
+	for (uint mipIndex = mip; mipIndex < m_numMips; mipIndex++)
+	{
+		numBytes += m_mipBytes[mipIndex];
+	}
+	return numBytes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ResidencyManager::ResidencyManager(ResidencyBackend* backend)
+	:	m_backend(backend)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::SetBudget(const ResidencyBudget& budget)
+{
+	m_budget = budget;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// residencyMeshMB, residencyTextureMB, residencyMipStreamKB and residencyEvictFrames in GameConfig, the defaults otherwise
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::LoadBudgetFromConfig()
+{
+	ResidencyBudget budget;
+	budget.m_maxBytes[RESIDENCY_MESH] = (uint64_t)g_gameConfigBlackboard.GetValue("residencyMeshMB", (int)(budget.m_maxBytes[RESIDENCY_MESH] >> 20)) << 20;
+	budget.m_maxBytes[RESIDENCY_TEXTURE] = (uint64_t)g_gameConfigBlackboard.GetValue("residencyTextureMB", (int)(budget.m_maxBytes[RESIDENCY_TEXTURE] >> 20)) << 20;
+	budget.m_mipStreamMinBytes = (uint64_t)g_gameConfigBlackboard.GetValue("residencyMipStreamKB", (int)(budget.m_mipStreamMinBytes >> 10)) << 10;
+	budget.m_evictAfterFrames = (uint)g_gameConfigBlackboard.GetValue("residencyEvictFrames", (int)budget.m_evictAfterFrames);
+	SetBudget(budget);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ResidencyID ResidencyManager::FindAsset(eResidencyAssetType type, uint resourceHandle) const
+{
+	const std::vector<ResidencyID>& lookup = m_lookup[type];
+	if (resourceHandle >= (uint)lookup.size() || lookup[resourceHandle] == UNTRACKED_RESIDENCY_ID)
+		return INVALID_RESIDENCY_ID;
+
+	return lookup[resourceHandle];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Called for every draw, so a tracked asset costs an index and a compare
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::MarkUsed(eResidencyAssetType type, uint resourceHandle, uint wantedMip)
+{
+	std::vector<ResidencyID>& lookup = m_lookup[type];
+	ResidencyID id = resourceHandle < (uint)lookup.size() ? lookup[resourceHandle] : INVALID_RESIDENCY_ID;
+	if (id == INVALID_RESIDENCY_ID)
+	{
+		id = TrackAsset(type, resourceHandle);
+	}
+
+	if (id == UNTRACKED_RESIDENCY_ID)
+		return;
+
+	ResidencyAsset& asset = m_assets[id];
+	wantedMip = std::min(wantedMip, asset.m_numMips - 1U);
+	if (asset.m_lastUsedFrame == m_frame)
+	{
+		asset.m_wantedMip = std::min(asset.m_wantedMip, wantedMip);
+		return;
+	}
+
+	asset.m_lastUsedFrame = m_frame;
+	asset.m_wantedMip = wantedMip;
+	if (!asset.IsResident())
+	{
+		asset.m_numMisses++;
+		m_stats.m_numMisses++;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One the backend will describe later keeps no lookup entry, so the next mark asks again
+//------------------------------------------------------------------------------------------------------------------------------
+ResidencyID ResidencyManager::TrackAsset(eResidencyAssetType type, uint resourceHandle)
+{
+	std::vector<ResidencyID>& lookup = m_lookup[type];
+	if (resourceHandle >= (uint)lookup.size())
+	{
+		lookup.resize(resourceHandle + 1U, INVALID_RESIDENCY_ID);
+	}
+
+	ResidencyAsset asset;
+	eResidencyDescribeResult result = m_backend->DescribeAsset(type, resourceHandle, asset);
+	if (result == RESIDENCY_DESCRIBE_LATER)
+		return UNTRACKED_RESIDENCY_ID;
+
+	if (result != RESIDENCY_DESCRIBED || asset.m_numMips == 0U)
+	{
+		lookup[resourceHandle] = UNTRACKED_RESIDENCY_ID;
+		return UNTRACKED_RESIDENCY_ID;
+	}
+
+	asset.m_type = type;
+	asset.m_resourceHandle = resourceHandle;
+	asset.m_residentMip = std::min(asset.m_residentMip, asset.m_numMips);
+	asset.m_state = asset.IsResident() ? RESIDENCY_RESIDENT : RESIDENCY_EVICTED;
+	asset.m_isMipStreamed = type == RESIDENCY_TEXTURE && asset.m_numMips > 1U && asset.GetBytes(0U) >= m_budget.m_mipStreamMinBytes;
+
+	ResidencyID id = (ResidencyID)m_assets.size();
+	m_assets.push_back(asset);
+	lookup[resourceHandle] = id;
+
+	m_stats.m_residentBytes[type] += asset.GetResidentBytes();
+	m_stats.m_peakBytes[type] = std::max(m_stats.m_peakBytes[type], m_stats.m_residentBytes[type]);
+	return id;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::Update()
+{
+	m_backend->Update(*this);
+
+	bool isOverBudget = false;
+	for (int typeIndex = 0; typeIndex < NUM_RESIDENCY_ASSET_TYPES; typeIndex++)
+	{
+		EnforceBudget((eResidencyAssetType)typeIndex);
+		isOverBudget |= m_stats.m_residentBytes[typeIndex] > m_budget.m_maxBytes[typeIndex];
+	}
+
+	StartStreamIns();
+
+	if (isOverBudget)
+	{
+		m_stats.m_numOverBudgetFrames++;
+	}
+
+	m_stats.m_numFrames++;
+	m_frame++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::FinishStreamIn(ResidencyID id, bool succeeded)
+{
+	ResidencyAsset& asset = m_assets[id];
+	m_incomingBytes[asset.m_type] -= asset.GetBytes(asset.m_streamingMip) - asset.GetResidentBytes();
+
+	if (!succeeded)
+	{
+		m_stats.m_numFailedStreamIns++;
+		asset.m_state = RESIDENCY_FAILED;
+		return;
+	}
+
+	m_stats.m_bytesStreamedIn += asset.GetBytes(asset.m_streamingMip) - asset.GetResidentBytes();
+	m_stats.m_numStreamIns++;
+	asset.m_numStreamIns++;
+
+	SetResidentMip(asset, asset.m_streamingMip);
+	asset.m_state = RESIDENCY_RESIDENT;
+	m_version++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::SetResidentMip(ResidencyAsset& asset, uint mip)
+{
+	m_stats.m_residentBytes[asset.m_type] -= asset.GetResidentBytes();
+	asset.m_residentMip = mip;
+	m_stats.m_residentBytes[asset.m_type] += asset.GetResidentBytes();
+	m_stats.m_peakBytes[asset.m_type] = std::max(m_stats.m_peakBytes[asset.m_type], m_stats.m_residentBytes[asset.m_type]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t ResidencyManager::GetAvailableBytes(eResidencyAssetType type) const
+{
+	uint64_t committedBytes = m_stats.m_residentBytes[type] + m_incomingBytes[type];
+	return committedBytes < m_budget.m_maxBytes[type] ? m_budget.m_maxBytes[type] - committedBytes : 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ResidencyManager::IsEvictable(const ResidencyAsset& asset) const
+{
+	return asset.m_state == RESIDENCY_RESIDENT && asset.m_lastUsedFrame + m_budget.m_evictAfterFrames < m_frame;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::EnforceBudget(eResidencyAssetType type)
+{
+	ReleaseBytes(type, 0U, MAX_COOKED_TEXTURE_MIPS, INVALID_RESIDENCY_ID);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Frees until neededBytes more fit the budget. Evicting unused assets comes first since nothing on screen changes. Only then
+// do large textures resident finer than dropMipsFinerThan give up their top mips, one at a time from whichever has the
+// biggest resident mip, so quality evens out between them. The coarsest mip is always kept
+//------------------------------------------------------------------------------------------------------------------------------
+bool ResidencyManager::ReleaseBytes(eResidencyAssetType type, uint64_t neededBytes, uint dropMipsFinerThan, ResidencyID keepID)
+{
+	if (GetAvailableBytes(type) >= neededBytes && m_stats.m_residentBytes[type] + m_incomingBytes[type] <= m_budget.m_maxBytes[type])
+		return true;
+
+	std::vector<ResidencyID> candidates;
+	for (ResidencyID id = 0; id < (ResidencyID)m_assets.size(); id++)
+	{
+		if (m_assets[id].m_type == type && id != keepID && IsEvictable(m_assets[id]))
+		{
+			candidates.push_back(id);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [this](ResidencyID a, ResidencyID b) { return m_assets[a].m_lastUsedFrame < m_assets[b].m_lastUsedFrame; });
+
+	for (size_t candidateIndex = 0; candidateIndex < candidates.size(); candidateIndex++)
+	{
+		if (GetAvailableBytes(type) >= neededBytes && m_stats.m_residentBytes[type] + m_incomingBytes[type] <= m_budget.m_maxBytes[type])
+			return true;
+
+		ResidencyAsset& asset = m_assets[candidates[candidateIndex]];
+		m_backend->Evict(candidates[candidateIndex], asset);
+
+		m_stats.m_bytesEvicted += asset.GetResidentBytes();
+		m_stats.m_numEvictions++;
+		asset.m_numEvictions++;
+
+		SetResidentMip(asset, asset.m_numMips);
+		asset.m_state = RESIDENCY_EVICTED;
+		m_version++;
+	}
+
+	//A texture whose drop failed keeps its mip and isn't tried again this call
+	std::vector<ResidencyID> failedDrops;
+	while (GetAvailableBytes(type) < neededBytes || m_stats.m_residentBytes[type] + m_incomingBytes[type] > m_budget.m_maxBytes[type])
+	{
+		ResidencyID dropID = INVALID_RESIDENCY_ID;
+		for (ResidencyID id = 0; id < (ResidencyID)m_assets.size(); id++)
+		{
+			const ResidencyAsset& asset = m_assets[id];
+			if (asset.m_type != type || id == keepID || !asset.m_isMipStreamed || asset.m_state != RESIDENCY_RESIDENT)
+				continue;
+
+			if (std::find(failedDrops.begin(), failedDrops.end(), id) != failedDrops.end())
+				continue;
+
+			if (asset.m_residentMip + 1U >= asset.m_numMips || asset.m_residentMip >= dropMipsFinerThan)
+				continue;
+
+			if (dropID == INVALID_RESIDENCY_ID || asset.m_mipBytes[asset.m_residentMip] > m_assets[dropID].m_mipBytes[m_assets[dropID].m_residentMip])
+			{
+				dropID = id;
+			}
+		}
+
+		if (dropID == INVALID_RESIDENCY_ID)
+			return false;
+
+		ResidencyAsset& asset = m_assets[dropID];
+		if (!m_backend->DropMips(dropID, asset, asset.m_residentMip + 1U))
+		{
+			m_stats.m_numFailedMipDrops++;
+			failedDrops.push_back(dropID);
+			continue;
+		}
+
+		m_stats.m_bytesEvicted += asset.m_mipBytes[asset.m_residentMip];
+		m_stats.m_numMipDrops++;
+		asset.m_numMipDrops++;
+
+		SetResidentMip(asset, asset.m_residentMip + 1U);
+		m_version++;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Assets with nothing resident go first, they aren't drawn at all until they arrive. A mesh streams in even over budget and
+// the next update evicts to make room; a large texture starts at the finest mip that fits, never worse than its coarsest.
+// A texture already drawn moves up one mip at a time, and only by taking the room from unused assets or from textures
+// resident finer than it would be, so the textures in use settle on the same level
+//------------------------------------------------------------------------------------------------------------------------------
+void ResidencyManager::StartStreamIns()
+{
+	uint numStarted = 0U;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool isUpgradePass = pass == 1;
+		for (ResidencyID id = 0; id < (ResidencyID)m_assets.size(); id++)
+		{
+			if (numStarted >= m_budget.m_maxStreamInsPerFrame)
+				return;
+
+			ResidencyAsset& asset = m_assets[id];
+			if (asset.m_lastUsedFrame != m_frame || asset.IsResident() != isUpgradePass || asset.m_wantedMip >= asset.m_residentMip)
+				continue;
+
+			if (asset.m_state != RESIDENCY_RESIDENT && asset.m_state != RESIDENCY_EVICTED)
+				continue;
+
+			uint mip = asset.m_wantedMip;
+			if (isUpgradePass)
+			{
+				mip = asset.m_residentMip - 1U;
+				if (!ReleaseBytes(asset.m_type, asset.GetBytes(mip) - asset.GetResidentBytes(), mip, id))
+					continue;
+			}
+			else if (asset.m_isMipStreamed)
+			{
+				uint64_t availableBytes = GetAvailableBytes(asset.m_type);
+				while (mip + 1U < asset.m_numMips && asset.GetBytes(mip) > availableBytes)
+				{
+					mip++;
+				}
+			}
+
+			asset.m_state = RESIDENCY_STREAMING;
+			asset.m_streamingMip = mip;
+			m_incomingBytes[asset.m_type] += asset.GetBytes(mip) - asset.GetResidentBytes();
+			m_backend->BeginStreamIn(id, asset, mip);
+			numStarted++;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC const char* ResidencyManager::GetStateName(eResidencyState state)
+{
+	switch (state)
+	{
+	case RESIDENCY_EVICTED:		return "evicted";
+	case RESIDENCY_STREAMING:	return "streaming";
+	case RESIDENCY_RESIDENT:	return "resident";
+	case RESIDENCY_FAILED:		return "failed";
+	default:					return "unknown";
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Lists every tracked asset with its residency, then the totals against the budgets. all=false lists only what is resident
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool ResidencyManager::Command_Residency(EventArgs& args)
+{
+	bool listAll = args.GetValue("all", true);
+	const ResidencyManager& manager = *g_assetResidency;
+
+	for (ResidencyID id = 0; id < manager.GetNumAssets(); id++)
+	{
+		const ResidencyAsset& asset = manager.GetAsset(id);
+		if (!listAll && !asset.IsResident())
+			continue;
+
+		Rgba color = asset.m_state == RESIDENCY_FAILED ? Rgba::RED : (asset.IsResident() ? Rgba::WHITE : Rgba::YELLOW);
+		g_devConsole->PrintString(color, Stringf("%s %s mip %u/%u, %.1f KB, unused %u frames: %u streamed in, %u evicted, %u mip drops, %u misses",
+			asset.m_path.c_str(), GetStateName(asset.m_state), asset.m_residentMip, asset.m_numMips, (double)asset.GetResidentBytes() / 1024.0,
+			manager.GetFrame() - asset.m_lastUsedFrame, asset.m_numStreamIns, asset.m_numEvictions, asset.m_numMipDrops, asset.m_numMisses));
+	}
+
+	const ResidencyStats& stats = manager.GetStats();
+	const ResidencyBudget& budget = manager.GetBudget();
+	const char* typeNames[NUM_RESIDENCY_ASSET_TYPES] = { "Meshes", "Textures" };
+	for (int typeIndex = 0; typeIndex < NUM_RESIDENCY_ASSET_TYPES; typeIndex++)
+	{
+		g_devConsole->PrintString(Rgba::GREEN, Stringf("%s: %.2f of %.2f MB resident, peak %.2f MB", typeNames[typeIndex],
+			(double)stats.m_residentBytes[typeIndex] / (1024.0 * 1024.0), (double)budget.m_maxBytes[typeIndex] / (1024.0 * 1024.0), (double)stats.m_peakBytes[typeIndex] / (1024.0 * 1024.0)));
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("%u stream-ins (%u failed, %.2f MB), %u evictions and %u mip drops (%u failed, %.2f MB), %u misses, over budget %u of %u frames",
+		stats.m_numStreamIns, stats.m_numFailedStreamIns, (double)stats.m_bytesStreamedIn / (1024.0 * 1024.0), stats.m_numEvictions, stats.m_numMipDrops, stats.m_numFailedMipDrops,
+		(double)stats.m_bytesEvicted / (1024.0 * 1024.0), stats.m_numMisses, stats.m_numOverBudgetFrames, stats.m_numFrames));
+	return true;
+}
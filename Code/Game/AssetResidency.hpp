@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/TextureCooker.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ResidencyManager;
+
+//Index into the residency manager's asset list
+typedef uint	ResidencyID;
+
+constexpr ResidencyID INVALID_RESIDENCY_ID = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eResidencyAssetType
+{
+	RESIDENCY_MESH,
+	RESIDENCY_TEXTURE,
+
+	NUM_RESIDENCY_ASSET_TYPES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eResidencyState
+{
+	RESIDENCY_EVICTED,
+	RESIDENCY_STREAMING,
+	RESIDENCY_RESIDENT,
+	RESIDENCY_FAILED			//The backend couldn't stream it in, not asked again
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eResidencyDescribeResult
+{
+	RESIDENCY_DESCRIBED,
+	RESIDENCY_DESCRIBE_LATER,	//Not ready to be sized yet, asked again the next time it is marked
+	RESIDENCY_NOT_STREAMABLE	//Left untracked for good
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One streamable mesh or texture. Meshes have a single mip. A texture resident at mip N holds N and every coarser mip, so
+// its size is the sum of those
+//------------------------------------------------------------------------------------------------------------------------------
+struct ResidencyAsset
+{
+	std::string				m_path;
+	eResidencyAssetType		m_type = RESIDENCY_MESH;
+	uint					m_resourceHandle = 0U;						//Its MeshHandle or TextureHandle
+	uint					m_numMips = 1U;
+	uint64_t				m_mipBytes[MAX_COOKED_TEXTURE_MIPS] = {};
+
+	eResidencyState			m_state = RESIDENCY_EVICTED;
+	uint					m_residentMip = 1U;							//m_numMips while nothing is resident
+	uint					m_streamingMip = 0U;
+	uint					m_wantedMip = 0U;							//Finest mip the renderer asked for in m_lastUsedFrame
+	uint					m_lastUsedFrame = 0U;
+	bool					m_isMipStreamed = false;					//Large enough to give up its top mips under pressure
+
+	uint					m_numStreamIns = 0U;
+	uint					m_numEvictions = 0U;
+	uint					m_numMipDrops = 0U;
+	uint					m_numMisses = 0U;							//Frames it was used with nothing resident
+
+	uint64_t				GetBytes(uint mip) const;
+	inline uint64_t			GetResidentBytes() const { return GetBytes(m_residentMip); }
+	inline bool				IsResident() const { return m_residentMip < m_numMips; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Limits per asset type. Nothing is evicted until it has gone unused for m_evictAfterFrames, so panning back and forth
+// doesn't thrash. Textures of at least m_mipStreamMinBytes drop their top mips before a used asset goes over budget
+//------------------------------------------------------------------------------------------------------------------------------
+struct ResidencyBudget
+{
+	uint64_t				m_maxBytes[NUM_RESIDENCY_ASSET_TYPES] = { 64ULL << 20, 64ULL << 20 };
+	uint64_t				m_mipStreamMinBytes = 1ULL << 20;
+	uint					m_evictAfterFrames = 120U;
+	uint					m_maxStreamInsPerFrame = 4U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ResidencyStats
+{
+	uint64_t				m_residentBytes[NUM_RESIDENCY_ASSET_TYPES] = {};
+	uint64_t				m_peakBytes[NUM_RESIDENCY_ASSET_TYPES] = {};
+	uint64_t				m_bytesStreamedIn = 0U;
+	uint64_t				m_bytesEvicted = 0U;
+	uint					m_numStreamIns = 0U;
+	uint					m_numFailedStreamIns = 0U;
+	uint					m_numEvictions = 0U;
+	uint					m_numMipDrops = 0U;
+	uint					m_numFailedMipDrops = 0U;
+	uint					m_numMisses = 0U;
+	uint					m_numOverBudgetFrames = 0U;
+	uint					m_numFrames = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What actually moves the data. Stream-ins finish later by handing the asset back through ResidencyManager::FinishStreamIn
+// from Update, on the main thread. Evict and DropMips free at once; DropMips returns false if the texture was left as it was
+//------------------------------------------------------------------------------------------------------------------------------
+class ResidencyBackend
+{
+public:
+	virtual ~ResidencyBackend() {}
+
+	//Fills in the path, sizes and current residency of a resource the renderer used. Main thread, called while marking, so
+	//it must not do any slow work itself
+	virtual eResidencyDescribeResult	DescribeAsset(eResidencyAssetType type, uint resourceHandle, ResidencyAsset& outAsset) = 0;
+
+	virtual void		BeginStreamIn(ResidencyID id, const ResidencyAsset& asset, uint mip) = 0;
+	virtual void		Evict(ResidencyID id, const ResidencyAsset& asset) = 0;
+	virtual bool		DropMips(ResidencyID id, const ResidencyAsset& asset, uint mip) = 0;
+	virtual void		Update(ResidencyManager& manager) = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Decides what is resident. The renderer marks the streamable textures it draws each frame. Model meshes are never marked,
+// the model registry hands out their pointers for good, so they stay resident and untracked. Update, called once per
+// frame before anything draws, finishes stream-ins, evicts what has gone unused the longest while a type is over budget,
+// drops the top mips of large textures if that isn't enough, then starts stream-ins for what was used and isn't resident.
+// Resources are tracked the first time the backend can describe them, whatever it never can is left alone.
+// GetVersion changes whenever a resource pointer was replaced or freed, anything caching those pointers resolves again.
+// Main thread only
+//------------------------------------------------------------------------------------------------------------------------------
+class ResidencyManager
+{
+public:
+	explicit ResidencyManager(ResidencyBackend* backend);
+
+	void					SetBudget(const ResidencyBudget& budget);
+	void					LoadBudgetFromConfig();
+
+	inline void				MarkMeshUsed(uint meshHandle) { MarkUsed(RESIDENCY_MESH, meshHandle, 0U); }
+	inline void				MarkTextureUsed(uint textureHandle, uint wantedMip = 0U) { MarkUsed(RESIDENCY_TEXTURE, textureHandle, wantedMip); }
+	void					MarkUsed(eResidencyAssetType type, uint resourceHandle, uint wantedMip);
+
+	void					Update();
+	void					FinishStreamIn(ResidencyID id, bool succeeded);
+
+	ResidencyID				FindAsset(eResidencyAssetType type, uint resourceHandle) const;
+	inline const ResidencyAsset&	GetAsset(ResidencyID id) const { return m_assets[id]; }
+	inline uint				GetNumAssets() const { return (uint)m_assets.size(); }
+	inline const ResidencyStats&	GetStats() const { return m_stats; }
+	inline const ResidencyBudget&	GetBudget() const { return m_budget; }
+	inline uint				GetVersion() const { return m_version; }
+	inline uint				GetFrame() const { return m_frame; }
+
+	static const char*		GetStateName(eResidencyState state);
+
+	static bool				Command_Residency(EventArgs& args);
+
+private:
+	ResidencyID				TrackAsset(eResidencyAssetType type, uint resourceHandle);
+	void					EnforceBudget(eResidencyAssetType type);
+	bool					ReleaseBytes(eResidencyAssetType type, uint64_t neededBytes, uint dropMipsFinerThan, ResidencyID keepID);
+	void					StartStreamIns();
+	void					SetResidentMip(ResidencyAsset& asset, uint mip);
+	uint64_t				GetAvailableBytes(eResidencyAssetType type) const;
+	bool					IsEvictable(const ResidencyAsset& asset) const;
+
+private:
+	//Per type, indexed by resource handle. Untracked holds handles the backend couldn't describe
+	static const ResidencyID	UNTRACKED_RESIDENCY_ID = 0xFFFFFFFEU;
+
+	ResidencyBackend*			m_backend = nullptr;
+	ResidencyBudget				m_budget;
+	ResidencyStats				m_stats;
+	uint64_t					m_incomingBytes[NUM_RESIDENCY_ASSET_TYPES] = {};		//Still streaming, counted against the budget already
+
+	std::vector<ResidencyAsset>	m_assets;
+	std::vector<ResidencyID>	m_lookup[NUM_RESIDENCY_ASSET_TYPES];
+
+	uint						m_frame = 1U;
+	uint						m_version = 0U;
+};
+
+extern ResidencyManager* g_assetResidency;
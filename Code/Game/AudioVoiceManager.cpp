@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/AudioVoiceManager.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+//Others
+#include <algorithm>
+
+extern AudioSystem* g_audio;
+
+AudioVoiceManager* g_audioVoices = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+SoundPlaybackID EngineAudioVoiceBackend::PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel)
+{
+	return g_audio->Play3DSound(sound, position, channel);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineAudioVoiceBackend::StopVoice(SoundPlaybackID playback)
+{
+	g_audio->StopSound(playback);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SoundPlaybackID NullAudioVoiceBackend::PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel)
+{
+	UNUSED(sound);
+	UNUSED(position);
+	UNUSED(channel);
+
+	m_numPlays++;
+	return (SoundPlaybackID)m_numPlays;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void NullAudioVoiceBackend::StopVoice(SoundPlaybackID playback)
+{
+	UNUSED(playback);
+	m_numStops++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+AudioVoiceManager::AudioVoiceManager(AudioVoiceBackend* backend)
+	:	m_backend(backend)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AudioVoiceManager::SetSettings(const AudioVoiceSettings& settings)
+{
+	m_settings = settings;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// audioMaxVoices, audioVoiceMS, audioMergeWindowMS, audioMergeRadius and audioMaxDistance in GameConfig, the defaults otherwise
+//------------------------------------------------------------------------------------------------------------------------------
+void AudioVoiceManager::LoadSettingsFromConfig()
+{
+	AudioVoiceSettings settings;
+	settings.m_maxVoices = (uint)g_gameConfigBlackboard.GetValue("audioMaxVoices", (int)settings.m_maxVoices);
+	settings.m_voiceSeconds = (float)g_gameConfigBlackboard.GetValue("audioVoiceMS", (int)(settings.m_voiceSeconds * 1000.f)) * 0.001f;
+	settings.m_mergeWindowSeconds = (float)g_gameConfigBlackboard.GetValue("audioMergeWindowMS", (int)(settings.m_mergeWindowSeconds * 1000.f)) * 0.001f;
+	settings.m_mergeRadius = g_gameConfigBlackboard.GetValue("audioMergeRadius", settings.m_mergeRadius);
+	settings.m_maxDistance = g_gameConfigBlackboard.GetValue("audioMaxDistance", settings.m_maxDistance);
+	SetSettings(settings);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Called for every impact frame, so a burst of the same sound costs a walk over this frame's queue and the voice pool
+//------------------------------------------------------------------------------------------------------------------------------
+void AudioVoiceManager::PlayOneShot(SoundID sound, const Vec2& position, ChannelGroupID channel)
+{
+	m_stats.m_numRequested++;
+
+	for (size_t voiceIndex = 0; voiceIndex < m_voices.size(); voiceIndex++)
+	{
+		const AudioVoice& voice = m_voices[voiceIndex];
+		if (m_time - voice.m_startTime <= m_settings.m_mergeWindowSeconds && IsMergeable(sound, channel, position, voice.m_sound, voice.m_channel, voice.m_position))
+		{
+			m_stats.m_numMerged++;
+			return;
+		}
+	}
+
+	//The merged sound plays from whichever was nearer the listener
+	for (size_t requestIndex = 0; requestIndex < m_requests.size(); requestIndex++)
+	{
+		AudioVoiceRequest& request = m_requests[requestIndex];
+		if (IsMergeable(sound, channel, position, request.m_sound, request.m_channel, request.m_position))
+		{
+			if (GetDistanceToListener(position) < GetDistanceToListener(request.m_position))
+			{
+				request.m_position = position;
+			}
+
+			m_stats.m_numMerged++;
+			return;
+		}
+	}
+
+	AudioVoiceRequest request;
+	request.m_sound = sound;
+	request.m_channel = channel;
+	request.m_position = position;
+	m_requests.push_back(request);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AudioVoiceManager::Update(float deltaSeconds, const Vec3& listenerPosition)
+{
+	m_time += deltaSeconds;
+	m_listenerPosition = Vec2(listenerPosition.x, listenerPosition.y);
+	m_stats.m_numFrames++;
+
+	//Finished voices free their slot, the rest are prioritized from where the listener is now
+	size_t voiceIndex = 0;
+	while (voiceIndex < m_voices.size())
+	{
+		if (m_time - m_voices[voiceIndex].m_startTime >= m_settings.m_voiceSeconds)
+		{
+			m_voices[voiceIndex] = m_voices.back();
+			m_voices.pop_back();
+			continue;
+		}
+
+		m_voices[voiceIndex].m_distance = GetDistanceToListener(m_voices[voiceIndex].m_position);
+		voiceIndex++;
+	}
+
+	//Inaudible sources never reach the backend
+	size_t requestIndex = 0;
+	while (requestIndex < m_requests.size())
+	{
+		m_requests[requestIndex].m_distance = GetDistanceToListener(m_requests[requestIndex].m_position);
+		if (m_requests[requestIndex].m_distance > m_settings.m_maxDistance)
+		{
+			m_stats.m_numCulled++;
+			m_requests[requestIndex] = m_requests.back();
+			m_requests.pop_back();
+			continue;
+		}
+
+		requestIndex++;
+	}
+
+	std::sort(m_requests.begin(), m_requests.end(), [](const AudioVoiceRequest& lhs, const AudioVoiceRequest& rhs) { return lhs.m_distance < rhs.m_distance; });
+
+	for (requestIndex = 0; requestIndex < m_requests.size(); requestIndex++)
+	{
+		const AudioVoiceRequest& request = m_requests[requestIndex];
+		if (m_voices.size() < (size_t)m_settings.m_maxVoices)
+		{
+			StartVoice(request);
+			continue;
+		}
+
+		uint furthestIndex = FindFurthestVoice();
+		if (furthestIndex == (uint)m_voices.size() || m_voices[furthestIndex].m_distance <= request.m_distance)
+		{
+			m_stats.m_numDropped++;
+			continue;
+		}
+
+		m_backend->StopVoice(m_voices[furthestIndex].m_playback);
+		m_voices[furthestIndex] = m_voices.back();
+		m_voices.pop_back();
+		m_stats.m_numStolen++;
+
+		StartVoice(request);
+	}
+
+	m_requests.clear();
+	m_stats.m_peakVoices = std::max(m_stats.m_peakVoices, (uint)m_voices.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool AudioVoiceManager::IsMergeable(SoundID sound, ChannelGroupID channel, const Vec2& position, SoundID otherSound, ChannelGroupID otherChannel, const Vec2& otherPosition) const
+{
+	if (sound != otherSound || channel != otherChannel)
+		return false;
+
+	return (position - otherPosition).GetLength() <= m_settings.m_mergeRadius;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+float AudioVoiceManager::GetDistanceToListener(const Vec2& position) const
+{
+	return (position - m_listenerPosition).GetLength();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AudioVoiceManager::StartVoice(const AudioVoiceRequest& request)
+{
+	AudioVoice voice;
+	voice.m_sound = request.m_sound;
+	voice.m_channel = request.m_channel;
+	voice.m_playback = m_backend->PlayVoice(request.m_sound, request.m_position, request.m_channel);
+	voice.m_position = request.m_position;
+	voice.m_startTime = m_time;
+	voice.m_distance = request.m_distance;
+	m_voices.push_back(voice);
+
+	m_stats.m_numStarted++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The number of voices when there are none
+//------------------------------------------------------------------------------------------------------------------------------
+uint AudioVoiceManager::FindFurthestVoice() const
+{
+	uint furthestIndex = (uint)m_voices.size();
+	float furthestDistance = -1.f;
+	for (uint voiceIndex = 0; voiceIndex < (uint)m_voices.size(); voiceIndex++)
+	{
+		if (m_voices[voiceIndex].m_distance > furthestDistance)
+		{
+			furthestDistance = m_voices[voiceIndex].m_distance;
+			furthestIndex = voiceIndex;
+		}
+	}
+	return furthestIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool AudioVoiceManager::Command_AudioVoices(EventArgs& args)
+{
+	UNUSED(args);
+
+	const AudioVoiceManager& manager = *g_audioVoices;
+	const AudioVoiceStats& stats = manager.GetStats();
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("%u of %u voices playing, peak %u", manager.GetNumVoices(), manager.GetSettings().m_maxVoices, stats.m_peakVoices));
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("%u requested over %u frames: %u started, %u merged, %u culled, %u dropped, %u stolen",
+		stats.m_numRequested, stats.m_numFrames, stats.m_numStarted, stats.m_numMerged, stats.m_numCulled, stats.m_numDropped, stats.m_numStolen));
+	return true;
+}
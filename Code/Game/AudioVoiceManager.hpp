@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Others
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The same sound fired again within m_mergeWindowSeconds and m_mergeRadius of one already playing or queued is merged into
+// it. Voices are held for m_voiceSeconds, long enough for the one-shots we play
+//------------------------------------------------------------------------------------------------------------------------------
+struct AudioVoiceSettings
+{
+	uint					m_maxVoices = 24U;
+	float					m_voiceSeconds = 0.6f;
+	float					m_mergeWindowSeconds = 0.08f;
+	float					m_mergeRadius = 3.f;
+	float					m_maxDistance = 40.f;			//From the camera focal point, anything further is inaudible
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct AudioVoiceStats
+{
+	uint					m_numRequested = 0U;
+	uint					m_numMerged = 0U;
+	uint					m_numCulled = 0U;
+	uint					m_numDropped = 0U;				//No free voice and every playing one was nearer
+	uint					m_numStolen = 0U;
+	uint					m_numStarted = 0U;
+	uint					m_peakVoices = 0U;
+	uint					m_numFrames = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What actually plays the voices
+//------------------------------------------------------------------------------------------------------------------------------
+class AudioVoiceBackend
+{
+public:
+	virtual ~AudioVoiceBackend() {}
+
+	virtual SoundPlaybackID	PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel) = 0;
+	virtual void			StopVoice(SoundPlaybackID playback) = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Plays through the engine's FMOD audio system
+//------------------------------------------------------------------------------------------------------------------------------
+class EngineAudioVoiceBackend : public AudioVoiceBackend
+{
+public:
+	virtual SoundPlaybackID	PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel) override;
+	virtual void			StopVoice(SoundPlaybackID playback) override;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Plays nothing and needs no device, it only counts. Used when running headless
+//------------------------------------------------------------------------------------------------------------------------------
+class NullAudioVoiceBackend : public AudioVoiceBackend
+{
+public:
+	virtual SoundPlaybackID	PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel) override;
+	virtual void			StopVoice(SoundPlaybackID playback) override;
+
+public:
+	uint					m_numPlays = 0U;
+	uint					m_numStops = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Keeps a fixed pool of one-shot voices. PlayOneShot only queues the sound, merging it into a matching one; Update, once
+// per frame after the simulation, culls what is too far from the listener and starts the rest nearest first, stealing the
+// furthest playing voice when the pool is full. Main thread only
+//------------------------------------------------------------------------------------------------------------------------------
+class AudioVoiceManager
+{
+public:
+	explicit AudioVoiceManager(AudioVoiceBackend* backend);
+
+	void					SetSettings(const AudioVoiceSettings& settings);
+	void					LoadSettingsFromConfig();
+
+	void					PlayOneShot(SoundID sound, const Vec2& position, ChannelGroupID channel);
+	void					Update(float deltaSeconds, const Vec3& listenerPosition);
+
+	inline uint				GetNumVoices() const { return (uint)m_voices.size(); }
+	inline const AudioVoiceStats&	GetStats() const { return m_stats; }
+	inline const AudioVoiceSettings&	GetSettings() const { return m_settings; }
+
+	static bool				Command_AudioVoices(EventArgs& args);
+
+private:
+	struct AudioVoice
+	{
+		SoundID				m_sound;
+		ChannelGroupID		m_channel;
+		SoundPlaybackID		m_playback;
+		Vec2				m_position;
+		float				m_startTime = 0.f;
+		float				m_distance = 0.f;
+	};
+
+	struct AudioVoiceRequest
+	{
+		SoundID				m_sound;
+		ChannelGroupID		m_channel;
+		Vec2				m_position;
+		float				m_distance = 0.f;
+	};
+
+	bool					IsMergeable(SoundID sound, ChannelGroupID channel, const Vec2& position, SoundID otherSound, ChannelGroupID otherChannel, const Vec2& otherPosition) const;
+	float					GetDistanceToListener(const Vec2& position) const;
+	void					StartVoice(const AudioVoiceRequest& request);
+	uint					FindFurthestVoice() const;
+
+private:
+	AudioVoiceBackend*				m_backend = nullptr;
+	AudioVoiceSettings				m_settings;
+	AudioVoiceStats					m_stats;
+
+	std::vector<AudioVoice>			m_voices;
+	std::vector<AudioVoiceRequest>	m_requests;			//Queued since the last Update
+
+	Vec2							m_listenerPosition = Vec2::ZERO;
+	float							m_time = 0.f;
+};
+
+extern AudioVoiceManager* g_audioVoices;
@@ -13,12 +13,16 @@
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
 //Game Systems
+#include "Game/AudioVoiceManager.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameInput.hpp"
+#include "Game/GameLog.hpp"
+#include "Game/GameplayData.hpp"
 #include "Game/Map.hpp"
 #include "Game/IsoAnimDefenition.hpp"
 #include "Game/RTSTask.hpp"
 #include "Game/RTSCommand.hpp"
+#include "Game/StateHash.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
 Entity::Entity()
@@ -45,7 +49,7 @@ Entity::Entity(GameHandle handle, Vec2 position, const std::string& xmlName)
 
 	m_flags = SetBit(m_flags, ENTITY_SELECTABLE_BIT);
 
-	MakeFromXML(xmlName);
+	MakeFromDefinition(xmlName);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -59,137 +63,185 @@ Entity::~Entity()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Entity::MakeFromXML(const std::string& fileName)
+// Definitions come compiled from the unit XML, fileName is the XML the unit was compiled from
+//------------------------------------------------------------------------------------------------------------------------------
+void Entity::MakeFromDefinition(const std::string& fileName)
 {
-	//Open the xml file and parse it
-	tinyxml2::XMLDocument entityDoc;
-	entityDoc.LoadFile(fileName.c_str());
-
-	if (entityDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	const GameplayUnitRecord* unit = g_gameplayData->FindUnit(fileName);
+	if (unit == nullptr)
 	{
-		/*
-		printf("\n >> Error loading XML file from %s ", fileName);
-		printf("\n >> Error ID : %i ", shaderDoc.ErrorID());
-		printf("\n >> Error line number is : %i", shaderDoc.ErrorLineNum());
-		printf("\n >> Error name : %s", shaderDoc.ErrorName());
-		*/
-		ERROR_AND_DIE(">> Error loading Entity XML file ");
+		ERROR_AND_DIE(Stringf(">> No gameplay data compiled for %s ", fileName.c_str()));
 		return;
 	}
-	else
-	{
-		//We read everything fine. Now just shove all that data into the required place
-		XMLElement* rootElement = entityDoc.RootElement();
 
-		std::string id = ParseXmlAttribute(*rootElement, "id", "peon");
-		m_health = ParseXmlAttribute(*rootElement, "health", m_health);
-		m_speed = ParseXmlAttribute(*rootElement, "speed", m_speed);
-		bool selectable = ParseXmlAttribute(*rootElement, "selectable", true);
-		bool isResource = ParseXmlAttribute(*rootElement, "resource", true);
-		bool isBuilding = ParseXmlAttribute(*rootElement, "building", true);
+	m_definitionPath = fileName;
 
-		SetSelectable(selectable);
-		SetAsResource(isResource);
-
-		//Read animation texture data
-		rootElement = rootElement->FirstChildElement();
+	std::string id = g_gameplayData->GetString(unit->m_id);
+	if (unit->m_flags & GAMEPLAY_UNIT_HAS_HEALTH)
+	{
+		m_health = unit->m_health;
+	}
+	if (unit->m_flags & GAMEPLAY_UNIT_HAS_SPEED)
+	{
+		m_speed = unit->m_speed;
+	}
 
-		if (!isResource && !isBuilding)
-		{
-			//Follow pattern for non resource
+	bool isResource = (unit->m_flags & GAMEPLAY_UNIT_RESOURCE) != 0U;
+	bool isBuilding = (unit->m_flags & GAMEPLAY_UNIT_BUILDING) != 0U;
 
-			std::string textureName = ParseXmlAttribute(*rootElement, "walkTexture", "");
-			m_walkTexture = g_renderContext->CreateOrGetTextureViewFromFile(textureName);
-			textureName = ParseXmlAttribute(*rootElement, "attackTexture", "");
-			m_walkTexture = g_renderContext->CreateOrGetTextureViewFromFile(textureName);
+	SetSelectable((unit->m_flags & GAMEPLAY_UNIT_SELECTABLE) != 0U);
+	SetAsResource(isResource);
 
-			Vec2 pivot = ParseXmlAttribute(*rootElement, "pivot", Vec2::ZERO);
-			IntVec2 dimensions = ParseXmlAttribute(*rootElement, "sheetDimensions", IntVec2::ZERO);
+	if (!isResource && !isBuilding)
+	{
+		//Follow pattern for non resource
+		m_walkTexture = g_renderContext->CreateOrGetTextureViewFromFile(g_gameplayData->GetString(unit->m_walkTexture));
+		m_attackTexture = g_renderContext->CreateOrGetTextureViewFromFile(g_gameplayData->GetString(unit->m_attackTexture));
 
-			//Load the specific animations
-			XMLElement* childElement = rootElement->FirstChildElement();
+		IntVec2 dimensions = IntVec2(unit->m_sheetDimensions[0], unit->m_sheetDimensions[1]);
 
-			while (childElement != nullptr)
-			{
-				MakeAnimationsForEntity(childElement, dimensions, id);				
-				childElement = childElement->NextSiblingElement();
-			}
+		//Load the specific animations
+		const GameplayAnimRecord* anims = g_gameplayData->GetAnims(*unit);
+		for (uint animIndex = 0; animIndex < unit->m_numAnims; animIndex++)
+		{
+			MakeAnimationsForEntity(anims[animIndex], dimensions, id);
 		}
-		else
+	}
+	else
+	{
+		//Follows pattern for models
+		if (unit->m_flags & GAMEPLAY_UNIT_HAS_COLLISION)
 		{
-			//Follows pattern for models
-			if (rootElement != nullptr)
-			{
-				std::string name = rootElement->Name();
-				if (name == "collision")
-				{
-					m_collisionRadius = ParseXmlAttribute(*rootElement, "radius", m_collisionRadius);		
-					rootElement = rootElement->NextSiblingElement();
-				}
+			m_collisionRadius = unit->m_collisionRadius;
+		}
 
-				name = rootElement->Name();
-				if (name == "occupancy")
-				{
-					m_occupancy = ParseXmlAttribute(*rootElement, "tilesXY", m_occupancy);
-					rootElement = rootElement->NextSiblingElement();
-				}
-				
-				if (rootElement != nullptr)
-				{
-					SetMeshIDsForResource(rootElement);
-				}
+		if (unit->m_flags & GAMEPLAY_UNIT_HAS_OCCUPANCY)
+		{
+			m_occupancy = IntVec2(unit->m_occupancy[0], unit->m_occupancy[1]);
+		}
 
-				if (id == "building.townCenter" || id == "building.hut")
-				{
-					Game::s_gameReference->m_map->m_townCenterOcc = m_occupancy;
-				}
-			}
+		SetModelsForResource(*unit);
+
+		if (id == "building.townCenter" || id == "building.hut")
+		{
+			Game::s_gameReference->m_map->m_townCenterOcc = m_occupancy;
 		}
 	}
-
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Entity::SetMeshIDsForResource(XMLElement* xmlElement)
-{
-	m_meshIDMap[SOURCE] = ParseXmlAttribute(*xmlElement, "src", "");
-	m_meshIDMap[BASE] = ParseXmlAttribute(*xmlElement, "base", "");
-	m_meshIDMap[FULL] = ParseXmlAttribute(*xmlElement, "full", "");
-	m_meshIDMap[WEAK] = ParseXmlAttribute(*xmlElement, "weak", "");
-}
-
+// Patches a live entity with its reloaded definition. Health scales by how much the definition changed so damage taken
+// and construction progress carry over. Returns how many animations were rebuilt
 //------------------------------------------------------------------------------------------------------------------------------
-void Entity::MakeAnimationsForEntity(XMLElement* xmlElement, const IntVec2& dimensions, const std::string& id)
+uint Entity::ReloadDefinition(const GameplayUnitRecord& previous, const GameplayUnitRecord& unit, bool rebuildAnimations, bool rebuildMeshes)
 {
-	std::string animID = ParseXmlAttribute(*xmlElement, "id", "idle");
-	int numFrames = ParseXmlAttribute(*xmlElement, "numFrames", 1);
-	int spritesEachFrame = ParseXmlAttribute(*xmlElement, "spritesEachFrame", 8);
-	float animTime = ParseXmlAttribute(*xmlElement, "animTime", 1.f);
+	if ((previous.m_flags & unit.m_flags & GAMEPLAY_UNIT_HAS_HEALTH) && previous.m_health > 0.f)
+	{
+		float healthScale = unit.m_health / previous.m_health;
+		m_health *= healthScale;
+		m_maxHealth *= healthScale;
+	}
+	if (unit.m_flags & GAMEPLAY_UNIT_HAS_SPEED)
+	{
+		m_speed = unit.m_speed;
+	}
+	if (unit.m_flags & GAMEPLAY_UNIT_HAS_COLLISION)
+	{
+		m_collisionRadius = unit.m_collisionRadius;
+	}
+	SetSelectable((unit.m_flags & GAMEPLAY_UNIT_SELECTABLE) != 0U);
 
-	SpriteSheet walkSheet = SpriteSheet(m_walkTexture, dimensions);
-	SpriteSheet attackSheet = SpriteSheet(m_attackTexture, dimensions);
+	IntVec2 occupancy = (unit.m_flags & GAMEPLAY_UNIT_HAS_OCCUPANCY) ? IntVec2(unit.m_occupancy[0], unit.m_occupancy[1]) : m_occupancy;
+	if (occupancy != m_occupancy)
+	{
+		Map* map = Game::s_gameReference->m_map;
+		if (m_occupancy != IntVec2::ZERO)
+		{
+			map->SetOccupancyForUnit(m_position, m_occupancy, false);
+		}
+		map->SetOccupancyForUnit(m_position, occupancy, true);
+		m_occupancy = occupancy;
+
+		std::string id = g_gameplayData->GetString(unit.m_id);
+		if (id == "building.townCenter" || id == "building.hut")
+		{
+			map->m_townCenterOcc = m_occupancy;
+		}
+	}
 
-	if (animID == "idle")
+	if (rebuildMeshes)
 	{
-		int idleColumn = ParseXmlAttribute(*xmlElement, "idleColumn", 5);
-		MakeIdleCycle(walkSheet, numFrames, spritesEachFrame, idleColumn, id, animTime);
+		SetModelsForResource(unit);
 	}
-	else if (animID == "walk")
+
+	if (!rebuildAnimations || unit.m_numAnims == 0U)
+		return 0U;
+
+	//Anything the new definition leaves out keeps playing the old animation
+	IsoAnimDefenition* previousSet[ANIMATION_COUNT];
+	for (int animType = 0; animType < ANIMATION_COUNT; animType++)
 	{
-		MakeWalkCycle(walkSheet, numFrames, spritesEachFrame, id, animTime);
+		previousSet[animType] = m_animationSet[animType];
 	}
-	else if (animID == "death")
+
+	m_walkTexture = g_renderContext->CreateOrGetTextureViewFromFile(g_gameplayData->GetString(unit.m_walkTexture));
+	m_attackTexture = g_renderContext->CreateOrGetTextureViewFromFile(g_gameplayData->GetString(unit.m_attackTexture));
+
+	IntVec2 dimensions = IntVec2(unit.m_sheetDimensions[0], unit.m_sheetDimensions[1]);
+	std::string id = g_gameplayData->GetString(unit.m_id);
+	const GameplayAnimRecord* anims = g_gameplayData->GetAnims(unit);
+	for (uint animIndex = 0; animIndex < unit.m_numAnims; animIndex++)
 	{
-		IntRange deathColumns = ParseXmlAttribute(*xmlElement, "deathColumn", IntRange(5, 7));
-		MakeDeathCycle(walkSheet, numFrames, spritesEachFrame, id, animTime, deathColumns);
+		MakeAnimationsForEntity(anims[animIndex], dimensions, id);
 	}
-	else if (animID == "attack")
+
+	uint numRebuilt = 0U;
+	for (int animType = 0; animType < ANIMATION_COUNT; animType++)
 	{
-		MakeAttackCycle(attackSheet, numFrames, spritesEachFrame, id, animTime);
+		if (m_animationSet[animType] != previousSet[animType])
+		{
+			delete previousSet[animType];
+			numRebuilt++;
+		}
 	}
-	else
+
+	m_currentAnimTime = 0.f;
+	return numRebuilt;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Entity::SetModelsForResource(const GameplayUnitRecord& unit)
+{
+	//Requested now so rendering the resource never looks a path up. A mesh that isn't resident yet is cooked on the job system
+	m_modelHandles[SOURCE] = g_modelRegistry->RequestModel(g_gameplayData->GetString(unit.m_meshes[SOURCE]));
+	m_modelHandles[BASE] = g_modelRegistry->RequestModel(g_gameplayData->GetString(unit.m_meshes[BASE]));
+	m_modelHandles[FULL] = g_modelRegistry->RequestModel(g_gameplayData->GetString(unit.m_meshes[FULL]));
+	m_modelHandles[WEAK] = g_modelRegistry->RequestModel(g_gameplayData->GetString(unit.m_meshes[WEAK]));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Entity::MakeAnimationsForEntity(const GameplayAnimRecord& anim, const IntVec2& dimensions, const std::string& id)
+{
+	SpriteSheet walkSheet = SpriteSheet(m_walkTexture, dimensions);
+	SpriteSheet attackSheet = SpriteSheet(m_attackTexture, dimensions);
+
+	switch (anim.m_type)
 	{
+	case GAMEPLAY_ANIM_IDLE:
+		MakeIdleCycle(walkSheet, anim.m_numFrames, anim.m_spritesEachFrame, anim.m_idleColumn, id, anim.m_animTime);
+		break;
+	case GAMEPLAY_ANIM_WALK:
+		MakeWalkCycle(walkSheet, anim.m_numFrames, anim.m_spritesEachFrame, id, anim.m_animTime);
+		break;
+	case GAMEPLAY_ANIM_DEATH:
+		MakeDeathCycle(walkSheet, anim.m_numFrames, anim.m_spritesEachFrame, id, anim.m_animTime, IntRange(anim.m_deathColumnMin, anim.m_deathColumnMax));
+		break;
+	case GAMEPLAY_ANIM_ATTACK:
+		MakeAttackCycle(attackSheet, anim.m_numFrames, anim.m_spritesEachFrame, id, anim.m_animTime);
+		break;
+	default:
 		ASSERT_RECOVERABLE(true, "Animation type not defined in project");
+		break;
 	}
 }
 
@@ -239,7 +291,10 @@ void Entity::CheckEntityDeath()
 	{
 		//Die
 		Game* game = Game::s_gameReference;
-		game->m_deathSoundPlayback = g_audio->Play3DSound(game->m_deathSoundID, m_position, game->m_SFXChannel);
+		if (!game->m_isReplaying)
+		{
+			g_audioVoices->PlayOneShot(game->m_deathSoundID, m_position, game->m_SFXChannel);
+		}
 
 		m_position = m_targetPosition;
 		m_prevState = m_currentState;
@@ -277,18 +332,14 @@ void Entity::CheckIfTrainingUnit(float deltaTime)
 				m_trainingProgress = 0.f;
 				m_isTrainingUnit = false;
 
-				CreateEntityCommand* command = nullptr;
-
 				if (m_team == 1)
 				{
-					command = new CreateEntityCommand(GetPosition(), PEON);
+					Game::s_gameReference->EnqueueCommand(RTSCommand::MakeCreateEntity(GetPosition(), PEON));
 				}
 				else
 				{
-					command = new CreateEntityCommand(GetPosition(), GOBLIN);
+					Game::s_gameReference->EnqueueCommand(RTSCommand::MakeCreateEntity(GetPosition(), GOBLIN));
 				}
-
-				Game::s_gameReference->EnqueueCommand(reinterpret_cast<RTSCommand*>(command));
 			}
 		}
 	}
@@ -318,12 +369,15 @@ void Entity::CheckIfEntityIsPathing()
 			}
 		}
 
-		
-		AABB2 quad = AABB2(Vec3::ZERO, Vec3(1.f, 1.f, 0.f));
-		for (int i = 0; i < (int)m_unitPath->size(); i++)
+		//Replays can run many ticks a frame, skip the path quads so the debug renderer isn't flooded
+		if (!Game::s_gameReference->m_isReplaying)
 		{
-			IntVec2 position = m_unitPath->at(i);
-			g_debugRenderer->DebugRenderQuad(quad, Vec3((float)position.x, (float)position.y, 0.f), 0.f, nullptr, false);
+			AABB2 quad = AABB2(Vec3::ZERO, Vec3(1.f, 1.f, 0.f));
+			for (int i = 0; i < (int)m_unitPath->size(); i++)
+			{
+				IntVec2 position = m_unitPath->at(i);
+				g_debugRenderer->DebugRenderQuad(quad, Vec3((float)position.x, (float)position.y, 0.f), 0.f, nullptr, false);
+			}
 		}
 	}
 }
@@ -633,7 +687,10 @@ void Entity::DamageUnit(Entity* target)
 	if (frameNum == 3 && !m_doingDamage)
 	{
 		Game* game = Game::s_gameReference;
-		game->m_attackSoundPlayback = g_audio->Play3DSound(game->m_attackSoundID, m_position, game->m_SFXChannel);
+		if (!game->m_isReplaying)
+		{
+			g_audioVoices->PlayOneShot(game->m_attackSoundID, m_position, game->m_SFXChannel);
+		}
 
 		target->TakeDamage(m_attackDamage);
 		m_doingDamage = true;
@@ -659,7 +716,10 @@ void Entity::GatherUnit(Entity* target)
 	if (frameNum == 3 && !m_doingDamage)
 	{
 		Game* game = Game::s_gameReference;
-		game->m_attackSoundPlayback = g_audio->Play3DSound(game->m_attackSoundID, m_position, game->m_SFXChannel);
+		if (!game->m_isReplaying)
+		{
+			g_audioVoices->PlayOneShot(game->m_attackSoundID, m_position, game->m_SFXChannel);
+		}
 
 		DamageUnit(target);
 
@@ -902,15 +962,27 @@ void Entity::MoveTo(Vec2 target)
 	m_targetPosition = target;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Paths are solved as a batch of jobs in Map::Update, this just records where we want to go
 //------------------------------------------------------------------------------------------------------------------------------
 void Entity::PathTo(Vec2 target)
+{
+	m_pathRequestTarget = target;
+	m_pathRequested = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Runs on a job thread. Only touches this entity and reads the pather so solves for different entities can run together
+//------------------------------------------------------------------------------------------------------------------------------
+void Entity::SolveRequestedPath(Pather* pather)
 {
 	delete m_unitPath;
 	m_unitPath = new Path;
 	m_pathSolver.AddStart(m_position);
-	m_pathSolver.AddEnd(target);
-	m_pathSolver.StartDistanceField(&Game::s_gameReference->m_map->m_mapPather, m_unitPath);
+	m_pathSolver.AddEnd(m_pathRequestTarget);
+	m_pathSolver.StartDistanceField(pather, m_unitPath);
 	m_pathTarget = Vec2::NEGATIVE_ONE;
+	m_pathRequested = false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -989,15 +1061,9 @@ void Entity::SetAsResource(bool resource)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-const std::string& Entity::GetMeshIDForState(ResourceMeshT meshType) const
+ModelHandle Entity::GetModelHandleForState(ResourceMeshT meshType) const
 {
-	std::map<ResourceMeshT, std::string>::const_iterator requestedMeshID = m_meshIDMap.find(meshType);
-	if (requestedMeshID == m_meshIDMap.end())
-	{
-		ASSERT_RECOVERABLE(true, "Mesh type doesn't exist");
-	}
-	
-	return requestedMeshID->second;
+	return m_modelHandles[meshType];
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -1085,10 +1151,10 @@ bool Entity::RaycastHit(float *out, const Ray3D& ray) const
 
 	if (hits > 0) 
 	{
-		g_devConsole->PrintString(Rgba::WHITE, Stringf("Hits: %u", hits));
+		g_gameLog->Log(LOG_DEBUG, LOG_CATEGORY_GAMEPLAY, "Hits: %u", hits);
 		for (uint i = 0; i < hits; ++i)
 		{
-			g_devConsole->PrintString(Rgba::YELLOW, Stringf("  Time: %.2f", out[i]));
+			g_gameLog->Log(LOG_DEBUG, LOG_CATEGORY_GAMEPLAY, "  Time: %.2f", out[i]);
 		}
 	}
 
@@ -1104,42 +1170,103 @@ bool Entity::RaycastHit(float *out, const Ray3D& ray) const
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Entity::EnqueueTask(RTSTask* task)
+bool Entity::EnqueueTask(const RTSTask& task)
+{
+	return m_taskQueue.Enqueue(task);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A player order. Anything not queued with shift replaces whatever we were doing
+//------------------------------------------------------------------------------------------------------------------------------
+bool Entity::IssueTask(const RTSTask& task)
 {
-	for (int index = 0; index < m_taskQueue.size(); index++)
+	if (!task.m_isQueued)
 	{
-		if (m_taskQueue[index] == nullptr)
-		{
-			m_taskQueue[index] = task;
-			return;
-		}
+		ClearTasks();
+		ResetTaskData();
 	}
 
-	m_taskQueue.push_back(task);
+	return EnqueueTask(task);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Runs at most one task a frame. Queued tasks hold the line until whatever we are doing now has finished
 //------------------------------------------------------------------------------------------------------------------------------
 void Entity::ProcessTasks()
 {
-	std::vector<RTSTask*>::iterator itr;
-	itr = m_taskQueue.begin();
+	const RTSTask* nextTask = m_taskQueue.PeekFront();
+	if(nextTask == nullptr)
+		return;
 
-	int numTasks = (int)m_taskQueue.size();
+	if(nextTask->m_isQueued && !IsIdle())
+		return;
 
-	for (int index = 0; index < numTasks; index++)
-	{
-		if (m_taskQueue[index] != nullptr)
-		{
-			m_taskQueue[index]->Execute();
-			delete m_taskQueue[index];
-			m_taskQueue[index] = nullptr;
-		}
-	}
+	RTSTask task;
+	m_taskQueue.Dequeue(&task);
+	task.Execute(*this);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Entity::ClearTasks()
 {
 	m_unitToFollow = nullptr;
-	m_taskQueue.clear();
+	m_taskQueue.Clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool Entity::IsIdle() const
+{
+	if (!m_isAlive)
+		return false;
+
+	if (m_unitToFollow != nullptr || m_unitToAttack != nullptr || m_unitToGather != nullptr || m_unitToBuild != nullptr)
+		return false;
+
+	if (m_pathRequested || (m_unitPath != nullptr && m_unitPath->size() > 0))
+		return false;
+
+	return GetDistanceSquared2D(m_position, m_targetPosition) < m_idleDistanceSquared;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Everything the simulation reads back on the next tick, packed as ENTITY_HASH_WORDS words. Render only data stays out
+//------------------------------------------------------------------------------------------------------------------------------
+void Entity::PackStateHashWords(uint* words) const
+{
+	uint flags = 0U;
+	flags |= m_isAlive ? BIT_FLAG(0) : 0U;
+	flags |= m_isGarbage ? BIT_FLAG(1) : 0U;
+	flags |= m_isGathering ? BIT_FLAG(2) : 0U;
+	flags |= m_isTrainingUnit ? BIT_FLAG(3) : 0U;
+	flags |= m_isBuilt ? BIT_FLAG(4) : 0U;
+	flags |= m_dropOffResources ? BIT_FLAG(5) : 0U;
+	flags |= m_doingDamage ? BIT_FLAG(6) : 0U;
+	flags |= m_pathRequested ? BIT_FLAG(7) : 0U;
+
+	const RTSTask* frontTask = m_taskQueue.PeekFront();
+
+	words[0] = GetStateHashHandleWord(m_handle);
+	words[1] = (uint)m_type;
+	words[2] = (uint)m_team;
+	words[3] = flags;
+	words[4] = GetStateHashFloatWord(m_position.x);
+	words[5] = GetStateHashFloatWord(m_position.y);
+	words[6] = GetStateHashFloatWord(m_targetPosition.x);
+	words[7] = GetStateHashFloatWord(m_targetPosition.y);
+	words[8] = GetStateHashFloatWord(m_health);
+	words[9] = (uint)m_currentState;
+	words[10] = GetStateHashFloatWord(m_currentAnimTime);
+	words[11] = (uint)m_currentResourceInventory;
+	words[12] = GetStateHashFloatWord(m_trainingProgress);
+	words[13] = GetStateHashFloatWord(m_buildTime);
+	words[14] = (uint)m_taskQueue.GetCount();
+	words[15] = (frontTask != nullptr) ? (uint)frontTask->m_taskType : 0xffffffffU;
+	words[16] = (m_unitToFollow != nullptr) ? GetStateHashHandleWord(m_unitToFollow->GetHandle()) : 0U;
+	words[17] = (m_unitToAttack != nullptr) ? GetStateHashHandleWord(m_unitToAttack->GetHandle()) : 0U;
+	words[18] = (m_unitToGather != nullptr) ? GetStateHashHandleWord(m_unitToGather->GetHandle()) : 0U;
+	words[19] = (m_unitToBuild != nullptr) ? GetStateHashHandleWord(m_unitToBuild->GetHandle()) : 0U;
+	words[20] = GetStateHashFloatWord(m_pathTarget.x);
+	words[21] = GetStateHashFloatWord(m_pathTarget.y);
+	words[22] = (m_unitPath != nullptr) ? (uint)m_unitPath->size() : 0U;
+	words[23] = (uint)m_currentSupply;
 }
@@ -13,7 +13,10 @@
 #include "Game/RTSTask.hpp"
 #include "Game/GameTypes.hpp"
 #include "Game/PathSolver.hpp"
+#include "Game/ModelRegistry.hpp"
 
+struct GameplayAnimRecord;
+struct GameplayUnitRecord;
 struct IntRange;
 struct Ray3D;
 
@@ -36,9 +39,11 @@ public:
 	explicit Entity(GameHandle handle, Vec2 position, const std::string& xmlName);
 	~Entity();
 
-	void					MakeFromXML(const std::string& fileName);
-	void					SetMeshIDsForResource(XMLElement* xmlElement);
-	void					MakeAnimationsForEntity(XMLElement* xmlElement, const IntVec2& dimensions, const std::string& id);
+	void					MakeFromDefinition(const std::string& fileName);
+	uint					ReloadDefinition(const GameplayUnitRecord& previous, const GameplayUnitRecord& unit, bool rebuildAnimations, bool rebuildMeshes);
+	inline const std::string&	GetDefinitionPath() const { return m_definitionPath; }
+	void					SetModelsForResource(const GameplayUnitRecord& unit);
+	void					MakeAnimationsForEntity(const GameplayAnimRecord& anim, const IntVec2& dimensions, const std::string& id);
 
 	void					Update(float deltaTime);
 	void					CheckEntityDeath();
@@ -86,6 +91,8 @@ public:
 	void					ResetTargetPosition();
 	void					MoveTo(Vec2 target);
 	void					PathTo(Vec2 target);
+	void					SolveRequestedPath(Pather* pather);
+	inline bool				HasPathRequest() const { return m_pathRequested; }
 	Vec2					GetPosition() const;
 	float					GetCollisionRadius() const;
 	Vec2&					GetEditablePosition();
@@ -104,7 +111,7 @@ public:
 
 	//Resource Actions
 	void					SetAsResource(bool resource);
-	const std::string&		GetMeshIDForState(ResourceMeshT meshType) const;
+	ModelHandle				GetModelHandleForState(ResourceMeshT meshType) const;
 
 	//Building Actions
 	void					SetUnitToBuild(Entity* unitToBuild);
@@ -136,9 +143,15 @@ public:
 	bool					RaycastHit(float *out, const Ray3D& ray) const;
 
 	//Task Handling
-	void					EnqueueTask(RTSTask* task);
-	void					ProcessTasks(); // process and free up memory 
-	void					ClearTasks();   // just free up memory 
+	bool					EnqueueTask(const RTSTask& task);
+	bool					IssueTask(const RTSTask& task);
+	inline bool				IsTaskQueueFull() const { return m_taskQueue.IsFull(); }
+	void					ProcessTasks();
+	void					ClearTasks();
+	bool					IsIdle() const;
+
+	//State hashing
+	void					PackStateHashWords(uint* words) const;
 
 public:
 	//Animation Data
@@ -150,6 +163,7 @@ public:
 private:
 
 	EntityTypeT		m_type = PEON;
+	std::string		m_definitionPath;		//The unit XML it was made from, what a hot reload patches it by
 	TextureView*	m_walkTexture = nullptr;
 	TextureView*	m_attackTexture = nullptr;
 
@@ -184,7 +198,7 @@ private:
 
 	//Resource Information
 	bool			m_isResource = false;
-	std::map<ResourceMeshT, std::string>	m_meshIDMap;
+	ModelHandle		m_modelHandles[NUM_RESOURCE_MESHES] = { INVALID_MODEL_HANDLE, INVALID_MODEL_HANDLE, INVALID_MODEL_HANDLE, INVALID_MODEL_HANDLE };
 	bool			m_dropOffResources = false;
 
 	//Build Information
@@ -203,11 +217,12 @@ private:
 	float			m_radius = 0.5f;
 	float			m_proximitySquared = 2.3f;
 	float			m_buildingProximity = 15.f;
+	float			m_idleDistanceSquared = 0.01f;
 	Vec3			m_orientation = Vec3::BACK; //Am I standing? Am I lying down?
 
 	Vec3			m_directionFacing = Vec3::UP;
 
-	std::vector<RTSTask*>			m_taskQueue;
+	RTSTaskQueue	m_taskQueue;
 
 	//Unit pointers for tasks
 	Entity*			m_unitToFollow = nullptr;
@@ -221,6 +236,8 @@ private:
 	//Pathing
 	Path*			m_unitPath = nullptr;
 	PathSolver		m_pathSolver;
+	bool			m_pathRequested = false;
+	Vec2			m_pathRequestTarget = Vec2::NEGATIVE_ONE;
 
 	Vec2			m_pathTarget = Vec2::NEGATIVE_ONE;
 };
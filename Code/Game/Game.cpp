@@ -33,12 +33,21 @@
 #include "Engine/Renderer/TextureView.hpp"
 //Game Systems
 #include "Game/App.hpp"
+#include "Game/AssetLoader.hpp"
+#include "Game/AssetResidency.hpp"
+#include "Game/AudioVoiceManager.hpp"
 #include "Game/GameInput.hpp"
 #include "Game/Map.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderResources.hpp"
 #include "Game/RTSCamera.hpp"
 #include "Game/RTSCommand.hpp"
+#include "Game/TextureCooker.hpp"
 #include "Game/UIWidget.hpp"
 #include "Game/Entity.hpp"
+//Others
+#include <cstring>
+#include <direct.h>
 
 //------------------------------------------------------------------------------------------------------------------------------
 float g_shakeAmount = 0.0f;
@@ -217,6 +226,33 @@ STATIC bool Game::QuitGame(EventArgs& args)
 	return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::PlayReplay(EventArgs& args)
+{
+	std::string filePath = args.GetValue("file", s_gameReference->m_replayPath);
+	//Ticks simulated each frame, 0 runs the whole log in one go
+	int ticksPerFrame = args.GetValue("speed", 0);
+
+	if (s_gameReference->m_gameState == STATE_INIT || s_gameReference->m_gameState == STATE_EDIT)
+	{
+		g_devConsole->PrintString(Rgba::RED, "Replays can only be played from the menu or an active match");
+		return false;
+	}
+
+	//The recording may be the file we are about to read so get everything it has onto disk first
+	s_gameReference->m_replayRecorder.StopRecording();
+
+	if (!s_gameReference->m_replayPlayer.Load(filePath))
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("Could not load replay %s", filePath.c_str()));
+		return false;
+	}
+
+	s_gameReference->StartReplay(ticksPerFrame);
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Playing replay %s", filePath.c_str()));
+	return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 STATIC Game* Game::s_gameReference = nullptr;
 
@@ -262,12 +298,8 @@ Game::Game()
 //------------------------------------------------------------------------------------------------------------------------------
 Game::~Game()
 {	
-	for (std::thread& threadHandle : m_threads)
-	{
-		threadHandle.join();
-	}
-
-	m_threads.clear();
+	//Don't let in flight load jobs outlive the game they report back to
+	g_jobSystem->WaitForCounter(&m_loadJobs);
 
 	m_isGameAlive = false;
 	Shutdown();
@@ -304,6 +336,17 @@ void Game::StartUp()
 	g_eventSystem->SubscribeEventCallBackFn("ResumeGame", ResumeGame);
 	g_eventSystem->SubscribeEventCallBackFn("ReturnToMenu", ReturnToMenu);
 	g_eventSystem->SubscribeEventCallBackFn("QuitGame", QuitGame);
+	g_eventSystem->SubscribeEventCallBackFn("PlayReplay", PlayReplay);
+	g_eventSystem->SubscribeEventCallBackFn("HashTrace", StateHashTrace::Command_HashTrace);
+	g_eventSystem->SubscribeEventCallBackFn("HashBisect", StateHashTrace::Command_HashBisect);
+	g_eventSystem->SubscribeEventCallBackFn("RenderBudget", Map::Command_RenderBudget);
+	g_eventSystem->SubscribeEventCallBackFn("ReloadGameplayData", GameplayHotReload::Command_ReloadGameplayData);
+
+	//Nobody edits data during a boot benchmark
+	if (!g_startupProfiler->IsBenchmarking())
+	{
+		m_gameplayHotReload.StartWatching();
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -368,11 +411,13 @@ void Game::PerformInitActions()
 	PROFILE_LOG_SCOPE("Resource Loading");
 
 	GetandSetShaders();
+
+	//Runs until the last job's result is on the GPU, closed in Update
+	m_asyncLoadPhase = g_startupProfiler->BeginPhase("AsyncLoading");
+	StartLoadingAssets();
 	LoadGameTextures();
-	LoadGameMaterials();
 	CreateInitialMeshes();
 	CreateInitialLight();
-	LoadInitMesh();
 	LoadAudioResources();
 
 	//This will happen in your update now
@@ -702,6 +747,13 @@ void Game::DebugEnabled()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::Shutdown()
 {
+	m_replayRecorder.StopRecording();
+
+	if (m_stateHashTrace.IsTracing())
+	{
+		m_stateHashTrace.Stop();
+	}
+
 	delete m_menuParent;
 	m_menuParent = nullptr;
 
@@ -747,17 +799,14 @@ void Game::Shutdown()
 	delete m_explosionPingPong;
 	m_explosionPingPong = nullptr;
 
-	delete m_initMesh->m_mesh;
-	m_initMesh->m_mesh = nullptr;
+	delete m_unitAtlas;
+	m_unitAtlas = nullptr;
 
-	delete m_initMesh;
-	m_initMesh = nullptr;
+	delete m_unitAtlasWork;
+	m_unitAtlasWork = nullptr;
 
-	delete m_hutMesh->m_mesh;
-	m_hutMesh->m_mesh = nullptr;
-
-	delete m_hutMesh;
-	m_hutMesh = nullptr;
+	delete m_assetLoader;
+	m_assetLoader = nullptr;
 
 }
 
@@ -1117,9 +1166,13 @@ void Game::RenderEditState() const
 	g_renderContext->SetModelMatrix(Matrix44::IDENTITY);
 	m_map->Render();
 
-	g_renderContext->SetModelMatrix(m_townCenterTransform);
-	g_renderContext->BindMaterial(m_initMesh->m_material);
-	g_renderContext->DrawMesh(m_initMesh->m_mesh);
+	Model* townCenter = g_modelRegistry->GetModel(m_townCenterModel);
+	if (townCenter != nullptr)
+	{
+		g_renderContext->SetModelMatrix(m_townCenterTransform);
+		g_renderContext->BindMaterial(townCenter->m_material);
+		g_renderContext->DrawMesh(townCenter->m_mesh);
+	}
 
 	g_renderContext->EndCamera();
 
@@ -1229,7 +1282,7 @@ void Game::RenderInitState() const
 	std::vector<Vertex_PCU> textVerts;
 	AABB2 titleBox = AABB2(Vec2(-100.0f, -100.f), Vec2(100.f, 100.f));
 
-	std::string textString = "Initializing Game.";
+	std::string textString = Stringf("Initializing Game %d%%.", (int)(GetLoadProgress() * 100.f));
 
 	float time = (float)GetCurrentTimeSeconds() * 0.1f;
 	float check = CosDegrees(time);
@@ -1438,12 +1491,27 @@ void Game::Update( float deltaTime )
 	m_animTime += deltaTime;
 
 	FinishReadyTextures();
-	FinishReadyModels();
+	if (m_assetLoader != nullptr)
+	{
+		m_assetLoader->Update(m_assetLoadBudgetSeconds);
+	}
+	g_modelRegistry->Update(m_assetLoadBudgetSeconds);
+	g_assetResidency->Update();
+	m_gameplayHotReload.Update(deltaTime);
 	
-	if (IsFinishedImageLoading() && IsFinishedModelLoading() && !m_threadedLoadComplete)
+	bool isManifestLoaded = m_assetLoader == nullptr || m_assetLoader->IsFinished();
+	if (IsFinishedImageLoading() && isManifestLoaded && !m_threadedLoadComplete)
 	{
 		m_lastState = m_gameState;
 		m_gameState = STATE_MENU;
+		g_startupProfiler->EndPhase(m_asyncLoadPhase);
+
+		if (m_assetLoader != nullptr)
+		{
+			g_devConsole->PrintString(m_assetLoader->GetNumFailed() > 0U ? Rgba::RED : Rgba::GREEN, Stringf("Loaded %u assets, %u failed", m_assetLoader->GetNumAssets(), m_assetLoader->GetNumFailed()));
+		}
+		LoadGameMaterials();
+		LoadInitMesh();
 
 		m_textureTest = g_renderContext->CreateOrGetTextureViewFromFile(m_testImagePath);
 		m_boxTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_boxTexturePath);
@@ -1456,6 +1524,7 @@ void Game::Update( float deltaTime )
 		m_warriorAttackTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_warriorAttackSheetPath);
 		m_goblinAttackTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_goblinAttackSheetPath);
 		m_goblinTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_goblinSheetPath);
+		FinishUnitAtlas();
 
 		//m_peonSheet = new SpriteSheet(m_peonTexture, m_peonSheetDim);
 		//m_warriorSheet = new SpriteSheet(m_warriorTexture, m_warriorSheetDim);
@@ -1467,6 +1536,14 @@ void Game::Update( float deltaTime )
 		CreatePauseUIWidgets();
 
 		m_threadedLoadComplete = true;
+		g_startupProfiler->MarkMenuReady();
+
+		//A benchmark boot goes straight on to the map, there is nobody to press play
+		if (g_startupProfiler->IsBenchmarking())
+		{
+			EventArgs args;
+			GoToGame(args);
+		}
 	}
 
 
@@ -1503,12 +1580,23 @@ void Game::Update( float deltaTime )
 	//Update the moving lights
 	UpdateLightPositions();
 
-	ProcessCommands();
-
-	if (m_gameState == STATE_PLAY)
+	if (m_isReplaying)
 	{
-		m_map->Update(deltaTime);
+		UpdateReplay();
 	}
+	else
+	{
+		ProcessCommands();
+
+		if (m_gameState == STATE_PLAY)
+		{
+			m_map->Update(deltaTime);
+			m_replayRecorder.EndTick(deltaTime, UpdateStateHash());
+		}
+	}
+
+	//Everything the units fired this frame goes out together, nearest the focal point first
+	g_audioVoices->Update(deltaTime, m_RTSCam->m_focalPoint);
 
 	//If we can load the map, let's load it
 	if(m_beginMapLoad)
@@ -1522,6 +1610,8 @@ void Game::Update( float deltaTime )
 			if (result)
 			{
 				m_map->CreateAIController();
+				StartReplayRecording();
+				g_startupProfiler->MarkMapReady();
 			}
 		}
 
@@ -1600,6 +1690,10 @@ bool Game::HandleMouseLBUp()
 //------------------------------------------------------------------------------------------------------------------------------
 bool Game::HandleMouseRBDown()
 {
+	//Orders can't be given to a match that is being replayed
+	if(m_isReplaying)
+		return true;
+
 	m_gameInput->HandleMouseRBDown();
 	return true;
 }
@@ -1619,43 +1713,204 @@ bool Game::HandleMouseScroll(float wheelDelta)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::EnqueueCommand(RTSCommand *command)
+void Game::EnqueueCommand(const RTSCommand& command)
 {
-	for (int index = 0; index < m_commandQueue.size(); index++)
+	if (!m_commandQueue.Enqueue(command))
 	{
-		if (m_commandQueue[index] == nullptr)
-		{
-			m_commandQueue[index] = command;
-			return;
-		}
+		ERROR_RECOVERABLE("Command queue is full, dropping command");
 	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::EnqueueGroupMove(const std::vector<GameHandle>& units, const Vec2& position)
+{
+	if(units.empty())
+		return;
 
-	m_commandQueue.push_back(command);
+	if (!m_commandQueue.EnqueueGroupMove(units.data(), (uint)units.size(), position))
+	{
+		ERROR_RECOVERABLE("Command queue is full, dropping group move");
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::ProcessCommands()
 {	
-	std::vector<RTSCommand*>::iterator itr;
-	itr = m_commandQueue.begin();
-	
-	int numCommands = (int)m_commandQueue.size();
+	m_commandQueue.ProcessCommands();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::ClearCommands()
+{
+	m_commandQueue.ClearCommands();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::EnqueuePlayerCommand(const RTSCommand& command)
+{
+	if(m_isReplaying)
+		return;
+
+	RTSCommand playerCommand = command;
+	playerCommand.m_position = ReplayRecorder::QuantizePosition(command.m_position);
+
+	m_replayRecorder.RecordCommand(m_simulationTick, playerCommand);
+	EnqueueCommand(playerCommand);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::EnqueuePlayerGroupMove(const std::vector<GameHandle>& units, const Vec2& position)
+{
+	if(m_isReplaying || units.empty())
+		return;
+
+	RTSCommand groupCommand;
+	groupCommand.m_commandType = GROUP_MOVE_ENTITY;
+	groupCommand.m_position = ReplayRecorder::QuantizePosition(position);
+	groupCommand.m_groupCount = (uint)units.size();
+
+	m_replayRecorder.RecordCommand(m_simulationTick, groupCommand, units.data());
+	EnqueueGroupMove(units, groupCommand.m_position);
+}
 
-	for (int index = 0; index < numCommands; index++)
+//------------------------------------------------------------------------------------------------------------------------------
+// Returns false when the order was refused. A queued order can't fit once the entity's task ring is full, it is refused
+// before it is recorded so the replay never holds an order that live play dropped
+//------------------------------------------------------------------------------------------------------------------------------
+bool Game::IssuePlayerTask(Entity* entity, const RTSTask& task)
+{
+	if(m_isReplaying || entity == nullptr)
+		return false;
+
+	if(task.m_isQueued && entity->IsTaskQueueFull())
+		return false;
+
+	RTSTask playerTask = task;
+	playerTask.m_position = ReplayRecorder::QuantizePosition(task.m_position);
+
+	m_replayRecorder.RecordTask(m_simulationTick, *entity, playerTask);
+	return entity->IssueTask(playerTask);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::StartReplayRecording()
+{
+	m_simulationTick = 0U;
+	if(!g_gameConfigBlackboard.GetValue("recordReplays", true))
+		return;
+
+	_mkdir(m_replayFolder.c_str());
+
+	ReplayHeader header;
+	header.m_disableAI = m_disableAI;
+	header.m_currentTeam = m_currentTeam;
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		header.m_teamResource[teamIndex] = m_teamResource[teamIndex];
+		header.m_teamCurrentSupply[teamIndex] = m_teamCurrentSupply[teamIndex];
+		header.m_teamMaxSupply[teamIndex] = m_teamMaxSupply[teamIndex];
+	}
+
+	m_replayRecorder.StartRecording(m_replayPath, header);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Rebuilds the match from scratch the same way GoToGame does and hands the map over to the replay player
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::StartReplay(int ticksPerFrame)
+{
+	ClearCommands();
+	m_gameInput->ClearSelection();
+
+	delete m_map;
+	m_map = new Map();
+	m_map->Load("InitMap");
+	m_map->CreateAIController();
+
+	const ReplayHeader& header = m_replayPlayer.GetHeader();
+	m_disableAI = header.m_disableAI;
+	m_currentTeam = header.m_currentTeam;
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		m_teamResource[teamIndex] = header.m_teamResource[teamIndex];
+		m_teamCurrentSupply[teamIndex] = header.m_teamCurrentSupply[teamIndex];
+		m_teamMaxSupply[teamIndex] = header.m_teamMaxSupply[teamIndex];
+	}
+
+	m_isReplaying = true;
+	m_replayTicksPerFrame = ticksPerFrame;
+	m_replayStartTime = GetCurrentTimeSeconds();
+	m_replaySimulatedTime = 0.f;
+	m_replayDesynced = false;
+	m_simulationTick = 0U;
+
+	m_isPaused = false;
+	m_returnToMenu = false;
+	m_beginEditLoad = false;
+	m_beginMapLoad = true;
+	m_lastState = m_gameState;
+	m_gameState = STATE_PLAY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::UpdateReplay()
+{
+	int ticksThisFrame = 0;
+	while (m_replayTicksPerFrame <= 0 || ticksThisFrame < m_replayTicksPerFrame)
 	{
-		if (m_commandQueue[index] != nullptr)
+		float tickDeltaTime = 0.f;
+		uint recordedHash = 0U;
+		if (!m_replayPlayer.ApplyNextTick(this, &tickDeltaTime, &recordedHash))
 		{
-			m_commandQueue[index]->Execute();
-			delete m_commandQueue[index];
-			m_commandQueue[index] = nullptr;
+			FinishReplay();
+			return;
 		}
+
+		ProcessCommands();
+		m_map->Update(tickDeltaTime);
+
+		uint tick = m_simulationTick;
+		uint stateHash = UpdateStateHash();
+		if (!m_replayDesynced && stateHash != recordedHash)
+		{
+			//Only the first one matters, everything after it follows on. HashTrace and HashBisect narrow it down to an entity
+			g_devConsole->PrintString(Rgba::RED, Stringf("Replay desynced at tick %u: recorded %08x, replayed %08x", tick, recordedHash, stateHash));
+			m_replayDesynced = true;
+		}
+
+		m_replaySimulatedTime += tickDeltaTime;
+		++ticksThisFrame;
 	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::ClearCommands()
+void Game::FinishReplay()
+{
+	m_isReplaying = false;
+
+	double wallTime = GetCurrentTimeSeconds() - m_replayStartTime;
+	float speedUp = (wallTime > 0.0) ? m_replaySimulatedTime / (float)wallTime : 0.f;
+
+	Rgba resultColor = m_replayDesynced ? Rgba::RED : Rgba::GREEN;
+	g_devConsole->PrintString(resultColor, Stringf("Replay finished: %u ticks, %.2fs of play in %.3fs (%.1fx)",
+		m_replayPlayer.GetTickCount(), m_replaySimulatedTime, wallTime, speedUp));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only the replay and the hash trace read the hash. Outside of those there is nothing to compare against so the tick is
+// counted and the hash skipped; recording can be turned off with recordReplays in the game config
+//------------------------------------------------------------------------------------------------------------------------------
+uint Game::UpdateStateHash()
 {
-	m_commandQueue.clear();
+	bool isTracing = m_stateHashTrace.IsTracing();
+	if (isTracing || m_isReplaying || m_replayRecorder.IsRecording())
+	{
+		ComputeStateHashFrame(*this, *m_map, m_simulationTick, isTracing, &m_stateHashFrame);
+		m_stateHashTrace.AddFrame(m_stateHashFrame);
+	}
+
+	++m_simulationTick;
+	return m_stateHashFrame.m_hash;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -1687,6 +1942,8 @@ void Game::AddResourcesForTeam(int teamNum, int resourceAmount)
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreateMenuUIWidgets()
 {
+	StartupPhaseScope phase("CreateMenuUIWidgets");
+
 	// Menu Widgets
 	m_menuParent = new UIWidget(this, nullptr);
 	m_menuParent->SetColor(Rgba(0.f, 0.f, 0.f, 0.f));
@@ -1753,6 +2010,8 @@ void Game::CreateMenuUIWidgets()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreateEditUIWidgets()
 {
+	StartupPhaseScope phase("CreateEditUIWidgets");
+
 	// Menu Widgets
 	m_editParent = new UIWidget(this, nullptr);
 	m_editParent->SetColor(Rgba(0.f, 0.f, 0.f, 0.f));
@@ -1814,6 +2073,8 @@ void Game::CreateEditUIWidgets()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreatePauseUIWidgets()
 {
+	StartupPhaseScope phase("CreatePauseUIWidgets");
+
 	// Menu Widgets
 	m_pauseParent = new UIWidget(this, nullptr);
 	m_pauseParent->SetColor(Rgba(0.f, 0.f, 0.f, 0.f));
@@ -1895,6 +2156,8 @@ void Game::CreatePauseUIWidgets()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::LoadGameMaterials()
 {
+	StartupPhaseScope phase("LoadGameMaterials");
+
 	m_testMaterial = g_renderContext->CreateOrGetMaterialFromFile(m_materialPath);
 
 	m_toneMap = g_renderContext->CreateOrGetMaterialFromFile(m_tonemapPath);
@@ -1965,27 +2228,21 @@ void Game::CreateInitialLight()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::LoadInitMesh()
 {
+	StartupPhaseScope phase("LoadInitMesh");
+
 	m_lastState = STATE_LOAD;
-	if (m_initMesh == nullptr)
-	{		
-		StartLoadingModel(m_objectPath);
-		StartLoadingModel(m_hutPath);
-
-		int coreCount = std::thread::hardware_concurrency();
-		int halfCores = coreCount / 2;
-		for (int i = 0; i < halfCores; ++i)
-		{
-			m_threads.emplace_back(&Game::ModelLoadThread, this, m_gameState);
-		}
 
-		//m_initMesh = new Model(g_renderContext, m_objectPath);
-	}
+	//Ready at once when the asset manifest already loaded the mesh, drawn from whenever it is
+	m_townCenterModel = g_modelRegistry->RequestModel(m_objectPath, m_objectMatPath);
+
 	m_lastState = m_gameState;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::LoadAudioResources()
 {
+	StartupPhaseScope phase("LoadAudioResources");
+
 	m_attackSoundID = g_audio->CreateOrGetSound3D(m_attackSoundPath);
 	m_deathSoundID = g_audio->CreateOrGetSound3D(m_deathSoundPath);
 
@@ -2014,6 +2271,8 @@ void Game::EndFrame()
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreateInitialMeshes()
 {
+	StartupPhaseScope phase("CreateInitialMeshes");
+
 	//Meshes for A4
 	CPUMesh mesh;
 	CPUMeshAddQuad(&mesh, AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f)));
@@ -2064,24 +2323,22 @@ void Game::StartLoadingTexture(std::string fileName)
 	work->imageName = fileName;
 
 	++m_imageLoading;
-	m_loadQueue.enqueue(work);
+	++m_imageLoadsQueued;
+	work->queuedTime = GetCurrentTimeSeconds();
+	g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, work]() { ImageLoadJob(work); }, &m_loadJobs);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::ImageLoadThread(GameState state)
+void Game::ImageLoadJob(ImageLoadWork* work)
 {
-	ImageLoadWork* work;
+	double startTime = GetCurrentTimeSeconds();
+	StartupProfiler::TakeBytesRead();
 
-	while (state == STATE_INIT) 
-	{
-		while (m_loadQueue.dequeue(&work)) 
-		{
-			//We use our image default constructor to load
-			work->image = new Image(work->imageName.c_str());
-			m_finishedQueue.enqueue(work);
-		}
-		Sleep(0);
-	}
+	//Cooked pixels when the source has been seen before, only decodes when it changed
+	work->image = CookedTexture::CreateImageFromSource(work->imageName);
+
+	g_startupProfiler->RecordAssetPrepare(work->imageName, "texture", work->queuedTime, startTime, GetCurrentTimeSeconds(), StartupProfiler::TakeBytesRead());
+	m_finishedQueue.enqueue(work);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -2090,20 +2347,7 @@ void Game::FinishReadyTextures()
 	ImageLoadWork* work;
 	if (m_finishedQueue.dequeue(&work)) 
 	{
-		std::string name = work->imageName.c_str();
-		PROFILE_LOG_SCOPE(name.c_str());
-
-		Texture2D *texture = new Texture2D(g_renderContext);
-		TextureView* textureView = nullptr;
-		texture->LoadTextureFromImage(*work->image);
-		textureView = texture->CreateTextureView2D();
-
-		g_renderContext->RegisterTextureView(work->imageName, textureView);
-		
-		delete work->image;
-		work->image = nullptr;
-		delete work;
-		delete texture;
+		RegisterLoadedTexture(work);
 
 		--m_imageLoading;
 		
@@ -2112,93 +2356,202 @@ void Game::FinishReadyTextures()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::StartLoadingModel(std::string fileName)
+void Game::RegisterLoadedTexture(ImageLoadWork* work)
 {
-	ModelLoadWork* work = new ModelLoadWork(fileName);
-	work->modelName = fileName;
+	std::string name = work->imageName.c_str();
+	PROFILE_LOG_SCOPE(name.c_str());
 
-	++m_modelLoading;
-	m_modelLoadQueue.enqueue(work);
+	double startTime = GetCurrentTimeSeconds();
+	g_renderResources->CreateTexture(work->imageName, *work->image);
+	g_startupProfiler->RecordAssetCreate(work->imageName, "texture", startTime, GetCurrentTimeSeconds());
+	
+	delete work->image;
+	work->image = nullptr;
+	delete work;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::ModelLoadThread(GameState state)
+// Once the pages are built each sheet is registered under its own path as a 1x1 stand-in, so entities still get a distinct
+// texture view to build their sprite sheets from and the atlas to look up, but the sheet's texels are only uploaded as part
+// of its page. If the layout can not be planned the sheets just load the old way and draw unbatched
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::StartBuildingUnitAtlas(const std::vector<std::string>& sheetPaths)
 {
-	ModelLoadWork* work;
+	m_unitAtlas = new SpriteAtlas();
+	m_unitAtlasWork = new SpriteAtlasLoadWork();
+	SpriteAtlasLoadWork* work = m_unitAtlasWork;
+
+	bool isPlanned = true;
+	for (size_t sheetIndex = 0; sheetIndex < sheetPaths.size(); sheetIndex++)
+	{
+		isPlanned = isPlanned && work->packer.AddImageFromFile(sheetPaths[sheetIndex]);
+	}
+	isPlanned = isPlanned && work->packer.Pack(m_unitAtlasMaxPageSize, m_unitAtlasPadding);
 
-	while (state == STATE_INIT)
+	if (!isPlanned)
 	{
-		while (m_modelLoadQueue.dequeue(&work))
+		ERROR_RECOVERABLE("Could not plan the unit sprite atlas, loading the sheets separately");
+		for (size_t sheetIndex = 0; sheetIndex < sheetPaths.size(); sheetIndex++)
 		{
-			//Load the file and make the CPUMesh here
-			std::string filePath = MODEL_PATH + work->modelName;
-			ObjectLoader object;
-			object.m_renderContext = g_renderContext;
-			object.LoadFromXML(filePath.c_str());
-			work->mesh = object.m_cpuMesh;
-
-			//work->model = new Model();
-			//work->model->m_material = new Material(g_renderContext, )
-			m_modelFinishedQueue.enqueue(work);
+			StartLoadingTexture(sheetPaths[sheetIndex]);
 		}
-		Sleep(0);
+
+		delete m_unitAtlasWork;
+		m_unitAtlasWork = nullptr;
+		return;
 	}
+
+	const std::vector<SpriteAtlasEntry>& entries = work->packer.GetEntries();
+	int numPages = work->packer.GetNumPages();
+	work->sources.resize(entries.size(), nullptr);
+	m_imageLoading += (int)entries.size() + numPages;
+	m_imageLoadsQueued += (int)entries.size() + numPages;
+
+	double queuedTime = GetCurrentTimeSeconds();
+	for (size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		g_jobSystem->Run(JOB_CATEGORY_LOADING, [work, entryIndex, queuedTime]()
+		{
+			double startTime = GetCurrentTimeSeconds();
+			StartupProfiler::TakeBytesRead();
+
+			const std::string& sourcePath = work->packer.GetEntries()[entryIndex].m_sourcePath;
+			work->sources[entryIndex] = CookedTexture::CreateImageFromSource(sourcePath);
+
+			g_startupProfiler->RecordAssetPrepare(sourcePath, "atlas", queuedTime, startTime, GetCurrentTimeSeconds(), StartupProfiler::TakeBytesRead());
+		}, &work->sourcesLoaded);
+	}
+
+	//Parked behind the sources, so their wait includes the decodes
+	for (int page = 0; page < numPages; page++)
+	{
+		g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, work, page, queuedTime]() { BuildUnitAtlasPage(work, page, queuedTime); }, &work->pagesBuilt, &work->sourcesLoaded);
+	}
+
+	//Sources are only freed after every page is done with them
+	g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, work]()
+	{
+		for (size_t entryIndex = 0; entryIndex < work->sources.size(); entryIndex++)
+		{
+			delete work->sources[entryIndex];
+			work->sources[entryIndex] = nullptr;
+
+			ImageLoadWork* sourceWork = new ImageLoadWork(work->packer.GetEntries()[entryIndex].m_sourcePath);
+			sourceWork->image = new Image(IntVec2(1, 1), Rgba(0.f, 0.f, 0.f, 0.f));
+			m_finishedQueue.enqueue(sourceWork);
+		}
+	}, &m_loadJobs, &work->pagesBuilt);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Game::FinishReadyModels()
+// Both images are RGBA8 with rows packed tight, so each source row lands in the page with one copy
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::BuildUnitAtlasPage(SpriteAtlasLoadWork* work, int page, double queuedTime)
 {
-	ModelLoadWork* work;
-	while (m_modelFinishedQueue.dequeue(&work))
+	double startTime = GetCurrentTimeSeconds();
+	const IntVec2& pageSize = work->packer.GetPageSize(page);
+	Image* pageImage = new Image(pageSize, Rgba(0.f, 0.f, 0.f, 0.f));
+	unsigned char* pageTexels = (unsigned char*)pageImage->GetImageBuffer();
+	size_t pageRowBytes = (size_t)pageSize.x * 4U;
+
+	const std::vector<SpriteAtlasEntry>& entries = work->packer.GetEntries();
+	for (size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
 	{
-		//Create the Model with GPUMesh here
-		work->model = new Model();
-		work->model->m_context = g_renderContext;
-		work->model->m_mesh = new GPUMesh(g_renderContext);
-		work->model->m_mesh->CreateFromCPUMesh<Vertex_Lit>(work->mesh);
-		work->model->m_mesh->m_defaultMaterial = work->modelName;
+		const SpriteAtlasEntry& entry = entries[entryIndex];
+		if (entry.m_page != page)
+			continue;
 
-		std::string materialPath = "";
-		//Setup materials
-		std::vector<std::string> splits = SplitStringOnDelimiter(work->modelName, '.');
-		if (splits[splits.size() - 1] == "obj" || splits[splits.size() - 1] == "mesh")
-		{
-			materialPath = MODEL_PATH + splits[0] + ".mat";
-		}
+		const unsigned char* sourceTexels = (const unsigned char*)work->sources[entryIndex]->GetImageBuffer();
+		size_t sourceRowBytes = (size_t)entry.m_size.x * 4U;
+		unsigned char* destination = pageTexels + (size_t)entry.m_offset.y * pageRowBytes + (size_t)entry.m_offset.x * 4U;
 
-		work->model->m_material = g_renderContext->CreateOrGetMaterialFromFile(materialPath);
-		--m_modelLoading;
-		
-		if (splits[splits.size() - 2] == "building/towncenter")
+		for (int texelY = 0; texelY < entry.m_size.y; texelY++)
 		{
-			m_initMesh = work->model;
-		}
-		else
-		{
-			m_hutMesh = work->model;
+			memcpy(destination, sourceTexels, sourceRowBytes);
+			sourceTexels += sourceRowBytes;
+			destination += pageRowBytes;
 		}
+	}
+
+	ImageLoadWork* pageWork = new ImageLoadWork(SpriteAtlas::GetPageName(m_unitAtlasName, page));
+	pageWork->image = pageImage;
 
-		delete work;
+	g_startupProfiler->RecordAssetPrepare(pageWork->imageName, "atlas", queuedTime, startTime, GetCurrentTimeSeconds(), 0U);
+	m_finishedQueue.enqueue(pageWork);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every page and sheet is registered by now, so the regions can point at the texture views
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::FinishUnitAtlas()
+{
+	if (m_unitAtlasWork == nullptr)
+		return;
+
+	StartupPhaseScope phase("FinishUnitAtlas");
 
-		ASSERT_RECOVERABLE(m_modelLoading >= 0, "m_modelLoading is less than 0");
+	const std::vector<SpriteAtlasEntry>& entries = m_unitAtlasWork->packer.GetEntries();
+	for (size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		const SpriteAtlasEntry& entry = entries[entryIndex];
+
+		SpriteAtlasRegion region = SpriteAtlas::MakeRegion(entry, m_unitAtlasWork->packer.GetPageSize(entry.m_page));
+		region.m_source = g_renderContext->CreateOrGetTextureViewFromFile(entry.m_sourcePath);
+		region.m_page = g_renderContext->CreateOrGetTextureViewFromFile(SpriteAtlas::GetPageName(m_unitAtlasName, entry.m_page));
+		m_unitAtlas->AddRegion(region);
 	}
+
+	delete m_unitAtlasWork;
+	m_unitAtlasWork = nullptr;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool Game::IsFinishedImageLoading() const
+// Everything the manifest lists loads through the asset loader. The unit atlas still has its own jobs since its pages are
+// built from several sources
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::StartLoadingAssets()
 {
-	return (m_imageLoading == 0);
+	m_assetLoader = new AssetLoader();
+
+	//A manifest that failed part way is not loaded at all, the game carries on without its assets
+	std::string error;
+	if (!m_assetLoader->LoadManifest(m_assetManifestPath, error))
+	{
+		ERROR_RECOVERABLE(error.c_str());
+		delete m_assetLoader;
+		m_assetLoader = nullptr;
+		return;
+	}
+
+	m_assetLoader->Start();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Manifest assets count a step for their CPU and GPU sides, atlas images a step each once uploaded
+//------------------------------------------------------------------------------------------------------------------------------
+float Game::GetLoadProgress() const
+{
+	uint numAssets = m_assetLoader != nullptr ? m_assetLoader->GetNumAssets() : 0U;
+	float numSteps = (float)(numAssets * 2U + (uint)m_imageLoadsQueued);
+	if (numSteps == 0.f)
+		return 1.f;
+
+	float assetProgress = m_assetLoader != nullptr ? m_assetLoader->GetProgress() : 1.f;
+	float numDone = assetProgress * (float)(numAssets * 2U) + (float)(m_imageLoadsQueued - m_imageLoading);
+	return numDone / numSteps;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool Game::IsFinishedModelLoading() const
+bool Game::IsFinishedImageLoading() const
 {
-	return (m_modelLoading == 0);
+	return (m_imageLoading == 0);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::LoadGameTextures()
 {
+	StartupPhaseScope phase("LoadGameTextures");
+
 	/*
 	//Get the test texture
 	m_textureTest = g_renderContext->CreateOrGetTextureViewFromFile(m_testImagePath);
@@ -2220,33 +2573,22 @@ void Game::LoadGameTextures()
 
 	//CreateIsoSpriteDefenitions();
 
-	StartLoadingTexture(m_testImagePath);
-	StartLoadingTexture(m_boxTexturePath);
-	StartLoadingTexture(m_sphereTexturePath);
-	StartLoadingTexture(m_backgroundPath);
-
-	StartLoadingTexture(m_peonSheetPath);
-	StartLoadingTexture(m_warriorSheetPath);
-	StartLoadingTexture(m_peonAttackSheetPath);
-	StartLoadingTexture(m_warriorAttackSheetPath);
-	StartLoadingTexture(m_goblinSheetPath);
-	StartLoadingTexture(m_goblinAttackSheetPath);
-	
-	StartLoadingTexture("Data/Images/stone_diffuse.png");
-	StartLoadingTexture("Data/Images/stone_normal.png");
-	StartLoadingTexture("Data/Images/stone_spec.png");
-	
-	int coreCount = std::thread::hardware_concurrency();
-	int halfCores = coreCount / 2;
-	for (int i = 0; i < halfCores; ++i) 
-	{
-		m_threads.emplace_back(&Game::ImageLoadThread, this, m_gameState);
-	}
+	//The rest of the textures are in the asset manifest
+	std::vector<std::string> unitSheets;
+	unitSheets.push_back(m_peonSheetPath);
+	unitSheets.push_back(m_warriorSheetPath);
+	unitSheets.push_back(m_peonAttackSheetPath);
+	unitSheets.push_back(m_warriorAttackSheetPath);
+	unitSheets.push_back(m_goblinSheetPath);
+	unitSheets.push_back(m_goblinAttackSheetPath);
+	StartBuildingUnitAtlas(unitSheets);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::GetandSetShaders()
 {
+	StartupPhaseScope phase("GetandSetShaders");
+
 	//Get the Shaders
 	m_normalShader = g_renderContext->CreateOrGetShaderFromFile(m_normalColorShader);
 	m_normalShader->SetDepth(eCompareOp::COMPARE_LEQUAL, true);
@@ -2302,15 +2644,3 @@ ImageLoadWork::~ImageLoadWork()
 {
 
 }
-
-//------------------------------------------------------------------------------------------------------------------------------
-ModelLoadWork::ModelLoadWork(const std::string& fileName)
-{
-	modelName = fileName;
-}
-
-//------------------------------------------------------------------------------------------------------------------------------
-ModelLoadWork::~ModelLoadWork()
-{
-
-}
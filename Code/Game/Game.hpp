@@ -12,11 +12,19 @@
 #include "Engine/Math/IntVec2.hpp"
 //Game Systems
 #include "Game/GameCommon.hpp"
+#include "Game/GameplayHotReload.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/ModelRegistry.hpp"
+#include "Game/RTSCommand.hpp"
+#include "Game/RTSReplay.hpp"
+#include "Game/SpriteAtlas.hpp"
+#include "Game/StartupProfiler.hpp"
+#include "Game/StateHash.hpp"
 //Others
 #include <vector>
-#include <thread>
 
 //------------------------------------------------------------------------------------------------------------------------------
+class AssetLoader;
 class BitmapFont;
 class ColorTargetView;
 class GameInput;
@@ -24,7 +32,6 @@ class GPUMesh;
 class Map;
 class Model;
 class RTSCamera;
-class RTSCommand;
 class Shader;
 class SpriteAnimDefenition;
 class StopWatch;
@@ -37,6 +44,7 @@ class UIRadioGroup;
 class IsoSpriteDefenition;
 class SpriteSheet;
 class CPUMesh;
+class Entity;
 
 struct Camera;
 
@@ -59,17 +67,19 @@ struct ImageLoadWork
 
 	std::string imageName;
 	Image* image = nullptr;
+	double queuedTime = 0.0;
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
-struct ModelLoadWork
+// The unit sheets decode into sources, then one job per page copies them into place. Layout is planned up front from the
+// PNG headers so the number of pages is known before anything is decoded
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteAtlasLoadWork
 {
-	ModelLoadWork(const std::string& fileName);
-	~ModelLoadWork();
-
-	std::string modelName;
-	CPUMesh* mesh = nullptr;
-	Model* model = nullptr;
+	SpriteAtlasPacker		packer;
+	std::vector<Image*>		sources;
+	JobCounter				sourcesLoaded;
+	JobCounter				pagesBuilt;
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -93,6 +103,7 @@ public:
 	static bool				ResumeGame(EventArgs& args);
 	static bool				ReturnToMenu(EventArgs& args);
 	static bool				QuitGame(EventArgs& args);
+	static bool				PlayReplay(EventArgs& args);
 
 	static Game*			s_gameReference;
 
@@ -117,14 +128,17 @@ public:
 	
 	//Async Load Textrues
 	void								StartLoadingTexture(std::string fileName);
-	void								ImageLoadThread(GameState state);
+	void								ImageLoadJob(ImageLoadWork* work);
 	void								FinishReadyTextures();
+	void								RegisterLoadedTexture(ImageLoadWork* work);
 	bool								IsFinishedImageLoading() const;
-	//Async Load Models	
-	void								StartLoadingModel(std::string fileName);
-	void								ModelLoadThread(GameState state);
-	void								FinishReadyModels();
-	bool								IsFinishedModelLoading() const;
+	//Unit sprite atlas
+	void								StartBuildingUnitAtlas(const std::vector<std::string>& sheetPaths);
+	void								BuildUnitAtlasPage(SpriteAtlasLoadWork* work, int page, double queuedTime);
+	void								FinishUnitAtlas();
+	//Manifest assets
+	void								StartLoadingAssets();
+	float								GetLoadProgress() const;
 	
 	void								CreateInitialLight();
 	void								LoadInitMesh();
@@ -177,9 +191,24 @@ public:
 	bool								HandleMouseScroll(float wheelDelta);
 
 	//Commands
-	void								EnqueueCommand(RTSCommand *command);
-	void								ProcessCommands(); // process and free up memory 
-	void								ClearCommands();   // just free up memory 
+	void								EnqueueCommand(const RTSCommand& command);
+	void								EnqueueGroupMove(const std::vector<GameHandle>& units, const Vec2& position);
+	void								ProcessCommands();
+	void								ClearCommands();
+
+	//Player orders, recorded for replays before they are queued
+	void								EnqueuePlayerCommand(const RTSCommand& command);
+	void								EnqueuePlayerGroupMove(const std::vector<GameHandle>& units, const Vec2& position);
+	bool								IssuePlayerTask(Entity* entity, const RTSTask& task);
+
+	//Replays
+	void								StartReplayRecording();
+	void								StartReplay(int ticksPerFrame);
+	void								UpdateReplay();
+	void								FinishReplay();
+
+	//Hash of the simulation after the tick that just ran
+	uint								UpdateStateHash();
 
 	//Entity Data
 	int									GetCurrentTeam() const;
@@ -199,19 +228,30 @@ private:
 	bool								m_showGameControls = false;
 	float								m_cameraSpeed = 0.3f; 
 
-	std::vector<RTSCommand*>			m_commandQueue;
+	RTSCommandQueue						m_commandQueue;
 	int									m_currentTeam = 1;
+
+	ReplayRecorder						m_replayRecorder;
+	ReplayPlayer						m_replayPlayer;
+	int									m_replayTicksPerFrame = 0;
+	double								m_replayStartTime = 0.0;
+	float								m_replaySimulatedTime = 0.f;
+	bool								m_replayDesynced = false;
+
+	uint								m_simulationTick = 0U;
+	StateHashFrame						m_stateHashFrame;
 	
-	//Async Queues for the loading
-	AsyncQueue<ImageLoadWork*>			m_loadQueue;
+	//Loading runs as jobs, finished work comes back to the main thread through these queues
 	AsyncQueue<ImageLoadWork*>			m_finishedQueue;
 	int									m_imageLoading = 0;
+	int									m_imageLoadsQueued = 0;
 
-	AsyncQueue<ModelLoadWork*>			m_modelLoadQueue;
-	AsyncQueue<ModelLoadWork*>			m_modelFinishedQueue;
-	int									m_modelLoading = 0;
+	AssetLoader*						m_assetLoader = nullptr;
+	uint								m_asyncLoadPhase = INVALID_STARTUP_PHASE;
+	std::string							m_assetManifestPath = "Data/Gameplay/asset_manifest.xml";
+	double								m_assetLoadBudgetSeconds = 0.008;
 
-	std::vector<std::thread>			m_threads;
+	JobCounter							m_loadJobs;
 	bool								m_threadedLoadComplete = false;
 
 	//Load anim
@@ -223,10 +263,8 @@ public:
 	//Audio
 	std::string							m_deathSoundPath = "Data/Audio/SFX/pain.wav";
 	SoundID								m_deathSoundID = NULL;
-	SoundPlaybackID						m_deathSoundPlayback = NULL;
 	std::string							m_attackSoundPath = "Data/Audio/SFX/hit00.wav";
 	SoundID								m_attackSoundID = NULL;
-	SoundPlaybackID						m_attackSoundPlayback = NULL;
 
 	ChannelGroupID						m_SFXChannel;
 	ChannelGroupID						m_musicChannel;
@@ -257,8 +295,6 @@ public:
 	std::string							m_backgroundPath = "Data/Images/pixelArt.jpg";
 	std::string							m_objectPath = "building/towncenter.mesh";
 	std::string							m_objectMatPath = "building/towncenter.mat";
-	std::string							m_hutPath = "hut/hut.mesh";
-	std::string							m_hutMatPath = "hut/hut.mat";
 
 	//Cameras
 	Camera*								m_mainCamera = nullptr;
@@ -288,8 +324,7 @@ public:
 	GPUMesh*							m_baseQuad = nullptr;
 	Matrix44							m_baseQuadTransform;
 
-	Model*								m_initMesh = nullptr;
-	Model*								m_hutMesh = nullptr;
+	ModelHandle							m_townCenterModel = INVALID_MODEL_HANDLE;
 	Matrix44							m_townCenterTransform;
 
 	GPUMesh*							m_capsule = nullptr;
@@ -348,6 +383,13 @@ public:
 	TextureView*						m_goblinTexture = nullptr;
 	TextureView*						m_goblinAttackTexture = nullptr;
 
+	//All unit sheets packed into as few pages as fit, sprites draw from these instead of the sheets
+	std::string							m_unitAtlasName = "Data/Images/units.atlas";
+	IntVec2								m_unitAtlasMaxPageSize = IntVec2(4096, 4096);
+	int									m_unitAtlasPadding = 2;
+	SpriteAtlas*						m_unitAtlas = nullptr;
+	SpriteAtlasLoadWork*				m_unitAtlasWork = nullptr;
+
 	float								m_quadSize = 1.f;
 
 	//UI References
@@ -381,4 +423,16 @@ public:
 	bool								m_returnToMenu = false;
 
 	bool								m_disableAI = true;
+
+	//Replay playback drives the map from the log, player input and audio are ignored while it runs
+	bool								m_isReplaying = false;
+	std::string							m_replayFolder = "Data/Replays";
+	std::string							m_replayPath = "Data/Replays/LastMatch.rtsreplay";
+	StateHashTrace						m_stateHashTrace;
+
+	//Per scenario frame limits checked by the RenderBudget command
+	std::string							m_renderBudgetPath = "Data/Gameplay/render_budgets.xml";
+
+	//Saving a unit, building or model list file patches the running match
+	GameplayHotReload					m_gameplayHotReload;
 };
\ No newline at end of file
@@ -29,8 +29,12 @@ class RenderContext;
 class InputSystem;
 class AudioSystem;
 class App;
+class JobSystem;
+class RenderResources;
 
 extern RenderContext* g_renderContext;
 extern InputSystem* g_inputSystem;
 extern AudioSystem* g_audio;
-extern App* g_theApp;
\ No newline at end of file
+extern App* g_theApp;
+extern JobSystem* g_jobSystem;
+extern RenderResources* g_renderResources;
\ No newline at end of file
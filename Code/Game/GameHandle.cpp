@@ -34,6 +34,12 @@ uint GameHandle::GetIndex() const
 	return (m_data & 0x0000ffff);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+uint GameHandle::GetCyclicID() const
+{
+	return (m_data >> 16);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 bool GameHandle::operator!=(GameHandle const &other) const
 {
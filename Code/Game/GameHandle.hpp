@@ -13,6 +13,7 @@ public:
 	~GameHandle();
 
 	uint GetIndex() const;
+	uint GetCyclicID() const;
 
 	bool operator==(GameHandle const &other) const;
 	bool operator!=(GameHandle const &other) const;
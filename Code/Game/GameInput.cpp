@@ -14,6 +14,7 @@
 #include "Game/GameHandle.hpp"
 #include "Game/RTSCommand.hpp"
 #include "Game/Entity.hpp"
+#include "Game/GameLog.hpp"
 #include "Game/RTSTask.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -192,6 +193,22 @@ void GameInput::EndFrame()
 {
 	m_framePan = Vec2::ZERO;
 	m_frameZoomDelta = 0.f;
+
+	//One line for the whole click rather than one per selected unit
+	if (m_numRejectedOrders > 0)
+	{
+		g_gameLog->Log(LOG_WARNING, LOG_CATEGORY_GAMEPLAY, "%d units have %d queued orders already, the new order was not queued", m_numRejectedOrders, MAX_QUEUED_TASKS);
+		m_numRejectedOrders = 0;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameInput::IssuePlayerTask(Entity* entity, const RTSTask& task)
+{
+	if (!m_game->IssuePlayerTask(entity, task))
+	{
+		++m_numRejectedOrders;
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -356,12 +373,22 @@ void GameInput::SelectEntitiesInClientBox(const IntVec2& boxStart, const IntVec2
 	m_game->m_map->SelectEntitiesInFrustum(m_selectionHandles, selectionFrustum);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void GameInput::ClearSelection()
+{
+	m_selectionHandles.clear();
+	m_hoverHandle = GameHandle::INVALID;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 bool GameInput::HandleMouseRBDown()
 {
 	if (Game::s_gameReference->m_gameState != STATE_PLAY && Game::s_gameReference->m_gameState != STATE_EDIT)
 		return false;
 
+	//Every unit sent to open ground shares one group move record
+	m_groupMoveHandles.clear();
+
 	for (int selectIndex = 0; selectIndex < (int)m_selectionHandles.size(); ++selectIndex)
 	{
 		if (m_selectionHandles[selectIndex] != GameHandle::INVALID)
@@ -379,61 +406,34 @@ bool GameInput::HandleMouseRBDown()
 
 			Entity* thisEntity = m_game->m_map->FindEntity(m_selectionHandles[selectIndex]);
 
-			if (m_shiftPressed)
-			{
-				thisEntity->ClearTasks();
-			}
-
 			if (entity)
 			{
-
-				thisEntity->ResetTaskData();
-
 				if (entity->GetTeam() == thisEntity->GetTeam() && !entity->IsBuildingType())
 				{
 					//Follow entity
-					FollowTask *followTask = new FollowTask(m_selectionHandles[selectIndex], entity->GetHandle());
-					thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(followTask));
+					IssuePlayerTask(thisEntity, RTSTask::MakeFollow(entity->GetHandle(), m_shiftPressed));
 				}
 				else if (entity->GetTeam() != thisEntity->GetTeam() && !entity->IsResource())
 				{
 					//Fuck up your enemies						
-					AttackTask *attackTask = new AttackTask(m_selectionHandles[selectIndex], entity->GetHandle());
-					thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(attackTask));
+					IssuePlayerTask(thisEntity, RTSTask::MakeAttack(entity->GetHandle(), m_shiftPressed));
 				}
 				else if (entity->IsResource())
 				{
 					if (thisEntity->GetType() == PEON || thisEntity->GetType() == GOBLIN)
 					{
 						//Gather some shit
-						GatherTask *gatherTask = new GatherTask(m_selectionHandles[selectIndex], entity->GetHandle());
-						thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(gatherTask));
+						IssuePlayerTask(thisEntity, RTSTask::MakeGather(entity->GetHandle(), m_shiftPressed));
 					}
 					else
 					{
-						MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], entity->GetPosition());
-						m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-						thisEntity->ResetTaskData();
-						m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+						IssuePlayerTask(thisEntity, RTSTask::MakeMove(entity->GetPosition(), m_shiftPressed));
 					}
 				}
 				else if (entity->IsBuildingType())
 				{
-					if (thisEntity->GetType() == PEON || thisEntity->GetType() == GOBLIN)
-					{
-						if (entity->GetHealth() < entity->GetMaxHealth())
-						{
-							thisEntity->SetUnitToBuild(entity);
-						}
-						else
-						{
-							thisEntity->MoveTo(entity->GetPosition());
-						}
-					}
-					else
-					{
-						thisEntity->MoveTo(entity->GetPosition());
-					}
+					//Repair it if it is damaged, otherwise walk over to it
+					IssuePlayerTask(thisEntity, RTSTask::MakeRepair(entity->GetHandle(), m_shiftPressed));
 				}
 			}
 			else
@@ -443,16 +443,23 @@ bool GameInput::HandleMouseRBDown()
 
 				if (IntVec2(m_terrainCastLocation).IsInBounds(Game::s_gameReference->m_map->m_tileDimensions))
 				{
-					MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], m_terrainCastLocation);
-					m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-					thisEntity->ResetTaskData();
-					m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+					if (m_shiftPressed)
+					{
+						//Waypoint, runs once the unit has finished what it is doing
+						IssuePlayerTask(thisEntity, RTSTask::MakeMove(m_terrainCastLocation, true));
+					}
+					else
+					{
+						m_groupMoveHandles.push_back(m_selectionHandles[selectIndex]);
+					}
 				}
 			}
 
 		}
 	}
 
+	m_game->EnqueuePlayerGroupMove(m_groupMoveHandles, m_terrainCastLocation);
+
 	return false;
 }
 
@@ -490,6 +497,10 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 		entity = m_game->m_map->RaycastEntity(out, ray);
 	}
 
+	//Only the camera keys work while a replay is running, everything else would change the match
+	if (m_game->m_isReplaying && keyCode != A_KEY && keyCode != W_KEY && keyCode != S_KEY && keyCode != D_KEY && keyCode != LCTRL_KEY)
+		return;
+
 	switch( keyCode )
 	{
 	case A_KEY:
@@ -606,13 +617,13 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 		{
 		case 1:
 		{
-			m_game->SetCurrentTeam(2);
+			m_game->EnqueuePlayerCommand(RTSCommand::MakeSetPlayerTeam(2));
 			SetTeamForSelectedEntities(2);
 		}
 		break;
 		case 2:
 		{
-			m_game->SetCurrentTeam(1);
+			m_game->EnqueuePlayerCommand(RTSCommand::MakeSetPlayerTeam(1));
 			SetTeamForSelectedEntities(1);
 		}
 		break;
@@ -624,44 +635,36 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 	break;
 	case NUM_2:
 	{
+		m_groupMoveHandles.clear();
 		for (int selectIndex = 0; selectIndex < (int)m_selectionHandles.size(); ++selectIndex)
 		{
 			if (m_selectionHandles[selectIndex] != GameHandle::INVALID)
 			{
-				Entity* thisEntity = m_game->m_map->FindEntity(m_selectionHandles[selectIndex]);
-
 				Vec3 dest = ray.GetPointAtTime(terrainOut[0]);
 				m_terrainCastLocation = Vec2(dest.x, dest.y);
 
-				MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], m_terrainCastLocation);
-				m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-				thisEntity->ResetTaskData();
-				m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+				m_groupMoveHandles.push_back(m_selectionHandles[selectIndex]);
 			}
 		}
+
+		m_game->EnqueuePlayerGroupMove(m_groupMoveHandles, m_terrainCastLocation);
 	}
 	break;
 	case NUM_3:
 	{
+		m_groupMoveHandles.clear();
 		for (int selectIndex = 0; selectIndex < (int)m_selectionHandles.size(); ++selectIndex)
 		{
 			if (m_selectionHandles[selectIndex] != GameHandle::INVALID)
 			{
 				Entity* thisEntity = m_game->m_map->FindEntity(m_selectionHandles[selectIndex]);
 
-				if (m_shiftPressed)
-				{
-					thisEntity->ClearTasks();
-				}
-
 				if (entity)
 				{
-					thisEntity->ResetTaskData();
 					if (entity->GetTeam() != thisEntity->GetTeam() && !entity->IsResource())
 					{
 						//Fuck up your enemies						
-						AttackTask *attackTask = new AttackTask(m_selectionHandles[selectIndex], entity->GetHandle());
-						thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(attackTask));
+						IssuePlayerTask(thisEntity, RTSTask::MakeAttack(entity->GetHandle(), m_shiftPressed));
 					}
 				}
 				else
@@ -669,46 +672,35 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 					Vec3 dest = ray.GetPointAtTime(terrainOut[0]);
 					m_terrainCastLocation = Vec2(dest.x, dest.y);
 
-					MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], m_terrainCastLocation);
-					m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-					thisEntity->ResetTaskData();
-					m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+					m_groupMoveHandles.push_back(m_selectionHandles[selectIndex]);
 				}
 			}
 		}
+
+		m_game->EnqueuePlayerGroupMove(m_groupMoveHandles, m_terrainCastLocation);
 	}
 	break;
 	case NUM_4:
 	{
+		m_groupMoveHandles.clear();
 		for (int selectIndex = 0; selectIndex < (int)m_selectionHandles.size(); ++selectIndex)
 		{
 			if (m_selectionHandles[selectIndex] != GameHandle::INVALID)
 			{
 				Entity* thisEntity = m_game->m_map->FindEntity(m_selectionHandles[selectIndex]);
 
-				if (m_shiftPressed)
-				{
-					thisEntity->ClearTasks();
-				}
-
 				if (entity)
 				{
-					thisEntity->ResetTaskData();
-					
 					if (entity->IsResource())
 					{
 						if (thisEntity->GetType() == PEON)
 						{
 							//Gather some shit
-							GatherTask *gatherTask = new GatherTask(m_selectionHandles[selectIndex], entity->GetHandle());
-							thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(gatherTask));
+							IssuePlayerTask(thisEntity, RTSTask::MakeGather(entity->GetHandle(), m_shiftPressed));
 						}
 						else
 						{
-							MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], entity->GetPosition());
-							m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-							thisEntity->ResetTaskData();
-							m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+							IssuePlayerTask(thisEntity, RTSTask::MakeMove(entity->GetPosition(), m_shiftPressed));
 						}
 					}
 				}
@@ -717,13 +709,12 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 					Vec3 dest = ray.GetPointAtTime(terrainOut[0]);
 					m_terrainCastLocation = Vec2(dest.x, dest.y);
 
-					MoveCommand *cmd = new MoveCommand(m_selectionHandles[selectIndex], m_terrainCastLocation);
-					m_game->m_map->FindEntity(m_selectionHandles[selectIndex])->StopFollow();
-					thisEntity->ResetTaskData();
-					m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(cmd));
+					m_groupMoveHandles.push_back(m_selectionHandles[selectIndex]);
 				}
 			}
 		}
+
+		m_game->EnqueuePlayerGroupMove(m_groupMoveHandles, m_terrainCastLocation);
 	}
 	break;
 	case NUM_5:
@@ -742,14 +733,14 @@ void GameInput::HandleKeyPressed( unsigned char keyCode )
 		{
 			for (int entityIndex = 0; entityIndex < m_selectionHandles.size(); entityIndex++)
 			{
-				entity = m_game->m_map->FindEntity(m_selectionHandles[entityIndex]);
-				entity->SetHealth(0.f);
+				m_game->EnqueuePlayerCommand(RTSCommand::MakeKill(m_selectionHandles[entityIndex]));
 			}
 		}
 	}
+	break;
 	case L_KEY:
 	{
-		m_game->m_disableAI = !m_game->m_disableAI;
+		m_game->EnqueuePlayerCommand(RTSCommand::MakeSetAIEnabled(m_game->m_disableAI));
 	}
 	break;
 	}
@@ -774,19 +765,11 @@ void GameInput::MakeBuilding()
 						return;
 
 					if (m_game->m_teamResource[team] < m_game->m_map->GetTownCenterCost())
-					{
 						return;
-					}
-					else
-					{
-						m_game->m_teamResource[team] -= m_game->m_map->GetTownCenterCost();
-					}
 
 					//build some shit
-					BuildTask *buildTask = new BuildTask(m_selectionHandles[i], buildPos, TOWNCENTER);
-					thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(buildTask));
-
-					m_game->m_map->SetOccupancyForUnit(buildPos, m_game->m_map->m_townCenterOcc, true);
+					m_game->EnqueuePlayerCommand(RTSCommand::MakePlaceBuilding(buildPos, TOWNCENTER, team + 1));
+					IssuePlayerTask(thisEntity, RTSTask::MakeBuild(buildPos, TOWNCENTER, m_shiftPressed));
 
 					m_towncenterSpawnSelect = false;
 					break;
@@ -839,19 +822,11 @@ void GameInput::MakeHut()
 						return;
 
 					if (m_game->m_teamResource[team] < m_game->m_map->GetHutCost())
-					{
 						return;
-					}
-					else
-					{
-						m_game->m_teamResource[team] -= m_game->m_map->GetHutCost();
-					}
 
 					//build some shit
-					BuildTask *buildTask = new BuildTask(m_selectionHandles[i], buildPos, HUT);
-					thisEntity->EnqueueTask(reinterpret_cast<RTSTask*>(buildTask));
-
-					m_game->m_map->SetOccupancyForUnit(buildPos, m_game->m_map->m_hutOcc, true);
+					m_game->EnqueuePlayerCommand(RTSCommand::MakePlaceBuilding(buildPos, HUT, team + 1));
+					IssuePlayerTask(thisEntity, RTSTask::MakeBuild(buildPos, HUT, m_shiftPressed));
 
 					m_hutSpawnSelect = false;
 					break;
@@ -929,10 +904,9 @@ void GameInput::SetTeamForSelectedEntities(int teamNum)
 {
 	for (int i = 0; i < (int)m_selectionHandles.size(); i++)
 	{
-		Entity* entity = Game::s_gameReference->m_map->FindEntity(m_selectionHandles[i]);
-		if(entity != nullptr)
+		if (m_selectionHandles[i] != GameHandle::INVALID)
 		{
-			entity->SetTeam(teamNum);
+			m_game->EnqueuePlayerCommand(RTSCommand::MakeSetEntityTeam(m_selectionHandles[i], teamNum));
 		}
 	}
 }
@@ -959,8 +933,6 @@ void GameInput::SpawnUnit(EntityTypeT type, const Vec2& buildPos)
 
 		Vec2 pointOnMap = GetCorrectedMapPosition(Vec2(point.x, point.y), mapBounds, IntVec2(0, 0));
 
-		CreateEntityCommand* command;
-
 		if (type == TOWNCENTER)
 		{
 			pointOnMap = GetCorrectedMapPosition(buildPos, mapBounds, m_game->m_map->m_townCenterOcc);
@@ -972,14 +944,7 @@ void GameInput::SpawnUnit(EntityTypeT type, const Vec2& buildPos)
 			return;
 		}
 
-		//Set occupancy for tree
-		if (type == TREE)
-		{
-			m_game->m_map->SetOccupancyForUnit(pointOnMap, IntVec2(1, 1), true);
-		}
-
-		command = new CreateEntityCommand(pointOnMap, type);
-		m_game->EnqueueCommand(reinterpret_cast<RTSCommand*>(command));
+		m_game->EnqueuePlayerCommand(RTSCommand::MakeCreateEntity(pointOnMap, type));
 	}
 }
 
@@ -1022,31 +987,8 @@ void GameInput::TrainUnit()
 
 			if (thisEntity->GetType() == TOWNCENTER || thisEntity->GetType() == HUT)
 			{
-				int team = m_game->GetCurrentTeam() - 1;
-
-				if (m_game->m_teamCurrentSupply[team] >= m_game->m_teamMaxSupply[team])
-					return;
-
-				if (team == 0)
-				{
-					if (m_game->m_teamResource[team] >= m_game->m_map->GetPeonCost())
-					{
-						thisEntity->SetIsTrainingUnit(true);
-
-						m_game->m_teamResource[team] -= m_game->m_map->GetPeonCost();
-						m_game->m_teamCurrentSupply[team] += 1;
-					}
-				}
-				else
-				{
-					if (m_game->m_teamResource[team] >= m_game->m_map->GetGoblinCost())
-					{
-						thisEntity->SetIsTrainingUnit(true);
-
-						m_game->m_teamResource[team] -= m_game->m_map->GetGoblinCost();
-						m_game->m_teamCurrentSupply[team] += 1;
-					}
-				}
+				//Supply and cost are checked when the command runs so replays make the same call
+				m_game->EnqueuePlayerCommand(RTSCommand::MakeTrainUnit(m_selectionHandles[selectIndex], m_game->GetCurrentTeam()));
 			}
 		}
 	}
@@ -51,6 +51,7 @@ public:
 	//Frustum Selection
 	void								SelectEntityAtClientPosition(const IntVec2& position);
 	void								SelectEntitiesInClientBox(const IntVec2& boxStart, const IntVec2& boxEnd);
+	void								ClearSelection();
 
 	//Key input handling
 	void								HandleKeyPressed( unsigned char keyCode );
@@ -62,6 +63,7 @@ public:
 	void								SetTeamForSelectedEntities(int teamNum);
 	void								SpawnUnit(EntityTypeT type, const Vec2& buildPos = Vec2::ZERO);
 	void								TrainUnit();
+	void								IssuePlayerTask(Entity* entity, const RTSTask& task);
 
 	//Utilities
 	Vec2								GetCorrectedMapPosition(Vec2 position, IntVec2 limits, IntVec2 occupancy);
@@ -96,7 +98,8 @@ public:
 
 	bool m_LMousePressed			 = true;
 
-	bool m_shiftPressed = true;
+	bool m_shiftPressed = false;
+	int m_numRejectedOrders = 0;		//Orders refused this frame because the unit's task queue was full
 
 	Vec2 m_terrainCastLocation = Vec2::ZERO;
 
@@ -107,6 +110,7 @@ public:
 
 	//GameHandle m_selectionHandle; 
 	std::vector<GameHandle> m_selectionHandles; 
+	std::vector<GameHandle> m_groupMoveHandles;		// scratch list reused for group move commands
 	GameHandle m_hoverHandle;
 
 
@@ -0,0 +1,830 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/GameLog.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/Time.hpp"
+//Others
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+GameLog* g_gameLog = nullptr;
+
+static const char	LOG_MAGIC[4] = { 'G', 'L', 'O', 'G' };
+static const uint	LOG_VERSION = 1U;
+
+//How long the writer sleeps between passes, a burst bigger than a ring in this time is dropped
+static const uint	LOG_WRITE_INTERVAL_MS = 10U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogChunk : uint8_t
+{
+	LOG_CHUNK_FORMAT,			//id, length, the format string
+	LOG_CHUNK_RECORD,			//format id, level, category, thread, arg count, time, then each arg's type and value
+	LOG_CHUNK_DROPPED			//thread, how many records its full ring dropped
+};
+
+//The calling thread's ring, and the generation of the log it belongs to. A new log can be made at the address of a deleted
+//one, so the generation is compared rather than the address
+static thread_local LogRing*	s_threadRing = nullptr;
+static thread_local uint		s_threadRingGeneration = 0U;
+
+STATIC std::atomic<uint> GameLog::s_nextGeneration(1U);
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AppendBytes(std::vector<uint8_t>& bytes, const void* data, size_t numBytes)
+{
+	const uint8_t* first = (const uint8_t*)data;
+	bytes.insert(bytes.end(), first, first + numBytes);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadBytes(const std::vector<uint8_t>& bytes, size_t& readIndex, void* outData, size_t numBytes)
+{
+	if (readIndex + numBytes > bytes.size())
+		return false;
+
+	memcpy(outData, bytes.data() + readIndex, numBytes);
+	readIndex += numBytes;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsEqualIgnoringCase(const std::string& a, const char* b)
+{
+	size_t length = strlen(b);
+	if (a.size() != length)
+		return false;
+
+	for (size_t charIndex = 0; charIndex < length; charIndex++)
+	{
+		if (tolower((unsigned char)a[charIndex]) != tolower((unsigned char)b[charIndex]))
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PackLogInt(LogRecord& record, int64_t value)
+{
+	if (record.m_numArgs >= MAX_LOG_ARGS)
+		return;
+
+	record.m_argTypes[record.m_numArgs] = LOG_ARG_INT;
+	record.m_args[record.m_numArgs].m_int = value;
+	record.m_numArgs++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PackLogUint(LogRecord& record, uint64_t value)
+{
+	if (record.m_numArgs >= MAX_LOG_ARGS)
+		return;
+
+	record.m_argTypes[record.m_numArgs] = LOG_ARG_UINT;
+	record.m_args[record.m_numArgs].m_uint = value;
+	record.m_numArgs++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PackLogFloat(LogRecord& record, double value)
+{
+	if (record.m_numArgs >= MAX_LOG_ARGS)
+		return;
+
+	record.m_argTypes[record.m_numArgs] = LOG_ARG_FLOAT;
+	record.m_args[record.m_numArgs].m_float = value;
+	record.m_numArgs++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PackLogText(LogRecord& record, const char* text)
+{
+	if (record.m_numArgs >= MAX_LOG_ARGS || record.m_textSize >= LOG_RECORD_TEXT_BYTES)
+		return;
+
+	uint length = text != nullptr ? (uint)strlen(text) : 0U;
+	uint maxLength = LOG_RECORD_TEXT_BYTES - record.m_textSize - 1U;
+	if (length > maxLength)
+	{
+		length = maxLength;
+	}
+
+	record.m_argTypes[record.m_numArgs] = LOG_ARG_TEXT;
+	record.m_args[record.m_numArgs].m_textOffset = record.m_textSize;
+	memcpy(record.m_text + record.m_textSize, text, length);
+	record.m_text[record.m_textSize + length] = '\0';
+	record.m_textSize += length + 1U;
+	record.m_numArgs++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+GameLog::GameLog()
+	:	m_generation(s_nextGeneration++)
+{
+	m_startTime = GetCurrentTimeSeconds();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Whatever is still in the rings is written before the file closes
+//------------------------------------------------------------------------------------------------------------------------------
+GameLog::~GameLog()
+{
+	if (m_isRunning)
+	{
+		{
+			std::lock_guard<std::mutex> sleepLock(m_sleepLock);
+			m_isRunning = false;
+		}
+		m_wakeCondition.notify_all();
+		m_writerThread.join();
+	}
+
+	DrainRings();
+
+	if (m_file != nullptr)
+	{
+		fclose(m_file);
+		m_file = nullptr;
+	}
+
+	for (size_t ringIndex = 0; ringIndex < m_rings.size(); ringIndex++)
+	{
+		delete m_rings[ringIndex];
+	}
+	m_rings.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Starts a new log file each run. Without one the records are still echoed
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::StartUp(const std::string& filePath)
+{
+	m_filePath = filePath;
+	m_file = fopen(filePath.c_str(), "wb");
+	if (m_file == nullptr)
+	{
+		DebuggerPrintf("Could not open log file %s\n", filePath.c_str());
+	}
+	else
+	{
+		fwrite(LOG_MAGIC, 1, 4, m_file);
+		fwrite(&LOG_VERSION, sizeof(uint), 1, m_file);
+	}
+
+	m_isRunning = true;
+	m_writerThread = std::thread(&GameLog::WriterThreadMain, this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// logLevel, logDebuggerLevel and logConsoleLevel in GameConfig by name, the defaults otherwise
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::LoadLevelsFromConfig()
+{
+	eLogLevel level;
+	if (FindLevel(g_gameConfigBlackboard.GetValue("logLevel", ""), level))
+	{
+		SetLevel(level);
+	}
+	if (FindLevel(g_gameConfigBlackboard.GetValue("logDebuggerLevel", ""), level))
+	{
+		SetDebuggerLevel(level);
+	}
+	if (FindLevel(g_gameConfigBlackboard.GetValue("logConsoleLevel", ""), level))
+	{
+		SetConsoleLevel(level);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::Update()
+{
+	LogConsoleLine line;
+	while (m_consoleLines.dequeue(&line))
+	{
+		Rgba color = line.m_level >= LOG_ERROR ? Rgba::RED : (line.m_level == LOG_WARNING ? Rgba::YELLOW : Rgba::WHITE);
+		g_devConsole->PrintString(color, line.m_text);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Writes everything logged so far on the calling thread instead of waiting for the writer
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::Flush()
+{
+	DrainRings();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::SetLevel(eLogLevel level)
+{
+	m_level = level;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::SetDebuggerLevel(eLogLevel level)
+{
+	m_debuggerLevel = level;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::SetConsoleLevel(eLogLevel level)
+{
+	m_consoleLevel = level;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::SetCategoryEnabled(eLogCategory category, bool isEnabled)
+{
+	if (isEnabled)
+	{
+		m_categoryMask |= (1U << category);
+	}
+	else
+	{
+		m_categoryMask &= ~(1U << category);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC const char* GameLog::GetLevelName(eLogLevel level)
+{
+	switch (level)
+	{
+	case LOG_TRACE:		return "Trace";
+	case LOG_DEBUG:		return "Debug";
+	case LOG_INFO:		return "Info";
+	case LOG_WARNING:	return "Warning";
+	case LOG_ERROR:		return "Error";
+	default:			return "Unknown";
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC const char* GameLog::GetCategoryName(eLogCategory category)
+{
+	switch (category)
+	{
+	case LOG_CATEGORY_CORE:		return "Core";
+	case LOG_CATEGORY_MEMORY:	return "Memory";
+	case LOG_CATEGORY_ASSETS:	return "Assets";
+	case LOG_CATEGORY_AUDIO:	return "Audio";
+	case LOG_CATEGORY_GAMEPLAY:	return "Gameplay";
+	case LOG_CATEGORY_RENDER:	return "Render";
+	default:					return "Unknown";
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameLog::FindLevel(const std::string& name, eLogLevel& outLevel)
+{
+	for (int levelIndex = 0; levelIndex < NUM_LOG_LEVELS; levelIndex++)
+	{
+		if (IsEqualIgnoringCase(name, GetLevelName((eLogLevel)levelIndex)))
+		{
+			outLevel = (eLogLevel)levelIndex;
+			return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameLog::FindCategory(const std::string& name, eLogCategory& outCategory)
+{
+	for (int categoryIndex = 0; categoryIndex < NUM_LOG_CATEGORIES; categoryIndex++)
+	{
+		if (IsEqualIgnoringCase(name, GetCategoryName((eLogCategory)categoryIndex)))
+		{
+			outCategory = (eLogCategory)categoryIndex;
+			return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Walks the format and hands each conversion its packed argument. Length modifiers in the format are ignored, every
+// integer was widened to 64 bits when packed. A conversion without an argument prints <?>
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string GameLog::FormatRecord(const LogRecord& record)
+{
+	std::string result;
+	if (record.m_format == nullptr)
+		return result;
+
+	uint argIndex = 0U;
+	const char* read = record.m_format;
+	while (*read != '\0')
+	{
+		if (*read != '%')
+		{
+			result += *read++;
+			continue;
+		}
+
+		if (read[1] == '%')
+		{
+			result += '%';
+			read += 2;
+			continue;
+		}
+
+		std::string spec = "%";
+		read++;
+		while (*read != '\0' && strchr("-+ #0123456789.", *read) != nullptr)
+		{
+			spec += *read++;
+		}
+		while (*read != '\0' && strchr("hlLzjtI", *read) != nullptr)
+		{
+			read++;
+		}
+
+		char conversion = *read;
+		if (conversion == '\0')
+			break;
+		read++;
+
+		if (argIndex >= record.m_numArgs)
+		{
+			result += "<?>";
+			continue;
+		}
+
+		uint8_t argType = record.m_argTypes[argIndex];
+		const LogArg& arg = record.m_args[argIndex];
+		argIndex++;
+
+		int64_t intValue = argType == LOG_ARG_FLOAT ? (int64_t)arg.m_float : arg.m_int;
+		double floatValue = argType == LOG_ARG_FLOAT ? arg.m_float : (argType == LOG_ARG_UINT ? (double)arg.m_uint : (double)arg.m_int);
+
+		char buffer[256];
+		buffer[0] = '\0';
+		switch (conversion)
+		{
+		case 'd': case 'i':
+			spec += "ll";
+			spec += conversion;
+			snprintf(buffer, sizeof(buffer), spec.c_str(), (long long)intValue);
+			break;
+		case 'u': case 'x': case 'X': case 'o':
+			spec += "ll";
+			spec += conversion;
+			snprintf(buffer, sizeof(buffer), spec.c_str(), (unsigned long long)intValue);
+			break;
+		case 'c':
+			spec += 'c';
+			snprintf(buffer, sizeof(buffer), spec.c_str(), (int)intValue);
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+			spec += conversion;
+			snprintf(buffer, sizeof(buffer), spec.c_str(), floatValue);
+			break;
+		case 's':
+			spec += 's';
+			if (argType == LOG_ARG_TEXT)
+			{
+				snprintf(buffer, sizeof(buffer), spec.c_str(), record.m_text + arg.m_textOffset);
+			}
+			else
+			{
+				snprintf(buffer, sizeof(buffer), "%g", floatValue);
+			}
+			break;
+		default:
+			snprintf(buffer, sizeof(buffer), "<?>");
+			break;
+		}
+
+		result += buffer;
+	}
+
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string GameLog::FormatLine(const LogRecord& record)
+{
+	return Stringf("[%10.3f] %-7s %-8s T%u  %s", record.m_time, GetLevelName((eLogLevel)record.m_level), GetCategoryName((eLogCategory)record.m_category),
+		(uint)record.m_threadIndex, FormatRecord(record).c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Called for every log line, so it is a thread local lookup and a compare of two indices. Nothing waits on the writer
+//------------------------------------------------------------------------------------------------------------------------------
+LogRecord* GameLog::BeginRecord(eLogLevel level, eLogCategory category, const char* format)
+{
+	LogRing* ring = GetThreadRing();
+	uint head = ring->m_head.load(std::memory_order_relaxed);
+	uint tail = ring->m_tail.load(std::memory_order_acquire);
+	if (head - tail >= LOG_RING_SIZE)
+	{
+		ring->m_numDropped.fetch_add(1U, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	LogRecord& record = ring->m_records[head & (LOG_RING_SIZE - 1U)];
+	record.m_format = format;
+	record.m_time = GetCurrentTimeSeconds() - m_startTime;
+	record.m_level = (uint8_t)level;
+	record.m_category = (uint8_t)category;
+	record.m_threadIndex = (uint8_t)ring->m_threadIndex;
+	record.m_numArgs = 0U;
+	record.m_textSize = 0U;
+	return &record;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::CommitRecord()
+{
+	LogRing* ring = s_threadRing;
+	ring->m_head.store(ring->m_head.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A thread's first log line makes its ring, the only time logging takes a lock
+//------------------------------------------------------------------------------------------------------------------------------
+LogRing* GameLog::GetThreadRing()
+{
+	if (s_threadRing != nullptr && s_threadRingGeneration == m_generation)
+		return s_threadRing;
+
+	LogRing* ring = new LogRing();
+	{
+		std::lock_guard<std::mutex> ringLock(m_ringLock);
+		ring->m_threadIndex = (uint)m_rings.size();
+		m_rings.push_back(ring);
+	}
+
+	s_threadRing = ring;
+	s_threadRingGeneration = m_generation;
+	return ring;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::WriterThreadMain()
+{
+	while (m_isRunning)
+	{
+		{
+			std::unique_lock<std::mutex> sleepLock(m_sleepLock);
+			m_wakeCondition.wait_for(sleepLock, std::chrono::milliseconds(LOG_WRITE_INTERVAL_MS));
+		}
+
+		DrainRings();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The ring lock is held throughout so no ring is added mid pass, a thread's first line waits at most one pass
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::DrainRings()
+{
+	std::lock_guard<std::mutex> drainLock(m_drainLock);
+	{
+		std::lock_guard<std::mutex> ringLock(m_ringLock);
+		for (size_t ringIndex = 0; ringIndex < m_rings.size(); ringIndex++)
+		{
+			LogRing* ring = m_rings[ringIndex];
+			uint numDropped = ring->m_numDropped.exchange(0U, std::memory_order_relaxed);
+			if (numDropped > 0U)
+			{
+				WriteDropped(ring->m_threadIndex, numDropped);
+			}
+
+			uint tail = ring->m_tail.load(std::memory_order_relaxed);
+			uint head = ring->m_head.load(std::memory_order_acquire);
+			for (; tail != head; tail++)
+			{
+				WriteRecord(ring->m_records[tail & (LOG_RING_SIZE - 1U)]);
+			}
+			ring->m_tail.store(tail, std::memory_order_release);
+		}
+	}
+
+	if (m_file != nullptr && !m_writeBytes.empty())
+	{
+		fwrite(m_writeBytes.data(), 1, m_writeBytes.size(), m_file);
+		fflush(m_file);
+	}
+	m_writeBytes.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only the lines that are echoed get formatted. Caller holds the drain lock
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::WriteRecord(const LogRecord& record)
+{
+	m_numRecords++;
+
+	bool toDebugger = record.m_level >= m_debuggerLevel.load(std::memory_order_relaxed);
+	bool toConsole = record.m_level >= m_consoleLevel.load(std::memory_order_relaxed);
+	if (toDebugger || toConsole)
+	{
+		std::string line = FormatLine(record);
+		if (toDebugger)
+		{
+			DebuggerPrintf("%s\n", line.c_str());
+		}
+		if (toConsole)
+		{
+			LogConsoleLine consoleLine;
+			consoleLine.m_level = (eLogLevel)record.m_level;
+			consoleLine.m_text = line;
+			m_consoleLines.enqueue(consoleLine);
+		}
+	}
+
+	if (m_file == nullptr)
+		return;
+
+	uint formatID = GetFormatID(record.m_format);
+	uint8_t chunk = LOG_CHUNK_RECORD;
+	AppendBytes(m_writeBytes, &chunk, 1);
+	AppendBytes(m_writeBytes, &formatID, sizeof(uint));
+	AppendBytes(m_writeBytes, &record.m_level, 1);
+	AppendBytes(m_writeBytes, &record.m_category, 1);
+	AppendBytes(m_writeBytes, &record.m_threadIndex, 1);
+	AppendBytes(m_writeBytes, &record.m_numArgs, 1);
+	AppendBytes(m_writeBytes, &record.m_time, sizeof(double));
+
+	for (uint argIndex = 0; argIndex < record.m_numArgs; argIndex++)
+	{
+		AppendBytes(m_writeBytes, &record.m_argTypes[argIndex], 1);
+		if (record.m_argTypes[argIndex] == LOG_ARG_TEXT)
+		{
+			const char* text = record.m_text + record.m_args[argIndex].m_textOffset;
+			uint8_t length = (uint8_t)strlen(text);
+			AppendBytes(m_writeBytes, &length, 1);
+			AppendBytes(m_writeBytes, text, length);
+		}
+		else
+		{
+			AppendBytes(m_writeBytes, &record.m_args[argIndex].m_uint, sizeof(uint64_t));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameLog::WriteDropped(uint threadIndex, uint numDropped)
+{
+	m_numDropped += numDropped;
+	DebuggerPrintf("Log ring for thread %u was full, %u records dropped\n", threadIndex, numDropped);
+
+	if (m_file == nullptr)
+		return;
+
+	uint8_t chunk = LOG_CHUNK_DROPPED;
+	uint8_t thread = (uint8_t)threadIndex;
+	AppendBytes(m_writeBytes, &chunk, 1);
+	AppendBytes(m_writeBytes, &thread, 1);
+	AppendBytes(m_writeBytes, &numDropped, sizeof(uint));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each format string goes into the file once, before the first record that uses it
+//------------------------------------------------------------------------------------------------------------------------------
+uint GameLog::GetFormatID(const char* format)
+{
+	std::map<const char*, uint>::const_iterator found = m_formatIDs.find(format);
+	if (found != m_formatIDs.end())
+		return found->second;
+
+	uint formatID = (uint)m_formatIDs.size();
+	m_formatIDs[format] = formatID;
+
+	uint8_t chunk = LOG_CHUNK_FORMAT;
+	uint length = format != nullptr ? (uint)strlen(format) : 0U;
+	AppendBytes(m_writeBytes, &chunk, 1);
+	AppendBytes(m_writeBytes, &formatID, sizeof(uint));
+	AppendBytes(m_writeBytes, &length, sizeof(uint));
+	AppendBytes(m_writeBytes, format, length);
+	return formatID;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Turns a binary log, from this run or any earlier one, into the same lines the debugger echo prints
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameLog::DecodeFile(const std::string& logPath, const std::string& textPath, std::string& outError)
+{
+	FILE* file = fopen(logPath.c_str(), "rb");
+	if (file == nullptr)
+	{
+		outError = Stringf("Could not open %s", logPath.c_str());
+		return false;
+	}
+
+	std::vector<uint8_t> bytes;
+	uint8_t buffer[4096];
+	size_t numRead;
+	while ((numRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		bytes.insert(bytes.end(), buffer, buffer + numRead);
+	}
+	fclose(file);
+
+	size_t readIndex = 0U;
+	char magic[4];
+	uint version = 0U;
+	if (!ReadBytes(bytes, readIndex, magic, 4) || memcmp(magic, LOG_MAGIC, 4) != 0 || !ReadBytes(bytes, readIndex, &version, sizeof(uint)) || version != LOG_VERSION)
+	{
+		outError = Stringf("%s is not a version %u log", logPath.c_str(), LOG_VERSION);
+		return false;
+	}
+
+	std::vector<std::string> formats;
+	std::string text;
+	while (readIndex < bytes.size())
+	{
+		uint8_t chunk = 0U;
+		ReadBytes(bytes, readIndex, &chunk, 1);
+
+		bool result = true;
+		if (chunk == LOG_CHUNK_FORMAT)
+		{
+			uint formatID = 0U;
+			uint length = 0U;
+			result = ReadBytes(bytes, readIndex, &formatID, sizeof(uint)) && ReadBytes(bytes, readIndex, &length, sizeof(uint));
+			result = result && formatID == (uint)formats.size() && readIndex + length <= bytes.size();
+			if (result)
+			{
+				formats.push_back(std::string((const char*)bytes.data() + readIndex, length));
+				readIndex += length;
+			}
+		}
+		else if (chunk == LOG_CHUNK_RECORD)
+		{
+			LogRecord record;
+			uint formatID = 0U;
+			result = ReadBytes(bytes, readIndex, &formatID, sizeof(uint)) && formatID < (uint)formats.size();
+			result = result && ReadBytes(bytes, readIndex, &record.m_level, 1) && ReadBytes(bytes, readIndex, &record.m_category, 1);
+			result = result && ReadBytes(bytes, readIndex, &record.m_threadIndex, 1) && ReadBytes(bytes, readIndex, &record.m_numArgs, 1);
+			result = result && record.m_numArgs <= MAX_LOG_ARGS && ReadBytes(bytes, readIndex, &record.m_time, sizeof(double));
+
+			for (uint argIndex = 0; result && argIndex < record.m_numArgs; argIndex++)
+			{
+				result = ReadBytes(bytes, readIndex, &record.m_argTypes[argIndex], 1);
+				if (result && record.m_argTypes[argIndex] == LOG_ARG_TEXT)
+				{
+					uint8_t length = 0U;
+					result = ReadBytes(bytes, readIndex, &length, 1) && record.m_textSize + length < LOG_RECORD_TEXT_BYTES;
+					result = result && ReadBytes(bytes, readIndex, record.m_text + record.m_textSize, length);
+					if (result)
+					{
+						record.m_args[argIndex].m_textOffset = record.m_textSize;
+						record.m_text[record.m_textSize + length] = '\0';
+						record.m_textSize += length + 1U;
+					}
+				}
+				else if (result)
+				{
+					result = ReadBytes(bytes, readIndex, &record.m_args[argIndex].m_uint, sizeof(uint64_t));
+				}
+			}
+
+			if (result)
+			{
+				record.m_format = formats[formatID].c_str();
+				text += FormatLine(record);
+				text += '\n';
+			}
+		}
+		else if (chunk == LOG_CHUNK_DROPPED)
+		{
+			uint8_t threadIndex = 0U;
+			uint numDropped = 0U;
+			result = ReadBytes(bytes, readIndex, &threadIndex, 1) && ReadBytes(bytes, readIndex, &numDropped, sizeof(uint));
+			if (result)
+			{
+				text += Stringf("--- thread %u dropped %u records ---\n", (uint)threadIndex, numDropped);
+			}
+		}
+		else
+		{
+			result = false;
+		}
+
+		//A crash can leave the last pass half written, everything before it still decodes
+		if (!result)
+		{
+			text += Stringf("--- log cut off at byte %u ---\n", (uint)readIndex);
+			break;
+		}
+	}
+
+	file = fopen(textPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		outError = Stringf("Could not write %s", textPath.c_str());
+		return false;
+	}
+
+	fwrite(text.data(), 1, text.size(), file);
+	fclose(file);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// level, debugger and console take a level name, enable and disable a category name. Prints the state afterwards
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameLog::Command_Log(EventArgs& args)
+{
+	GameLog& gameLog = *g_gameLog;
+	bool succeeded = true;
+
+	const char* levelKeys[3] = { "level", "debugger", "console" };
+	for (int keyIndex = 0; keyIndex < 3; keyIndex++)
+	{
+		std::string name = args.GetValue(levelKeys[keyIndex], "");
+		if (name == "")
+			continue;
+
+		eLogLevel level;
+		if (!FindLevel(name, level))
+		{
+			g_devConsole->PrintString(Rgba::RED, Stringf("Unknown log level %s", name.c_str()));
+			succeeded = false;
+			continue;
+		}
+
+		if (keyIndex == 0)
+		{
+			gameLog.SetLevel(level);
+		}
+		else if (keyIndex == 1)
+		{
+			gameLog.SetDebuggerLevel(level);
+		}
+		else
+		{
+			gameLog.SetConsoleLevel(level);
+		}
+	}
+
+	const char* categoryKeys[2] = { "enable", "disable" };
+	for (int keyIndex = 0; keyIndex < 2; keyIndex++)
+	{
+		std::string name = args.GetValue(categoryKeys[keyIndex], "");
+		if (name == "")
+			continue;
+
+		eLogCategory category;
+		if (!FindCategory(name, category))
+		{
+			g_devConsole->PrintString(Rgba::RED, Stringf("Unknown log category %s", name.c_str()));
+			succeeded = false;
+			continue;
+		}
+
+		gameLog.SetCategoryEnabled(category, keyIndex == 0);
+	}
+
+	std::string categories;
+	for (int categoryIndex = 0; categoryIndex < NUM_LOG_CATEGORIES; categoryIndex++)
+	{
+		if ((gameLog.m_categoryMask & (1U << categoryIndex)) != 0U)
+		{
+			categories += categories == "" ? "" : ", ";
+			categories += GetCategoryName((eLogCategory)categoryIndex);
+		}
+	}
+
+	uint64_t numRecords = 0U;
+	uint64_t numDropped = 0U;
+	{
+		std::lock_guard<std::mutex> drainLock(gameLog.m_drainLock);
+		numRecords = gameLog.m_numRecords;
+		numDropped = gameLog.m_numDropped;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Logging %s and up, debugger %s, console %s: %s", GetLevelName((eLogLevel)gameLog.m_level.load()),
+		GetLevelName((eLogLevel)gameLog.m_debuggerLevel.load()), GetLevelName((eLogLevel)gameLog.m_consoleLevel.load()), categories.c_str()));
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("%llu records written to %s, %llu dropped", (unsigned long long)numRecords, gameLog.m_filePath.c_str(), (unsigned long long)numDropped));
+	return succeeded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// file defaults to this run's log, out to the same path with .txt after it
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameLog::Command_DecodeLog(EventArgs& args)
+{
+	std::string logPath = args.GetValue("file", g_gameLog->m_filePath);
+	std::string textPath = args.GetValue("out", logPath + ".txt");
+
+	if (logPath == g_gameLog->m_filePath)
+	{
+		g_gameLog->Flush();
+	}
+
+	std::string error;
+	if (!DecodeFile(logPath, textPath, error))
+	{
+		g_devConsole->PrintString(Rgba::RED, error);
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Decoded %s to %s", logPath.c_str(), textPath.c_str()));
+	return true;
+}
@@ -0,0 +1,224 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Async/AsyncQueue.hpp"
+//Others
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogLevel
+{
+	LOG_TRACE,
+	LOG_DEBUG,
+	LOG_INFO,
+	LOG_WARNING,
+	LOG_ERROR,
+
+	NUM_LOG_LEVELS
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogCategory
+{
+	LOG_CATEGORY_CORE,
+	LOG_CATEGORY_MEMORY,
+	LOG_CATEGORY_ASSETS,
+	LOG_CATEGORY_AUDIO,
+	LOG_CATEGORY_GAMEPLAY,
+	LOG_CATEGORY_RENDER,
+
+	NUM_LOG_CATEGORIES
+};
+
+enum eLogArgType : uint8_t
+{
+	LOG_ARG_INT,
+	LOG_ARG_UINT,
+	LOG_ARG_FLOAT,
+	LOG_ARG_TEXT			//Copied into the record's text, m_textOffset into it
+};
+
+constexpr uint MAX_LOG_ARGS = 8U;
+constexpr uint LOG_RECORD_TEXT_BYTES = 64U;
+constexpr uint LOG_RING_SIZE = 512U;		//Records per thread, a power of two
+
+//------------------------------------------------------------------------------------------------------------------------------
+union LogArg
+{
+	int64_t					m_int;
+	uint64_t				m_uint;
+	double					m_float;
+	uint					m_textOffset;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One call's arguments, unformatted. The format is only kept by pointer so it has to be a string literal, strings passed
+// as arguments are copied and cut off at whatever text is left
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogRecord
+{
+	const char*				m_format = nullptr;
+	double					m_time = 0.0;
+	uint8_t					m_level = LOG_INFO;
+	uint8_t					m_category = LOG_CATEGORY_CORE;
+	uint8_t					m_threadIndex = 0U;
+	uint8_t					m_numArgs = 0U;
+	uint					m_textSize = 0U;
+	uint8_t					m_argTypes[MAX_LOG_ARGS];
+	LogArg					m_args[MAX_LOG_ARGS];
+	char					m_text[LOG_RECORD_TEXT_BYTES];
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Written only by its thread and read only by the log writer. A full ring drops the record and counts it rather than
+// waiting on the writer
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogRing
+{
+	LogRecord				m_records[LOG_RING_SIZE];
+	std::atomic<uint>		m_head { 0U };
+	std::atomic<uint>		m_tail { 0U };
+	std::atomic<uint>		m_numDropped { 0U };
+	uint					m_threadIndex = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogConsoleLine
+{
+	eLogLevel				m_level = LOG_INFO;
+	std::string				m_text;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Filling in a record
+//------------------------------------------------------------------------------------------------------------------------------
+void						PackLogInt(LogRecord& record, int64_t value);
+void						PackLogUint(LogRecord& record, uint64_t value);
+void						PackLogFloat(LogRecord& record, double value);
+void						PackLogText(LogRecord& record, const char* text);
+
+inline void					PackLogArg(LogRecord& record, int value) { PackLogInt(record, (int64_t)value); }
+inline void					PackLogArg(LogRecord& record, long value) { PackLogInt(record, (int64_t)value); }
+inline void					PackLogArg(LogRecord& record, long long value) { PackLogInt(record, (int64_t)value); }
+inline void					PackLogArg(LogRecord& record, unsigned int value) { PackLogUint(record, (uint64_t)value); }
+inline void					PackLogArg(LogRecord& record, unsigned long value) { PackLogUint(record, (uint64_t)value); }
+inline void					PackLogArg(LogRecord& record, unsigned long long value) { PackLogUint(record, (uint64_t)value); }
+inline void					PackLogArg(LogRecord& record, float value) { PackLogFloat(record, (double)value); }
+inline void					PackLogArg(LogRecord& record, double value) { PackLogFloat(record, value); }
+inline void					PackLogArg(LogRecord& record, const char* text) { PackLogText(record, text); }
+inline void					PackLogArg(LogRecord& record, const std::string& text) { PackLogText(record, text.c_str()); }
+
+inline void					PackLogArgs(LogRecord& record) { UNUSED(record); }
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T, typename... Rest>
+void PackLogArgs(LogRecord& record, const T& arg, const Rest&... rest)
+{
+	PackLogArg(record, arg);
+	PackLogArgs(record, rest...);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Levels and categories are checked at the call before anything is copied. Records go into the calling thread's ring and
+// a background thread drains the rings, appends every record to a binary log and only formats the ones echoed to the
+// debugger or the dev console. Console lines go to the main thread to print in Update, the console isn't thread safe.
+// The binary log stores each format string once and the arguments raw, DecodeFile turns one back into text afterwards
+//------------------------------------------------------------------------------------------------------------------------------
+class GameLog
+{
+public:
+	GameLog();
+	~GameLog();
+
+	void					StartUp(const std::string& filePath);
+	void					LoadLevelsFromConfig();
+	void					Update();
+	void					Flush();
+
+	template <typename... Args>
+	void					Log(eLogLevel level, eLogCategory category, const char* format, const Args&... args);
+
+	inline bool				IsEnabled(eLogLevel level, eLogCategory category) const { return level >= m_level.load(std::memory_order_relaxed) && (m_categoryMask.load(std::memory_order_relaxed) & (1U << category)) != 0U; }
+	void					SetLevel(eLogLevel level);
+	void					SetDebuggerLevel(eLogLevel level);
+	void					SetConsoleLevel(eLogLevel level);
+	void					SetCategoryEnabled(eLogCategory category, bool isEnabled);
+
+	static const char*		GetLevelName(eLogLevel level);
+	static const char*		GetCategoryName(eLogCategory category);
+	static bool				FindLevel(const std::string& name, eLogLevel& outLevel);
+	static bool				FindCategory(const std::string& name, eLogCategory& outCategory);
+
+	static std::string		FormatRecord(const LogRecord& record);
+	static std::string		FormatLine(const LogRecord& record);
+	static bool				DecodeFile(const std::string& logPath, const std::string& textPath, std::string& outError);
+
+	static bool				Command_Log(EventArgs& args);
+	static bool				Command_DecodeLog(EventArgs& args);
+
+private:
+	LogRecord*				BeginRecord(eLogLevel level, eLogCategory category, const char* format);
+	void					CommitRecord();
+	LogRing*				GetThreadRing();
+
+	void					WriterThreadMain();
+	void					DrainRings();
+	void					WriteRecord(const LogRecord& record);
+	void					WriteDropped(uint threadIndex, uint numDropped);
+	uint					GetFormatID(const char* format);
+
+private:
+	std::atomic<int>				m_level { LOG_DEBUG };
+	std::atomic<int>				m_debuggerLevel { LOG_INFO };
+	std::atomic<int>				m_consoleLevel { LOG_WARNING };
+	std::atomic<uint>				m_categoryMask { 0xFFFFFFFFU };
+	double							m_startTime = 0.0;
+
+	static std::atomic<uint>		s_nextGeneration;
+	const uint						m_generation;			//Unique per log made, tells threads their cached ring is stale
+
+	std::mutex						m_ringLock;
+	std::vector<LogRing*>			m_rings;
+
+	//Writer side, only touched while holding the drain lock
+	std::mutex						m_drainLock;
+	FILE*							m_file = nullptr;
+	std::string						m_filePath;
+	std::map<const char*, uint>		m_formatIDs;
+	std::vector<uint8_t>			m_writeBytes;			//Everything drained in one pass, written at once
+	uint64_t						m_numRecords = 0U;
+	uint64_t						m_numDropped = 0U;
+
+	std::thread						m_writerThread;
+	std::atomic<bool>				m_isRunning { false };
+	std::mutex						m_sleepLock;
+	std::condition_variable			m_wakeCondition;
+
+	AsyncQueue<LogConsoleLine>		m_consoleLines;		//Formatted by the writer, printed by the main thread
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename... Args>
+void GameLog::Log(eLogLevel level, eLogCategory category, const char* format, const Args&... args)
+{
+	if (!IsEnabled(level, category))
+		return;
+
+	LogRecord* record = BeginRecord(level, category, format);
+	if (record == nullptr)
+		return;
+
+	PackLogArgs(*record, args...);
+	CommitRecord();
+}
+
+extern GameLog* g_gameLog;
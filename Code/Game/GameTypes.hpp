@@ -15,5 +15,6 @@ enum ResourceMeshT
 	SOURCE,
 	BASE,
 	FULL,
-	WEAK
+	WEAK,
+	NUM_RESOURCE_MESHES
 };
\ No newline at end of file
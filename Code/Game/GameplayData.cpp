@@ -0,0 +1,846 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/GameplayData.hpp"
+//Engine Systems
+#include "Engine/Commons/ErrorWarningAssert.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+#include "Engine/Math/IntRange.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+//Others
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sys/stat.h>
+
+GameplayData* g_gameplayData = nullptr;
+
+static const char		GAMEPLAY_PACK_MAGIC[4] = { 'R', 'T', 'S', 'G' };
+static const uint		GAMEPLAY_TABLE_ALIGNMENT = 16U;
+static const char*		GAMEPLAY_ANIM_NAMES[NUM_GAMEPLAY_ANIM_TYPES] = { "idle", "walk", "death", "attack" };
+static const char*		GAMEPLAY_MESH_ATTRIBUTES[4] = { "src", "base", "full", "weak" };
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Everything compiled so far. Strings are interned as they are added so a path used by several units is stored once
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayPackBuilder
+{
+	uint								Intern(const std::string& text);
+
+	std::map<std::string, uint>			m_stringLookup;
+	std::vector<std::string>			m_strings;
+	std::vector<GameplayUnitRecord>		m_units;
+	std::vector<GameplayAnimRecord>		m_anims;
+	std::vector<GameplayModelListRecord>	m_modelLists;
+	std::vector<uint>					m_modelPaths;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint GameplayPackBuilder::Intern(const std::string& text)
+{
+	std::map<std::string, uint>::const_iterator found = m_stringLookup.find(text);
+	if (found != m_stringLookup.end())
+		return found->second;
+
+	uint stringIndex = (uint)m_strings.size();
+	m_strings.push_back(text);
+	m_stringLookup[text] = stringIndex;
+	return stringIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int64_t GetFileWriteTime(const std::string& filePath)
+{
+	struct stat fileInfo;
+	if (stat(filePath.c_str(), &fileInfo) != 0)
+		return -1;
+
+	return (int64_t)fileInfo.st_mtime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint AlignUp(uint value, uint alignment)
+{
+	return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string GetFolder(const std::string& filePath)
+{
+	size_t slash = filePath.find_last_of("/\\");
+	return slash == std::string::npos ? "" : filePath.substr(0, slash + 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsModelReadable(const std::string& modelPath)
+{
+	return std::ifstream(MODEL_PATH + modelPath).good();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Appends a table at the next aligned offset and returns where it starts
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static uint AppendTable(std::vector<unsigned char>& pack, const T* data, size_t count)
+{
+	uint offset = AlignUp((uint)pack.size(), GAMEPLAY_TABLE_ALIGNMENT);
+	pack.resize(offset + count * sizeof(T), 0U);
+	if (count > 0)
+	{
+		memcpy(pack.data() + offset, data, count * sizeof(T));
+	}
+	return offset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The highest sprite an animation reads from its sheet, laid out the way the Make*Cycle functions walk it
+//------------------------------------------------------------------------------------------------------------------------------
+static int GetLastSpriteIndex(const GameplayAnimRecord& anim)
+{
+	int lastIndex = (anim.m_spritesEachFrame - 1) * anim.m_spritesEachFrame + (anim.m_numFrames - 1);
+	if (anim.m_type == GAMEPLAY_ANIM_IDLE)
+	{
+		lastIndex += anim.m_idleColumn;
+	}
+	return lastIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool CompileAnimations(GameplayPackBuilder& builder, XMLElement& animSetElement, const std::string& unitPath, GameplayUnitRecord& unit, std::vector<std::string>& outErrors)
+{
+	size_t numErrors = outErrors.size();
+
+	std::string walkTexture = ParseXmlAttribute(animSetElement, "walkTexture", "");
+	std::string attackTexture = ParseXmlAttribute(animSetElement, "attackTexture", "");
+	Vec2 pivot = ParseXmlAttribute(animSetElement, "pivot", Vec2::ZERO);
+	IntVec2 dimensions = ParseXmlAttribute(animSetElement, "sheetDimensions", IntVec2::ZERO);
+
+	if (walkTexture == "" || attackTexture == "")
+	{
+		outErrors.push_back(unitPath + ": animset needs a walkTexture and an attackTexture");
+	}
+	if (dimensions.x <= 0 || dimensions.y <= 0)
+	{
+		outErrors.push_back(unitPath + ": animset sheetDimensions must be positive");
+	}
+
+	unit.m_walkTexture = builder.Intern(walkTexture);
+	unit.m_attackTexture = builder.Intern(attackTexture);
+	unit.m_sheetDimensions[0] = dimensions.x;
+	unit.m_sheetDimensions[1] = dimensions.y;
+	unit.m_pivot[0] = pivot.x;
+	unit.m_pivot[1] = pivot.y;
+	unit.m_firstAnim = (uint)builder.m_anims.size();
+
+	for (XMLElement* animElement = animSetElement.FirstChildElement(); animElement != nullptr; animElement = animElement->NextSiblingElement())
+	{
+		if (std::string(animElement->Name()) != "anim")
+		{
+			outErrors.push_back(Stringf("%s: unexpected <%s> in animset", unitPath.c_str(), animElement->Name()));
+			continue;
+		}
+
+		std::string animID = ParseXmlAttribute(*animElement, "id", "idle");
+		GameplayAnimRecord anim;
+		anim.m_type = NUM_GAMEPLAY_ANIM_TYPES;
+		for (uint animType = 0; animType < NUM_GAMEPLAY_ANIM_TYPES; animType++)
+		{
+			if (animID == GAMEPLAY_ANIM_NAMES[animType])
+			{
+				anim.m_type = animType;
+			}
+		}
+		if (anim.m_type == NUM_GAMEPLAY_ANIM_TYPES)
+		{
+			outErrors.push_back(unitPath + ": unknown animation " + animID);
+			continue;
+		}
+
+		IntRange deathColumns = ParseXmlAttribute(*animElement, "deathColumn", IntRange(5, 7));
+		anim.m_numFrames = ParseXmlAttribute(*animElement, "numFrames", 1);
+		anim.m_spritesEachFrame = ParseXmlAttribute(*animElement, "spritesEachFrame", 8);
+		anim.m_animTime = ParseXmlAttribute(*animElement, "animTime", 1.f);
+		anim.m_idleColumn = ParseXmlAttribute(*animElement, "idleColumn", 5);
+		anim.m_deathColumnMin = deathColumns.minInt;
+		anim.m_deathColumnMax = deathColumns.maxInt;
+
+		if (anim.m_numFrames <= 0 || anim.m_spritesEachFrame <= 0 || anim.m_animTime <= 0.f)
+		{
+			outErrors.push_back(unitPath + ": " + animID + " needs positive numFrames, spritesEachFrame and animTime");
+			continue;
+		}
+
+		if (anim.m_type != GAMEPLAY_ANIM_DEATH && GetLastSpriteIndex(anim) >= dimensions.x * dimensions.y)
+		{
+			outErrors.push_back(Stringf("%s: %s reads sprite %d from a %dx%d sheet", unitPath.c_str(), animID.c_str(), GetLastSpriteIndex(anim), dimensions.x, dimensions.y));
+			continue;
+		}
+
+		builder.m_anims.push_back(anim);
+	}
+
+	unit.m_numAnims = (uint)builder.m_anims.size() - unit.m_firstAnim;
+	return outErrors.size() == numErrors;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool CompileModels(GameplayPackBuilder& builder, XMLElement& rootElement, const std::string& unitPath, GameplayUnitRecord& unit, std::vector<std::string>& outErrors)
+{
+	size_t numErrors = outErrors.size();
+	bool hasModel = false;
+
+	for (XMLElement* element = rootElement.FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string name = element->Name();
+		if (name == "collision")
+		{
+			unit.m_flags |= GAMEPLAY_UNIT_HAS_COLLISION;
+			unit.m_collisionRadius = ParseXmlAttribute(*element, "radius", 0.f);
+			if (unit.m_collisionRadius <= 0.f)
+			{
+				outErrors.push_back(unitPath + ": collision radius must be positive");
+			}
+		}
+		else if (name == "occupancy")
+		{
+			IntVec2 occupancy = ParseXmlAttribute(*element, "tilesXY", IntVec2::ZERO);
+			unit.m_flags |= GAMEPLAY_UNIT_HAS_OCCUPANCY;
+			unit.m_occupancy[0] = occupancy.x;
+			unit.m_occupancy[1] = occupancy.y;
+			if (occupancy.x <= 0 || occupancy.y <= 0)
+			{
+				outErrors.push_back(unitPath + ": occupancy tilesXY must be positive");
+			}
+		}
+		else if (name == "model")
+		{
+			hasModel = true;
+			for (uint meshIndex = 0; meshIndex < 4U; meshIndex++)
+			{
+				std::string meshPath = ParseXmlAttribute(*element, GAMEPLAY_MESH_ATTRIBUTES[meshIndex], "");
+				if (meshPath == "")
+					continue;
+
+				if (!IsModelReadable(meshPath))
+				{
+					outErrors.push_back(unitPath + ": can't read model " + meshPath);
+				}
+				unit.m_meshes[meshIndex] = builder.Intern(meshPath);
+			}
+
+			if (unit.m_meshes[0] == GAMEPLAY_NO_STRING)
+			{
+				outErrors.push_back(unitPath + ": model needs a src");
+			}
+		}
+		else
+		{
+			outErrors.push_back(unitPath + ": unexpected <" + name + ">");
+		}
+	}
+
+	if (!hasModel)
+	{
+		outErrors.push_back(unitPath + ": resources and buildings need a model");
+	}
+
+	return outErrors.size() == numErrors;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Same attributes and defaults Entity used to read straight from the XML
+//------------------------------------------------------------------------------------------------------------------------------
+static bool CompileUnit(GameplayPackBuilder& builder, const std::string& unitPath, std::vector<std::string>& outErrors)
+{
+	tinyxml2::XMLDocument unitDoc;
+	unitDoc.LoadFile(unitPath.c_str());
+	if (unitDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outErrors.push_back(unitPath + ": could not be read");
+		return false;
+	}
+
+	XMLElement* rootElement = unitDoc.RootElement();
+	std::string id = ParseXmlAttribute(*rootElement, "id", "");
+	if (std::string(rootElement->Name()) != "unit" || id == "")
+	{
+		outErrors.push_back(unitPath + ": root must be a <unit> with an id");
+		return false;
+	}
+
+	for (size_t unitIndex = 0; unitIndex < builder.m_units.size(); unitIndex++)
+	{
+		if (builder.m_strings[builder.m_units[unitIndex].m_id] == id)
+		{
+			outErrors.push_back(unitPath + ": id " + id + " is already used by " + builder.m_strings[builder.m_units[unitIndex].m_sourcePath]);
+			return false;
+		}
+	}
+
+	GameplayUnitRecord unit;
+	unit.m_sourcePath = builder.Intern(unitPath);
+	unit.m_id = builder.Intern(id);
+
+	bool isSelectable = ParseXmlAttribute(*rootElement, "selectable", true);
+	bool isResource = ParseXmlAttribute(*rootElement, "resource", true);
+	bool isBuilding = ParseXmlAttribute(*rootElement, "building", true);
+	unit.m_flags |= isSelectable ? GAMEPLAY_UNIT_SELECTABLE : 0U;
+	unit.m_flags |= isResource ? GAMEPLAY_UNIT_RESOURCE : 0U;
+	unit.m_flags |= isBuilding ? GAMEPLAY_UNIT_BUILDING : 0U;
+
+	size_t numErrors = outErrors.size();
+	if (rootElement->Attribute("health") != nullptr)
+	{
+		unit.m_flags |= GAMEPLAY_UNIT_HAS_HEALTH;
+		unit.m_health = ParseXmlAttribute(*rootElement, "health", 0.f);
+		if (unit.m_health <= 0.f)
+		{
+			outErrors.push_back(unitPath + ": health must be positive");
+		}
+	}
+	if (rootElement->Attribute("speed") != nullptr)
+	{
+		unit.m_flags |= GAMEPLAY_UNIT_HAS_SPEED;
+		unit.m_speed = ParseXmlAttribute(*rootElement, "speed", 0.f);
+		if (unit.m_speed < 0.f)
+		{
+			outErrors.push_back(unitPath + ": speed can't be negative");
+		}
+	}
+
+	if (!isResource && !isBuilding)
+	{
+		XMLElement* animSetElement = rootElement->FirstChildElement();
+		if (animSetElement == nullptr || std::string(animSetElement->Name()) != "animset" || animSetElement->NextSiblingElement() != nullptr)
+		{
+			outErrors.push_back(unitPath + ": units need exactly one animset");
+		}
+		else
+		{
+			CompileAnimations(builder, *animSetElement, unitPath, unit, outErrors);
+		}
+	}
+	else
+	{
+		CompileModels(builder, *rootElement, unitPath, unit, outErrors);
+	}
+
+	if (outErrors.size() != numErrors)
+		return false;
+
+	builder.m_units.push_back(unit);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool CompileModelList(GameplayPackBuilder& builder, const std::string& listPath, std::vector<std::string>& outErrors)
+{
+	tinyxml2::XMLDocument listDoc;
+	listDoc.LoadFile(listPath.c_str());
+	if (listDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outErrors.push_back(listPath + ": could not be read");
+		return false;
+	}
+
+	size_t numErrors = outErrors.size();
+	GameplayModelListRecord modelList;
+	modelList.m_sourcePath = builder.Intern(listPath);
+	modelList.m_firstPath = (uint)builder.m_modelPaths.size();
+
+	XMLElement* rootElement = listDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string modelPath = ParseXmlAttribute(*element, "path", "");
+		if (std::string(element->Name()) != "dataFile" || modelPath == "")
+		{
+			outErrors.push_back(listPath + ": entries must be <dataFile> with a path");
+		}
+		else if (!IsModelReadable(modelPath))
+		{
+			outErrors.push_back(listPath + ": can't read model " + modelPath);
+		}
+		else
+		{
+			builder.m_modelPaths.push_back(builder.Intern(modelPath));
+		}
+	}
+
+	modelList.m_numPaths = (uint)builder.m_modelPaths.size() - modelList.m_firstPath;
+	builder.m_modelLists.push_back(modelList);
+	return outErrors.size() == numErrors;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void SerializePack(const GameplayPackBuilder& builder, std::vector<unsigned char>& outPack)
+{
+	std::vector<uint> stringOffsets;
+	std::vector<char> stringData;
+	for (size_t stringIndex = 0; stringIndex < builder.m_strings.size(); stringIndex++)
+	{
+		const std::string& text = builder.m_strings[stringIndex];
+		stringOffsets.push_back((uint)stringData.size());
+		stringData.insert(stringData.end(), text.begin(), text.end());
+		stringData.push_back('\0');
+	}
+
+	GameplayPackHeader header;
+	memcpy(header.m_magic, GAMEPLAY_PACK_MAGIC, sizeof(header.m_magic));
+	header.m_version = GAMEPLAY_PACK_VERSION;
+	header.m_numUnits = (uint)builder.m_units.size();
+	header.m_numAnims = (uint)builder.m_anims.size();
+	header.m_numModelLists = (uint)builder.m_modelLists.size();
+	header.m_numModelPaths = (uint)builder.m_modelPaths.size();
+	header.m_numStrings = (uint)stringOffsets.size();
+	header.m_stringDataSize = (uint)stringData.size();
+
+	outPack.assign(sizeof(GameplayPackHeader), 0U);
+	header.m_unitsOffset = AppendTable(outPack, builder.m_units.data(), builder.m_units.size());
+	header.m_animsOffset = AppendTable(outPack, builder.m_anims.data(), builder.m_anims.size());
+	header.m_modelListsOffset = AppendTable(outPack, builder.m_modelLists.data(), builder.m_modelLists.size());
+	header.m_modelPathsOffset = AppendTable(outPack, builder.m_modelPaths.data(), builder.m_modelPaths.size());
+	header.m_stringOffsetsOffset = AppendTable(outPack, stringOffsets.data(), stringOffsets.size());
+	header.m_stringDataOffset = AppendTable(outPack, stringData.data(), stringData.size());
+	header.m_fileSize = (uint)outPack.size();
+	memcpy(outPack.data(), &header, sizeof(header));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint InternFrom(GameplayPackBuilder& builder, const GameplayData& current, uint stringIndex)
+{
+	return stringIndex == GAMEPLAY_NO_STRING ? GAMEPLAY_NO_STRING : builder.Intern(current.GetString(stringIndex));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Copies an unchanged unit over from the loaded data, its strings land in the new string table
+//------------------------------------------------------------------------------------------------------------------------------
+static void ImportUnit(GameplayPackBuilder& builder, const GameplayData& current, const GameplayUnitRecord& currentUnit)
+{
+	GameplayUnitRecord unit = currentUnit;
+	unit.m_sourcePath = InternFrom(builder, current, currentUnit.m_sourcePath);
+	unit.m_id = InternFrom(builder, current, currentUnit.m_id);
+	unit.m_walkTexture = InternFrom(builder, current, currentUnit.m_walkTexture);
+	unit.m_attackTexture = InternFrom(builder, current, currentUnit.m_attackTexture);
+	for (uint meshIndex = 0; meshIndex < 4U; meshIndex++)
+	{
+		unit.m_meshes[meshIndex] = InternFrom(builder, current, currentUnit.m_meshes[meshIndex]);
+	}
+
+	unit.m_firstAnim = (uint)builder.m_anims.size();
+	const GameplayAnimRecord* anims = current.GetAnims(currentUnit);
+	builder.m_anims.insert(builder.m_anims.end(), anims, anims + currentUnit.m_numAnims);
+	builder.m_units.push_back(unit);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void ImportModelList(GameplayPackBuilder& builder, const GameplayData& current, const GameplayModelListRecord& currentList)
+{
+	GameplayModelListRecord modelList = currentList;
+	modelList.m_sourcePath = InternFrom(builder, current, currentList.m_sourcePath);
+	modelList.m_firstPath = (uint)builder.m_modelPaths.size();
+	for (uint pathIndex = 0; pathIndex < currentList.m_numPaths; pathIndex++)
+	{
+		builder.m_modelPaths.push_back(builder.Intern(current.GetModelPath(currentList, pathIndex)));
+	}
+	builder.m_modelLists.push_back(modelList);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// <unit path/> and <modelList path/>, relative to the index. Units and lists are stored under their full path, the one the
+// game already knows them by
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayDataCompiler::Compile(const std::string& indexPath, std::vector<unsigned char>& outPack, std::vector<std::string>& outErrors)
+{
+	outErrors.clear();
+
+	tinyxml2::XMLDocument indexDoc;
+	indexDoc.LoadFile(indexPath.c_str());
+	if (indexDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outErrors.push_back(indexPath + ": could not be read");
+		return false;
+	}
+
+	std::string folder = GetFolder(indexPath);
+	GameplayPackBuilder builder;
+
+	XMLElement* rootElement = indexDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
+	{
+		std::string name = element->Name();
+		std::string path = folder + ParseXmlAttribute(*element, "path", "");
+		if (builder.m_stringLookup.find(path) != builder.m_stringLookup.end())
+		{
+			outErrors.push_back(indexPath + ": " + path + " is listed more than once");
+		}
+		else if (name == "unit")
+		{
+			CompileUnit(builder, path, outErrors);
+		}
+		else if (name == "modelList")
+		{
+			CompileModelList(builder, path, outErrors);
+		}
+		else
+		{
+			outErrors.push_back(indexPath + ": unexpected <" + name + ">");
+		}
+	}
+
+	if (!outErrors.empty())
+		return false;
+
+	SerializePack(builder, outPack);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayDataCompiler::CompileToFile(const std::string& indexPath, const std::string& packPath, std::vector<std::string>& outErrors)
+{
+	std::vector<unsigned char> pack;
+	if (!Compile(indexPath, pack, outErrors))
+		return false;
+
+	return WritePack(pack, packPath, outErrors);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayDataCompiler::WritePack(const std::vector<unsigned char>& pack, const std::string& packPath, std::vector<std::string>& outErrors)
+{
+	std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open() || !file.write((const char*)pack.data(), (std::streamsize)pack.size()))
+	{
+		outErrors.push_back("Could not write gameplay pack " + packPath);
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Records keep the order they had, so only the changed files move. A changed path that isn't in the current data is
+// ignored, adding a file means the index changed and that is a full compile
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayDataCompiler::Recompile(const GameplayData& current, const std::vector<std::string>& changedPaths, std::vector<unsigned char>& outPack, std::vector<std::string>& outErrors)
+{
+	outErrors.clear();
+	GameplayPackBuilder builder;
+
+	for (uint unitIndex = 0; unitIndex < current.GetNumUnits(); unitIndex++)
+	{
+		const GameplayUnitRecord& unit = current.GetUnit(unitIndex);
+		std::string unitPath = current.GetString(unit.m_sourcePath);
+		if (std::find(changedPaths.begin(), changedPaths.end(), unitPath) != changedPaths.end())
+		{
+			CompileUnit(builder, unitPath, outErrors);
+		}
+		else
+		{
+			ImportUnit(builder, current, unit);
+		}
+	}
+
+	for (uint listIndex = 0; listIndex < current.GetNumModelLists(); listIndex++)
+	{
+		const GameplayModelListRecord& modelList = current.GetModelList(listIndex);
+		std::string listPath = current.GetString(modelList.m_sourcePath);
+		if (std::find(changedPaths.begin(), changedPaths.end(), listPath) != changedPaths.end())
+		{
+			CompileModelList(builder, listPath, outErrors);
+		}
+		else
+		{
+			ImportModelList(builder, current, modelList);
+		}
+	}
+
+	if (!outErrors.empty())
+		return false;
+
+	SerializePack(builder, outPack);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Entities copy what they need when they spawn and the map reads its model lists on load, so swapping the data under a
+// running game only affects what is made from now on
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayDataCompiler::Command_CompileGameplayData(EventArgs& args)
+{
+	std::string indexPath = args.GetValue("index", GAMEPLAY_DATA_INDEX_PATH);
+	std::string packPath = args.GetValue("pack", GAMEPLAY_PACK_PATH);
+
+	std::vector<std::string> errors;
+	if (!CompileToFile(indexPath, packPath, errors))
+	{
+		for (size_t errorIndex = 0; errorIndex < errors.size(); errorIndex++)
+		{
+			g_devConsole->PrintString(Rgba::RED, errors[errorIndex]);
+		}
+		g_devConsole->PrintString(Rgba::RED, Stringf("Gameplay data not compiled, %u errors", (uint)errors.size()));
+		return false;
+	}
+
+	std::string error;
+	if (!g_gameplayData->LoadPack(packPath, error))
+	{
+		g_devConsole->PrintString(Rgba::RED, error);
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Compiled %s into %s", indexPath.c_str(), packPath.c_str()));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::Load(bool useXml, std::vector<std::string>& outErrors)
+{
+	outErrors.clear();
+
+	if (useXml)
+		return LoadFromXml(GAMEPLAY_DATA_INDEX_PATH, outErrors);
+
+	std::string error;
+	if (LoadPack(GAMEPLAY_PACK_PATH, error))
+	{
+		if (!IsOlderThanSources(GAMEPLAY_PACK_PATH))
+			return true;
+
+		error = "Gameplay pack is older than its XML";
+	}
+
+	DebuggerPrintf("%s, rebuilding it from %s\n", error.c_str(), GAMEPLAY_DATA_INDEX_PATH);
+	if (!GameplayDataCompiler::CompileToFile(GAMEPLAY_DATA_INDEX_PATH, GAMEPLAY_PACK_PATH, outErrors) || !LoadPack(GAMEPLAY_PACK_PATH, error))
+	{
+		outErrors.push_back(error);
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One read of the whole file, the records are used where they land
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::LoadPack(const std::string& packPath, std::string& outError)
+{
+	std::ifstream file(packPath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		outError = "Could not open gameplay pack " + packPath;
+		return false;
+	}
+
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	std::vector<unsigned char> pack((size_t)size);
+	if (size <= 0 || !file.read((char*)pack.data(), size))
+	{
+		outError = "Could not read gameplay pack " + packPath;
+		return false;
+	}
+
+	if (!AdoptPack(pack, outError))
+	{
+		outError = packPath + ": " + outError;
+		return false;
+	}
+
+	m_isFromXml = false;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::LoadFromXml(const std::string& indexPath, std::vector<std::string>& outErrors)
+{
+	std::vector<unsigned char> pack;
+	if (!GameplayDataCompiler::Compile(indexPath, pack, outErrors))
+		return false;
+
+	std::string error;
+	if (!AdoptPack(pack, error))
+	{
+		outErrors.push_back(error);
+		return false;
+	}
+
+	m_isFromXml = true;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::LoadRecompiled(const GameplayData& current, const std::vector<std::string>& changedPaths, std::vector<std::string>& outErrors)
+{
+	std::vector<unsigned char> pack;
+	if (!GameplayDataCompiler::Recompile(current, changedPaths, pack, outErrors))
+		return false;
+
+	std::string error;
+	if (!AdoptPack(pack, error))
+	{
+		outErrors.push_back(error);
+		return false;
+	}
+
+	m_isFromXml = current.m_isFromXml;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The index and every file compiled into the data, what a change has to be watched for in
+//------------------------------------------------------------------------------------------------------------------------------
+void GameplayData::GetSourcePaths(std::vector<std::string>& outPaths) const
+{
+	outPaths.clear();
+	outPaths.push_back(GAMEPLAY_DATA_INDEX_PATH);
+
+	for (uint unitIndex = 0; unitIndex < m_header->m_numUnits; unitIndex++)
+	{
+		outPaths.push_back(GetString(m_units[unitIndex].m_sourcePath));
+	}
+	for (uint listIndex = 0; listIndex < m_header->m_numModelLists; listIndex++)
+	{
+		outPaths.push_back(GetString(m_modelLists[listIndex].m_sourcePath));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::IsOlderThanSources(const std::string& filePath) const
+{
+	int64_t fileTime = GetFileWriteTime(filePath);
+
+	std::vector<std::string> sourcePaths;
+	GetSourcePaths(sourcePaths);
+	for (size_t pathIndex = 0; pathIndex < sourcePaths.size(); pathIndex++)
+	{
+		if (GetFileWriteTime(sourcePaths[pathIndex]) > fileTime)
+			return true;
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Checks every table fits and every string and range a record holds points inside the pack. Only then is it swapped in,
+// a bad pack leaves whatever was loaded before untouched
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayData::AdoptPack(std::vector<unsigned char>& pack, std::string& outError)
+{
+	size_t size = pack.size();
+	const unsigned char* data = pack.data();
+	const GameplayPackHeader* header = (const GameplayPackHeader*)data;
+
+	if (size < sizeof(GameplayPackHeader) || memcmp(header->m_magic, GAMEPLAY_PACK_MAGIC, sizeof(GAMEPLAY_PACK_MAGIC)) != 0
+		|| header->m_version != GAMEPLAY_PACK_VERSION || header->m_fileSize != size)
+	{
+		outError = "not a current gameplay pack";
+		return false;
+	}
+
+	bool isValid = (uint64_t)header->m_unitsOffset + (uint64_t)header->m_numUnits * sizeof(GameplayUnitRecord) <= size
+		&& (uint64_t)header->m_animsOffset + (uint64_t)header->m_numAnims * sizeof(GameplayAnimRecord) <= size
+		&& (uint64_t)header->m_modelListsOffset + (uint64_t)header->m_numModelLists * sizeof(GameplayModelListRecord) <= size
+		&& (uint64_t)header->m_modelPathsOffset + (uint64_t)header->m_numModelPaths * sizeof(uint) <= size
+		&& (uint64_t)header->m_stringOffsetsOffset + (uint64_t)header->m_numStrings * sizeof(uint) <= size
+		&& (uint64_t)header->m_stringDataOffset + header->m_stringDataSize <= size
+		&& header->m_stringDataSize > 0U && data[header->m_stringDataOffset + header->m_stringDataSize - 1U] == '\0'
+		&& header->m_unitsOffset % GAMEPLAY_TABLE_ALIGNMENT == 0U && header->m_animsOffset % GAMEPLAY_TABLE_ALIGNMENT == 0U
+		&& header->m_modelListsOffset % GAMEPLAY_TABLE_ALIGNMENT == 0U && header->m_modelPathsOffset % GAMEPLAY_TABLE_ALIGNMENT == 0U
+		&& header->m_stringOffsetsOffset % GAMEPLAY_TABLE_ALIGNMENT == 0U;
+
+	const GameplayUnitRecord* units = (const GameplayUnitRecord*)(data + header->m_unitsOffset);
+	const GameplayModelListRecord* modelLists = (const GameplayModelListRecord*)(data + header->m_modelListsOffset);
+	const uint* modelPaths = (const uint*)(data + header->m_modelPathsOffset);
+	const uint* stringOffsets = (const uint*)(data + header->m_stringOffsetsOffset);
+	uint numStrings = header->m_numStrings;
+
+	for (uint stringIndex = 0; isValid && stringIndex < numStrings; stringIndex++)
+	{
+		isValid = stringOffsets[stringIndex] < header->m_stringDataSize;
+	}
+
+	for (uint unitIndex = 0; isValid && unitIndex < header->m_numUnits; unitIndex++)
+	{
+		const GameplayUnitRecord& unit = units[unitIndex];
+		isValid = unit.m_sourcePath < numStrings && unit.m_id < numStrings
+			&& (uint64_t)unit.m_firstAnim + unit.m_numAnims <= header->m_numAnims
+			&& (unit.m_walkTexture < numStrings || unit.m_walkTexture == GAMEPLAY_NO_STRING)
+			&& (unit.m_attackTexture < numStrings || unit.m_attackTexture == GAMEPLAY_NO_STRING);
+
+		for (uint meshIndex = 0; isValid && meshIndex < 4U; meshIndex++)
+		{
+			isValid = unit.m_meshes[meshIndex] < numStrings || unit.m_meshes[meshIndex] == GAMEPLAY_NO_STRING;
+		}
+	}
+
+	for (uint listIndex = 0; isValid && listIndex < header->m_numModelLists; listIndex++)
+	{
+		isValid = modelLists[listIndex].m_sourcePath < numStrings
+			&& (uint64_t)modelLists[listIndex].m_firstPath + modelLists[listIndex].m_numPaths <= header->m_numModelPaths;
+	}
+
+	for (uint pathIndex = 0; isValid && pathIndex < header->m_numModelPaths; pathIndex++)
+	{
+		isValid = modelPaths[pathIndex] < numStrings;
+	}
+
+	if (!isValid)
+	{
+		outError = "gameplay pack is damaged";
+		return false;
+	}
+
+	m_pack.swap(pack);
+	data = m_pack.data();
+	m_header = (const GameplayPackHeader*)data;
+	m_units = (const GameplayUnitRecord*)(data + m_header->m_unitsOffset);
+	m_anims = (const GameplayAnimRecord*)(data + m_header->m_animsOffset);
+	m_modelLists = (const GameplayModelListRecord*)(data + m_header->m_modelListsOffset);
+	m_modelPaths = (const uint*)(data + m_header->m_modelPathsOffset);
+	m_stringOffsets = (const uint*)(data + m_header->m_stringOffsetsOffset);
+	m_stringData = (const char*)(data + m_header->m_stringDataOffset);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A handful of records, a straight scan beats building a lookup
+//------------------------------------------------------------------------------------------------------------------------------
+const GameplayUnitRecord* GameplayData::FindUnit(const std::string& sourcePath) const
+{
+	for (uint unitIndex = 0; unitIndex < m_header->m_numUnits; unitIndex++)
+	{
+		if (sourcePath == GetString(m_units[unitIndex].m_sourcePath))
+			return &m_units[unitIndex];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const GameplayModelListRecord* GameplayData::FindModelList(const std::string& sourcePath) const
+{
+	for (uint listIndex = 0; listIndex < m_header->m_numModelLists; listIndex++)
+	{
+		if (sourcePath == GetString(m_modelLists[listIndex].m_sourcePath))
+			return &m_modelLists[listIndex];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* GameplayData::GetModelPath(const GameplayModelListRecord& modelList, uint pathIndex) const
+{
+	return GetString(m_modelPaths[modelList.m_firstPath + pathIndex]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* GameplayData::GetString(uint stringIndex) const
+{
+	if (stringIndex == GAMEPLAY_NO_STRING)
+		return "";
+
+	return m_stringData + m_stringOffsets[stringIndex];
+}
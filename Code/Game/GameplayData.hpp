@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Bump whenever a record changes, an old pack is then refused and rebuilt from the XML
+constexpr uint GAMEPLAY_PACK_VERSION = 1U;
+constexpr uint GAMEPLAY_NO_STRING = 0xFFFFFFFFU;
+
+constexpr const char* GAMEPLAY_DATA_INDEX_PATH = "Data/Gameplay/gameplay_data.xml";
+constexpr const char* GAMEPLAY_PACK_PATH = "Data/Gameplay/gameplay.pack";
+
+class GameplayData;
+
+//Last write time of a file, -1 when it can't be found
+int64_t GetFileWriteTime(const std::string& filePath);
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eGameplayUnitFlags : uint
+{
+	GAMEPLAY_UNIT_SELECTABLE = BIT_FLAG(0),
+	GAMEPLAY_UNIT_RESOURCE = BIT_FLAG(1),
+	GAMEPLAY_UNIT_BUILDING = BIT_FLAG(2),
+
+	//Left out of the XML means the entity keeps its own default
+	GAMEPLAY_UNIT_HAS_HEALTH = BIT_FLAG(3),
+	GAMEPLAY_UNIT_HAS_SPEED = BIT_FLAG(4),
+	GAMEPLAY_UNIT_HAS_COLLISION = BIT_FLAG(5),
+	GAMEPLAY_UNIT_HAS_OCCUPANCY = BIT_FLAG(6)
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eGameplayAnimType : uint
+{
+	GAMEPLAY_ANIM_IDLE,
+	GAMEPLAY_ANIM_WALK,
+	GAMEPLAY_ANIM_DEATH,
+	GAMEPLAY_ANIM_ATTACK,
+
+	NUM_GAMEPLAY_ANIM_TYPES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every field is filled in, the defaults the XML parse used to apply are applied by the compiler
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayAnimRecord
+{
+	uint			m_type = GAMEPLAY_ANIM_IDLE;
+	int				m_numFrames = 1;
+	int				m_spritesEachFrame = 8;
+	float			m_animTime = 1.f;
+	int				m_idleColumn = 5;
+	int				m_deathColumnMin = 5;
+	int				m_deathColumnMax = 7;
+	uint			m_padding = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Strings are indices into the pack's string table. Sprite fields are only set for units, mesh fields only for
+// resources and buildings
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayUnitRecord
+{
+	uint			m_sourcePath = GAMEPLAY_NO_STRING;		//The XML it was compiled from, which is what it is looked up by
+	uint			m_id = GAMEPLAY_NO_STRING;
+	uint			m_flags = 0U;
+	float			m_health = 0.f;
+	float			m_speed = 0.f;
+	float			m_collisionRadius = 0.f;
+	int				m_occupancy[2] = { 0, 0 };
+
+	uint			m_meshes[4] = { GAMEPLAY_NO_STRING, GAMEPLAY_NO_STRING, GAMEPLAY_NO_STRING, GAMEPLAY_NO_STRING };	//src, base, full, weak
+
+	uint			m_walkTexture = GAMEPLAY_NO_STRING;
+	uint			m_attackTexture = GAMEPLAY_NO_STRING;
+	int				m_sheetDimensions[2] = { 0, 0 };
+	float			m_pivot[2] = { 0.f, 0.f };
+	uint			m_firstAnim = 0U;
+	uint			m_numAnims = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayModelListRecord
+{
+	uint			m_sourcePath = GAMEPLAY_NO_STRING;
+	uint			m_firstPath = 0U;						//Into the model path table, each entry a string
+	uint			m_numPaths = 0U;
+	uint			m_padding = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Header, then each table 16 byte aligned: units, anims, model lists, model paths, string offsets, string data. Strings
+// are null terminated and every distinct string is stored once
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayPackHeader
+{
+	char			m_magic[4];
+	uint			m_version = 0U;
+	uint			m_fileSize = 0U;
+
+	uint			m_numUnits = 0U;
+	uint			m_unitsOffset = 0U;
+	uint			m_numAnims = 0U;
+	uint			m_animsOffset = 0U;
+	uint			m_numModelLists = 0U;
+	uint			m_modelListsOffset = 0U;
+	uint			m_numModelPaths = 0U;
+	uint			m_modelPathsOffset = 0U;
+
+	uint			m_numStrings = 0U;
+	uint			m_stringOffsetsOffset = 0U;
+	uint			m_stringDataOffset = 0U;
+	uint			m_stringDataSize = 0U;
+	uint			m_padding = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Validates every unit and model list the index names and writes them into one pack. Every problem is reported, not just
+// the first, and nothing is written unless the whole set is valid
+//------------------------------------------------------------------------------------------------------------------------------
+class GameplayDataCompiler
+{
+public:
+	static bool				Compile(const std::string& indexPath, std::vector<unsigned char>& outPack, std::vector<std::string>& outErrors);
+	static bool				CompileToFile(const std::string& indexPath, const std::string& packPath, std::vector<std::string>& outErrors);
+	static bool				WritePack(const std::vector<unsigned char>& pack, const std::string& packPath, std::vector<std::string>& outErrors);
+
+	//Re-parses only the changed unit and model list files, everything else is copied over from the current data
+	static bool				Recompile(const GameplayData& current, const std::vector<std::string>& changedPaths, std::vector<unsigned char>& outPack, std::vector<std::string>& outErrors);
+
+	static bool				Command_CompileGameplayData(EventArgs& args);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The unit, building, tree and model definitions the game runs on. Normally the pack is read in one go and used in place;
+// with gameplayData="xml" in GameConfig the XML is compiled in memory on every boot instead, so mods don't need the
+// compiler. A missing or outdated pack is rebuilt from the XML
+//------------------------------------------------------------------------------------------------------------------------------
+class GameplayData
+{
+public:
+	bool							Load(bool useXml, std::vector<std::string>& outErrors);
+	bool							LoadPack(const std::string& packPath, std::string& outError);
+	bool							LoadFromXml(const std::string& indexPath, std::vector<std::string>& outErrors);
+	bool							LoadRecompiled(const GameplayData& current, const std::vector<std::string>& changedPaths, std::vector<std::string>& outErrors);
+
+	void							GetSourcePaths(std::vector<std::string>& outPaths) const;
+	bool							IsOlderThanSources(const std::string& filePath) const;
+	inline bool						IsFromXml() const { return m_isFromXml; }
+	inline const std::vector<unsigned char>&	GetPack() const { return m_pack; }
+
+	const GameplayUnitRecord*		FindUnit(const std::string& sourcePath) const;
+	const GameplayModelListRecord*	FindModelList(const std::string& sourcePath) const;
+
+	inline uint						GetNumUnits() const { return m_header->m_numUnits; }
+	inline const GameplayUnitRecord&	GetUnit(uint unitIndex) const { return m_units[unitIndex]; }
+	inline uint						GetNumModelLists() const { return m_header->m_numModelLists; }
+	inline const GameplayModelListRecord&	GetModelList(uint listIndex) const { return m_modelLists[listIndex]; }
+
+	inline const GameplayAnimRecord*	GetAnims(const GameplayUnitRecord& unit) const { return m_anims + unit.m_firstAnim; }
+	const char*						GetModelPath(const GameplayModelListRecord& modelList, uint pathIndex) const;
+	const char*						GetString(uint stringIndex) const;
+
+private:
+	bool							AdoptPack(std::vector<unsigned char>& pack, std::string& outError);
+
+private:
+	std::vector<unsigned char>		m_pack;
+	const GameplayPackHeader*		m_header = nullptr;
+	const GameplayUnitRecord*		m_units = nullptr;
+	const GameplayAnimRecord*		m_anims = nullptr;
+	const GameplayModelListRecord*	m_modelLists = nullptr;
+	const uint*						m_modelPaths = nullptr;
+	const uint*						m_stringOffsets = nullptr;
+	const char*						m_stringData = nullptr;
+	bool							m_isFromXml = false;
+};
+
+extern GameplayData* g_gameplayData;
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/GameplayHotReload.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/Time.hpp"
+//Game Systems
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+//Others
+#include <algorithm>
+#include <cstring>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Reloads whatever changed since the last check, all=true reloads every definition file
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool GameplayHotReload::Command_ReloadGameplayData(EventArgs& args)
+{
+	bool reloadAll = args.GetValue("all", false);
+	return Game::s_gameReference->m_gameplayHotReload.ReloadChanged(reloadAll);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameplayHotReload::StartWatching()
+{
+	g_gameplayData->GetSourcePaths(m_watchedPaths);
+
+	m_writeTimes.clear();
+	for (size_t pathIndex = 0; pathIndex < m_watchedPaths.size(); pathIndex++)
+	{
+		m_writeTimes.push_back(GetFileWriteTime(m_watchedPaths[pathIndex]));
+	}
+
+	//Decided by how the game booted, reloads compile from the XML either way
+	if (!m_isWatching)
+	{
+		m_writesPack = !g_gameplayData->IsFromXml();
+	}
+
+	m_pollTimer = 0.f;
+	m_isWatching = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GameplayHotReload::Update(float deltaTime)
+{
+	if (!m_isWatching)
+		return;
+
+	m_pollTimer += deltaTime;
+	if (m_pollTimer < GAMEPLAY_HOT_RELOAD_POLL_SECONDS)
+		return;
+
+	m_pollTimer = 0.f;
+	ReloadChanged(false);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Write times are taken when a change is seen, not when it loads, so a file saved with a mistake is reported once and
+// picked up again on the next save
+//------------------------------------------------------------------------------------------------------------------------------
+void GameplayHotReload::FindChangedPaths(std::vector<std::string>& outPaths)
+{
+	outPaths.clear();
+
+	for (size_t pathIndex = 0; pathIndex < m_watchedPaths.size(); pathIndex++)
+	{
+		int64_t writeTime = GetFileWriteTime(m_watchedPaths[pathIndex]);
+		if (writeTime != m_writeTimes[pathIndex])
+		{
+			m_writeTimes[pathIndex] = writeTime;
+			outPaths.push_back(m_watchedPaths[pathIndex]);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Entities are made differently for units, resources and buildings, so switching between those needs a new entity and
+// is refused. Strings are compared by value, the two sets of data don't share string tables
+//------------------------------------------------------------------------------------------------------------------------------
+void GameplayHotReload::FindDefinitionChanges(const GameplayData& reloaded, const std::vector<std::string>& changedPaths, std::vector<GameplayDefinitionChange>& outChanges, std::vector<std::string>& outErrors) const
+{
+	const uint kindFlags = GAMEPLAY_UNIT_RESOURCE | GAMEPLAY_UNIT_BUILDING;
+
+	for (size_t pathIndex = 0; pathIndex < changedPaths.size(); pathIndex++)
+	{
+		const GameplayUnitRecord* previous = g_gameplayData->FindUnit(changedPaths[pathIndex]);
+		const GameplayUnitRecord* unit = reloaded.FindUnit(changedPaths[pathIndex]);
+		if (previous == nullptr || unit == nullptr)
+			continue;
+
+		if ((previous->m_flags & kindFlags) != (unit->m_flags & kindFlags))
+		{
+			outErrors.push_back(changedPaths[pathIndex] + ": resource and building can't change without a restart");
+			continue;
+		}
+
+		GameplayDefinitionChange change;
+		change.m_sourcePath = changedPaths[pathIndex];
+		change.m_previous = *previous;
+
+		change.m_animationsChanged = previous->m_numAnims != unit->m_numAnims
+			|| previous->m_sheetDimensions[0] != unit->m_sheetDimensions[0] || previous->m_sheetDimensions[1] != unit->m_sheetDimensions[1]
+			|| strcmp(g_gameplayData->GetString(previous->m_walkTexture), reloaded.GetString(unit->m_walkTexture)) != 0
+			|| strcmp(g_gameplayData->GetString(previous->m_attackTexture), reloaded.GetString(unit->m_attackTexture)) != 0
+			|| (unit->m_numAnims > 0U && memcmp(g_gameplayData->GetAnims(*previous), reloaded.GetAnims(*unit), unit->m_numAnims * sizeof(GameplayAnimRecord)) != 0);
+
+		for (uint meshIndex = 0; meshIndex < 4U; meshIndex++)
+		{
+			change.m_meshesChanged |= strcmp(g_gameplayData->GetString(previous->m_meshes[meshIndex]), reloaded.GetString(unit->m_meshes[meshIndex])) != 0;
+		}
+
+		outChanges.push_back(change);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool GameplayHotReload::ReloadChanged(bool reloadAll)
+{
+	double startTime = GetCurrentTimeSeconds();
+
+	std::vector<std::string> changedPaths;
+	FindChangedPaths(changedPaths);
+	if (reloadAll)
+	{
+		changedPaths = m_watchedPaths;
+	}
+
+	if (changedPaths.empty())
+		return true;
+
+	//A new index can add or drop files, so everything is compiled again and watched afresh
+	bool isIndexChanged = std::find(changedPaths.begin(), changedPaths.end(), GAMEPLAY_DATA_INDEX_PATH) != changedPaths.end();
+
+	std::vector<std::string> errors;
+	GameplayData* reloaded = new GameplayData();
+	bool result = isIndexChanged ? reloaded->LoadFromXml(GAMEPLAY_DATA_INDEX_PATH, errors) : reloaded->LoadRecompiled(*g_gameplayData, changedPaths, errors);
+	if (result && isIndexChanged)
+	{
+		reloaded->GetSourcePaths(changedPaths);
+	}
+
+	std::vector<GameplayDefinitionChange> changes;
+	if (result)
+	{
+		FindDefinitionChanges(*reloaded, changedPaths, changes, errors);
+	}
+
+	if (!errors.empty())
+	{
+		for (size_t errorIndex = 0; errorIndex < errors.size(); errorIndex++)
+		{
+			g_devConsole->PrintString(Rgba::RED, errors[errorIndex]);
+		}
+		g_devConsole->PrintString(Rgba::RED, Stringf("Gameplay data not reloaded, %u errors", (uint)errors.size()));
+
+		delete reloaded;
+		return false;
+	}
+
+	if (m_writesPack && !GameplayDataCompiler::WritePack(reloaded->GetPack(), GAMEPLAY_PACK_PATH, errors))
+	{
+		g_devConsole->PrintString(Rgba::YELLOW, errors.back());
+	}
+
+	delete g_gameplayData;
+	g_gameplayData = reloaded;
+
+	//Without a map there is nothing live to patch, the next spawn reads the new data
+	uint numEntities = 0U;
+	uint numAnimationSets = 0U;
+	Map* map = Game::s_gameReference->m_map;
+	if (map != nullptr)
+	{
+		numEntities = map->ApplyDefinitionChanges(changes, numAnimationSets);
+
+		for (size_t pathIndex = 0; pathIndex < changedPaths.size(); pathIndex++)
+		{
+			if (g_gameplayData->FindModelList(changedPaths[pathIndex]) != nullptr)
+			{
+				map->LoadModelList(changedPaths[pathIndex]);
+			}
+		}
+	}
+
+	if (isIndexChanged)
+	{
+		StartWatching();
+	}
+
+	double reloadMilliseconds = (GetCurrentTimeSeconds() - startTime) * 1000.0;
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Reloaded %u gameplay files in %.2f ms: %u entities patched, %u animation sets rebuilt",
+		(uint)changedPaths.size(), reloadMilliseconds, numEntities, numAnimationSets));
+	return true;
+}
@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/GameplayData.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//How often the definition files are checked for a new write time
+constexpr float GAMEPLAY_HOT_RELOAD_POLL_SECONDS = 0.5f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One reloaded unit definition, with the record it replaces so live entities can scale what they hold and skip
+// rebuilding what didn't change
+//------------------------------------------------------------------------------------------------------------------------------
+struct GameplayDefinitionChange
+{
+	std::string				m_sourcePath;
+	GameplayUnitRecord		m_previous;
+	bool					m_animationsChanged = false;
+	bool					m_meshesChanged = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Watches the files the gameplay data was compiled from. When some change only those are parsed again, the rest of the
+// data is carried over, and the entities made from them are patched in place so a match keeps running. A reload with an
+// error leaves everything as it was
+//------------------------------------------------------------------------------------------------------------------------------
+class GameplayHotReload
+{
+public:
+	static bool					Command_ReloadGameplayData(EventArgs& args);
+
+	void						StartWatching();
+	void						Update(float deltaTime);
+	bool						ReloadChanged(bool reloadAll);
+
+private:
+	void						FindChangedPaths(std::vector<std::string>& outPaths);
+	void						FindDefinitionChanges(const GameplayData& reloaded, const std::vector<std::string>& changedPaths, std::vector<GameplayDefinitionChange>& outChanges, std::vector<std::string>& outErrors) const;
+
+private:
+	std::vector<std::string>	m_watchedPaths;
+	std::vector<int64_t>		m_writeTimes;
+	float						m_pollTimer = 0.f;
+	bool						m_isWatching = false;
+	bool						m_writesPack = false;		//Pack mode keeps the pack on disk in step with the XML
+};
@@ -0,0 +1,341 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/JobSystem.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/Time.hpp"
+
+JobSystem* g_jobSystem = nullptr;
+
+//Index of the worker running on this thread, -1 for the main thread
+static thread_local int s_workerIndex = -1;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const char* GetJobCategoryName(JobCategoryT category)
+{
+	switch (category)
+	{
+	case JOB_CATEGORY_LOADING:		return "Loading";
+	case JOB_CATEGORY_PATHING:		return "Pathing";
+	case JOB_CATEGORY_VISIBILITY:	return "Visibility";
+	case JOB_CATEGORY_SIMULATION:	return "Simulation";
+	case JOB_CATEGORY_RENDERING:	return "Rendering";
+	default:						return "Unknown";
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobSystem::JobSystem()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	ShutDown();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool JobSystem::Command_JobStats(EventArgs& args)
+{
+	if (g_jobSystem == nullptr)
+	{
+		return false;
+	}
+
+	g_jobSystem->PrintStats();
+
+	bool reset = args.GetValue("reset", false);
+	if (reset)
+	{
+		g_jobSystem->ResetStats();
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::StartUp(int numWorkers)
+{
+	if (numWorkers < 0)
+	{
+		//Leave a core for the main thread
+		numWorkers = (int)std::thread::hardware_concurrency() - 1;
+	}
+
+	if (numWorkers < 1)
+	{
+		numWorkers = 1;
+	}
+
+	m_isRunning = true;
+
+	for (int workerIndex = 0; workerIndex < numWorkers; ++workerIndex)
+	{
+		m_queues.push_back(new JobWorkerQueue());
+	}
+
+	for (int workerIndex = 0; workerIndex < numWorkers; ++workerIndex)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerThreadMain, this, workerIndex);
+	}
+
+	g_eventSystem->SubscribeEventCallBackFn("JobStats", Command_JobStats);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::ShutDown()
+{
+	if (!m_isRunning)
+		return;
+
+	//Workers drain whatever is still queued before they exit
+	{
+		std::lock_guard<std::mutex> sleepLock(m_sleepLock);
+		m_isRunning = false;
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	for (JobWorkerQueue* queue : m_queues)
+	{
+		delete queue;
+	}
+	m_queues.clear();
+
+	//Anything still parked depended on work that never finished
+	for (Job* job : m_parkedJobs)
+	{
+		delete job;
+	}
+	m_parkedJobs.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::Run(JobCategoryT category, const JobFunction& function, JobCounter* counter, JobCounter* dependency)
+{
+	Job* job = new Job();
+	job->m_function = function;
+	job->m_category = category;
+	job->m_counter = counter;
+	job->m_dependency = dependency;
+
+	if (counter != nullptr)
+	{
+		++counter->m_pending;
+	}
+
+	if (dependency != nullptr)
+	{
+		//Check under the lock so we can't miss the dependency finishing while we park
+		std::lock_guard<std::mutex> parkedLock(m_parkedLock);
+		if (!dependency->IsDone())
+		{
+			m_parkedJobs.push_back(job);
+			return;
+		}
+	}
+
+	PushJob(job);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The calling thread helps out with queued work instead of blocking while the counter is outstanding
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::WaitForCounter(JobCounter* counter)
+{
+	if (counter == nullptr)
+		return;
+
+	while (!counter->IsDone())
+	{
+		if (!ExecuteOneJob(s_workerIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::PrintStats() const
+{
+	g_devConsole->PrintString(Rgba::YELLOW, Stringf("Job System: %d workers", GetNumWorkers()));
+
+	for (int categoryIndex = 0; categoryIndex < JOB_CATEGORY_COUNT; ++categoryIndex)
+	{
+		const JobCategoryStats& stats = m_stats[categoryIndex];
+		uint count = stats.m_jobCount.load();
+		uint64_t totalMicroseconds = stats.m_totalMicroseconds.load();
+		float averageMicroseconds = (count > 0U) ? (float)totalMicroseconds / (float)count : 0.f;
+
+		g_devConsole->PrintString(Rgba::WHITE, Stringf("  %-10s jobs: %6u  total: %8.2fms  avg: %8.1fus  max: %6uus",
+			GetJobCategoryName((JobCategoryT)categoryIndex), count, (float)totalMicroseconds * 0.001f, averageMicroseconds, stats.m_maxMicroseconds.load()));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::ResetStats()
+{
+	for (int categoryIndex = 0; categoryIndex < JOB_CATEGORY_COUNT; ++categoryIndex)
+	{
+		m_stats[categoryIndex].m_jobCount = 0U;
+		m_stats[categoryIndex].m_totalMicroseconds = 0U;
+		m_stats[categoryIndex].m_maxMicroseconds = 0U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::WorkerThreadMain(int workerIndex)
+{
+	s_workerIndex = workerIndex;
+
+	while (true)
+	{
+		if (ExecuteOneJob(workerIndex))
+			continue;
+
+		std::unique_lock<std::mutex> sleepLock(m_sleepLock);
+		if (!m_isRunning && m_queuedJobs.load() == 0)
+			break;
+
+		//Sleep until something is queued instead of spinning
+		m_wakeCondition.wait(sleepLock, [this]() { return m_queuedJobs.load() > 0 || !m_isRunning; });
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::PushJob(Job* job)
+{
+	//Jobs kicked from a worker stay local to it, the main thread deals them out round robin
+	int queueIndex = s_workerIndex;
+	if (queueIndex < 0)
+	{
+		queueIndex = (int)(m_nextQueue++ % (uint)m_queues.size());
+	}
+
+	{
+		JobWorkerQueue* queue = m_queues[queueIndex];
+		std::lock_guard<std::mutex> queueLock(queue->m_lock);
+		queue->m_jobs.push_back(job);
+	}
+
+	{
+		//Taking the sleep lock stops a worker from missing this between its check and its wait
+		std::lock_guard<std::mutex> sleepLock(m_sleepLock);
+		++m_queuedJobs;
+	}
+	m_wakeCondition.notify_one();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+Job* JobSystem::PopOrStealJob(int workerIndex)
+{
+	int numQueues = (int)m_queues.size();
+	if (numQueues == 0)
+		return nullptr;
+
+	//Newest work from our own queue first, it is the most likely to still be in cache
+	if (workerIndex >= 0)
+	{
+		JobWorkerQueue* queue = m_queues[workerIndex];
+		std::lock_guard<std::mutex> queueLock(queue->m_lock);
+		if (!queue->m_jobs.empty())
+		{
+			Job* job = queue->m_jobs.back();
+			queue->m_jobs.pop_back();
+			--m_queuedJobs;
+			return job;
+		}
+	}
+
+	//Steal the oldest work from everyone else
+	int startIndex = (workerIndex >= 0) ? workerIndex + 1 : 0;
+	for (int offset = 0; offset < numQueues; ++offset)
+	{
+		int victimIndex = (startIndex + offset) % numQueues;
+		if(victimIndex == workerIndex)
+			continue;
+
+		JobWorkerQueue* queue = m_queues[victimIndex];
+		std::lock_guard<std::mutex> queueLock(queue->m_lock);
+		if (!queue->m_jobs.empty())
+		{
+			Job* job = queue->m_jobs.front();
+			queue->m_jobs.pop_front();
+			--m_queuedJobs;
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool JobSystem::ExecuteOneJob(int workerIndex)
+{
+	Job* job = PopOrStealJob(workerIndex);
+	if (job == nullptr)
+		return false;
+
+	double startTime = GetCurrentTimeSeconds();
+	job->m_function();
+	double endTime = GetCurrentTimeSeconds();
+
+	uint microseconds = (uint)((endTime - startTime) * 1000000.0);
+	JobCategoryStats& stats = m_stats[job->m_category];
+	++stats.m_jobCount;
+	stats.m_totalMicroseconds += microseconds;
+
+	uint currentMax = stats.m_maxMicroseconds.load();
+	while (microseconds > currentMax && !stats.m_maxMicroseconds.compare_exchange_weak(currentMax, microseconds))
+	{
+	}
+
+	FinishJob(job);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::FinishJob(Job* job)
+{
+	JobCounter* counter = job->m_counter;
+	delete job;
+
+	if (counter != nullptr)
+	{
+		if (--counter->m_pending == 0)
+		{
+			ReleaseParkedJobs();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobSystem::ReleaseParkedJobs()
+{
+	std::vector<Job*> readyJobs;
+
+	{
+		std::lock_guard<std::mutex> parkedLock(m_parkedLock);
+		for (int parkedIndex = 0; parkedIndex < (int)m_parkedJobs.size(); ++parkedIndex)
+		{
+			if (m_parkedJobs[parkedIndex]->m_dependency->IsDone())
+			{
+				readyJobs.push_back(m_parkedJobs[parkedIndex]);
+				m_parkedJobs.erase(m_parkedJobs.begin() + parkedIndex);
+				--parkedIndex;
+			}
+		}
+	}
+
+	for (Job* job : readyJobs)
+	{
+		PushJob(job);
+	}
+}
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Loading, pathing and render packet recording run as jobs. Visibility and the entity simulation still run on the main
+// thread because entity updates write to each other and to the map; their categories are reserved for when they move
+//------------------------------------------------------------------------------------------------------------------------------
+enum JobCategoryT
+{
+	JOB_CATEGORY_LOADING,
+	JOB_CATEGORY_PATHING,
+	JOB_CATEGORY_VISIBILITY,
+	JOB_CATEGORY_SIMULATION,
+	JOB_CATEGORY_RENDERING,
+
+	JOB_CATEGORY_COUNT
+};
+
+typedef std::function<void()> JobFunction;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Counts the jobs still outstanding for a batch. Jobs can wait on a counter before they are allowed to run and the
+// main thread can wait on one to join a batch it kicked off
+//------------------------------------------------------------------------------------------------------------------------------
+struct JobCounter
+{
+	bool				IsDone() const { return m_pending.load() == 0; }
+
+	std::atomic<int>	m_pending { 0 };
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct Job
+{
+	JobFunction			m_function;
+	JobCategoryT		m_category = JOB_CATEGORY_SIMULATION;
+	JobCounter*			m_counter = nullptr;		//Decremented when this job finishes
+	JobCounter*			m_dependency = nullptr;		//Job is parked until this counter reaches 0
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct JobCategoryStats
+{
+	std::atomic<uint>		m_jobCount { 0U };
+	std::atomic<uint64_t>	m_totalMicroseconds { 0U };
+	std::atomic<uint>		m_maxMicroseconds { 0U };
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each worker owns a deque. The owner pushes and pops from the back, idle workers steal from the front
+//------------------------------------------------------------------------------------------------------------------------------
+struct JobWorkerQueue
+{
+	std::mutex			m_lock;
+	std::deque<Job*>	m_jobs;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class JobSystem
+{
+public:
+	JobSystem();
+	~JobSystem();
+
+	static bool				Command_JobStats(EventArgs& args);
+
+	void					StartUp(int numWorkers = -1);
+	void					ShutDown();
+
+	void					Run(JobCategoryT category, const JobFunction& function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+	void					WaitForCounter(JobCounter* counter);
+
+	int						GetNumWorkers() const { return (int)m_workers.size(); }
+	void					PrintStats() const;
+	void					ResetStats();
+
+private:
+	void					WorkerThreadMain(int workerIndex);
+
+	void					PushJob(Job* job);
+	Job*					PopOrStealJob(int workerIndex);
+	bool					ExecuteOneJob(int workerIndex);
+	void					FinishJob(Job* job);
+	void					ReleaseParkedJobs();
+
+private:
+	std::vector<std::thread>		m_workers;
+	std::vector<JobWorkerQueue*>	m_queues;
+	std::atomic<uint>				m_nextQueue { 0U };
+	std::atomic<int>				m_queuedJobs { 0 };
+	std::atomic<bool>				m_isRunning { false };
+
+	std::mutex						m_parkedLock;
+	std::vector<Job*>				m_parkedJobs;
+
+	std::mutex						m_sleepLock;
+	std::condition_variable			m_wakeCondition;
+
+	JobCategoryStats				m_stats[JOB_CATEGORY_COUNT];
+};
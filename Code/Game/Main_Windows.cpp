@@ -11,9 +11,14 @@
 //Game Systems
 #include "Game/GameCommon.hpp"
 #include "Game/App.hpp"
+#include "Game/GameplayData.hpp"
+#include "Game/StartupProfiler.hpp"
 
 //Purely for debugging
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <direct.h>
 
 extern App* g_theApp;
 
@@ -155,7 +160,9 @@ void Startup()
 	//CreateOpenGLWindow( applicationInstanceHandle, CLIENT_ASPECT );
 
 	//Here call a CreateWindow 
+	uint windowPhase = g_startupProfiler->BeginPhase("CreateWindowAndRenderContext");
 	CreateWindowAndRenderContext( CLIENT_ASPECT );
+	g_startupProfiler->EndPhase(windowPhase);
 	g_theApp = new App();	
 	g_theApp->StartUp();
 }
@@ -173,11 +180,145 @@ void Shutdown()
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Cooked caches are what makes a warm boot warm, so a cold boot starts without any. The OS file cache is left alone
+//------------------------------------------------------------------------------------------------------------------------------
+static void DeleteCookedFiles(const std::string& folder)
+{
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA((folder + "/*").c_str(), &findData);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		std::string name = findData.cFileName;
+		std::string path = folder + "/" + name;
+		if (name == "." || name == "..")
+			continue;
+
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			DeleteCookedFiles(path);
+		}
+		else if (name.size() > 7 && name.compare(name.size() - 7, 7, ".cooked") == 0)
+		{
+			DeleteFileA(path.c_str());
+		}
+	}
+	while (FindNextFileA(find, &findData));
+
+	FindClose(find);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// -bootbench=N boots once cold and N times warm. No option means a normal run
+//------------------------------------------------------------------------------------------------------------------------------
+static int GetNumBenchmarkWarmBoots(const char* commandLine)
+{
+	const char* option = strstr(commandLine, "-bootbench");
+	if (option == nullptr)
+		return -1;
+
+	option += strlen("-bootbench");
+	return *option == '=' ? atoi(option + 1) : 3;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// -compiledata builds Data/Gameplay/gameplay.pack and exits without opening a window, for build scripts
+//------------------------------------------------------------------------------------------------------------------------------
+static int RunCompileGameplayData()
+{
+	std::vector<std::string> errors;
+	bool result = GameplayDataCompiler::CompileToFile(GAMEPLAY_DATA_INDEX_PATH, GAMEPLAY_PACK_PATH, errors);
+
+	for (size_t errorIndex = 0; errorIndex < errors.size(); errorIndex++)
+	{
+		DebuggerPrintf("%s\n", errors[errorIndex].c_str());
+	}
+	DebuggerPrintf(result ? "Compiled %s\n" : "Could not compile %s\n", GAMEPLAY_PACK_PATH);
+
+	return result ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each boot runs frames without drawing until the first map and its AI are up, then shuts everything down again. Results
+// go to Data/Logs: a row per boot in BootBench.csv and a Chrome trace per boot. Returns non zero when a boot is over the
+// budget in Data/Gameplay/boot_budgets.xml so a build script can fail on a regression
+//------------------------------------------------------------------------------------------------------------------------------
+static int RunBootBenchmark(int numWarmBoots)
+{
+	_mkdir("Data/Logs");
+
+	BootBudgetSet budgets;
+	bool hasBudgets = budgets.LoadFromFile("Data/Gameplay/boot_budgets.xml");
+	int numFailedBoots = 0;
+
+	for (int bootIndex = 0; bootIndex <= numWarmBoots; bootIndex++)
+	{
+		const char* bootKind = bootIndex == 0 ? "cold" : "warm";
+		if (bootIndex == 0)
+		{
+			DeleteCookedFiles("Data");
+			DeleteFileA(GAMEPLAY_PACK_PATH);
+		}
+
+		g_startupProfiler = new StartupProfiler(true);
+		Startup();
+
+		while (!g_theApp->IsQuitting() && !g_startupProfiler->IsMapReady())
+		{
+			RunMessagePump();
+			g_theApp->RunFrame();
+		}
+
+		bool wasClosed = !g_startupProfiler->IsMapReady();
+		Shutdown();
+
+		DebuggerPrintf("Boot %d (%s)\n", bootIndex, bootKind);
+		g_startupProfiler->PrintSummary();
+		g_startupProfiler->WriteChromeTrace(Stringf("Data/Logs/BootBench_%d_%s.json", bootIndex, bootKind));
+		g_startupProfiler->AppendBenchmarkRow("Data/Logs/BootBench.csv", bootKind);
+
+		std::vector<std::string> failures;
+		const BootBudget* budget = hasBudgets ? budgets.FindBudget(bootKind) : nullptr;
+		if (wasClosed || (budget != nullptr && !BootBudgetSet::CheckBudget(*budget, *g_startupProfiler, failures)))
+		{
+			for (size_t failureIndex = 0; failureIndex < failures.size(); failureIndex++)
+			{
+				DebuggerPrintf("%s\n", failures[failureIndex].c_str());
+			}
+			DebuggerPrintf("Boot %d (%s) FAILED\n", bootIndex, bootKind);
+			numFailedBoots++;
+		}
+
+		delete g_startupProfiler;
+		g_startupProfiler = nullptr;
+
+		if (wasClosed)
+			break;
+	}
+
+	return numFailedBoots > 0 ? 1 : 0;
+}
+
 //-----------------------------------------------------------------------------------------------
 int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR commandLineString, int )
 {
-	UNUSED( commandLineString );
 	UNUSED( applicationInstanceHandle );
+
+	if (strstr(commandLineString, "-compiledata") != nullptr)
+	{
+		return RunCompileGameplayData();
+	}
+
+	int numWarmBoots = GetNumBenchmarkWarmBoots(commandLineString);
+	if (numWarmBoots >= 0)
+	{
+		return RunBootBenchmark(numWarmBoots);
+	}
+
+	g_startupProfiler = new StartupProfiler();
 	Startup();
 
 	// Program main loop; keep running frames until it's time to quit
@@ -190,6 +331,13 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 	}
 
 	Shutdown();
+
+	//Only the boot is in here, recording stopped once the first map was up
+	_mkdir("Data/Logs");
+	g_startupProfiler->WriteChromeTrace("Data/Logs/StartupTrace.json");
+	delete g_startupProfiler;
+	g_startupProfiler = nullptr;
+
 	return 0;
 }
 
@@ -3,7 +3,10 @@
 
 // Engine Systems
 #include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedStrings.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/WindowContext.hpp"
 #include "Engine/Math/Frustum.hpp"
 #include "Engine/Math/Plane3D.hpp"
 #include "Engine/Math/Ray3D.hpp"
@@ -24,16 +27,51 @@
 #include "Game/Entity.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameInput.hpp"
+#include "Game/GameplayData.hpp"
+#include "Game/GameplayHotReload.hpp"
 #include "Game/RTSCamera.hpp"
 #include "Game/IsoAnimDefenition.hpp"
 #include "Game/AIController.hpp"
+#include "Game/AssetResidency.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/RenderResources.hpp"
+#include "Game/SpriteAtlas.hpp"
+#include "Game/SpriteBatcher.hpp"
+#include "Game/SpriteFacing.hpp"
+#include "Game/StartupProfiler.hpp"
+#include "Game/StateHash.hpp"
+#include "Game/StaticModelRenderer.hpp"
+#include "Game/StatusBarBatcher.hpp"
+#include "Game/TerrainMesh.hpp"
+#include "Game/ViewCulling.hpp"
 
 extern RenderContext* g_renderContext;
 
 //------------------------------------------------------------------------------------------------------------------------------
 Map::Map()
 {
-	m_quad = new GPUMesh(g_renderContext);
+	m_liveRenderBackend = new RenderContextBackend(g_renderContext);
+	m_spriteShader = g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml");
+
+	m_spriteBatcher = new SpriteBatcher();
+	m_statusBarBatcher = new StatusBarBatcher();
+	m_statusBarBatcher->SetBarDimensions(m_healthBarWidth, m_healthBarHeight, m_healthBarPivot);
+
+	m_staticModels = new StaticModelRenderer();
+	m_renderQueue = new RenderQueue();
+
+	//Units blend back to front with everything else that is see-through, the bars draw over all of it
+	m_spriteBackend = new QueueSpriteBackend(m_renderQueue, m_spriteShader, RENDER_PASS_ALPHA);
+	m_statusBarBackend = new QueueSpriteBackend(m_renderQueue, m_spriteShader, RENDER_PASS_OVERLAY);
+
+	CreateRenderAdapters(m_liveRenderBackend);
+
+	m_terrain = new TerrainMesh();
+	m_viewFootprint = new ViewFootprint();
+	m_entityGrid = new EntityCellGrid();
+	m_spriteFacing = new SpriteFacingResolver();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -48,17 +86,21 @@ Map::~Map()
 bool Map::Load( char const* filename )
 {
 	UNUSED(filename);
+	StartupPhaseScope phase("Map::Load");
 
 	m_terrainMaterial = g_renderContext->CreateOrGetMaterialFromFile(m_materialName);
-	m_goblinBuildingTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_goblinBuildingTexturePath);
+	m_treeMaterial = g_renderResources->ResolveMaterial(m_treeMaterialFile);
+	m_debugLitShader = g_renderResources->ResolveShader("default_lit.hlsl");
+	m_goblinBuildingTexture = g_renderResources->ReserveTexture(m_goblinBuildingTexturePath);
+	g_assetResidency->MarkTextureUsed(m_goblinBuildingTexture);
 
-	m_townCenter = Game::s_gameReference->m_initMesh;
-	m_hut = Game::s_gameReference->m_hutMesh;
+	m_townCenterModel = g_modelRegistry->RequestModel(m_townCenterMeshPath, m_townCenterMaterialPath);
+	m_hutModel = g_modelRegistry->RequestModel(m_hutMeshPath, m_hutMaterialPath);
 
 	m_redShader = g_renderContext->CreateOrGetShaderFromFile(m_redShaderPath);
 
 	LoadFoliageModels();
-	//LoadBuildingModels();
+	LoadBuildingModels();
 
 	bool result = Create(32, 32);
 	return result;
@@ -67,68 +109,34 @@ bool Map::Load( char const* filename )
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::LoadFoliageModels()
 {
-	//Open the xml file and parse it
-	tinyxml2::XMLDocument meshDoc;
-	meshDoc.LoadFile(m_treeModelsXMLFile.c_str());
-
-	if (meshDoc.ErrorID() != tinyxml2::XML_SUCCESS)
-	{
-
-		ERROR_AND_DIE(">> Error loading Mesh XML file ");
-		return;
-	}
-	else
-	{
-		//We loaded the file successfully
-		XMLElement* root = meshDoc.RootElement();
-		XMLElement* childElement = root->FirstChildElement();
-
-		std::string sourceName = "";
-
-		while (childElement != nullptr)
-		{
-			sourceName = ParseXmlAttribute(*childElement, "path", "");
-
-			if (sourceName != "")
-			{
-				g_renderContext->CreateOrGetMeshFromFile(sourceName);
-				childElement = childElement->NextSiblingElement();
-			}
-		}
-	}
+	LoadModelList(m_treeModelsXMLFile);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::LoadBuildingModels()
- {
-	//Open the xml file and parse it
-	tinyxml2::XMLDocument meshDoc;
-	meshDoc.LoadFile(m_buildingModelsXMLFile.c_str());
+{
+	LoadModelList(m_buildingModelsXMLFile);
+}
 
-	if (meshDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::LoadModelList(const std::string& fileName)
+{
+	const GameplayModelListRecord* modelList = g_gameplayData->FindModelList(fileName);
+	if (modelList == nullptr)
 	{
-
-		ERROR_AND_DIE(">> Error loading Mesh XML file ");
+		ERROR_AND_DIE(Stringf(">> No gameplay data compiled for %s ", fileName.c_str()));
 		return;
 	}
-	else
-	{
-		//We loaded the file successfully
-		XMLElement* root = meshDoc.RootElement();
-		XMLElement* childElement = root->FirstChildElement();
 
-		std::string sourceName = "";
-
-		while (childElement != nullptr)
-		{
-			sourceName = ParseXmlAttribute(*childElement, "path", "");
+	//Requested up front so they cook on the job system while the map loads, rather than when the first entity asks.
+	//Meshes already requested with a material are left as they are
+	for (uint pathIndex = 0; pathIndex < modelList->m_numPaths; pathIndex++)
+	{
+		std::string modelPath = g_gameplayData->GetModelPath(*modelList, pathIndex);
+		if (g_modelRegistry->IsRequested(modelPath))
+			continue;
 
-			if (sourceName != "")
-			{
-				g_renderContext->CreateOrGetMeshFromFile(sourceName);
-				childElement = childElement->NextSiblingElement();
-			}
-		}
+		g_modelRegistry->RequestModel(modelPath);
 	}
 }
 
@@ -163,77 +171,11 @@ bool Map::Create(int mapWidth, int mapHeight)
 	//Create a map grid
 	m_tileDimensions = IntVec2(mapWidth, mapHeight);
 
-	//Create a temp CPU Mesh for now
-	CPUMesh mesh;
-	mesh.Clear();
-
-	int vertsX = 2 * mapWidth + 1;
-	int vertsY = 2 * mapHeight + 1;
-
-	float u = 0.f;
-	float v = (float)vertsY;
-
-	mesh.SetLayout<Vertex_Lit>();
-	mesh.SetColor(Rgba::WHITE);
-	mesh.SetNormal(Vec3(0.f, 0.f, -1.f));
-	mesh.SetTangent(Vec3(1.f, 0.f, 0.f));
-	mesh.SetBiTangent(Vec3(0.f, 1.f, 0.f));
-
-	for (int yIndex = 0; yIndex < vertsY; ++yIndex)
-	{
-		for (int xIndex = 0; xIndex < vertsX; ++xIndex)
-		{
-			Vertex_Lit vert;
-			vert.m_position = Vec3(xIndex * 0.5f - 0.5f, yIndex * 0.5f - 0.5f, 0.f);
-			vert.m_uv = Vec2(u, v);
-
-			//Setup data on the CPUMesh
-			mesh.SetUV(Vec2(u, v));
-			mesh.AddVertex(vert.m_position);
-
-			//Push into vector for map
-			m_mapVerts.push_back(vert);
-			u += 0.5f;
-		}
-		u = 0.f;
-		v -= 0.5f;
-	}
-
-	for (int yIndex = 0; yIndex < vertsY - 1; ++yIndex)
-	{
-		for (int xIndex = 0; xIndex < vertsX - 1; ++xIndex)
-		{
-			int botLeft = xIndex + yIndex * vertsX;
-			int botright = botLeft + 1;
-			int topLeft = botLeft + vertsX;
-			int topRight = topLeft + 1;
-
-			//Push into vector for map
-			m_mapIndices.push_back(botLeft);
-			m_mapIndices.push_back(botright);
-			m_mapIndices.push_back(topRight);
-
-			m_mapIndices.push_back(botLeft);
-			m_mapIndices.push_back(topRight);
-			m_mapIndices.push_back(topLeft);
-
-			//Add index to the mesh
-			mesh.AddIndexedQuad(topLeft, topRight, botLeft, botright);
-		}
-	}
-
-	if (m_terrainMesh != nullptr)
-	{
-		delete m_terrainMesh;
-		m_terrainMesh = nullptr;
-	}
-
-	//Copy the CPU mesh info to the GPUMesh
-	m_terrainMesh = new GPUMesh(g_renderContext);
-	m_terrainMesh->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
+	//Terrain verts are generated per chunk straight from the grid, nothing is kept on the CPU
+	m_terrain->Create(m_tileDimensions);
 
 	//Set the map bounds in the AABB2
-	m_mapBounds = AABB2(Vec2(m_mapVerts[0].m_position.x, m_mapVerts[0].m_position.y), Vec2(m_mapVerts[(int)m_mapVerts.size() - 1].m_position.x, m_mapVerts[(int)m_mapVerts.size() - 1].m_position.y));
+	m_mapBounds = AABB2(Vec2(-0.5f, -0.5f), Vec2((float)mapWidth - 0.5f, (float)mapHeight - 0.5f));
 
 	//Set occupancy values (All are false at start)
 	for (int occIndex = 0; occIndex < mapHeight * mapWidth; occIndex++)
@@ -247,6 +189,8 @@ bool Map::Create(int mapWidth, int mapHeight)
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::CreateAIController()
 {
+	StartupPhaseScope phase("AIController::Startup");
+
 	m_AIController = new AIController(Game::s_gameReference);
 	m_AIController->Startup();
 }
@@ -255,6 +199,7 @@ void Map::CreateAIController()
 void Map::Update(float deltaTime)
 {
 	PreparePather();
+	SolveRequestedPaths();
 
 	if (!Game::s_gameReference->m_disableAI)
 	{
@@ -264,6 +209,10 @@ void Map::Update(float deltaTime)
 
 	UpdateEntities(deltaTime);
 
+	//The AI and entity tasks ask for paths while they update, solve those now so they are ready for the next frame just
+	//as they were when PathTo solved in place
+	SolveRequestedPaths();
+
 	ResolveEntityCollisions();
 
 	ClearDeadEntities();
@@ -290,6 +239,63 @@ void Map::PreparePather()
 	}
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Every entity that asked for a path this frame gets its own job, the pather is read only until they are all done
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::SolveRequestedPaths()
+{
+	JobCounter pathJobs;
+
+	int numEntities = (int)m_entities.size();
+	for (int entityIndex = 0; entityIndex < numEntities; ++entityIndex)
+	{
+		Entity* entity = m_entities[entityIndex];
+		if(entity == nullptr || !entity->HasPathRequest())
+			continue;
+
+		Pather* pather = &m_mapPather;
+		g_jobSystem->Run(JOB_CATEGORY_PATHING, [entity, pather]() { entity->SolveRequestedPath(pather); }, &pathJobs);
+	}
+
+	g_jobSystem->WaitForCounter(&pathJobs);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One hash per live slot folded in slot order, so two runs that created the same entities line up entry for entry. The
+// entries are only filled in when asked for
+//------------------------------------------------------------------------------------------------------------------------------
+uint Map::ComputeEntityStateHash(std::vector<StateHashEntry>* entries) const
+{
+	if (entries != nullptr)
+	{
+		entries->clear();
+	}
+
+	uint hash = 0U;
+	uint words[ENTITY_HASH_WORDS];
+	int numEntities = (int)m_entities.size();
+	for (int entityIndex = 0; entityIndex < numEntities; ++entityIndex)
+	{
+		const Entity* entity = m_entities[entityIndex];
+		if(entity == nullptr)
+			continue;
+
+		entity->PackStateHashWords(words);
+
+		StateHashEntry entry;
+		entry.m_handle = entity->GetHandle();
+		entry.m_hash = HashPackedWords(words, ENTITY_HASH_WORDS);
+		hash = CombineStateHashEntry(hash, entry);
+
+		if (entries != nullptr)
+		{
+			entries->push_back(entry);
+		}
+	}
+
+	return hash;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::UpdateEntities(float deltaTime)
 {
@@ -324,6 +330,12 @@ void Map::ClearDeadEntities()
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::Render() const
 {
+	UpdateViewCulling();
+
+	//Terrain, static models, sprites, bars and the building preview are all recorded into the queue and drawn in one
+	//sorted submit at the end. The main thread records into the first buffer, jobs into the rest
+	m_renderQueue->BeginFrame((uint)g_jobSystem->GetNumWorkers() + 1U);
+
 	RenderTerrain(m_terrainMaterial);
 	//RenderEntities();
 	RenderEntityData();
@@ -338,21 +350,87 @@ void Map::Render() const
 	{
 		RenderBuildingPreview(HUT);
 	}
+
+	m_renderQueue->Submit(*m_renderQueueBackend);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The camera frustum is reduced to the quad of ground its corner rays land on. Terrain chunks and entity grid cells are
+// tested against that quad, padded by m_viewCullMargin for anything standing up off the ground
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::UpdateViewCulling() const
+{
+	RTSCamera* camera = Game::s_gameReference->m_RTSCam;
+	IntVec2 clientBounds = g_windowContext->GetTrueClientBounds();
+	IntVec2 screenCorners[4] = { IntVec2(0, 0), IntVec2(clientBounds.x, 0), IntVec2(clientBounds.x, clientBounds.y), IntVec2(0, clientBounds.y) };
+
+	Plane3D terrainPlane(Vec3(0.f, 0.f, -1.f), 0.f);
+	Vec2 groundCorners[4];
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		Ray3D ray = camera->ScreenPointToWorldRay(screenCorners[cornerIndex], clientBounds);
+
+		//A corner looking over the horizon is cut off at the far distance
+		float hitTimes[2];
+		uint numHits = Raycast(hitTimes, ray, terrainPlane);
+		float time = m_viewCullFarDistance;
+		if (numHits > 0 && hitTimes[0] >= 0.f && hitTimes[0] < m_viewCullFarDistance)
+		{
+			time = hitTimes[0];
+		}
+
+		Vec3 groundPoint = ray.GetPointAtTime(time);
+		groundCorners[cornerIndex] = Vec2(groundPoint.x, groundPoint.y);
+	}
+
+	m_viewFootprint->SetGroundCorners(groundCorners, m_viewCullMargin);
+	m_entityGrid->Rebuild(m_entities, m_mapBounds, m_entityCellSize);
+	m_entityGrid->GatherVisible(*m_viewFootprint);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::Shutdown()
 {
-	delete m_terrainMesh;
-	m_terrainMesh = nullptr;
+	delete m_AIController;
+	m_AIController = nullptr;
+
+	delete m_terrain;
+	m_terrain = nullptr;
+
+	delete m_viewFootprint;
+	m_viewFootprint = nullptr;
+
+	delete m_entityGrid;
+	m_entityGrid = nullptr;
+
+	delete m_spriteFacing;
+	m_spriteFacing = nullptr;
+
+	DestroyRenderAdapters();
+
+	delete m_liveRenderBackend;
+	m_liveRenderBackend = nullptr;
+
+	delete m_spriteBatcher;
+	m_spriteBatcher = nullptr;
+
+	delete m_statusBarBatcher;
+	m_statusBarBatcher = nullptr;
+
+	delete m_spriteBackend;
+	m_spriteBackend = nullptr;
 
-	delete m_quad;
-	m_quad = nullptr;
+	delete m_statusBarBackend;
+	m_statusBarBackend = nullptr;
+
+	delete m_staticModels;
+	m_staticModels = nullptr;
+
+	delete m_renderQueue;
+	m_renderQueue = nullptr;
 
 	//Empty both the vectors we have of verts and of MapTiles
 	m_mapTiles.clear();
-	m_mapVerts.clear();
-	m_mapIndices.clear();
 
 	for (int entityIndex = 0; entityIndex < (int)m_entities.size(); entityIndex++)
 	{
@@ -365,17 +443,88 @@ void Map::Shutdown()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Map::RenderTerrain( Material* matOverride /*= nullptr */ ) const
+void Map::SetRenderBackend(RenderBackend* renderBackend)
+{
+	DestroyRenderAdapters();
+	CreateRenderAdapters(renderBackend != nullptr ? renderBackend : m_liveRenderBackend);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::CreateRenderAdapters(RenderBackend* renderBackend)
+{
+	m_renderBackend = renderBackend;
+	m_renderQueueBackend = new ForwardingQueueBackend(renderBackend);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::DestroyRenderAdapters()
 {
-	if(matOverride != nullptr)
+	delete m_renderQueueBackend;
+	m_renderQueueBackend = nullptr;
+
+	m_renderBackend = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Renders the current map into a recording backend for a few frames and checks the worst one against the scenario's budget.
+// The frames are recorded instead of drawn, but the map, camera, meshes and textures still come from the running game and
+// its render context. RenderBudgetTests checks the budgets without a device
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Map::Command_RenderBudget(EventArgs& args)
+{
+	Game* game = Game::s_gameReference;
+	std::string scenario = args.GetValue("scenario", "default");
+	std::string filePath = args.GetValue("file", game->m_renderBudgetPath);
+	int numFrames = args.GetValue("frames", 4);
+
+	if (game->m_map == nullptr)
 	{
-		g_renderContext->BindMaterial(matOverride);
+		g_devConsole->PrintString(Rgba::RED, "RenderBudget needs a loaded map");
+		return false;
 	}
-	else
+
+	RenderBudgetSet budgets;
+	const RenderBudget* budget = budgets.LoadFromFile(filePath) ? budgets.FindBudget(scenario) : nullptr;
+	if (budget == nullptr)
 	{
-		g_renderContext->BindMaterial(m_terrainMaterial);
+		g_devConsole->PrintString(Rgba::RED, Stringf("No render budget for scenario %s in %s", scenario.c_str(), filePath.c_str()));
+		return false;
 	}
-	g_renderContext->DrawMesh(m_terrainMesh);
+
+	RecordingRenderBackend recorder;
+	game->m_map->SetRenderBackend(&recorder);
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		recorder.BeginFrame();
+		game->m_map->Render();
+		recorder.EndFrame();
+	}
+	game->m_map->SetRenderBackend(nullptr);
+
+	const RenderFrameStats& stats = recorder.GetWorstFrameStats();
+	g_devConsole->PrintString(Rgba::WHITE, Stringf("Worst of %u frames: %u draws, %u state changes (%u redundant binds), %u uploads, %llu bytes",
+		recorder.GetNumFrames(), stats.m_numDrawCalls, stats.m_numStateChanges, stats.m_numRedundantBinds, stats.m_numUploads, (unsigned long long)stats.m_numBytesUploaded));
+
+	std::vector<std::string> failures;
+	if (!RenderBudgetSet::CheckBudget(*budget, stats, failures))
+	{
+		for (size_t failureIndex = 0; failureIndex < failures.size(); failureIndex++)
+		{
+			g_devConsole->PrintString(Rgba::RED, failures[failureIndex]);
+		}
+		g_devConsole->PrintString(Rgba::RED, Stringf("Render budget %s FAILED", scenario.c_str()));
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Render budget %s passed", scenario.c_str()));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::RenderTerrain( Material* matOverride /*= nullptr */ ) const
+{
+	Material* material = matOverride != nullptr ? matOverride : m_terrainMaterial;
+	m_terrain->RecordPackets(m_renderQueue->GetBuffer(0U), material, *m_viewFootprint, GetCameraEyePosition());
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -384,7 +533,7 @@ void Map::RenderEntities() const
 	int numEntities = (int)m_entities.size();
 	for (int index = 0; index < numEntities; index++)
 	{
-		g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_lit.hlsl"));
+		g_renderContext->BindShader(g_renderResources->GetShader(m_debugLitShader));
 		g_renderContext->BindTextureView(0U, nullptr);
 
 		CPUMesh mesh;
@@ -423,8 +572,8 @@ void Map::RenderEntities() const
 void Map::RenderEntityData() const
 {
 	//First draw a ring under any selected entity
-	g_renderContext->BindShader(Game::s_gameReference->m_shader);
-	g_renderContext->BindTextureView(0U, nullptr);
+	m_renderBackend->BindShader(Game::s_gameReference->m_shader);
+	m_renderBackend->BindTextureView(0U, nullptr);
 
 	GameInput* inputClass = Game::s_gameReference->m_gameInput;
 	for (int index = 0; index < (int)inputClass->m_selectionHandles.size(); index++)
@@ -441,8 +590,8 @@ void Map::RenderEntityData() const
 				ringVerts[i].m_position.z = -0.01f;
 			}
 
-			g_renderContext->BindModelMatrix(Matrix44::IDENTITY);
-			g_renderContext->DrawVertexArray(ringVerts);
+			m_renderBackend->BindModelMatrix(Matrix44::IDENTITY);
+			m_renderBackend->DrawVertexArray(ringVerts);
 		}
 	}
 
@@ -459,26 +608,50 @@ void Map::RenderEntityData() const
 			ringVerts[i].m_position.z = -0.01f;
 		}
 
-		g_renderContext->BindModelMatrix(Matrix44::IDENTITY);
-		g_renderContext->DrawVertexArray(ringVerts);
+		m_renderBackend->BindModelMatrix(Matrix44::IDENTITY);
+		m_renderBackend->DrawVertexArray(ringVerts);
 	}
 
 	//Draw the entity sprite
-	g_renderContext->BindShader(Game::s_gameReference->m_defaultLit);
-	g_renderContext->BindTextureView(0U, nullptr);
+	m_renderBackend->BindShader(Game::s_gameReference->m_defaultLit);
+	m_renderBackend->BindTextureView(0U, nullptr);
 
-	for (int index = 0; index < (int)m_entities.size(); index++)
+	//Camera setup for every billboard happens once here. Visible unit facings are queued in walk order and resolved to
+	//octants in one pass, so the walk below only reads a slot back
+	RTSCamera* camera = Game::s_gameReference->m_RTSCam;
+	m_spriteFacing->BeginFrame(camera->GetModelMatrix(), camera->GetViewMatrix(), camera->GetCameraForward());
+	const SpriteCameraSetup& cameraSetup = m_spriteFacing->GetCameraSetup();
+
+	//Only entities in the view are walked. Static instances that leave it drop out at EndSync and are set again when they return
+	const std::vector<int>& visibleEntities = m_entityGrid->GetVisibleEntities();
+	for (int visibleIndex = 0; visibleIndex < (int)visibleEntities.size(); visibleIndex++)
 	{
-		if(m_entities[index] == nullptr)
-			continue;
+		const Entity& entity = *m_entities[visibleEntities[visibleIndex]];
+		EntityTypeT type = entity.GetType();
+		if (type == PEON || type == WARRIOR || type == GOBLIN)
+		{
+			m_spriteFacing->AddFacing(entity.GetDirectionFacing());
+		}
+	}
+	m_spriteFacing->ResolveOctants();
+
+	//Sprites and bars are collected while walking the entities and drawn in a handful of batches after
+	m_staticModels->BeginSync(g_assetResidency->GetVersion());
+	m_spriteBatcher->BeginFrame();
+	m_statusBarBatcher->BeginFrame(cameraSetup.m_billboardRight, cameraSetup.m_billboardUp);
 
+	int facingSlot = 0;
+	for (int visibleIndex = 0; visibleIndex < (int)visibleEntities.size(); visibleIndex++)
+	{
+		int index = visibleEntities[visibleIndex];
 		switch (m_entities[index]->GetType())
 		{
 		case PEON:
 		case WARRIOR:
 		case GOBLIN:
 		{
-			RenderIsoSpriteForEntity(*m_entities[index]);
+			RenderIsoSpriteForEntity(*m_entities[index], facingSlot);
+			facingSlot++;
 		}
 		break;
 		case TREE:
@@ -501,13 +674,57 @@ void Map::RenderEntityData() const
 
 		
 	}
+
+	//Static models bind once per mesh and material through the sorted queue, unit sprites draw once per texture run
+	m_staticModels->EndSync();
+	RecordStaticModelPackets();
+	m_spriteBatcher->Flush(*m_spriteBackend);
+	m_statusBarBatcher->Flush(*m_statusBarBackend);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Static model packets are recorded by one job per worker plus the main thread, each into its own queue buffer over an even
+// slice of the instances. The queue was started with a buffer per worker already, too few instances leaves them empty
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::RecordStaticModelPackets() const
+{
+	Vec3 eyePosition = GetCameraEyePosition();
+
+	uint numInstances = m_staticModels->GetNumInstances();
+	uint numSlices = m_renderQueue->GetNumBuffers();
+	if (numInstances < numSlices * m_minPacketsPerRecordJob)
+	{
+		numSlices = 1U;
+	}
+
+	uint sliceSize = (numInstances + numSlices - 1U) / numSlices;
+
+	JobCounter recordJobs;
+	for (uint sliceIndex = 1; sliceIndex < numSlices; sliceIndex++)
+	{
+		RenderPacketBuffer* buffer = &m_renderQueue->GetBuffer(sliceIndex);
+		StaticModelRenderer* staticModels = m_staticModels;
+		uint firstInstance = sliceIndex * sliceSize;
+		g_jobSystem->Run(JOB_CATEGORY_RENDERING, [staticModels, buffer, firstInstance, sliceSize, eyePosition]() { staticModels->RecordPackets(*buffer, firstInstance, sliceSize, eyePosition); }, &recordJobs);
+	}
+
+	//The main thread records the first slice instead of sitting idle
+	m_staticModels->RecordPackets(m_renderQueue->GetBuffer(0U), 0U, sliceSize, eyePosition);
+	g_jobSystem->WaitForCounter(&recordJobs);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Map::RenderIsoSpriteForEntity(const Entity& entity) const
+Vec3 Map::GetCameraEyePosition() const
+{
+	RTSCamera* camera = Game::s_gameReference->m_RTSCam;
+	return camera->m_focalPoint - camera->m_distance * camera->GetCameraForward().GetNormalized();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::RenderIsoSpriteForEntity(const Entity& entity, int facingSlot) const
 {
 	IsoSpriteDefenition* isoSprite = &entity.m_animationSet[entity.m_currentState]->GetIsoSpriteAtTime(entity.m_currentAnimTime);
-	DrawBillBoardedIsoSprites(entity.GetPosition(), entity.GetDirectionFacing(), *isoSprite, *Game::s_gameReference->m_RTSCam, entity.GetType(), Rgba::WHITE, entity.m_currentState);
+	DrawBillBoardedIsoSprites(entity.GetPosition(), m_spriteFacing->GetLocalDirection(facingSlot), *isoSprite, entity.GetType(), Rgba::WHITE, entity.m_currentState);
 
 	if (!entity.IsAlive())
 		return;
@@ -518,12 +735,6 @@ void Map::RenderIsoSpriteForEntity(const Entity& entity) const
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::DrawHealthBar(const Entity& entity) const
 {
-	//Draw the health bar
-	Vec3 corners[4];
-
-	float width = m_healthBarWidth;
-	float height = m_healthBarHeight;
-	
 	float zHeight;
 	switch (entity.GetType())
 	{
@@ -543,59 +754,7 @@ void Map::DrawHealthBar(const Entity& entity) const
 	break;
 	}
 
-	Vec2 pivot = m_healthBarPivot;
-
-	corners[0] = Vec3::ZERO + height * Vec3::UP;
-	corners[1] = Vec3::ZERO + height * Vec3::UP + width * Vec3::RIGHT;
-	corners[2] = Vec3::ZERO;
-	corners[3] = Vec3::ZERO + width * Vec3::RIGHT;
-
-	Vec2 localOffset = -1.f * (pivot * Vec2(width, height));
-	Vec3 worldOffset = localOffset.x * Vec3::RIGHT + localOffset.y * Vec3::UP;
-
-	// offset so pivot point is at position
-	for (uint i = 0; i < 4; ++i) {
-		corners[i] += worldOffset;
-	}
-
-	CPUMesh mesh;
-
-	AABB2 box = AABB2(corners[2], corners[1]);
-
-	CPUMeshAddQuad(&mesh, box, Rgba::BLACK);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
-
-	//Billboard here
-	RTSCamera* camera = Game::s_gameReference->m_RTSCam;
-	Matrix44 mat = camera->GetModelMatrix();
-	Matrix44 objectModel = Matrix44::IDENTITY;
-	objectModel.SetRotationFromMatrix(objectModel, mat);
-
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), objectModel);
-
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->BindTextureView(0U, nullptr);
-	g_renderContext->DrawMesh(m_quad);
-
-	//Making the actual health bar
 	float ratio = entity.GetHealth() / entity.GetMaxHealth();
-	width = ratio * m_healthBarWidth;
-
-	corners[0] = Vec3::ZERO + height * Vec3::UP;
-	corners[1] = Vec3::ZERO + height * Vec3::UP + width * Vec3::RIGHT;
-	corners[2] = Vec3::ZERO;
-	corners[3] = Vec3::ZERO + width * Vec3::RIGHT;
-
-	localOffset = -1.f * (pivot * Vec2(width, height));
-	worldOffset = localOffset.x * Vec3::RIGHT + localOffset.y * Vec3::UP;
-
-	// offset so pivot point is at position
-	for (uint i = 0; i < 4; ++i) {
-		corners[i] += worldOffset;
-	}
-
-	box = AABB2(corners[2], corners[1]);
 
 	Rgba drawColor = Rgba::GREEN;
 	if (ratio < 0.8f && ratio > 0.3f)
@@ -607,31 +766,12 @@ void Map::DrawHealthBar(const Entity& entity) const
 		drawColor = Rgba::RED;
 	}
 
-	CPUMeshAddQuad(&mesh, box, drawColor);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
-
-	//Billboard here
-	mat = camera->GetModelMatrix();
-	objectModel = Matrix44::IDENTITY;
-	objectModel.SetRotationFromMatrix(objectModel, mat);
-
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), objectModel);
-
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->BindTextureView(0U, nullptr);
-	g_renderContext->DrawMesh(m_quad);
+	m_statusBarBatcher->AddBar(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), ratio, drawColor);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::DrawProgressBar(const Entity& entity) const
 {
-	//Draw the health bar
-	Vec3 corners[4];
-
-	float width = m_healthBarWidth;
-	float height = m_healthBarHeight;
-
 	float zHeight;
 	switch (entity.GetType())
 	{
@@ -643,128 +783,94 @@ void Map::DrawProgressBar(const Entity& entity) const
 		break;
 	}
 
-	Vec2 pivot = m_healthBarPivot;
-
-	corners[0] = Vec3::ZERO + height * Vec3::UP;
-	corners[1] = Vec3::ZERO + height * Vec3::UP + width * Vec3::RIGHT;
-	corners[2] = Vec3::ZERO;
-	corners[3] = Vec3::ZERO + width * Vec3::RIGHT;
-
-	Vec2 localOffset = -1.f * (pivot * Vec2(width, height));
-	Vec3 worldOffset = localOffset.x * Vec3::RIGHT + localOffset.y * Vec3::UP;
-
-	// offset so pivot point is at position
-	for (uint i = 0; i < 4; ++i) {
-		corners[i] += worldOffset;
-	}
-
-	CPUMesh mesh;
-
-	AABB2 box = AABB2(corners[2], corners[1]);
-
-	CPUMeshAddQuad(&mesh, box, Rgba::BLACK);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
-
-	//Billboard here
-	RTSCamera* camera = Game::s_gameReference->m_RTSCam;
-	Matrix44 mat = camera->GetModelMatrix();
-	Matrix44 objectModel = Matrix44::IDENTITY;
-	objectModel.SetRotationFromMatrix(objectModel, mat);
-
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), objectModel);
-
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->BindTextureView(0U, nullptr);
-	g_renderContext->DrawMesh(m_quad);
-
-	//Making the actual health bar
 	float ratio = entity.GetTrainingProgress() / entity.GetTrainingDuration();
-	width = ratio * m_healthBarWidth;
-
-	corners[0] = Vec3::ZERO + height * Vec3::UP;
-	corners[1] = Vec3::ZERO + height * Vec3::UP + width * Vec3::RIGHT;
-	corners[2] = Vec3::ZERO;
-	corners[3] = Vec3::ZERO + width * Vec3::RIGHT;
-
-	localOffset = -1.f * (pivot * Vec2(width, height));
-	worldOffset = localOffset.x * Vec3::RIGHT + localOffset.y * Vec3::UP;
-
-	// offset so pivot point is at position
-	for (uint i = 0; i < 4; ++i) {
-		corners[i] += worldOffset;
-	}
-
-	box = AABB2(corners[2], corners[1]);
-
-	Rgba drawColor = Rgba::BLUE;
-
-	CPUMeshAddQuad(&mesh, box, drawColor);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
-
-	//Billboard here
-	mat = camera->GetModelMatrix();
-	objectModel = Matrix44::IDENTITY;
-	objectModel.SetRotationFromMatrix(objectModel, mat);
-
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), objectModel);
-
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->BindTextureView(0U, nullptr);
-	g_renderContext->DrawMesh(m_quad);
+	m_statusBarBatcher->AddBar(Vec3(entity.GetPosition()) + Vec3(0.f, 0.f, zHeight), ratio, Rgba::BLUE);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::RenderResourceEntity(const Entity& entity) const
 {
 	float ratio = entity.GetHealth() / entity.GetMaxHealth();
-	//Render the model at entity position
-	GPUMesh* mesh = nullptr;
 
+	ResourceMeshT meshState = WEAK;
 	if (ratio >= 0.8f)
 	{
-		mesh = g_renderContext->CreateOrGetMeshFromFile(entity.GetMeshIDForState(SOURCE));
+		meshState = SOURCE;
 	}
 	else if (ratio < 0.8f && ratio >= 0.3f)
 	{
-		mesh = g_renderContext->CreateOrGetMeshFromFile(entity.GetMeshIDForState(FULL));
+		meshState = FULL;
 	}
-	else if (ratio < 0.3f)
+
+	//Only look the model up when the tree changed model since we last saw it, from its health or a reloaded definition. Its
+	//handle is the state id so a reload swapping the handle replaces the instance; one still loading is left out until it arrives
+	ModelHandle modelHandle = entity.GetModelHandleForState(meshState);
+	if (modelHandle == INVALID_MODEL_HANDLE)
 	{
-		mesh = g_renderContext->CreateOrGetMeshFromFile(entity.GetMeshIDForState(WEAK));
+		ERROR_AND_DIE("The model to be rendered was never requested");
 	}
 
-	Matrix44 objectModel = Matrix44::IDENTITY;
-	//objectModel = objectModel.MakeUniformScale3D(0.00390625f);
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()), objectModel);
-
-	if (mesh == nullptr)
+	Vec3 position = Vec3(entity.GetPosition());
+	if (!m_staticModels->IsInstanceCurrent(entity.GetHandle(), modelHandle, position))
 	{
-		ERROR_AND_DIE("The mesh to be rendered was nullptr");
-	}
+		Model* model = g_modelRegistry->GetModel(modelHandle);
+		if (model != nullptr)
+		{
+			StaticModelGroupKey key;
+			key.m_mesh = model->m_mesh;
+			key.m_material = g_renderResources->GetMaterial(m_treeMaterial);
 
-	g_renderContext->BindMaterial(g_renderContext->CreateOrGetMaterialFromFile(m_treeMaterialFile));
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->DrawMesh(mesh);
+			Matrix44 objectModel = Matrix44::IDENTITY;
+			//objectModel = objectModel.MakeUniformScale3D(0.00390625f);
+			objectModel = Matrix44::SetTranslation3D(position, objectModel);
+
+			m_staticModels->SetInstance(entity.GetHandle(), modelHandle, position, key, objectModel);
+		}
+	}
 
 	DrawHealthBar(entity);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Map::RenderTownCenter(const Entity& entity) const
+void Map::SyncBuildingModel(const Entity& entity, const Model& model) const
 {
-	//Render the model at entity position
+	Vec3 position = Vec3(entity.GetPosition());
+	uint team = (uint)entity.GetTeam();
+
+	//Marked even when the instance is current, so it isn't evicted while on screen. The override is the only render
+	//resources texture the map draws; sprite, terrain and material textures are loaded by the render context
+	//and can't stream
+	if (team == 2)
+	{
+		g_assetResidency->MarkTextureUsed(m_goblinBuildingTexture);
+	}
+
+	if (m_staticModels->IsInstanceCurrent(entity.GetHandle(), team, position))
+		return;
+
+	//Until the goblin texture has streamed in the building draws with its own
+	StaticModelGroupKey key;
+	key.m_mesh = model.m_mesh;
+	key.m_material = model.m_material;
+	if (team == 2)
+	{
+		key.m_textureOverride = g_renderResources->GetTexture(m_goblinBuildingTexture);
+	}
+
 	Matrix44 objectModel = Matrix44::IDENTITY;
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()), objectModel);
+	objectModel = Matrix44::SetTranslation3D(position, objectModel);
+
+	m_staticModels->SetInstance(entity.GetHandle(), team, position, key, objectModel);
+}
 
-	g_renderContext->BindMaterial(m_townCenter->m_material);
-	if (entity.GetTeam() == 2)
+//------------------------------------------------------------------------------------------------------------------------------
+void Map::RenderTownCenter(const Entity& entity) const
+{
+	Model* townCenter = g_modelRegistry->GetModel(m_townCenterModel);
+	if (townCenter != nullptr)
 	{
-		g_renderContext->BindTextureView(0U, m_goblinBuildingTexture);
+		SyncBuildingModel(entity, *townCenter);
 	}
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->DrawMesh(m_townCenter->m_mesh);
 
 	DrawHealthBar(entity);
 
@@ -777,17 +883,11 @@ void Map::RenderTownCenter(const Entity& entity) const
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::RenderHut(const Entity& entity) const
 {
-	//Render the model at entity position
-	Matrix44 objectModel = Matrix44::IDENTITY;
-	objectModel = Matrix44::SetTranslation3D(Vec3(entity.GetPosition()), objectModel);
-
-	g_renderContext->BindMaterial(m_hut->m_material);
-	if (entity.GetTeam() == 2)
+	Model* hut = g_modelRegistry->GetModel(m_hutModel);
+	if (hut != nullptr)
 	{
-		g_renderContext->BindTextureView(0U, m_goblinBuildingTexture);
+		SyncBuildingModel(entity, *hut);
 	}
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->DrawMesh(m_hut->m_mesh);
 
 	DrawHealthBar(entity);
 
@@ -800,6 +900,11 @@ void Map::RenderHut(const Entity& entity) const
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::RenderBuildingPreview(EntityTypeT type) const
 {
+	Model* townCenter = g_modelRegistry->GetModel(m_townCenterModel);
+	Model* building = g_modelRegistry->GetModel(type == TOWNCENTER ? m_townCenterModel : m_hutModel);
+	if (townCenter == nullptr || building == nullptr)
+		return;
+
 	Matrix44 objectModel = Matrix44::IDENTITY;
 
 	GameInput* input = Game::s_gameReference->m_gameInput;
@@ -809,142 +914,104 @@ void Map::RenderBuildingPreview(EntityTypeT type) const
 	Vec3 terrainPos = Vec3(correctedPos);
 	objectModel = Matrix44::SetTranslation3D(terrainPos, objectModel);
 
+	//Blocked spots draw with the plain red shader, which samples nothing
+	RenderDrawState state;
+	state.m_mesh = building->m_mesh;
 	if (IsRegionOccupied(correctedPos, m_townCenterOcc))
 	{
-		g_renderContext->BindShader(m_redShader);
+		state.m_shader = m_redShader;
 	}
 	else
 	{
-		g_renderContext->BindMaterial(m_townCenter->m_material);
+		state.m_material = townCenter->m_material;
 	}
 
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->BindTextureView(0U, nullptr);
-
-	if (type == TOWNCENTER)
-	{
-		g_renderContext->DrawMesh(m_townCenter->m_mesh);
-	}
-	else
-	{
-		g_renderContext->DrawMesh(m_hut->m_mesh);
-	}
+	RenderPacketBuffer& buffer = m_renderQueue->GetBuffer(0U);
+	float depth = (terrainPos - GetCameraEyePosition()).GetLength();
+	uint64_t sortKey = MakeRenderSortKey(RENDER_PASS_OPAQUE, state.m_shader, state.m_material, nullptr, depth);
+	buffer.AddPacket(sortKey, buffer.AddState(state), buffer.AddTransform(objectModel));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Map::DrawBillBoardedIsoSprites(const Vec2& position, const Vec3& orientation, const IsoSpriteDefenition& isoDef, const RTSCamera& camera, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const
+void Map::DrawBillBoardedIsoSprites(const Vec2& position, const Vec3& localDirection, const IsoSpriteDefenition& isoDef, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const
 {
-	Matrix44 viewMat = camera.GetViewMatrix();
-	Vec3 entityForwardRelativeToCamera = viewMat.TransformVector3D(orientation);
-	//Get the correct sprite for the direction
-	SpriteDefenition *sprite = &isoDef.GetSpriteForLocalDirection(entityForwardRelativeToCamera);
+	//Get the correct sprite for the direction, already snapped to an octant in camera space
+	SpriteDefenition *sprite = &isoDef.GetSpriteForLocalDirection(localDirection);
 	//Now draw the sprite
-	DrawBillBoardedSprite(position, *sprite, camera, type, drawColor, animState);
+	DrawBillBoardedSprite(position, *sprite, type, drawColor, animState);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void Map::DrawBillBoardedSprite(const Vec3& position, const SpriteDefenition& sprite, const RTSCamera& camera, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const
+void Map::DrawBillBoardedSprite(const Vec3& position, const SpriteDefenition& sprite, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const
 {
 	// tl - tr
 	// |     | 
 	// bl - br
-	Vec3 corners[4];
+	//Corners are in billboard space, x along the camera's right and y along its up
+	Vec2 corners[4];
 	Vec2 uvs[4];
 	
 	float width = m_entityWidth;
 	float height = m_entityHeight;
 	Vec2 pivot = sprite.GetPivot();
 
-	// technically right
-	//Vec3 right = camera.GetCameraRight();
-	//Vec3 up = camera.GetCameraUp();
-
-	corners[0] = Vec3::ZERO + height * Vec3::UP;
-	corners[1] = Vec3::ZERO + height * Vec3::UP + width * Vec3::RIGHT;
-	corners[2] = Vec3::ZERO;
-	corners[3] = Vec3::ZERO + width * Vec3::RIGHT;
+	corners[0] = Vec2(0.f, height);
+	corners[1] = Vec2(width, height);
+	corners[2] = Vec2(0.f, 0.f);
+	corners[3] = Vec2(width, 0.f);
 
 	Vec2 localOffset = -1.f * (pivot * Vec2(width, height));
-	Vec3 worldOffset = localOffset.x * Vec3::RIGHT + localOffset.y * Vec3::UP;
-	// vec3 worldOffset = (vec4( localOffset, 0, 0 ) * camera->GetCameraMatrix()).xyz();
 
 	// offset so pivot point is at position
 	for (uint i = 0; i < 4; ++i) {
-		corners[i] += worldOffset;
+		corners[i] += localOffset;
 	}
 
 	sprite.GetUVs(uvs[0], uvs[3]);
 	std::swap(uvs[0].y, uvs[3].y);
 
-	CPUMesh mesh;
+	//Billboard here with the basis set up for the frame. The quad is placed in world space so every sprite sharing a texture
+	//can go out in one draw
+	const SpriteCameraSetup& cameraSetup = m_spriteFacing->GetCameraSetup();
 
-	AABB2 box = AABB2(corners[2], corners[1]);
+	SpriteQuad quad;
+	quad.m_texture = GetSpriteTexture(type, animState);
+	for (uint i = 0; i < 4; ++i)
+	{
+		quad.m_corners[i] = position + corners[i].x * cameraSetup.m_billboardRight + corners[i].y * cameraSetup.m_billboardUp;
+	}
+	quad.m_uvMins = uvs[0];
+	quad.m_uvMaxs = uvs[3];
+	quad.m_color = drawColor;
 
-	CPUMeshAddQuad(&mesh, box, drawColor, uvs[0], uvs[3]);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
+	Vec3 fromEye = position - GetCameraEyePosition();
+	quad.m_sortDepth = fromEye.x * fromEye.x + fromEye.y * fromEye.y + fromEye.z * fromEye.z;
 
-	//Billboard here
-	Matrix44 mat = camera.GetModelMatrix();
-	Matrix44 objectModel = Matrix44::IDENTITY;
-	objectModel.SetRotationFromMatrix(objectModel, mat);
+	//Sheets packed into the unit atlas draw from their page so every unit lands in the same batch
+	const SpriteAtlasRegion* region = Game::s_gameReference->m_unitAtlas->FindRegion(quad.m_texture);
+	if (region != nullptr)
+	{
+		quad.m_texture = region->m_page;
+		quad.m_uvMins = region->RemapUV(quad.m_uvMins);
+		quad.m_uvMaxs = region->RemapUV(quad.m_uvMaxs);
+	}
 
-	objectModel = Matrix44::SetTranslation3D(position, objectModel);
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
+	m_spriteBatcher->AddQuad(quad);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* Map::GetSpriteTexture(EntityTypeT type, eAnimationType animState) const
+{
+	Game* game = Game::s_gameReference;
+	bool isAttacking = (animState == ANIMATION_ATTACK);
 
 	switch (type)
 	{
-	case PEON:
-		switch (animState)
-		{
-		case ANIMATION_ATTACK:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_peonAttackTexture);
-		}
-		break;
-		default:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_peonTexture);
-		}
-		break;
-		}
-		break;
-	case WARRIOR:
-		switch (animState)
-		{
-		case ANIMATION_ATTACK:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_warriorAttackTexture);
-		}
-		break;
-		default:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_warriorTexture);
-		}
-		break;
-		}
-		break;
-	case GOBLIN:
-		switch (animState)
-		{
-		case ANIMATION_ATTACK:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_goblinAttackTexture);
-		}
-		break;
-		default:
-		{
-			g_renderContext->BindTextureView(0U, Game::s_gameReference->m_goblinTexture);
-		}
-		break;
-		}
-		break;
-	default:
-		break;
+	case PEON:		return isAttacking ? game->m_peonAttackTexture : game->m_peonTexture;
+	case WARRIOR:	return isAttacking ? game->m_warriorAttackTexture : game->m_warriorTexture;
+	case GOBLIN:	return isAttacking ? game->m_goblinAttackTexture : game->m_goblinTexture;
+	default:		return nullptr;
 	}
-
-	g_renderContext->BindModelMatrix(objectModel);
-	g_renderContext->DrawMesh(m_quad);
-	g_renderContext->BindTextureView(0U, nullptr);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -1053,26 +1120,26 @@ Entity* Map::CreateEntity(const Vec2& pos, EntityTypeT entityType, int team )
 	{
 	case PEON:
 	{
-		entity->MakeFromXML(m_peonXMLFile);
+		entity->MakeFromDefinition(m_peonXMLFile);
 		entity->SetType(PEON);
 	}
 	break;
 	case WARRIOR:
 	{
-		entity->MakeFromXML(m_warriorXMLFile);
+		entity->MakeFromDefinition(m_warriorXMLFile);
 		entity->SetType(WARRIOR);
 	}
 	break;
 	case TREE:
 	{
-		entity->MakeFromXML(m_treeXMLFile);
+		entity->MakeFromDefinition(m_treeXMLFile);
 		entity->SetType(TREE);
 	}
 	break;
 	case TOWNCENTER:
 	{
 		//This is some sketch bro
-		entity->MakeFromXML(m_townCenterXMLFile);
+		entity->MakeFromDefinition(m_townCenterXMLFile);
 		entity->SetType(TOWNCENTER);
 		entity->SetAsBuilding(true);
 		entity->SetIsBuilt(false);
@@ -1083,7 +1150,7 @@ Entity* Map::CreateEntity(const Vec2& pos, EntityTypeT entityType, int team )
 	case HUT:
 	{
 		//This is some sketch bro
-		entity->MakeFromXML(m_hutXMLFile);
+		entity->MakeFromDefinition(m_hutXMLFile);
 		entity->SetType(HUT);
 		entity->SetAsBuilding(true);
 		entity->SetIsBuilt(false);
@@ -1093,7 +1160,7 @@ Entity* Map::CreateEntity(const Vec2& pos, EntityTypeT entityType, int team )
 	break;
 	case GOBLIN:
 	{
-		entity->MakeFromXML(m_peonXMLFile);
+		entity->MakeFromDefinition(m_peonXMLFile);
 		entity->SetType(GOBLIN);
 	}
 	break;
@@ -1141,6 +1208,33 @@ Entity* Map::GetEntityAtIndex(int index)
 	}
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+uint Map::ApplyDefinitionChanges(const std::vector<GameplayDefinitionChange>& changes, uint& outNumAnimationSets)
+{
+	uint numPatched = 0U;
+	outNumAnimationSets = 0U;
+
+	for (size_t entityIndex = 0; entityIndex < m_entities.size(); entityIndex++)
+	{
+		Entity* entity = m_entities[entityIndex];
+		if (entity == nullptr || entity->IsGarbage())
+			continue;
+
+		for (size_t changeIndex = 0; changeIndex < changes.size(); changeIndex++)
+		{
+			const GameplayDefinitionChange& change = changes[changeIndex];
+			if (entity->GetDefinitionPath() != change.m_sourcePath)
+				continue;
+
+			const GameplayUnitRecord* unit = g_gameplayData->FindUnit(change.m_sourcePath);
+			outNumAnimationSets += entity->ReloadDefinition(change.m_previous, *unit, change.m_animationsChanged, change.m_meshesChanged);
+			numPatched++;
+		}
+	}
+
+	return numPatched;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void Map::ResolveEntityCollisions()
 {
@@ -9,14 +9,18 @@
 #include <cstdint>
 
 #include "Game/GameTypes.hpp"
+#include "Game/ModelRegistry.hpp"
+#include "Game/RenderResources.hpp"
 
 typedef unsigned int uint;
 typedef uint16_t uint16;
 
 //------------------------------------------------------------------------------------------------------------------------------
 struct Frustum;
+struct GameplayDefinitionChange;
 struct Ray3D;
 struct Rgba;
+struct StateHashEntry;
 struct Vertex_Lit;
 class Entity;
 class GameHandle;
@@ -32,6 +36,17 @@ class Model;
 class Shader;
 class TextureView;
 class AIController;
+class SpriteBatcher;
+class SpriteBatchBackend;
+class StatusBarBatcher;
+class StaticModelRenderer;
+class RenderQueue;
+class RenderQueueBackend;
+class RenderBackend;
+class ViewFootprint;
+class EntityCellGrid;
+class TerrainMesh;
+class SpriteFacingResolver;
 
 //------------------------------------------------------------------------------------------------------------------------------
 struct MapTile
@@ -51,28 +66,39 @@ public:
 	bool				Load( char const* filename );          
 	void				LoadFoliageModels();
 	void				LoadBuildingModels();
+	void				LoadModelList(const std::string& fileName);
 	bool				Create(int mapWidth, int mapHeight);
 	void				CreateAIController();
 
 	void				Update(float deltaTime); 
 	void				PreparePather();
+	void				SolveRequestedPaths();
 	void				UpdateEntities(float deltaTime);
 	void				ClearDeadEntities();
 	void				Render() const; // assumes a camera is already bound
 	void				Shutdown();
 
+	void				SetRenderBackend(RenderBackend* renderBackend);		//Null goes back to the render context
+	static bool			Command_RenderBudget(EventArgs& args);
+
+	void				UpdateViewCulling() const;
+
 	void				RenderTerrain( Material* matOverride = nullptr ) const;
 	void				RenderEntities() const;
 	void				RenderEntityData() const;
-	void				RenderIsoSpriteForEntity(const Entity& entity) const;
+	void				RecordStaticModelPackets() const;
+	Vec3				GetCameraEyePosition() const;
+	void				RenderIsoSpriteForEntity(const Entity& entity, int facingSlot) const;
 	void				DrawHealthBar(const Entity& entity) const;
 	void				DrawProgressBar(const Entity& entity) const;
 	void				RenderResourceEntity(const Entity& entity) const;
 	void				RenderTownCenter(const Entity& entity) const;
 	void				RenderHut(const Entity& entity) const;
+	void				SyncBuildingModel(const Entity& entity, const Model& model) const;
 	void				RenderBuildingPreview(EntityTypeT type) const;
-	void				DrawBillBoardedIsoSprites(const Vec2& position, const Vec3& orientation, const IsoSpriteDefenition& isoDef, const RTSCamera& camera, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const;
-	void				DrawBillBoardedSprite(const Vec3& position, const SpriteDefenition& sprite, const RTSCamera& camera, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const;
+	void				DrawBillBoardedIsoSprites(const Vec2& position, const Vec3& localDirection, const IsoSpriteDefenition& isoDef, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const;
+	void				DrawBillBoardedSprite(const Vec3& position, const SpriteDefenition& sprite, EntityTypeT type, const Rgba& drawColor, eAnimationType animState) const;
+	TextureView*		GetSpriteTexture(EntityTypeT type, eAnimationType animState) const;
 
 	//Map utils
 	void				SetOccupancyForUnit(const Vec2& position, const IntVec2& occupancy, bool isOccupied);
@@ -85,12 +111,14 @@ public:
 	Entity*				CreateEntity(const Vec2& pos, EntityTypeT entityType, int team = 1);
 	Entity*				FindEntity(const GameHandle& handle) const;
 	Entity*				GetEntityAtIndex(int index);
+	uint				ApplyDefinitionChanges(const std::vector<GameplayDefinitionChange>& changes, uint& outNumAnimationSets);
 	void				ResolveEntityCollisions();
 
 	// Pick
 	Entity*				RaycastEntity(float *out, const Ray3D& ray, float maxDistance = INFINITY);
 	uint				RaycastTerrain(float* out, const Ray3D& ray);
 	void				SelectEntitiesInFrustum(std::vector<GameHandle>& entityHandles, const Frustum& selectionFrustum);
+	uint				ComputeEntityStateHash(std::vector<StateHashEntry>* entries) const;
 	bool				IsEntitySelected(const Entity& entity) const;
 
 	int					GetNumEntities() const;
@@ -106,6 +134,9 @@ private:
 	uint				GetFreeEntityIndex(); // return a free entity slot
 	uint				GetNextCyclicID();     // gets the next hi-word to use, skipping '0'
 
+	void				CreateRenderAdapters(RenderBackend* renderBackend);
+	void				DestroyRenderAdapters();
+
 public: 
 	IntVec2					m_tileDimensions; // how many tiles X and Y
 	IntVec2					m_vertDimensions; // how many verts X and Y
@@ -120,26 +151,28 @@ public:
 
 private:
 	std::vector<MapTile>	m_mapTiles;
-	std::vector<Vertex_Lit> m_mapVerts; 
-	std::vector<uint>		m_mapIndices;
 	std::map<int, bool>		m_mapOccupancy;
 
 	std::string				m_materialName = "terrain.mat";
 	std::string				m_redShaderPath = "redShader.xml";
 	Shader*					m_redShader = nullptr;
 
-	GPUMesh*				m_terrainMesh = nullptr; 
+	TerrainMesh*			m_terrain = nullptr;
 	Material*				m_terrainMaterial = nullptr; 
 
 	CPUMesh*				m_entityCPUMesh = nullptr;
 	GPUMesh*				m_entityMesh = nullptr; 
 	
-	//Building Models
-	Model*					m_townCenter = nullptr;
-	Model*					m_hut = nullptr;
+	//Building Models, drawn once the registry has them ready
+	ModelHandle				m_townCenterModel = INVALID_MODEL_HANDLE;
+	ModelHandle				m_hutModel = INVALID_MODEL_HANDLE;
+	std::string				m_townCenterMeshPath = "building/towncenter.mesh";
+	std::string				m_townCenterMaterialPath = "building/towncenter.mat";
+	std::string				m_hutMeshPath = "hut/hut.mesh";
+	std::string				m_hutMaterialPath = "hut/hut.mat";
 	AABB2					m_mapBounds;
 
-	TextureView*			m_goblinBuildingTexture = nullptr;
+	TextureHandle			m_goblinBuildingTexture = INVALID_RENDER_HANDLE;		//Streamed, see AssetResidency
 
 	// map entity data
 	std::vector<Entity*>	m_entities;
@@ -163,7 +196,29 @@ private:
 	int						m_warriorCost = 15;
 	int						m_hutCost = 20;
 
-	GPUMesh*				m_quad = nullptr;
+	//Everything the frame draws goes through m_renderBackend, the adapters below are rebuilt whenever it is swapped
+	RenderBackend*			m_renderBackend = nullptr;
+	RenderBackend*			m_liveRenderBackend = nullptr;
+	Shader*					m_spriteShader = nullptr;
+
+	SpriteBatcher*			m_spriteBatcher = nullptr;
+	SpriteBatchBackend*		m_spriteBackend = nullptr;
+	StatusBarBatcher*		m_statusBarBatcher = nullptr;
+	SpriteBatchBackend*		m_statusBarBackend = nullptr;
+	StaticModelRenderer*	m_staticModels = nullptr;
+	RenderQueue*			m_renderQueue = nullptr;
+	RenderQueueBackend*		m_renderQueueBackend = nullptr;
+	uint					m_minPacketsPerRecordJob = 64U;
+
+	//View culling, rebuilt at the start of every render
+	ViewFootprint*			m_viewFootprint = nullptr;
+	EntityCellGrid*			m_entityGrid = nullptr;
+	float					m_entityCellSize = 8.f;
+	float					m_viewCullMargin = 6.f;		//Covers building extents and how far models and sprites stand up
+	float					m_viewCullFarDistance = 200.f;	//Used for corner rays that never reach the ground
+
+	//Billboard basis and unit facings, resolved once per frame before any sprite is built
+	SpriteFacingResolver*	m_spriteFacing = nullptr;
 
 	//Data driving 
 	std::string				m_peonXMLFile = "Data/Gameplay/peon.xml";
@@ -172,11 +227,13 @@ private:
 	std::string				m_treeXMLFile = "Data/Gameplay/tree.xml";
 	std::string				m_townCenterXMLFile = "Data/Gameplay/building_townCenter.xml";
 	std::string				m_hutXMLFile = "Data/Gameplay/building_hut.xml";
-	std::string				m_goblinBuildingTexturePath = "goblin.diffuse.png";
+	std::string				m_goblinBuildingTexturePath = "Data/Images/goblin.diffuse.png";
 
 	std::string				m_treeModelsXMLFile = "Data/Gameplay/tree_models.xml";
 	std::string				m_buildingModelsXMLFile = "Data/Gameplay/building_models.xml";
 	std::string				m_treeMaterialFile = "Data/Models/foliage/foliage.mat";
+	MaterialHandle			m_treeMaterial = INVALID_RENDER_HANDLE;
+	ShaderHandle			m_debugLitShader = INVALID_RENDER_HANDLE;
 
 	PathSolver				m_pathSolver;
 	void CheckAIEntities();
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MappedFile.hpp"
+//Others
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN		// Always #define this before #including <windows.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Empty files are refused, neither platform will map zero bytes
+//------------------------------------------------------------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_data = (const unsigned char*)view;
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int file = open(filePath.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat fileStats;
+	if (fstat(file, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* view = mmap(nullptr, (size_t)fileStats.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+		return false;
+
+	m_data = (const unsigned char*)view;
+	m_size = (size_t)fileStats.st_size;
+#endif
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MappedFile::Close()
+{
+	if (m_data == nullptr)
+		return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(m_data);
+	CloseHandle((HANDLE)m_mappingHandle);
+	CloseHandle((HANDLE)m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	munmap((void*)m_data, m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each write gets its own temporary name so two workers cooking the same file never write into one another's. Replacing
+// fails on Windows while the old file is still mapped, the temporary is removed and the old file is left in place
+//------------------------------------------------------------------------------------------------------------------------------
+bool WriteFileReplacing(const std::string& filePath, const void* data, size_t numBytes)
+{
+	static std::atomic<uint> s_nextTempIndex(0U);
+	std::string tempPath = filePath + ".tmp" + std::to_string(s_nextTempIndex++);
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		if (!file.write((const char*)data, (std::streamsize)numBytes) || !file.flush())
+		{
+			file.close();
+			std::remove(tempPath.c_str());
+			return false;
+		}
+	}
+
+#if defined(_WIN32)
+	bool replaced = MoveFileExA(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	bool replaced = std::rename(tempPath.c_str(), filePath.c_str()) == 0;
+#endif
+
+	if (!replaced)
+	{
+		std::remove(tempPath.c_str());
+	}
+	return replaced;
+}
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A read only view of a whole file mapped into memory. Pages are faulted in by the OS as they are touched, nothing is
+// copied up front
+//------------------------------------------------------------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	bool					Open(const std::string& filePath);
+	void					Close();
+
+	inline bool				IsOpen() const { return m_data != nullptr; }
+	inline const unsigned char*	GetData() const { return m_data; }
+	inline size_t			GetSize() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile& copy) = delete;
+	MappedFile& operator=(const MappedFile& copy) = delete;
+
+private:
+	const unsigned char*	m_data = nullptr;
+	size_t					m_size = 0U;
+
+	void*					m_fileHandle = nullptr;		//Only used on Windows, the mapping keeps what it needs elsewhere
+	void*					m_mappingHandle = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Writes the bytes to a temporary file beside filePath and then moves it over filePath, so a reader or a crash mid-write
+// never leaves a half written file under the real name
+//------------------------------------------------------------------------------------------------------------------------------
+bool	WriteFileReplacing(const std::string& filePath, const void* data, size_t numBytes);
@@ -0,0 +1,930 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MeshCooker.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vertex_Lit.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+//Game Systems
+#include "Game/StartupProfiler.hpp"
+//Others
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+extern RenderContext* g_renderContext;
+
+static const char		COOKED_MESH_MAGIC[4] = { 'R', 'T', 'S', 'M' };
+static const uint64_t	FNV_PRIME = 1099511628211ULL;
+static const uint		COOKED_SECTION_ALIGNMENT = 16U;
+
+//Each part of an OBJ corner gets 21 bits of the dedupe key
+static const int		MAX_OBJ_ELEMENTS = (1 << 21) - 1;
+
+//Steps a position and a UV are rounded to when matching cooked triangles against ObjectLoader's
+static const float		CHECK_POSITION_STEP = 0.001f;
+static const float		CHECK_UV_STEP = 0.0001f;
+static const float		CHECK_MIN_NORMAL_DOT = 0.99f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookVec3
+{
+	float x = 0.f;
+	float y = 0.f;
+	float z = 0.f;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ObjCorner
+{
+	int		m_position = 0;		//1 based, 0 when the face left it out
+	int		m_uv = 0;
+	int		m_normal = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static CookVec3 Subtract(const CookVec3& a, const CookVec3& b)
+{
+	CookVec3 result;
+	result.x = a.x - b.x;
+	result.y = a.y - b.y;
+	result.z = a.z - b.z;
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static CookVec3 Cross(const CookVec3& a, const CookVec3& b)
+{
+	CookVec3 result;
+	result.x = a.y * b.z - a.z * b.y;
+	result.y = a.z * b.x - a.x * b.z;
+	result.z = a.x * b.y - a.y * b.x;
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float Dot(const CookVec3& a, const CookVec3& b)
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static CookVec3 Normalized(const CookVec3& a, const CookVec3& fallback)
+{
+	float length = sqrtf(Dot(a, a));
+	if (length <= 1.0e-12f)
+		return fallback;
+
+	CookVec3 result;
+	result.x = a.x / length;
+	result.y = a.y / length;
+	result.z = a.z / length;
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddTo(float* accumulated, const CookVec3& value)
+{
+	accumulated[0] += value.x;
+	accumulated[1] += value.y;
+	accumulated[2] += value.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static CookVec3 ToCookVec3(const float* values)
+{
+	CookVec3 result;
+	result.x = values[0];
+	result.y = values[1];
+	result.z = values[2];
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint AlignUp(uint value, uint alignment)
+{
+	return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The bytes always end in a NUL that isn't part of the file, so strtof and strtol stop there on a last line without a newline
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadWholeFile(const std::string& filePath, std::vector<char>& outBytes)
+{
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	outBytes.resize((size_t)size + 1U);
+	outBytes[(size_t)size] = '\0';
+	StartupProfiler::CountBytesRead((uint64_t)size);
+	return size == 0 || (bool)file.read(outBytes.data(), size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// OBJ indices are 1 based and negative ones count back from the end of what has been read so far
+//------------------------------------------------------------------------------------------------------------------------------
+static int ResolveObjIndex(long index, size_t numRead)
+{
+	if (index < 0)
+		return (int)((long)numRead + index + 1);
+	return (int)index;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const char* SkipSpaces(const char* cursor, const char* end)
+{
+	while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+	{
+		cursor++;
+	}
+	return cursor;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Reads up to maxValues floats off the rest of the line. strtof stops at the newline, or at the NUL ReadWholeFile puts after
+// the last line, so it never reads past the buffer
+//------------------------------------------------------------------------------------------------------------------------------
+static int ReadFloats(const char* cursor, const char* lineEnd, float* outValues, int maxValues)
+{
+	int numRead = 0;
+	while (numRead < maxValues)
+	{
+		cursor = SkipSpaces(cursor, lineEnd);
+		if (cursor >= lineEnd)
+			break;
+
+		char* next = nullptr;
+		outValues[numRead] = strtof(cursor, &next);
+		if (next == cursor)
+			break;
+
+		cursor = next;
+		numRead++;
+	}
+	return numRead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string MeshCooker::GetCookedPath(const std::string& meshPath)
+{
+	return meshPath + ".cooked";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::CookIfStale(const std::string& modelRoot, const std::string& meshPath, std::string& outError)
+{
+	std::string cookedPath = GetCookedPath(meshPath);
+
+	MeshCookSettings settings;
+	std::vector<char> meshBytes;
+	std::vector<char> objBytes;
+	bool hasSources = ReadMeshSettings(modelRoot, meshPath, settings, outError) && ReadWholeFile(meshPath, meshBytes);
+	if (hasSources && !ReadWholeFile(settings.m_sourcePath, objBytes))
+	{
+		outError = "Could not read mesh source " + settings.m_sourcePath;
+		hasSources = false;
+	}
+
+	CookedMesh existing;
+	bool hasCooked = existing.Open(cookedPath);
+	if (!hasSources)
+	{
+		//Shipped without sources, whatever was cooked is what we have
+		return hasCooked;
+	}
+
+	uint64_t sourceHash = HashBytes(objBytes, HashBytes(meshBytes, COOKED_HASH_BASIS ^ COOKED_MESH_VERSION));
+	if (hasCooked && existing.GetHeader().m_sourceHash == sourceHash)
+		return true;
+
+	//The old blob has to be unmapped before it can be written over
+	existing.Close();
+	return CookFromSources(meshPath, settings, objBytes, sourceHash, outError);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::ReadMeshSettings(const std::string& modelRoot, const std::string& meshPath, MeshCookSettings& outSettings, std::string& outError)
+{
+	tinyxml2::XMLDocument meshDoc;
+	meshDoc.LoadFile(meshPath.c_str());
+	if (meshDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		outError = "Could not read mesh file " + meshPath;
+		return false;
+	}
+
+	XMLElement* rootElement = meshDoc.RootElement();
+	std::string source = ParseXmlAttribute(*rootElement, "src", "");
+	if (source == "")
+	{
+		outError = "Mesh file " + meshPath + " has no src";
+		return false;
+	}
+
+	outSettings.m_sourcePath = modelRoot + source;
+	outSettings.m_scale = ParseXmlAttribute(*rootElement, "scale", 1.f);
+	outSettings.m_invertWinding = ParseXmlAttribute(*rootElement, "invert", false);
+	outSettings.m_generateTangents = ParseXmlAttribute(*rootElement, "tangents", true);
+
+	std::string transform = ParseXmlAttribute(*rootElement, "transform", "x y z");
+	if (!ParseAxisTransform(transform, outSettings))
+	{
+		outError = "Mesh file " + meshPath + " has a bad transform " + transform;
+		return false;
+	}
+
+	outSettings.m_materialPaths.clear();
+	for (XMLElement* element = rootElement->FirstChildElement("material"); element != nullptr; element = element->NextSiblingElement("material"))
+	{
+		uint index = (uint)ParseXmlAttribute(*element, "index", (int)outSettings.m_materialPaths.size());
+		if (index >= outSettings.m_materialPaths.size())
+		{
+			outSettings.m_materialPaths.resize(index + 1U);
+		}
+		outSettings.m_materialPaths[index] = ParseXmlAttribute(*element, "src", "");
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Three space separated axes, each an optional sign and x, y or z, e.g. "-y -z -x". Every source axis has to be used once
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::ParseAxisTransform(const std::string& transform, MeshCookSettings& outSettings)
+{
+	const char* cursor = transform.c_str();
+	const char* end = cursor + transform.size();
+	bool axisUsed[3] = { false, false, false };
+
+	for (int outputAxis = 0; outputAxis < 3; outputAxis++)
+	{
+		cursor = SkipSpaces(cursor, end);
+
+		float sign = 1.f;
+		if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		{
+			sign = *cursor == '-' ? -1.f : 1.f;
+			cursor++;
+		}
+
+		if (cursor >= end || *cursor < 'x' || *cursor > 'z')
+			return false;
+
+		int sourceAxis = *cursor - 'x';
+		if (axisUsed[sourceAxis])
+			return false;
+
+		axisUsed[sourceAxis] = true;
+		outSettings.m_axes[outputAxis] = sourceAxis;
+		outSettings.m_axisSigns[outputAxis] = sign;
+		cursor++;
+	}
+
+	return SkipSpaces(cursor, end) == end;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint64_t MeshCooker::HashBytes(const std::vector<char>& bytes, uint64_t hash)
+{
+	return HashBytes((const unsigned char*)bytes.data(), bytes.size(), hash);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint64_t MeshCooker::HashBytes(const unsigned char* bytes, size_t numBytes, uint64_t hash)
+{
+	for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A triangle with its corners rounded for matching, rotated so the smallest corner comes first. Rotating keeps the winding
+//------------------------------------------------------------------------------------------------------------------------------
+struct CheckTriangle
+{
+	int		m_corners[3][5];			//Rounded position and UV per corner
+	float	m_normals[3][3];
+
+	bool operator<(const CheckTriangle& other) const { return memcmp(m_corners, other.m_corners, sizeof(m_corners)) < 0; }
+	bool operator==(const CheckTriangle& other) const { return memcmp(m_corners, other.m_corners, sizeof(m_corners)) == 0; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddCheckTriangle(std::vector<CheckTriangle>& triangles, const float positions[3][3], const float uvs[3][2], const float normals[3][3])
+{
+	CheckTriangle triangle;
+	for (int corner = 0; corner < 3; corner++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			triangle.m_corners[corner][axis] = (int)floorf(positions[corner][axis] / CHECK_POSITION_STEP + 0.5f);
+			triangle.m_normals[corner][axis] = normals[corner][axis];
+		}
+		triangle.m_corners[corner][3] = (int)floorf(uvs[corner][0] / CHECK_UV_STEP + 0.5f);
+		triangle.m_corners[corner][4] = (int)floorf(uvs[corner][1] / CHECK_UV_STEP + 0.5f);
+	}
+
+	int first = 0;
+	for (int corner = 1; corner < 3; corner++)
+	{
+		if (memcmp(triangle.m_corners[corner], triangle.m_corners[first], sizeof(triangle.m_corners[0])) < 0)
+		{
+			first = corner;
+		}
+	}
+
+	CheckTriangle rotated;
+	for (int corner = 0; corner < 3; corner++)
+	{
+		memcpy(rotated.m_corners[corner], triangle.m_corners[(first + corner) % 3], sizeof(rotated.m_corners[0]));
+		memcpy(rotated.m_normals[corner], triangle.m_normals[(first + corner) % 3], sizeof(rotated.m_normals[0]));
+	}
+	triangles.push_back(rotated);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The cooker splits triangles by material and drops duplicate vertices, so the two meshes are compared as sorted triangle
+// lists. Positions, UVs and winding have to match after rounding and normals have to point the same way. Tangents are left
+// out, ObjectLoader builds them its own way
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::CheckAgainstObjectLoader(const std::string& modelRoot, const std::string& meshPath, std::string& outError)
+{
+	if (!CookIfStale(modelRoot, meshPath, outError))
+		return false;
+
+	CookedMesh cooked;
+	if (!cooked.Open(GetCookedPath(meshPath)))
+	{
+		outError = "Could not map cooked mesh for " + meshPath;
+		return false;
+	}
+
+	std::vector<CheckTriangle> cookedTriangles;
+	const CookedMeshHeader& header = cooked.GetHeader();
+	for (uint index = 0; index + 2U < header.m_numIndices; index += 3U)
+	{
+		float positions[3][3];
+		float uvs[3][2];
+		float normals[3][3];
+		for (uint corner = 0; corner < 3U; corner++)
+		{
+			const CookedMeshVertex& vertex = cooked.GetVertices()[cooked.GetIndex(index + corner)];
+			memcpy(positions[corner], vertex.m_position, sizeof(positions[corner]));
+			memcpy(uvs[corner], vertex.m_uv, sizeof(uvs[corner]));
+			memcpy(normals[corner], vertex.m_normal, sizeof(normals[corner]));
+		}
+		AddCheckTriangle(cookedTriangles, positions, uvs, normals);
+	}
+
+	ObjectLoader object;
+	object.m_renderContext = g_renderContext;
+	object.LoadFromXML(meshPath.c_str());
+	CPUMesh* reference = object.m_cpuMesh;
+	if (reference == nullptr)
+	{
+		outError = "ObjectLoader could not load " + meshPath;
+		return false;
+	}
+
+	//An unindexed reference draws its vertices in order
+	std::vector<CheckTriangle> referenceTriangles;
+	uint numCorners = reference->m_indices.empty() ? (uint)reference->m_vertices.size() : (uint)reference->m_indices.size();
+	for (uint cornerIndex = 0; cornerIndex + 2U < numCorners; cornerIndex += 3U)
+	{
+		float positions[3][3];
+		float uvs[3][2];
+		float normals[3][3];
+		for (uint corner = 0; corner < 3U; corner++)
+		{
+			uint vertexIndex = reference->m_indices.empty() ? cornerIndex + corner : reference->m_indices[cornerIndex + corner];
+			const VertexMaster& vertex = reference->m_vertices[vertexIndex];
+			positions[corner][0] = vertex.m_position.x;
+			positions[corner][1] = vertex.m_position.y;
+			positions[corner][2] = vertex.m_position.z;
+			uvs[corner][0] = vertex.m_uv.x;
+			uvs[corner][1] = vertex.m_uv.y;
+			normals[corner][0] = vertex.m_normal.x;
+			normals[corner][1] = vertex.m_normal.y;
+			normals[corner][2] = vertex.m_normal.z;
+		}
+		AddCheckTriangle(referenceTriangles, positions, uvs, normals);
+	}
+	delete reference;
+
+	if (cookedTriangles.size() != referenceTriangles.size())
+	{
+		outError = Stringf("%s cooks %u triangles, ObjectLoader makes %u", meshPath.c_str(), (uint)cookedTriangles.size(), (uint)referenceTriangles.size());
+		return false;
+	}
+
+	std::sort(cookedTriangles.begin(), cookedTriangles.end());
+	std::sort(referenceTriangles.begin(), referenceTriangles.end());
+	for (size_t triangleIndex = 0; triangleIndex < cookedTriangles.size(); triangleIndex++)
+	{
+		const CheckTriangle& cookedTriangle = cookedTriangles[triangleIndex];
+		const CheckTriangle& referenceTriangle = referenceTriangles[triangleIndex];
+		if (!(cookedTriangle == referenceTriangle))
+		{
+			outError = Stringf("%s triangle %u has a different position, UV or winding than ObjectLoader's", meshPath.c_str(), (uint)triangleIndex);
+			return false;
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const float* cookedNormal = cookedTriangle.m_normals[corner];
+			const float* referenceNormal = referenceTriangle.m_normals[corner];
+			float dot = cookedNormal[0] * referenceNormal[0] + cookedNormal[1] * referenceNormal[1] + cookedNormal[2] * referenceNormal[2];
+			if (dot < CHECK_MIN_NORMAL_DOT)
+			{
+				outError = Stringf("%s triangle %u has a different normal than ObjectLoader's", meshPath.c_str(), (uint)triangleIndex);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Cooks every mesh the asset manifest lists and checks it against ObjectLoader's parse of the same .mesh. Run it after
+// changing the cooker or a .mesh file
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::Command_CheckCookedMeshes(EventArgs& args)
+{
+	std::string manifestPath = args.GetValue("manifest", "Data/Gameplay/asset_manifest.xml");
+
+	tinyxml2::XMLDocument manifestDoc;
+	manifestDoc.LoadFile(manifestPath.c_str());
+	if (manifestDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		g_devConsole->PrintString(Rgba::RED, "Could not read asset manifest " + manifestPath);
+		return false;
+	}
+
+	uint numChecked = 0U;
+	uint numFailed = 0U;
+	XMLElement* rootElement = manifestDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement("mesh"); element != nullptr; element = element->NextSiblingElement("mesh"))
+	{
+		std::string meshPath = MODEL_PATH + ParseXmlAttribute(*element, "path", "");
+		std::string error;
+		numChecked++;
+		if (!CheckAgainstObjectLoader(MODEL_PATH, meshPath, error))
+		{
+			g_devConsole->PrintString(Rgba::RED, error);
+			numFailed++;
+		}
+	}
+
+	if (numFailed > 0U)
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("%u of %u cooked meshes differ from ObjectLoader", numFailed, numChecked));
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("All %u cooked meshes match ObjectLoader", numChecked));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One pass over the OBJ text builds deduplicated vertices and per material triangle lists. Normals the file leaves out are
+// made from the faces, tangents follow the UV gradient across each triangle and are orthogonalized per vertex
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MeshCooker::CookFromSources(const std::string& meshPath, const MeshCookSettings& settings, const std::vector<char>& objBytes, uint64_t sourceHash, std::string& outError)
+{
+	std::vector<CookVec3> positions;
+	std::vector<float> uvs;
+	std::vector<CookVec3> normals;
+
+	std::vector<CookedMeshVertex> vertices;
+	std::vector<ObjCorner> vertexCorners;
+	std::unordered_map<uint64_t, uint> vertexLookup;
+
+	std::vector<std::string> materialNames;
+	std::vector<std::vector<uint>> materialIndices(1);
+	uint currentMaterial = 0U;
+
+	std::vector<uint> faceVertices;
+	//The terminating NUL is not part of the text
+	const char* cursor = objBytes.data();
+	const char* end = cursor + objBytes.size() - 1U;
+
+	while (cursor < end)
+	{
+		const char* lineEnd = (const char*)memchr(cursor, '\n', (size_t)(end - cursor));
+		if (lineEnd == nullptr)
+		{
+			lineEnd = end;
+		}
+
+		const char* line = SkipSpaces(cursor, lineEnd);
+		cursor = lineEnd + 1;
+
+		if (lineEnd - line >= 2 && line[0] == 'v' && line[1] == ' ')
+		{
+			float values[3] = { 0.f, 0.f, 0.f };
+			ReadFloats(line + 2, lineEnd, values, 3);
+
+			CookVec3 position;
+			position.x = settings.m_axisSigns[0] * values[settings.m_axes[0]] * settings.m_scale;
+			position.y = settings.m_axisSigns[1] * values[settings.m_axes[1]] * settings.m_scale;
+			position.z = settings.m_axisSigns[2] * values[settings.m_axes[2]] * settings.m_scale;
+			positions.push_back(position);
+		}
+		else if (lineEnd - line >= 3 && line[0] == 'v' && line[1] == 't' && line[2] == ' ')
+		{
+			float values[2] = { 0.f, 0.f };
+			ReadFloats(line + 3, lineEnd, values, 2);
+			uvs.push_back(values[0]);
+			uvs.push_back(values[1]);
+		}
+		else if (lineEnd - line >= 3 && line[0] == 'v' && line[1] == 'n' && line[2] == ' ')
+		{
+			float values[3] = { 0.f, 0.f, 0.f };
+			ReadFloats(line + 3, lineEnd, values, 3);
+
+			CookVec3 normal;
+			normal.x = settings.m_axisSigns[0] * values[settings.m_axes[0]];
+			normal.y = settings.m_axisSigns[1] * values[settings.m_axes[1]];
+			normal.z = settings.m_axisSigns[2] * values[settings.m_axes[2]];
+			normals.push_back(normal);
+		}
+		else if (lineEnd - line >= 7 && strncmp(line, "usemtl ", 7) == 0)
+		{
+			std::string name(line + 7, lineEnd);
+			while (!name.empty() && (name.back() == '\r' || name.back() == ' ' || name.back() == '\t'))
+			{
+				name.pop_back();
+			}
+
+			//Faces before the first usemtl and faces of the first named material both go to material 0
+			currentMaterial = 0U;
+			for (size_t nameIndex = 0; nameIndex < materialNames.size(); nameIndex++)
+			{
+				if (materialNames[nameIndex] == name)
+				{
+					currentMaterial = (uint)nameIndex;
+					break;
+				}
+			}
+
+			if (materialNames.empty() || materialNames[currentMaterial] != name)
+			{
+				currentMaterial = materialNames.empty() ? 0U : (uint)materialNames.size();
+				materialNames.push_back(name);
+				materialIndices.resize(materialNames.size());
+			}
+		}
+		else if (lineEnd - line >= 2 && line[0] == 'f' && line[1] == ' ')
+		{
+			faceVertices.clear();
+			const char* faceCursor = line + 2;
+			while (true)
+			{
+				faceCursor = SkipSpaces(faceCursor, lineEnd);
+				if (faceCursor >= lineEnd || *faceCursor == '\r')
+					break;
+
+				//v, v/vt, v//vn or v/vt/vn
+				ObjCorner corner;
+				char* next = nullptr;
+				corner.m_position = ResolveObjIndex(strtol(faceCursor, &next, 10), positions.size());
+				faceCursor = next;
+				if (faceCursor < lineEnd && *faceCursor == '/')
+				{
+					faceCursor++;
+					if (faceCursor < lineEnd && *faceCursor != '/')
+					{
+						corner.m_uv = ResolveObjIndex(strtol(faceCursor, &next, 10), uvs.size() / 2U);
+						faceCursor = next;
+					}
+					if (faceCursor < lineEnd && *faceCursor == '/')
+					{
+						faceCursor++;
+						corner.m_normal = ResolveObjIndex(strtol(faceCursor, &next, 10), normals.size());
+						faceCursor = next;
+					}
+				}
+
+				if (corner.m_position <= 0 || corner.m_position > (int)positions.size() || corner.m_uv < 0 || corner.m_uv > (int)(uvs.size() / 2U)
+					|| corner.m_normal < 0 || corner.m_normal > (int)normals.size())
+				{
+					outError = "Face index out of range in " + settings.m_sourcePath;
+					return false;
+				}
+
+				if (corner.m_position > MAX_OBJ_ELEMENTS || corner.m_uv > MAX_OBJ_ELEMENTS || corner.m_normal > MAX_OBJ_ELEMENTS)
+				{
+					outError = "Too many elements to cook in " + settings.m_sourcePath;
+					return false;
+				}
+
+				uint64_t key = ((uint64_t)corner.m_position << 42U) | ((uint64_t)corner.m_uv << 21U) | (uint64_t)corner.m_normal;
+				std::unordered_map<uint64_t, uint>::iterator itr = vertexLookup.find(key);
+				if (itr == vertexLookup.end())
+				{
+					const CookVec3& position = positions[corner.m_position - 1];
+
+					CookedMeshVertex vertex;
+					memset(&vertex, 0, sizeof(vertex));
+					vertex.m_position[0] = position.x;
+					vertex.m_position[1] = position.y;
+					vertex.m_position[2] = position.z;
+					memset(vertex.m_color, 0xFF, sizeof(vertex.m_color));
+					if (corner.m_uv > 0)
+					{
+						vertex.m_uv[0] = uvs[(corner.m_uv - 1) * 2];
+						vertex.m_uv[1] = uvs[(corner.m_uv - 1) * 2 + 1];
+					}
+					if (corner.m_normal > 0)
+					{
+						const CookVec3& normal = normals[corner.m_normal - 1];
+						vertex.m_normal[0] = normal.x;
+						vertex.m_normal[1] = normal.y;
+						vertex.m_normal[2] = normal.z;
+					}
+
+					itr = vertexLookup.insert(std::make_pair(key, (uint)vertices.size())).first;
+					vertices.push_back(vertex);
+					vertexCorners.push_back(corner);
+				}
+
+				faceVertices.push_back(itr->second);
+			}
+
+			//Fan out polygons, winding flipped if the .mesh asks for it
+			std::vector<uint>& indices = materialIndices[currentMaterial];
+			for (size_t cornerIndex = 2; cornerIndex < faceVertices.size(); cornerIndex++)
+			{
+				indices.push_back(faceVertices[0]);
+				indices.push_back(faceVertices[settings.m_invertWinding ? cornerIndex : cornerIndex - 1]);
+				indices.push_back(faceVertices[settings.m_invertWinding ? cornerIndex - 1 : cornerIndex]);
+			}
+		}
+	}
+
+	//Materials go out in order, each one a contiguous range
+	std::vector<uint> indices;
+	std::vector<CookedSubmesh> submeshes;
+	for (size_t materialIndex = 0; materialIndex < materialIndices.size(); materialIndex++)
+	{
+		if (materialIndices[materialIndex].empty())
+			continue;
+
+		CookedSubmesh submesh;
+		submesh.m_firstIndex = (uint)indices.size();
+		submesh.m_numIndices = (uint)materialIndices[materialIndex].size();
+		submesh.m_materialIndex = (uint)materialIndex;
+		submeshes.push_back(submesh);
+		indices.insert(indices.end(), materialIndices[materialIndex].begin(), materialIndices[materialIndex].end());
+	}
+
+	if (indices.empty())
+	{
+		outError = "No faces to cook in " + settings.m_sourcePath;
+		return false;
+	}
+
+	//Per triangle normals and UV gradients, summed at the corners
+	std::vector<float> faceNormals(vertices.size() * 3U, 0.f);
+	std::vector<float> tangents(vertices.size() * 3U, 0.f);
+	std::vector<float> bitangents(vertices.size() * 3U, 0.f);
+	for (size_t triangleIndex = 0; triangleIndex + 2U < indices.size(); triangleIndex += 3U)
+	{
+		uint corners[3] = { indices[triangleIndex], indices[triangleIndex + 1U], indices[triangleIndex + 2U] };
+		CookVec3 p0 = ToCookVec3(vertices[corners[0]].m_position);
+		CookVec3 edge1 = Subtract(ToCookVec3(vertices[corners[1]].m_position), p0);
+		CookVec3 edge2 = Subtract(ToCookVec3(vertices[corners[2]].m_position), p0);
+		CookVec3 faceNormal = Cross(edge1, edge2);
+
+		float du1 = vertices[corners[1]].m_uv[0] - vertices[corners[0]].m_uv[0];
+		float dv1 = vertices[corners[1]].m_uv[1] - vertices[corners[0]].m_uv[1];
+		float du2 = vertices[corners[2]].m_uv[0] - vertices[corners[0]].m_uv[0];
+		float dv2 = vertices[corners[2]].m_uv[1] - vertices[corners[0]].m_uv[1];
+		float determinant = du1 * dv2 - du2 * dv1;
+
+		CookVec3 tangent;
+		CookVec3 bitangent;
+		if (fabsf(determinant) > 1.0e-12f)
+		{
+			float inverse = 1.f / determinant;
+			tangent.x = (edge1.x * dv2 - edge2.x * dv1) * inverse;
+			tangent.y = (edge1.y * dv2 - edge2.y * dv1) * inverse;
+			tangent.z = (edge1.z * dv2 - edge2.z * dv1) * inverse;
+			bitangent.x = (edge2.x * du1 - edge1.x * du2) * inverse;
+			bitangent.y = (edge2.y * du1 - edge1.y * du2) * inverse;
+			bitangent.z = (edge2.z * du1 - edge1.z * du2) * inverse;
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			AddTo(&faceNormals[corners[corner] * 3U], faceNormal);
+			AddTo(&tangents[corners[corner] * 3U], tangent);
+			AddTo(&bitangents[corners[corner] * 3U], bitangent);
+		}
+	}
+
+	CookVec3 fallbackNormal;
+	fallbackNormal.z = 1.f;
+	CookVec3 fallbackTangent;
+	fallbackTangent.x = 1.f;
+
+	for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+	{
+		CookedMeshVertex& vertex = vertices[vertexIndex];
+
+		CookVec3 normal = vertexCorners[vertexIndex].m_normal > 0 ? ToCookVec3(vertex.m_normal) : ToCookVec3(&faceNormals[vertexIndex * 3U]);
+		normal = Normalized(normal, fallbackNormal);
+		vertex.m_normal[0] = normal.x;
+		vertex.m_normal[1] = normal.y;
+		vertex.m_normal[2] = normal.z;
+
+		if (!settings.m_generateTangents)
+			continue;
+
+		//Gram-Schmidt against the normal, anything degenerate gets any direction in the plane
+		CookVec3 tangent = ToCookVec3(&tangents[vertexIndex * 3U]);
+		float alongNormal = Dot(normal, tangent);
+		tangent.x -= normal.x * alongNormal;
+		tangent.y -= normal.y * alongNormal;
+		tangent.z -= normal.z * alongNormal;
+
+		CookVec3 planeFallback = fabsf(normal.x) < 0.9f ? fallbackTangent : fallbackNormal;
+		planeFallback = Normalized(Cross(Cross(normal, planeFallback), normal), fallbackTangent);
+		tangent = Normalized(tangent, planeFallback);
+
+		vertex.m_tangent[0] = tangent.x;
+		vertex.m_tangent[1] = tangent.y;
+		vertex.m_tangent[2] = tangent.z;
+		vertex.m_tangent[3] = Dot(Cross(normal, tangent), ToCookVec3(&bitangents[vertexIndex * 3U])) < 0.f ? -1.f : 1.f;
+	}
+
+	//Lay the blob out and write it in one go
+	CookedMeshHeader header;
+	memcpy(header.m_magic, COOKED_MESH_MAGIC, sizeof(header.m_magic));
+	header.m_version = COOKED_MESH_VERSION;
+	header.m_sourceHash = sourceHash;
+	header.m_numVertices = (uint)vertices.size();
+	header.m_numIndices = (uint)indices.size();
+	header.m_indexSize = vertices.size() <= 0xFFFFU ? 2U : 4U;
+	header.m_numSubmeshes = (uint)submeshes.size();
+	header.m_vertexOffset = AlignUp((uint)sizeof(CookedMeshHeader), COOKED_SECTION_ALIGNMENT);
+	header.m_indexOffset = AlignUp(header.m_vertexOffset + header.m_numVertices * (uint)sizeof(CookedMeshVertex), COOKED_SECTION_ALIGNMENT);
+	header.m_submeshOffset = AlignUp(header.m_indexOffset + header.m_numIndices * header.m_indexSize, COOKED_SECTION_ALIGNMENT);
+	header.m_fileSize = header.m_submeshOffset + header.m_numSubmeshes * (uint)sizeof(CookedSubmesh);
+
+	std::vector<unsigned char> blob(header.m_fileSize, 0U);
+	memcpy(blob.data(), &header, sizeof(header));
+	memcpy(blob.data() + header.m_vertexOffset, vertices.data(), vertices.size() * sizeof(CookedMeshVertex));
+	for (size_t index = 0; index < indices.size(); index++)
+	{
+		unsigned char* destination = blob.data() + header.m_indexOffset + index * header.m_indexSize;
+		if (header.m_indexSize == 2U)
+		{
+			uint16_t shortIndex = (uint16_t)indices[index];
+			memcpy(destination, &shortIndex, sizeof(shortIndex));
+		}
+		else
+		{
+			memcpy(destination, &indices[index], sizeof(uint));
+		}
+	}
+	memcpy(blob.data() + header.m_submeshOffset, submeshes.data(), submeshes.size() * sizeof(CookedSubmesh));
+
+	std::string cookedPath = GetCookedPath(meshPath);
+	if (!WriteFileReplacing(cookedPath, blob.data(), blob.size()))
+	{
+		outError = "Could not write cooked mesh " + cookedPath;
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Everything the header claims is checked against the mapped size so a truncated or foreign file is refused rather than
+// read past the end
+//------------------------------------------------------------------------------------------------------------------------------
+bool CookedMesh::Open(const std::string& cookedPath)
+{
+	Close();
+
+	if (!m_file.Open(cookedPath))
+		return false;
+
+	const unsigned char* data = m_file.GetData();
+	size_t size = m_file.GetSize();
+	const CookedMeshHeader* header = (const CookedMeshHeader*)data;
+
+	bool isValid = size >= sizeof(CookedMeshHeader)
+		&& memcmp(header->m_magic, COOKED_MESH_MAGIC, sizeof(COOKED_MESH_MAGIC)) == 0
+		&& header->m_version == COOKED_MESH_VERSION
+		&& header->m_fileSize == size
+		&& (header->m_indexSize == 2U || header->m_indexSize == 4U)
+		&& header->m_vertexOffset % COOKED_SECTION_ALIGNMENT == 0U
+		&& header->m_indexOffset % COOKED_SECTION_ALIGNMENT == 0U
+		&& header->m_submeshOffset % COOKED_SECTION_ALIGNMENT == 0U
+		&& (uint64_t)header->m_vertexOffset + (uint64_t)header->m_numVertices * sizeof(CookedMeshVertex) <= header->m_indexOffset
+		&& (uint64_t)header->m_indexOffset + (uint64_t)header->m_numIndices * header->m_indexSize <= header->m_submeshOffset
+		&& (uint64_t)header->m_submeshOffset + (uint64_t)header->m_numSubmeshes * sizeof(CookedSubmesh) <= size;
+
+	if (!isValid)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_header = header;
+	m_vertices = (const CookedMeshVertex*)(data + header->m_vertexOffset);
+	m_indices = data + header->m_indexOffset;
+	m_submeshes = (const CookedSubmesh*)(data + header->m_submeshOffset);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void CookedMesh::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+	m_vertices = nullptr;
+	m_indices = nullptr;
+	m_submeshes = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint CookedMesh::GetIndex(uint index) const
+{
+	if (m_header->m_indexSize == 2U)
+	{
+		uint16_t shortIndex;
+		memcpy(&shortIndex, m_indices + index * 2U, sizeof(shortIndex));
+		return shortIndex;
+	}
+
+	uint longIndex;
+	memcpy(&longIndex, m_indices + index * 4U, sizeof(longIndex));
+	return longIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// GPUMesh only takes a CPUMesh, so the mapped vertices are streamed through one as they are. No parsing, transforming or
+// tangent work happens here
+//------------------------------------------------------------------------------------------------------------------------------
+void CookedMesh::FillCPUMesh(CPUMesh& mesh) const
+{
+	mesh.Clear();
+	mesh.SetLayout<Vertex_Lit>();
+
+	for (uint vertexIndex = 0; vertexIndex < m_header->m_numVertices; vertexIndex++)
+	{
+		const CookedMeshVertex& vertex = m_vertices[vertexIndex];
+		mesh.SetColor(Rgba(vertex.m_color[0] / 255.f, vertex.m_color[1] / 255.f, vertex.m_color[2] / 255.f, vertex.m_color[3] / 255.f));
+		mesh.SetUV(Vec2(vertex.m_uv[0], vertex.m_uv[1]));
+
+		//The bitangent is rebuilt from the normal, the tangent and its sign
+		Vec3 normal(vertex.m_normal[0], vertex.m_normal[1], vertex.m_normal[2]);
+		Vec3 tangent(vertex.m_tangent[0], vertex.m_tangent[1], vertex.m_tangent[2]);
+		Vec3 bitangent(normal.y * tangent.z - normal.z * tangent.y, normal.z * tangent.x - normal.x * tangent.z, normal.x * tangent.y - normal.y * tangent.x);
+		mesh.SetNormal(normal);
+		mesh.SetTangent(tangent);
+		mesh.SetBiTangent(bitangent * vertex.m_tangent[3]);
+		mesh.AddVertex(Vec3(vertex.m_position[0], vertex.m_position[1], vertex.m_position[2]));
+	}
+
+	for (uint index = 0; index + 2U < m_header->m_numIndices; index += 3U)
+	{
+		mesh.AddIndexedTriangle(GetIndex(index), GetIndex(index + 1U), GetIndex(index + 2U));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool CookedMesh::LoadIntoCPUMesh(const std::string& modelRoot, const std::string& meshPath, CPUMesh& outMesh, std::string& outError)
+{
+	if (!MeshCooker::CookIfStale(modelRoot, meshPath, outError))
+		return false;
+
+	CookedMesh cooked;
+	if (!cooked.Open(MeshCooker::GetCookedPath(meshPath)))
+	{
+		outError = "Could not map cooked mesh for " + meshPath;
+		return false;
+	}
+
+	cooked.FillCPUMesh(outMesh);
+	StartupProfiler::CountBytesRead(cooked.GetHeader().m_fileSize);
+	return true;
+}
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CPUMesh;
+
+//Bump whenever the cooked layout or what the cooker does to a mesh changes, every blob is re-cooked on the next load
+constexpr uint COOKED_MESH_VERSION = 1U;
+
+//FNV-1a offset basis, every cooked asset's source hash starts from here
+constexpr uint64_t COOKED_HASH_BASIS = 14695981039346656037ULL;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Vertex_Lit's attributes in the same order, final after transform, scale and tangent generation
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedMeshVertex
+{
+	float			m_position[3];
+	unsigned char	m_color[4];
+	float			m_uv[2];
+	float			m_normal[3];
+	float			m_tangent[4];			//w is the bitangent sign
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A contiguous index range drawn with one of the .mesh file's materials
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedSubmesh
+{
+	uint			m_firstIndex = 0U;
+	uint			m_numIndices = 0U;
+	uint			m_materialIndex = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Header, vertices, indices and submeshes, each section 16 byte aligned. Indices are 16 bit when every vertex fits
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedMeshHeader
+{
+	char			m_magic[4];
+	uint			m_version = 0U;
+	uint64_t		m_sourceHash = 0U;		//The .mesh and .obj bytes this was cooked from
+	uint			m_numVertices = 0U;
+	uint			m_numIndices = 0U;
+	uint			m_indexSize = 0U;
+	uint			m_numSubmeshes = 0U;
+	uint			m_vertexOffset = 0U;
+	uint			m_indexOffset = 0U;
+	uint			m_submeshOffset = 0U;
+	uint			m_fileSize = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a .mesh file asks of its source. Axis i of a cooked position is m_axisSigns[i] times source axis m_axes[i]
+//------------------------------------------------------------------------------------------------------------------------------
+struct MeshCookSettings
+{
+	std::string					m_sourcePath;
+	float						m_scale = 1.f;
+	bool						m_invertWinding = false;
+	bool						m_generateTangents = true;
+	int							m_axes[3] = { 0, 1, 2 };
+	float						m_axisSigns[3] = { 1.f, 1.f, 1.f };
+	std::vector<std::string>	m_materialPaths;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Turns a .mesh and its Wavefront OBJ into a cooked blob next to the .mesh. A blob is stale when the hash of its sources
+// no longer matches, when the sources are gone the blob is trusted as is. Source paths in a .mesh are relative to the
+// model root
+//------------------------------------------------------------------------------------------------------------------------------
+class MeshCooker
+{
+public:
+	static std::string		GetCookedPath(const std::string& meshPath);
+	static bool				CookIfStale(const std::string& modelRoot, const std::string& meshPath, std::string& outError);
+
+	static bool				ReadMeshSettings(const std::string& modelRoot, const std::string& meshPath, MeshCookSettings& outSettings, std::string& outError);
+	static bool				ParseAxisTransform(const std::string& transform, MeshCookSettings& outSettings);
+	static uint64_t			HashBytes(const std::vector<char>& bytes, uint64_t hash);
+	static uint64_t			HashBytes(const unsigned char* bytes, size_t numBytes, uint64_t hash);
+
+	static bool				CheckAgainstObjectLoader(const std::string& modelRoot, const std::string& meshPath, std::string& outError);
+	static bool				Command_CheckCookedMeshes(EventArgs& args);
+
+private:
+	static bool				CookFromSources(const std::string& meshPath, const MeshCookSettings& settings, const std::vector<char>& objBytes, uint64_t sourceHash, std::string& outError);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A cooked blob mapped straight from disk. Everything points into the mapping, nothing is parsed or copied on open
+//------------------------------------------------------------------------------------------------------------------------------
+class CookedMesh
+{
+public:
+	bool						Open(const std::string& cookedPath);
+	void						Close();
+
+	void						FillCPUMesh(CPUMesh& mesh) const;
+	static bool					LoadIntoCPUMesh(const std::string& modelRoot, const std::string& meshPath, CPUMesh& outMesh, std::string& outError);
+
+	inline const CookedMeshHeader&	GetHeader() const { return *m_header; }
+	inline const CookedMeshVertex*	GetVertices() const { return m_vertices; }
+	inline const CookedSubmesh*		GetSubmeshes() const { return m_submeshes; }
+	uint						GetIndex(uint index) const;
+
+private:
+	MappedFile					m_file;
+	const CookedMeshHeader*		m_header = nullptr;
+	const CookedMeshVertex*		m_vertices = nullptr;
+	const unsigned char*		m_indices = nullptr;
+	const CookedSubmesh*		m_submeshes = nullptr;
+};
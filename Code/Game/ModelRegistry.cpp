@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/ModelRegistry.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Model.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+//Game Systems
+#include "Game/MeshCooker.hpp"
+#include "Game/RenderResources.hpp"
+#include "Game/StartupProfiler.hpp"
+
+extern JobSystem* g_jobSystem;
+extern RenderContext* g_renderContext;
+
+ModelRegistry* g_modelRegistry = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+ModelRegistry::~ModelRegistry()
+{
+	//Workers write into the entries, so they all have to be done before anything is freed
+	g_jobSystem->WaitForCounter(&m_prepareJobs);
+
+	for (size_t entryIndex = 0; entryIndex < m_entries.size(); entryIndex++)
+	{
+		ModelEntry* entry = m_entries[entryIndex];
+		if (entry->m_model != nullptr)
+		{
+			entry->m_model->m_mesh = nullptr;
+		}
+
+		delete entry->m_model;
+		delete entry->m_cpuMesh;
+		delete entry;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ModelHandle ModelRegistry::RequestModel(const std::string& meshPath, const std::string& materialPath)
+{
+	std::string key = MakeLookupKey(meshPath, materialPath);
+	std::map<std::string, ModelHandle>::const_iterator found = m_lookup.find(key);
+	if (found != m_lookup.end())
+		return found->second;
+
+	ModelHandle handle = (ModelHandle)m_entries.size();
+	ModelEntry* entry = new ModelEntry();
+	entry->m_meshPath = meshPath;
+	entry->m_materialPath = materialPath;
+	m_entries.push_back(entry);
+	m_lookup[key] = handle;
+
+	if (g_renderResources->GetMesh(g_renderResources->FindMesh(meshPath)) != nullptr)
+	{
+		CreateModel(handle);
+		return handle;
+	}
+
+	m_numLoading++;
+	entry->m_queuedTime = GetCurrentTimeSeconds();
+	g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, entry, handle]() { PrepareModel(entry); m_preparedQueue.enqueue(handle); }, &m_prepareJobs);
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// True if any model uses the mesh, whatever its material. Keys for one mesh sort together, so only the first one after the
+// mesh's prefix needs checking
+//------------------------------------------------------------------------------------------------------------------------------
+bool ModelRegistry::IsRequested(const std::string& meshPath) const
+{
+	std::string prefix = MakeLookupKey(meshPath, "");
+	std::map<std::string, ModelHandle>::const_iterator found = m_lookup.lower_bound(prefix);
+	return found != m_lookup.end() && found->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The same mesh with two materials is two models. '|' can't appear in a path so no two pairs share a key
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string ModelRegistry::MakeLookupKey(const std::string& meshPath, const std::string& materialPath)
+{
+	return meshPath + "|" + materialPath;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ModelRegistry::PrepareModel(ModelEntry* entry)
+{
+	double startTime = GetCurrentTimeSeconds();
+	StartupProfiler::TakeBytesRead();
+
+	//Left null when it can't be cooked, the render context loads it from source at creation instead
+	std::string error;
+	entry->m_cpuMesh = new CPUMesh();
+	if (!CookedMesh::LoadIntoCPUMesh(MODEL_PATH, MODEL_PATH + entry->m_meshPath, *entry->m_cpuMesh, error))
+	{
+		delete entry->m_cpuMesh;
+		entry->m_cpuMesh = nullptr;
+	}
+
+	g_startupProfiler->RecordAssetPrepare(entry->m_meshPath, "model", entry->m_queuedTime, startTime, GetCurrentTimeSeconds(), StartupProfiler::TakeBytesRead());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Always creates at least one model when one is ready so a tiny budget still makes progress
+//------------------------------------------------------------------------------------------------------------------------------
+void ModelRegistry::Update(double budgetSeconds)
+{
+	double startTime = GetCurrentTimeSeconds();
+
+	ModelHandle handle;
+	while (m_preparedQueue.dequeue(&handle))
+	{
+		CreateModel(handle);
+		m_numLoading--;
+
+		if (GetCurrentTimeSeconds() - startTime >= budgetSeconds)
+			break;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The same mesh can be resolved elsewhere while its model was loading, so it is only created if still missing
+//------------------------------------------------------------------------------------------------------------------------------
+void ModelRegistry::CreateModel(ModelHandle handle)
+{
+	ModelEntry* entry = m_entries[handle];
+	double startTime = GetCurrentTimeSeconds();
+
+	MeshHandle mesh = g_renderResources->FindMesh(entry->m_meshPath);
+	if (g_renderResources->GetMesh(mesh) == nullptr)
+	{
+		mesh = entry->m_cpuMesh != nullptr ? g_renderResources->CreateMesh(entry->m_meshPath, *entry->m_cpuMesh) : g_renderResources->ResolveMesh(entry->m_meshPath);
+	}
+	delete entry->m_cpuMesh;
+	entry->m_cpuMesh = nullptr;
+
+	GPUMesh* gpuMesh = g_renderResources->GetMesh(mesh);
+	if (gpuMesh == nullptr)
+	{
+		entry->m_state = MODEL_STATE_FAILED;
+		g_devConsole->PrintString(Rgba::RED, Stringf("Failed to load model %s", entry->m_meshPath.c_str()));
+		return;
+	}
+
+	//The mesh belongs to the render resources, so the model must not be the one to delete it
+	Model* model = new Model();
+	model->m_context = g_renderContext;
+	model->m_mesh = gpuMesh;
+	model->m_mesh->m_defaultMaterial = entry->m_meshPath;
+	if (entry->m_materialPath != "")
+	{
+		model->m_material = g_renderResources->GetMaterial(g_renderResources->ResolveMaterial(MODEL_PATH + entry->m_materialPath));
+	}
+
+	entry->m_model = model;
+	entry->m_state = MODEL_STATE_READY;
+	g_startupProfiler->RecordAssetCreate(entry->m_meshPath, "model", startTime, GetCurrentTimeSeconds());
+}
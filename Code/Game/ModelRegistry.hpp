@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Async/AsyncQueue.hpp"
+//Game Systems
+#include "Game/JobSystem.hpp"
+//Others
+#include <map>
+#include <string>
+#include <vector>
+
+class CPUMesh;
+class Model;
+
+//Index into the registry, stays the same for as long as the registry lives
+typedef uint	ModelHandle;
+
+constexpr ModelHandle INVALID_MODEL_HANDLE = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eModelState
+{
+	MODEL_STATE_LOADING,
+	MODEL_STATE_READY,
+	MODEL_STATE_FAILED
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ModelEntry
+{
+	std::string				m_meshPath;					//Relative to Data/Models/, also the name the model is requested by
+	std::string				m_materialPath;				//Relative to Data/Models/, none leaves the mesh's own material
+
+	eModelState				m_state = MODEL_STATE_LOADING;
+	CPUMesh*				m_cpuMesh = nullptr;		//Filled in by the worker, handed to the GPU on the main thread
+	Model*					m_model = nullptr;
+	double					m_queuedTime = 0.0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Models by name. A request hands back a handle straight away and the mesh is read and cooked on the job system; the
+// handle becomes valid once the main thread has made its GPU mesh and material. Meshes that are already resident, such as
+// the ones the asset manifest loaded, are ready on request. Requesting the same mesh and material twice gives the same handle.
+// Requests, Update and the getters are main thread only. The models are owned here, their meshes by the render resources
+//------------------------------------------------------------------------------------------------------------------------------
+class ModelRegistry
+{
+public:
+	ModelRegistry() {}
+	~ModelRegistry();
+
+	ModelHandle				RequestModel(const std::string& meshPath, const std::string& materialPath = "");
+	void					Update(double budgetSeconds);
+
+	inline Model*			GetModel(ModelHandle handle) const { return IsReady(handle) ? m_entries[handle]->m_model : nullptr; }
+	inline bool				IsReady(ModelHandle handle) const { return handle < (uint)m_entries.size() && m_entries[handle]->m_state == MODEL_STATE_READY; }
+	inline uint				GetNumLoading() const { return m_numLoading; }
+	bool					IsRequested(const std::string& meshPath) const;
+
+private:
+	static std::string		MakeLookupKey(const std::string& meshPath, const std::string& materialPath);
+
+	void					PrepareModel(ModelEntry* entry);
+	void					CreateModel(ModelHandle handle);
+
+private:
+	std::vector<ModelEntry*>		m_entries;			//Allocated one by one so a worker's entry never moves when more are requested
+	std::map<std::string, ModelHandle>	m_lookup;		//Keyed on mesh and material, see MakeLookupKey
+
+	JobCounter				m_prepareJobs;
+	AsyncQueue<uint>		m_preparedQueue;		//Written by workers, drained by the main thread
+	uint					m_numLoading = 0U;
+};
+
+extern ModelRegistry* g_modelRegistry;
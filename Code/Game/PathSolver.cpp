@@ -1,7 +1,6 @@
 //------------------------------------------------------------------------------------------------------------------------------
 #include "Game/PathSolver.hpp"
 #include "Engine/Commons/EngineCommon.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Pather::Init(const IntVec2& mapSize, float initialCost)
@@ -304,6 +303,18 @@ void PathSolver::FallDownToShortestPath(Path& shortestPath)
 
 	PathInfo_T lastCell = m_pathInfo.Get(m_startPoint);
 
+	//Ties are broken by a generator seeded from this request's end points rather than the global RNG. Units sent from
+	//different tiles still spread over equal cost lanes, but a solve can run on any job thread and replays the same way
+	uint tieBreakState = 2166136261U;
+	tieBreakState = (tieBreakState ^ (uint)m_startPoint.x) * 16777619U;
+	tieBreakState = (tieBreakState ^ (uint)m_startPoint.y) * 16777619U;
+	tieBreakState = (tieBreakState ^ (uint)m_endPoint.x) * 16777619U;
+	tieBreakState = (tieBreakState ^ (uint)m_endPoint.y) * 16777619U;
+	if (tieBreakState == 0U)
+	{
+		tieBreakState = 1U;
+	}
+
 	while (shortestPath[(int)shortestPath.size() - 1] != m_endPoint)
 	{
 		lowestCostCells.clear();
@@ -316,8 +327,10 @@ void PathSolver::FallDownToShortestPath(Path& shortestPath)
 		if ((int)lowestCostCells.size() > 1)
 		{
 			//Pick one of the cells
-			int randomIndex = g_RNG->GetRandomIntInRange(0, (int)lowestCostCells.size() - 1);
-			lowestCostCell = lowestCostCells[randomIndex];
+			tieBreakState ^= tieBreakState << 13;
+			tieBreakState ^= tieBreakState >> 17;
+			tieBreakState ^= tieBreakState << 5;
+			lowestCostCell = lowestCostCells[tieBreakState % (uint)lowestCostCells.size()];
 		}
 		else if (lowestCostCells.size() == 0)
 		{
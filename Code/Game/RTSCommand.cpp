@@ -7,85 +7,444 @@
 #include "Game/AIController.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
-RTSCommand::RTSCommand(CommandTypeT commandType)
+STATIC RTSCommand RTSCommand::MakeCreateEntity(const Vec2& createPosition, EntityTypeT entityType)
 {
-	m_commandType = commandType;
-}
-
-//------------------------------------------------------------------------------------------------------------------------------
-CreateEntityCommand::CreateEntityCommand(Vec2 createPosition, EntityTypeT entityType)
-	:	RTSCommand(CREATE_ENTITY)
-{
-	m_createPosition = createPosition;
-	m_entityType = entityType;
+	RTSCommand command;
+	command.m_commandType = CREATE_ENTITY;
+	command.m_position = createPosition;
+	command.m_entityType = entityType;
 
 	switch (entityType)
 	{
 	case PEON:
-		m_team = 1;
+		command.m_team = 1;
 		break;
 	case WARRIOR:
-		m_team = 1;
+		command.m_team = 1;
 		break;
 	case TREE:
-		m_team = 0;
+		command.m_team = 0;
 		break;
 	case TOWNCENTER:
 		break;
 	case HUT:
 		break;
 	case GOBLIN:
-		m_team = 2;
+		command.m_team = 2;
 		break;
 	default:
 		break;
 	}
 
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeMove(const GameHandle& unit, const Vec2& position)
+{
+	RTSCommand command;
+	command.m_commandType = MOVE_ENTITY;
+	command.m_unit = unit;
+	command.m_position = position;
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeGroupMoveMember(const GameHandle& unit, const Vec2& position)
+{
+	RTSCommand command;
+	command.m_commandType = GROUP_MOVE_MEMBER;
+	command.m_unit = unit;
+	command.m_position = position;
+	return command;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-CreateEntityCommand::~CreateEntityCommand()
+STATIC RTSCommand RTSCommand::MakeTrainUnit(const GameHandle& building, int team)
 {
+	RTSCommand command;
+	command.m_commandType = TRAIN_UNIT;
+	command.m_unit = building;
+	command.m_team = team;
+	return command;
+}
 
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakePlaceBuilding(const Vec2& buildPosition, EntityTypeT buildingType, int team)
+{
+	RTSCommand command;
+	command.m_commandType = PLACE_BUILDING;
+	command.m_position = buildPosition;
+	command.m_entityType = buildingType;
+	command.m_team = team;
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeSetPlayerTeam(int team)
+{
+	RTSCommand command;
+	command.m_commandType = SET_PLAYER_TEAM;
+	command.m_team = team;
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeSetEntityTeam(const GameHandle& unit, int team)
+{
+	RTSCommand command;
+	command.m_commandType = SET_ENTITY_TEAM;
+	command.m_unit = unit;
+	command.m_team = team;
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeKill(const GameHandle& unit)
+{
+	RTSCommand command;
+	command.m_commandType = KILL_ENTITY;
+	command.m_unit = unit;
+	return command;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC RTSCommand RTSCommand::MakeSetAIEnabled(bool isEnabled)
+{
+	RTSCommand command;
+	command.m_commandType = SET_AI_ENABLED;
+	command.m_isEnabled = isEnabled;
+	return command;
 }
 
-VIRTUAL void CreateEntityCommand::Execute()
+//------------------------------------------------------------------------------------------------------------------------------
+void RTSCommand::Execute(const GameHandle* groupHandles) const
 {
 	Map* map = Game::s_gameReference->m_map;
-	int team;
-	if (m_team == 2)
+
+	switch (m_commandType)
+	{
+	case CREATE_ENTITY:
+	{
+		int team;
+		if (m_team == 2)
+		{
+			team = map->m_AIController->m_AITeam;
+		}
+		else
+		{
+			team = Game::s_gameReference->GetCurrentTeam();
+		}
+
+		//Set occupancy for tree
+		if (m_entityType == TREE)
+		{
+			map->SetOccupancyForUnit(m_position, IntVec2(1, 1), true);
+		}
+
+		map->CreateEntity(m_position, m_entityType, team);
+	}
+	break;
+	case MOVE_ENTITY:
+	{
+		Entity *entity = map->FindEntity(m_unit);
+		if (entity != nullptr)
+		{
+			entity->PathTo(m_position);
+		}
+	}
+	break;
+	case GROUP_MOVE_ENTITY:
 	{
-		team = Game::s_gameReference->m_map->m_AIController->m_AITeam;
+		//One record for the whole selection, fan it out to each unit that is still around
+		for (uint groupIndex = 0; groupIndex < m_groupCount; ++groupIndex)
+		{
+			Entity* entity = map->FindEntity(groupHandles[m_groupStart + groupIndex]);
+			if(entity == nullptr)
+				continue;
+
+			ApplyGroupMove(entity, m_position);
+		}
 	}
-	else
+	break;
+	case GROUP_MOVE_MEMBER:
 	{
-		team = Game::s_gameReference->GetCurrentTeam();
+		Entity* entity = map->FindEntity(m_unit);
+		if (entity != nullptr)
+		{
+			ApplyGroupMove(entity, m_position);
+		}
 	}
+	break;
+	case TRAIN_UNIT:
+	{
+		Game* game = Game::s_gameReference;
+		Entity* building = map->FindEntity(m_unit);
+		if(building == nullptr)
+			break;
+
+		int teamIndex = m_team - 1;
+		if(game->m_teamCurrentSupply[teamIndex] >= game->m_teamMaxSupply[teamIndex])
+			break;
 
-	map->CreateEntity(m_createPosition, m_entityType, team);
+		int unitCost = (teamIndex == 0) ? map->GetPeonCost() : map->GetGoblinCost();
+		if (game->m_teamResource[teamIndex] >= unitCost)
+		{
+			building->SetIsTrainingUnit(true);
+
+			game->m_teamResource[teamIndex] -= unitCost;
+			game->m_teamCurrentSupply[teamIndex] += 1;
+		}
+	}
+	break;
+	case PLACE_BUILDING:
+	{
+		//Pay for the building and reserve its footprint, the peon's BUILD task does the rest
+		Game* game = Game::s_gameReference;
+		if (m_entityType == TOWNCENTER)
+		{
+			game->m_teamResource[m_team - 1] -= map->GetTownCenterCost();
+			map->SetOccupancyForUnit(m_position, map->m_townCenterOcc, true);
+		}
+		else
+		{
+			game->m_teamResource[m_team - 1] -= map->GetHutCost();
+			map->SetOccupancyForUnit(m_position, map->m_hutOcc, true);
+		}
+	}
+	break;
+	case SET_PLAYER_TEAM:
+	{
+		Game::s_gameReference->SetCurrentTeam(m_team);
+	}
+	break;
+	case SET_ENTITY_TEAM:
+	{
+		Entity* entity = map->FindEntity(m_unit);
+		if (entity != nullptr)
+		{
+			entity->SetTeam(m_team);
+		}
+	}
+	break;
+	case KILL_ENTITY:
+	{
+		Entity* entity = map->FindEntity(m_unit);
+		if (entity != nullptr)
+		{
+			entity->SetHealth(0.f);
+		}
+	}
+	break;
+	case SET_AI_ENABLED:
+	{
+		Game::s_gameReference->m_disableAI = !m_isEnabled;
+	}
+	break;
+	default:
+		ERROR_RECOVERABLE("Unhandled RTSCommand type");
+		break;
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-MoveCommand::MoveCommand(const GameHandle& unit, const Vec2& position)
-	: RTSCommand(MOVE_ENTITY)
+// A group order replaces whatever the unit was doing, unlike a plain move which only repaths
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void RTSCommand::ApplyGroupMove(Entity* entity, const Vec2& position)
 {
-	m_unit = unit;
-	m_position = position;
+	entity->ClearTasks();
+	entity->StopFollow();
+	entity->ResetTaskData();
+	entity->PathTo(position);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-MoveCommand::~MoveCommand()
+RTSCommandQueue::RTSCommandQueue(uint capacity, uint groupHandleCapacity)
 {
+	//Round up to a power of 2 so positions wrap with a mask
+	uint ringSize = 2U;
+	while (ringSize < capacity)
+	{
+		ringSize <<= 1;
+	}
 
+	m_cells = new CommandCell[ringSize];
+	m_mask = ringSize - 1U;
+	for (uint cellIndex = 0; cellIndex < ringSize; ++cellIndex)
+	{
+		m_cells[cellIndex].m_sequence.store(cellIndex, std::memory_order_relaxed);
+	}
+
+	m_groupHandles = new GameHandle[groupHandleCapacity];
+	m_groupHandleCapacity = groupHandleCapacity;
 }
 
-//------------------------------------------------------------------------
-VIRTUAL void MoveCommand::Execute()
+//------------------------------------------------------------------------------------------------------------------------------
+RTSCommandQueue::~RTSCommandQueue()
 {
-	Map* map = Game::s_gameReference->m_map;
-	Entity *entity = map->FindEntity(m_unit);	
-	if (entity != nullptr) 
+	delete[] m_cells;
+	m_cells = nullptr;
+
+	delete[] m_groupHandles;
+	m_groupHandles = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RTSCommandQueue::Enqueue(const RTSCommand& command)
+{
+	CommandCell* cell = nullptr;
+	uint position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+	while (true)
 	{
-		entity->PathTo(m_position);
+		cell = &m_cells[position & m_mask];
+		uint sequence = cell->m_sequence.load(std::memory_order_acquire);
+		int difference = (int)sequence - (int)position;
+
+		if (difference == 0)
+		{
+			//Cell is free for this lap, try to claim it
+			if (m_enqueuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			//Ring is full
+			return false;
+		}
+		else
+		{
+			//Someone else claimed it, catch up
+			position = m_enqueuePosition.load(std::memory_order_relaxed);
+		}
 	}
+
+	cell->m_command = command;
+	cell->m_sequence.store(position + 1U, std::memory_order_release);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RTSCommandQueue::EnqueueGroupMove(const GameHandle* units, uint numUnits, const Vec2& position)
+{
+	if (numUnits == 0U)
+		return true;
+
+	++m_groupEnqueuesInFlight;
+
+	//The arena is reset when processing ends, so a group enqueued during ProcessCommands can't use it
+	bool isProcessing = m_isProcessing.load();
+	ASSERT_RECOVERABLE(!isProcessing, "Group commands can't be enqueued while the command queue is processing");
+
+	uint groupStart = isProcessing ? m_groupHandleCapacity : ReserveGroupHandles(numUnits);
+	if (groupStart == m_groupHandleCapacity)
+	{
+		//Arena is exhausted for this frame, fall back to one record per unit that is handled the same as the group
+		--m_groupEnqueuesInFlight;
+
+		bool result = true;
+		for (uint unitIndex = 0; unitIndex < numUnits; ++unitIndex)
+		{
+			result &= Enqueue(RTSCommand::MakeGroupMoveMember(units[unitIndex], position));
+		}
+		return result;
+	}
+
+	for (uint unitIndex = 0; unitIndex < numUnits; ++unitIndex)
+	{
+		m_groupHandles[groupStart + unitIndex] = units[unitIndex];
+	}
+
+	RTSCommand command;
+	command.m_commandType = GROUP_MOVE_ENTITY;
+	command.m_position = position;
+	command.m_groupStart = groupStart;
+	command.m_groupCount = numUnits;
+	bool result = Enqueue(command);
+
+	--m_groupEnqueuesInFlight;
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Returns the arena capacity when the group doesn't fit. Nothing is taken on failure, so a smaller group later in the frame
+// can still use what is left
+//------------------------------------------------------------------------------------------------------------------------------
+uint RTSCommandQueue::ReserveGroupHandles(uint numUnits)
+{
+	uint groupStart = m_groupHandlesUsed.load();
+	do
+	{
+		if (numUnits > m_groupHandleCapacity - groupStart)
+			return m_groupHandleCapacity;
+	}
+	while (!m_groupHandlesUsed.compare_exchange_weak(groupStart, groupStart + numUnits));
+
+	return groupStart;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RTSCommandQueue::Dequeue(RTSCommand* command)
+{
+	CommandCell* cell = nullptr;
+	uint position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		cell = &m_cells[position & m_mask];
+		uint sequence = cell->m_sequence.load(std::memory_order_acquire);
+		int difference = (int)sequence - (int)(position + 1U);
+
+		if (difference == 0)
+		{
+			if (m_dequeuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			//Ring is empty
+			return false;
+		}
+		else
+		{
+			position = m_dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	*command = cell->m_command;
+	//Hand the cell back to producers for the next lap
+	cell->m_sequence.store(position + m_mask + 1U, std::memory_order_release);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only runs what was enqueued before the pass started. Anything a command enqueues while executing waits for the next pass
+// the same as it would in a replay, where it was recorded on the following tick
+//------------------------------------------------------------------------------------------------------------------------------
+void RTSCommandQueue::ProcessCommands()
+{
+	m_isProcessing = true;
+	ASSERT_RECOVERABLE(m_groupEnqueuesInFlight.load() == 0U, "Group commands can't be enqueued while the command queue is processing");
+
+	uint endPosition = m_enqueuePosition.load(std::memory_order_acquire);
+
+	RTSCommand command;
+	while (m_dequeuePosition.load(std::memory_order_relaxed) != endPosition && Dequeue(&command))
+	{
+		command.Execute(m_groupHandles);
+	}
+
+	m_groupHandlesUsed = 0U;
+	m_isProcessing = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RTSCommandQueue::ClearCommands()
+{
+	RTSCommand command;
+	while (Dequeue(&command))
+	{
+	}
+
+	m_groupHandlesUsed = 0U;
 }
@@ -2,53 +2,111 @@
 #pragma once
 //Engine Systems
 #include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
 //Game Systems
 #include "Game/GameHandle.hpp"
-#include "Game/Map.hpp"
+#include "Game/GameTypes.hpp"
+//Others
+#include <atomic>
+#include <vector>
+
+class Entity;
 
 //------------------------------------------------------------------------------------------------------------------------------
 enum CommandTypeT
 {
 	CREATE_ENTITY,
 	MOVE_ENTITY,
+	GROUP_MOVE_ENTITY,
+	TRAIN_UNIT,
+	PLACE_BUILDING,
+	SET_PLAYER_TEAM,
+	SET_ENTITY_TEAM,
+	KILL_ENTITY,
+	SET_AI_ENABLED,
+	GROUP_MOVE_MEMBER,			//One unit of a group move that didn't fit the handle arena, made by the queue and never recorded
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
-class RTSCommand
+// Commands are flat records tagged by type so they can be copied straight into the queue's ring. Each type only reads
+// the fields it needs
+//------------------------------------------------------------------------------------------------------------------------------
+struct RTSCommand
 {
 public:
-	RTSCommand(CommandTypeT commandType);
-	virtual ~RTSCommand() {}
-	virtual void Execute() = 0;
+	static RTSCommand	MakeCreateEntity(const Vec2& createPosition, EntityTypeT entityType);
+	static RTSCommand	MakeMove(const GameHandle& unit, const Vec2& position);
+	static RTSCommand	MakeGroupMoveMember(const GameHandle& unit, const Vec2& position);
+	static RTSCommand	MakeTrainUnit(const GameHandle& building, int team);
+	static RTSCommand	MakePlaceBuilding(const Vec2& buildPosition, EntityTypeT buildingType, int team);
+	static RTSCommand	MakeSetPlayerTeam(int team);
+	static RTSCommand	MakeSetEntityTeam(const GameHandle& unit, int team);
+	static RTSCommand	MakeKill(const GameHandle& unit);
+	static RTSCommand	MakeSetAIEnabled(bool isEnabled);
 
-public:
-	CommandTypeT m_commandType;
-};
+	void				Execute(const GameHandle* groupHandles) const;
+
+private:
+	static void			ApplyGroupMove(Entity* entity, const Vec2& position);
 
-//------------------------------------------------------------------------------------------------------------------------------
-class CreateEntityCommand : RTSCommand
-{
 public:
-	CreateEntityCommand(Vec2 createPosition, EntityTypeT entityType);
-	~CreateEntityCommand();
+	CommandTypeT		m_commandType = MOVE_ENTITY;
+	Vec2				m_position = Vec2::ZERO;
 
-	virtual void Execute();
+	//CREATE_ENTITY, TRAIN_UNIT, PLACE_BUILDING, SET_PLAYER_TEAM, SET_ENTITY_TEAM
+	EntityTypeT			m_entityType = PEON;
+	int					m_team = 0;
 
-public:
-	Vec2 m_createPosition;
-	EntityTypeT m_entityType;
-	int m_team = 0;
+	//MOVE_ENTITY, GROUP_MOVE_MEMBER, TRAIN_UNIT, SET_ENTITY_TEAM, KILL_ENTITY
+	GameHandle			m_unit;
+
+	//SET_AI_ENABLED
+	bool				m_isEnabled = false;
+
+	//GROUP_MOVE_ENTITY, a range in the queue's group handle arena
+	uint				m_groupStart = 0U;
+	uint				m_groupCount = 0U;
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
-class MoveCommand : RTSCommand
+// Bounded multi-producer ring of command records. Producers claim a cell with a CAS on the enqueue position and publish it
+// with the cell's sequence number, so nothing on the enqueue path takes a lock or allocates.
+// Group commands copy their unit handles into a bump allocated arena that is reset once the queue has been processed.
+// Group enqueues must not overlap ProcessCommands, which holds for every producer we have as they all run in the
+// update phase. Both sides assert on it and an overlapping group falls back to one record per unit
+//------------------------------------------------------------------------------------------------------------------------------
+class RTSCommandQueue
 {
 public:
-	MoveCommand(const GameHandle& unit, const Vec2& position);
-	~MoveCommand();
-	virtual void Execute();
+	explicit RTSCommandQueue(uint capacity = 1024U, uint groupHandleCapacity = 4096U);
+	~RTSCommandQueue();
 
-public:
-	GameHandle m_unit;
-	Vec2 m_position;
-};
\ No newline at end of file
+	bool				Enqueue(const RTSCommand& command);
+	bool				EnqueueGroupMove(const GameHandle* units, uint numUnits, const Vec2& position);
+	bool				Dequeue(RTSCommand* command);
+
+	void				ProcessCommands();
+	void				ClearCommands();
+
+private:
+	uint				ReserveGroupHandles(uint numUnits);
+
+private:
+	struct CommandCell
+	{
+		std::atomic<uint>	m_sequence { 0U };
+		RTSCommand			m_command;
+	};
+
+	CommandCell*		m_cells = nullptr;
+	uint				m_mask = 0U;
+
+	alignas(64) std::atomic<uint>	m_enqueuePosition { 0U };
+	alignas(64) std::atomic<uint>	m_dequeuePosition { 0U };
+
+	GameHandle*			m_groupHandles = nullptr;
+	uint				m_groupHandleCapacity = 0U;
+	std::atomic<uint>	m_groupHandlesUsed { 0U };
+	std::atomic<uint>	m_groupEnqueuesInFlight { 0U };
+	std::atomic<bool>	m_isProcessing { false };
+};
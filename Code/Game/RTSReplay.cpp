@@ -0,0 +1,599 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RTSReplay.hpp"
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/Entity.hpp"
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+//Others
+#include <cmath>
+#include <cstring>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const char	REPLAY_MAGIC[4] = { 'R', 'T', 'S', 'R' };
+static const uint	REPLAY_VERSION = 4U;
+static const float	REPLAY_POSITION_SCALE = 1024.f;
+
+//Type byte layout. Commands use their CommandTypeT, tasks set the high bit and carry the queued flag
+static const uint8_t	REPLAY_TASK_BIT = 0x80;
+static const uint8_t	REPLAY_QUEUED_BIT = 0x40;
+static const uint8_t	REPLAY_TYPE_MASK = 0x3f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteVarUInt(std::vector<uint8_t>& bytes, uint value)
+{
+	while (value >= 0x80)
+	{
+		bytes.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back((uint8_t)value);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Zigzag so small negative deltas stay small
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteVarInt(std::vector<uint8_t>& bytes, int value)
+{
+	WriteVarUInt(bytes, ((uint)value << 1) ^ (uint)(value >> 31));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadVarUInt(const std::vector<uint8_t>& bytes, size_t& readIndex, uint* value)
+{
+	uint result = 0U;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if(readIndex >= bytes.size())
+			return false;
+
+		uint8_t byte = bytes[readIndex++];
+		result |= (uint)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			*value = result;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadVarInt(const std::vector<uint8_t>& bytes, size_t& readIndex, int* value)
+{
+	uint zigzag = 0U;
+	if(!ReadVarUInt(bytes, readIndex, &zigzag))
+		return false;
+
+	*value = (int)(zigzag >> 1) ^ -(int)(zigzag & 1U);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadByte(const std::vector<uint8_t>& bytes, size_t& readIndex, uint8_t* value)
+{
+	if(readIndex >= bytes.size())
+		return false;
+
+	*value = bytes[readIndex++];
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Hashes are uniformly random so varints would only make them bigger
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteFixedUInt(std::vector<uint8_t>& bytes, uint value)
+{
+	for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+	{
+		bytes.push_back((uint8_t)(value >> (byteIndex * 8)));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadFixedUInt(const std::vector<uint8_t>& bytes, size_t& readIndex, uint* value)
+{
+	if(readIndex + 4 > bytes.size())
+		return false;
+
+	uint result = 0U;
+	for (int byteIndex = 0; byteIndex < 4; ++byteIndex)
+	{
+		result |= (uint)bytes[readIndex++] << (byteIndex * 8);
+	}
+
+	*value = result;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteHandle(std::vector<uint8_t>& bytes, ReplayDeltaState& state, const GameHandle& handle)
+{
+	uint raw = (handle.GetCyclicID() << 16) | handle.GetIndex();
+	WriteVarInt(bytes, (int)(raw - state.m_lastHandle));
+	state.m_lastHandle = raw;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadHandle(const std::vector<uint8_t>& bytes, size_t& readIndex, ReplayDeltaState& state, GameHandle* handle)
+{
+	int delta = 0;
+	if(!ReadVarInt(bytes, readIndex, &delta))
+		return false;
+
+	uint raw = state.m_lastHandle + (uint)delta;
+	state.m_lastHandle = raw;
+	*handle = GameHandle(raw >> 16, raw & 0x0000ffff);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WritePosition(std::vector<uint8_t>& bytes, ReplayDeltaState& state, const Vec2& position)
+{
+	int fixedX = (int)std::lround(position.x * REPLAY_POSITION_SCALE);
+	int fixedY = (int)std::lround(position.y * REPLAY_POSITION_SCALE);
+
+	WriteVarInt(bytes, fixedX - state.m_lastPositionX);
+	WriteVarInt(bytes, fixedY - state.m_lastPositionY);
+
+	state.m_lastPositionX = fixedX;
+	state.m_lastPositionY = fixedY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadPosition(const std::vector<uint8_t>& bytes, size_t& readIndex, ReplayDeltaState& state, Vec2* position)
+{
+	int deltaX = 0;
+	int deltaY = 0;
+	if(!ReadVarInt(bytes, readIndex, &deltaX) || !ReadVarInt(bytes, readIndex, &deltaY))
+		return false;
+
+	state.m_lastPositionX += deltaX;
+	state.m_lastPositionY += deltaY;
+	*position = Vec2((float)state.m_lastPositionX / REPLAY_POSITION_SCALE, (float)state.m_lastPositionY / REPLAY_POSITION_SCALE);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ReplayRecorder::ReplayRecorder()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ReplayRecorder::~ReplayRecorder()
+{
+	StopRecording();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC Vec2 ReplayRecorder::QuantizePosition(const Vec2& position)
+{
+	return Vec2(std::round(position.x * REPLAY_POSITION_SCALE) / REPLAY_POSITION_SCALE, std::round(position.y * REPLAY_POSITION_SCALE) / REPLAY_POSITION_SCALE);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReplayRecorder::StartRecording(const std::string& filePath, const ReplayHeader& header)
+{
+	StopRecording();
+
+	m_file = fopen(filePath.c_str(), "wb");
+	if (m_file == nullptr)
+	{
+		ERROR_RECOVERABLE(Stringf("Could not open replay file %s for writing", filePath.c_str()));
+		return false;
+	}
+
+	m_tickRecords.clear();
+	m_pendingBytes.clear();
+	m_tickRecordCount = 0U;
+	m_tickCount = 0U;
+	m_ticksSinceFlush = 0U;
+	m_deltaState = ReplayDeltaState();
+
+	m_pendingBytes.insert(m_pendingBytes.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+	WriteVarUInt(m_pendingBytes, REPLAY_VERSION);
+	m_pendingBytes.push_back(header.m_disableAI ? 1U : 0U);
+	WriteVarInt(m_pendingBytes, header.m_currentTeam);
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		WriteVarInt(m_pendingBytes, header.m_teamResource[teamIndex]);
+		WriteVarInt(m_pendingBytes, header.m_teamCurrentSupply[teamIndex]);
+		WriteVarInt(m_pendingBytes, header.m_teamMaxSupply[teamIndex]);
+	}
+
+	Flush();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::StopRecording()
+{
+	if(m_file == nullptr)
+		return;
+
+	//Orders issued after the last tick never ran, so they are dropped with it
+	Flush();
+
+	fclose(m_file);
+	m_file = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every order is stamped with the simulation tick it will run on. Orders only ever run on the tick being assembled, the one
+// EndTick closes next, whether the match was paused or not when they were issued
+//------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::RecordCommand(uint tick, const RTSCommand& command, const GameHandle* groupHandles)
+{
+	if(m_file == nullptr)
+		return;
+
+	ASSERT_RECOVERABLE(tick == m_tickCount, Stringf("Replay command stamped for tick %u while recording tick %u", tick, m_tickCount));
+
+	m_tickRecords.push_back((uint8_t)command.m_commandType);
+
+	switch (command.m_commandType)
+	{
+	case CREATE_ENTITY:
+	case PLACE_BUILDING:
+	{
+		WritePosition(m_tickRecords, m_deltaState, command.m_position);
+		m_tickRecords.push_back((uint8_t)command.m_entityType);
+		WriteVarInt(m_tickRecords, command.m_team);
+	}
+	break;
+	case MOVE_ENTITY:
+	{
+		WriteHandle(m_tickRecords, m_deltaState, command.m_unit);
+		WritePosition(m_tickRecords, m_deltaState, command.m_position);
+	}
+	break;
+	case GROUP_MOVE_ENTITY:
+	{
+		WriteVarUInt(m_tickRecords, command.m_groupCount);
+		for (uint groupIndex = 0; groupIndex < command.m_groupCount; ++groupIndex)
+		{
+			WriteHandle(m_tickRecords, m_deltaState, groupHandles[groupIndex]);
+		}
+		WritePosition(m_tickRecords, m_deltaState, command.m_position);
+	}
+	break;
+	case TRAIN_UNIT:
+	case SET_ENTITY_TEAM:
+	{
+		WriteHandle(m_tickRecords, m_deltaState, command.m_unit);
+		WriteVarInt(m_tickRecords, command.m_team);
+	}
+	break;
+	case SET_PLAYER_TEAM:
+	{
+		WriteVarInt(m_tickRecords, command.m_team);
+	}
+	break;
+	case KILL_ENTITY:
+	{
+		WriteHandle(m_tickRecords, m_deltaState, command.m_unit);
+	}
+	break;
+	case SET_AI_ENABLED:
+	{
+		m_tickRecords.push_back(command.m_isEnabled ? 1U : 0U);
+	}
+	break;
+	default:
+		ERROR_RECOVERABLE("Unhandled RTSCommand type in replay recording");
+		m_tickRecords.pop_back();
+		return;
+	}
+
+	++m_tickRecordCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::RecordTask(uint tick, const Entity& entity, const RTSTask& task)
+{
+	if(m_file == nullptr)
+		return;
+
+	ASSERT_RECOVERABLE(tick == m_tickCount, Stringf("Replay task stamped for tick %u while recording tick %u", tick, m_tickCount));
+
+	uint8_t typeByte = REPLAY_TASK_BIT | (uint8_t)task.m_taskType;
+	if (task.m_isQueued)
+	{
+		typeByte |= REPLAY_QUEUED_BIT;
+	}
+
+	m_tickRecords.push_back(typeByte);
+	WriteHandle(m_tickRecords, m_deltaState, entity.GetHandle());
+
+	switch (task.m_taskType)
+	{
+	case FOLLOW:
+	case ATTACK:
+	case GATHER:
+	case REPAIR:
+	{
+		WriteHandle(m_tickRecords, m_deltaState, task.m_target);
+	}
+	break;
+	case BUILD:
+	{
+		WritePosition(m_tickRecords, m_deltaState, task.m_position);
+		m_tickRecords.push_back((uint8_t)task.m_buildingType);
+	}
+	break;
+	case MOVE:
+	{
+		WritePosition(m_tickRecords, m_deltaState, task.m_position);
+	}
+	break;
+	default:
+		break;
+	}
+
+	++m_tickRecordCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::EndTick(float deltaTime, uint stateHash)
+{
+	if(m_file == nullptr)
+		return;
+
+	uint deltaTimeBits = 0U;
+	memcpy(&deltaTimeBits, &deltaTime, sizeof(deltaTimeBits));
+
+	WriteVarUInt(m_pendingBytes, m_tickRecordCount);
+	WriteVarInt(m_pendingBytes, (int)(deltaTimeBits - m_deltaState.m_lastDeltaTimeBits));
+	m_deltaState.m_lastDeltaTimeBits = deltaTimeBits;
+	WriteFixedUInt(m_pendingBytes, stateHash);
+
+	m_pendingBytes.insert(m_pendingBytes.end(), m_tickRecords.begin(), m_tickRecords.end());
+	m_tickRecords.clear();
+	m_tickRecordCount = 0U;
+
+	++m_tickCount;
+	if (++m_ticksSinceFlush >= m_flushInterval)
+	{
+		Flush();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ReplayRecorder::Flush()
+{
+	m_ticksSinceFlush = 0U;
+
+	if(m_pendingBytes.empty())
+		return;
+
+	fwrite(m_pendingBytes.data(), 1, m_pendingBytes.size(), m_file);
+	fflush(m_file);
+	m_pendingBytes.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReplayPlayer::Load(const std::string& filePath)
+{
+	m_bytes.clear();
+	m_readIndex = 0U;
+	m_tickCount = 0U;
+	m_deltaState = ReplayDeltaState();
+
+	FILE* file = fopen(filePath.c_str(), "rb");
+	if(file == nullptr)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (fileSize > 0)
+	{
+		m_bytes.resize((size_t)fileSize);
+		m_bytes.resize(fread(m_bytes.data(), 1, (size_t)fileSize, file));
+	}
+	fclose(file);
+
+	if(m_bytes.size() < 4 || memcmp(m_bytes.data(), REPLAY_MAGIC, 4) != 0)
+		return false;
+
+	m_readIndex = 4U;
+
+	uint version = 0U;
+	if(!ReadVarUInt(m_bytes, m_readIndex, &version) || version != REPLAY_VERSION)
+		return false;
+
+	uint8_t disableAI = 0U;
+	bool result = ReadByte(m_bytes, m_readIndex, &disableAI);
+	result = result && ReadVarInt(m_bytes, m_readIndex, &m_header.m_currentTeam);
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		result = result && ReadVarInt(m_bytes, m_readIndex, &m_header.m_teamResource[teamIndex]);
+		result = result && ReadVarInt(m_bytes, m_readIndex, &m_header.m_teamCurrentSupply[teamIndex]);
+		result = result && ReadVarInt(m_bytes, m_readIndex, &m_header.m_teamMaxSupply[teamIndex]);
+	}
+	m_header.m_disableAI = (disableAI != 0U);
+
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReplayPlayer::ApplyNextTick(Game* game, float* deltaTime, uint* stateHash)
+{
+	if(IsFinished())
+		return false;
+
+	uint recordCount = 0U;
+	int deltaTimeBitsDelta = 0;
+	if (!ReadVarUInt(m_bytes, m_readIndex, &recordCount) || !ReadVarInt(m_bytes, m_readIndex, &deltaTimeBitsDelta)
+		|| !ReadFixedUInt(m_bytes, m_readIndex, stateHash))
+	{
+		//Partial tick from a recording that died mid write, treat it as the end
+		m_readIndex = m_bytes.size();
+		return false;
+	}
+
+	uint deltaTimeBits = m_deltaState.m_lastDeltaTimeBits + (uint)deltaTimeBitsDelta;
+	m_deltaState.m_lastDeltaTimeBits = deltaTimeBits;
+	memcpy(deltaTime, &deltaTimeBits, sizeof(deltaTimeBits));
+
+	for (uint recordIndex = 0; recordIndex < recordCount; ++recordIndex)
+	{
+		uint8_t typeByte = 0U;
+		bool result = ReadByte(m_bytes, m_readIndex, &typeByte);
+		if (result)
+		{
+			result = (typeByte & REPLAY_TASK_BIT) ? ApplyTask(game, typeByte) : ApplyCommand(game, typeByte);
+		}
+
+		if (!result)
+		{
+			m_readIndex = m_bytes.size();
+			return false;
+		}
+	}
+
+	++m_tickCount;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReplayPlayer::ApplyCommand(Game* game, uint8_t typeByte)
+{
+	RTSCommand command;
+	command.m_commandType = (CommandTypeT)typeByte;
+
+	switch (command.m_commandType)
+	{
+	case CREATE_ENTITY:
+	case PLACE_BUILDING:
+	{
+		uint8_t entityType = 0U;
+		if (!ReadPosition(m_bytes, m_readIndex, m_deltaState, &command.m_position) || !ReadByte(m_bytes, m_readIndex, &entityType)
+			|| !ReadVarInt(m_bytes, m_readIndex, &command.m_team))
+			return false;
+
+		command.m_entityType = (EntityTypeT)entityType;
+		game->EnqueueCommand(command);
+	}
+	break;
+	case MOVE_ENTITY:
+	{
+		if (!ReadHandle(m_bytes, m_readIndex, m_deltaState, &command.m_unit) || !ReadPosition(m_bytes, m_readIndex, m_deltaState, &command.m_position))
+			return false;
+
+		game->EnqueueCommand(command);
+	}
+	break;
+	case GROUP_MOVE_ENTITY:
+	{
+		uint groupCount = 0U;
+		if(!ReadVarUInt(m_bytes, m_readIndex, &groupCount))
+			return false;
+
+		m_groupHandles.resize(groupCount);
+		for (uint groupIndex = 0; groupIndex < groupCount; ++groupIndex)
+		{
+			if(!ReadHandle(m_bytes, m_readIndex, m_deltaState, &m_groupHandles[groupIndex]))
+				return false;
+		}
+
+		if(!ReadPosition(m_bytes, m_readIndex, m_deltaState, &command.m_position))
+			return false;
+
+		game->EnqueueGroupMove(m_groupHandles, command.m_position);
+	}
+	break;
+	case TRAIN_UNIT:
+	case SET_ENTITY_TEAM:
+	{
+		if (!ReadHandle(m_bytes, m_readIndex, m_deltaState, &command.m_unit) || !ReadVarInt(m_bytes, m_readIndex, &command.m_team))
+			return false;
+
+		game->EnqueueCommand(command);
+	}
+	break;
+	case SET_PLAYER_TEAM:
+	{
+		if(!ReadVarInt(m_bytes, m_readIndex, &command.m_team))
+			return false;
+
+		game->EnqueueCommand(command);
+	}
+	break;
+	case KILL_ENTITY:
+	{
+		if(!ReadHandle(m_bytes, m_readIndex, m_deltaState, &command.m_unit))
+			return false;
+
+		game->EnqueueCommand(command);
+	}
+	break;
+	case SET_AI_ENABLED:
+	{
+		uint8_t isEnabled = 0U;
+		if(!ReadByte(m_bytes, m_readIndex, &isEnabled))
+			return false;
+
+		command.m_isEnabled = (isEnabled != 0U);
+		game->EnqueueCommand(command);
+	}
+	break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReplayPlayer::ApplyTask(Game* game, uint8_t typeByte)
+{
+	RTSTask task;
+	task.m_taskType = (TaskTypeT)(typeByte & REPLAY_TYPE_MASK);
+	task.m_isQueued = (typeByte & REPLAY_QUEUED_BIT) != 0;
+
+	GameHandle entityHandle;
+	if(!ReadHandle(m_bytes, m_readIndex, m_deltaState, &entityHandle))
+		return false;
+
+	switch (task.m_taskType)
+	{
+	case FOLLOW:
+	case ATTACK:
+	case GATHER:
+	case REPAIR:
+	{
+		if(!ReadHandle(m_bytes, m_readIndex, m_deltaState, &task.m_target))
+			return false;
+	}
+	break;
+	case BUILD:
+	{
+		uint8_t buildingType = 0U;
+		if(!ReadPosition(m_bytes, m_readIndex, m_deltaState, &task.m_position) || !ReadByte(m_bytes, m_readIndex, &buildingType))
+			return false;
+
+		task.m_buildingType = (EntityTypeT)buildingType;
+	}
+	break;
+	case MOVE:
+	{
+		if(!ReadPosition(m_bytes, m_readIndex, m_deltaState, &task.m_position))
+			return false;
+	}
+	break;
+	default:
+		return false;
+	}
+
+	Entity* entity = game->m_map->FindEntity(entityHandle);
+	if (entity != nullptr)
+	{
+		entity->IssueTask(task);
+	}
+
+	return true;
+}
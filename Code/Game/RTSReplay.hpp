@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+//Game Systems
+#include "Game/GameHandle.hpp"
+#include "Game/RTSCommand.hpp"
+#include "Game/RTSTask.hpp"
+//Others
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Entity;
+class Game;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Match state that is set before the first tick and isn't rebuilt by loading the map
+//------------------------------------------------------------------------------------------------------------------------------
+struct ReplayHeader
+{
+	bool				m_disableAI = true;
+	int					m_currentTeam = 1;
+	int					m_teamResource[2] = { 0, 0 };
+	int					m_teamCurrentSupply[2] = { 0, 0 };
+	int					m_teamMaxSupply[2] = { 0, 0 };
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Running values each record is delta encoded against. The recorder and player step theirs in the same order
+//------------------------------------------------------------------------------------------------------------------------------
+struct ReplayDeltaState
+{
+	uint				m_lastHandle = 0U;
+	int					m_lastPositionX = 0;
+	int					m_lastPositionY = 0;
+	uint				m_lastDeltaTimeBits = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Writes every player issued command and task to a compact per tick log.
+// Each tick is a varint record count, the tick's delta time, the state hash after the tick and the records.
+// Handles and fixed point positions are zigzag deltas against the previous record so a typical order costs a handful of bytes.
+// The log is appended to disk every few seconds so a crash still leaves everything up to the last flush behind
+//------------------------------------------------------------------------------------------------------------------------------
+class ReplayRecorder
+{
+public:
+	ReplayRecorder();
+	~ReplayRecorder();
+
+	bool					StartRecording(const std::string& filePath, const ReplayHeader& header);
+	void					StopRecording();
+	inline bool				IsRecording() const { return m_file != nullptr; }
+
+	void					RecordCommand(uint tick, const RTSCommand& command, const GameHandle* groupHandles = nullptr);
+	void					RecordTask(uint tick, const Entity& entity, const RTSTask& task);
+	void					EndTick(float deltaTime, uint stateHash);
+
+	inline uint				GetTickCount() const { return m_tickCount; }
+
+	//Positions are stored at 1/1024 of a tile, orders are snapped to that before they run so playback sees the same value
+	static Vec2				QuantizePosition(const Vec2& position);
+
+private:
+	void					Flush();
+
+private:
+	FILE*					m_file = nullptr;
+	std::vector<uint8_t>	m_tickRecords;
+	std::vector<uint8_t>	m_pendingBytes;
+	uint					m_tickRecordCount = 0U;
+	uint					m_tickCount = 0U;
+	uint					m_ticksSinceFlush = 0U;
+	uint					m_flushInterval = 60U;
+	ReplayDeltaState		m_deltaState;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Reads a log back one tick at a time. Records are applied the same way the player input applied them
+//------------------------------------------------------------------------------------------------------------------------------
+class ReplayPlayer
+{
+public:
+	bool					Load(const std::string& filePath);
+
+	inline const ReplayHeader&	GetHeader() const { return m_header; }
+	inline bool				IsFinished() const { return m_readIndex >= m_bytes.size(); }
+	inline uint				GetTickCount() const { return m_tickCount; }
+
+	//Applies the next tick's records to the game and returns the tick's delta time and the state hash the recording
+	//had after it, false once the log runs out
+	bool					ApplyNextTick(Game* game, float* deltaTime, uint* stateHash);
+
+private:
+	bool					ApplyCommand(Game* game, uint8_t typeByte);
+	bool					ApplyTask(Game* game, uint8_t typeByte);
+
+private:
+	std::vector<uint8_t>	m_bytes;
+	size_t					m_readIndex = 0U;
+	ReplayHeader			m_header;
+	ReplayDeltaState		m_deltaState;
+	std::vector<GameHandle>	m_groupHandles;
+	uint					m_tickCount = 0U;
+};
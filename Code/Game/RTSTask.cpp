@@ -7,112 +7,172 @@
 #include "Game/Entity.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
-RTSTask::RTSTask(TaskTypeT taskType)
+STATIC RTSTask RTSTask::MakeFollow(const GameHandle& unitToFollow, bool isQueued)
 {
-	m_taskType = taskType;
+	RTSTask task;
+	task.m_taskType = FOLLOW;
+	task.m_target = unitToFollow;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-FollowTask::FollowTask(const GameHandle& thisUnit, const GameHandle& unitToFollow)
-	: RTSTask(FOLLOW)
+STATIC RTSTask RTSTask::MakeAttack(const GameHandle& unitToAttack, bool isQueued)
 {
-	m_thisUnit = thisUnit;
-	m_unitToFollow = unitToFollow;
+	RTSTask task;
+	task.m_taskType = ATTACK;
+	task.m_target = unitToAttack;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-FollowTask::~FollowTask()
+STATIC RTSTask RTSTask::MakeGather(const GameHandle& unitToGather, bool isQueued)
 {
-
+	RTSTask task;
+	task.m_taskType = GATHER;
+	task.m_target = unitToGather;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-VIRTUAL void FollowTask::Execute()
+STATIC RTSTask RTSTask::MakeBuild(const Vec2& buildLocation, EntityTypeT buildingType, bool isQueued)
 {
-	Map* map = Game::s_gameReference->m_map;
-	Entity *entity = map->FindEntity(m_unitToFollow);
-	Entity *thisEntity = map->FindEntity(m_thisUnit);
-	if (entity != nullptr && thisEntity != nullptr)
-	{
-		thisEntity->Follow(entity);
-	}
+	RTSTask task;
+	task.m_taskType = BUILD;
+	task.m_position = buildLocation;
+	task.m_buildingType = buildingType;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-AttackTask::AttackTask(const GameHandle& thisUnit, const GameHandle& unitToAttack)
-	: RTSTask(ATTACK)
+STATIC RTSTask RTSTask::MakeMove(const Vec2& moveLocation, bool isQueued)
 {
-	m_thisUnit = thisUnit;
-	m_unitToAttack = unitToAttack;
+	RTSTask task;
+	task.m_taskType = MOVE;
+	task.m_position = moveLocation;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-AttackTask::~AttackTask()
+STATIC RTSTask RTSTask::MakeRepair(const GameHandle& building, bool isQueued)
 {
-
+	RTSTask task;
+	task.m_taskType = REPAIR;
+	task.m_target = building;
+	task.m_isQueued = isQueued;
+	return task;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-VIRTUAL void AttackTask::Execute()
+void RTSTask::Execute(Entity& thisUnit) const
 {
 	Map* map = Game::s_gameReference->m_map;
-	Entity *entity = map->FindEntity(m_unitToAttack);
-	Entity *thisEntity = map->FindEntity(m_thisUnit);
-	if (entity != nullptr && thisEntity != nullptr)
+
+	switch (m_taskType)
 	{
-		thisEntity->Attack(entity);
+	case FOLLOW:
+	{
+		Entity *entity = map->FindEntity(m_target);
+		if (entity != nullptr)
+		{
+			thisUnit.Follow(entity);
+		}
+	}
+	break;
+	case ATTACK:
+	{
+		Entity *entity = map->FindEntity(m_target);
+		if (entity != nullptr)
+		{
+			thisUnit.Attack(entity);
+		}
+	}
+	break;
+	case GATHER:
+	{
+		Entity *entity = map->FindEntity(m_target);
+		if (entity != nullptr)
+		{
+			thisUnit.Gather(entity);
+		}
+	}
+	break;
+	case BUILD:
+	{
+		thisUnit.Build(m_position, m_buildingType);
+	}
+	break;
+	case MOVE:
+	{
+		thisUnit.StopFollow();
+		thisUnit.ResetTaskData();
+		thisUnit.PathTo(m_position);
+	}
+	break;
+	case REPAIR:
+	{
+		//Workers fix up a damaged building, anything else just walks over to it
+		Entity *entity = map->FindEntity(m_target);
+		if(entity == nullptr)
+			break;
+
+		bool isWorker = thisUnit.GetType() == PEON || thisUnit.GetType() == GOBLIN;
+		if (isWorker && entity->GetHealth() < entity->GetMaxHealth())
+		{
+			thisUnit.SetUnitToBuild(entity);
+		}
+		else
+		{
+			thisUnit.MoveTo(entity->GetPosition());
+		}
+	}
+	break;
+	default:
+		ERROR_RECOVERABLE("Unhandled RTSTask type");
+		break;
 	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-GatherTask::GatherTask(const GameHandle& thisUnit, const GameHandle& unitToGather)
-	: RTSTask(GATHER)
-{
-	m_thisUnit = thisUnit;
-	m_unitToGather = unitToGather;
-}
-
-//------------------------------------------------------------------------------------------------------------------------------
-GatherTask::~GatherTask()
+bool RTSTaskQueue::Enqueue(const RTSTask& task)
 {
+	if (IsFull())
+		return false;
 
+	int tail = (m_head + m_count) % MAX_QUEUED_TASKS;
+	m_tasks[tail] = task;
+	++m_count;
+	return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void GatherTask::Execute()
+bool RTSTaskQueue::Dequeue(RTSTask* task)
 {
-	Map* map = Game::s_gameReference->m_map;
-	Entity *entity = map->FindEntity(m_unitToGather);
-	Entity *thisEntity = map->FindEntity(m_thisUnit);
-	if (entity != nullptr && thisEntity != nullptr)
-	{
-		thisEntity->Gather(entity);
-	}
-}
+	if (IsEmpty())
+		return false;
 
-//------------------------------------------------------------------------------------------------------------------------------
-BuildTask::BuildTask(const GameHandle& thisUnit, const Vec2& buildLocation, EntityTypeT entityType)
-	:RTSTask(BUILD)
-{
-	m_thisUnit = thisUnit;
-	m_buildLocation = buildLocation;
-	m_buildingType = entityType;
+	*task = m_tasks[m_head];
+	m_head = (m_head + 1) % MAX_QUEUED_TASKS;
+	--m_count;
+	return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-BuildTask::~BuildTask()
+const RTSTask* RTSTaskQueue::PeekFront() const
 {
+	if (IsEmpty())
+		return nullptr;
 
+	return &m_tasks[m_head];
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void BuildTask::Execute()
+void RTSTaskQueue::Clear()
 {
-	Map* map = Game::s_gameReference->m_map;
-	Entity *thisEntity = map->FindEntity(m_thisUnit);
-
-	if (thisEntity != nullptr)
-	{
-		thisEntity->Build(m_buildLocation, m_buildingType);
-	}
+	m_head = 0;
+	m_count = 0;
 }
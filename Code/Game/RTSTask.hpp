@@ -4,76 +4,62 @@
 #include "Game/GameHandle.hpp"
 #include "Game/GameTypes.hpp"
 
+class Entity;
+
 //------------------------------------------------------------------------------------------------------------------------------
 enum TaskTypeT
 {
 	FOLLOW,
 	ATTACK,
 	GATHER,
-	BUILD
+	BUILD,
+	MOVE,
+	REPAIR
 };
 
-//------------------------------------------------------------------------------------------------------------------------------
-class RTSTask
-{
-public:
-	RTSTask(TaskTypeT taskType);
-	virtual ~RTSTask() {}
-	virtual void Execute() = 0;
-
-public:
-	TaskTypeT m_taskType;
-};
+constexpr int MAX_QUEUED_TASKS = 8;
 
 //------------------------------------------------------------------------------------------------------------------------------
-class FollowTask : RTSTask
-{
-public:
-	FollowTask(const GameHandle& thisUnit, const GameHandle& unitToFollow);
-	~FollowTask();
-	virtual void Execute();
-
-public:
-	GameHandle m_thisUnit;
-	GameHandle m_unitToFollow;
-};
-
+// Tasks are small value records owned by the entity's task queue. Each type only reads the fields it needs.
+// Queued tasks (shift orders) wait until the entity has gone idle, everything else runs on the next update
 //------------------------------------------------------------------------------------------------------------------------------
-class AttackTask : RTSTask
+struct RTSTask
 {
 public:
-	AttackTask(const GameHandle& thisUnit, const GameHandle& unitToAttack);
-	~AttackTask();
-	virtual void Execute();
+	static RTSTask	MakeFollow(const GameHandle& unitToFollow, bool isQueued = false);
+	static RTSTask	MakeAttack(const GameHandle& unitToAttack, bool isQueued = false);
+	static RTSTask	MakeGather(const GameHandle& unitToGather, bool isQueued = false);
+	static RTSTask	MakeBuild(const Vec2& buildLocation, EntityTypeT buildingType, bool isQueued = false);
+	static RTSTask	MakeMove(const Vec2& moveLocation, bool isQueued = false);
+	static RTSTask	MakeRepair(const GameHandle& building, bool isQueued = false);
 
-public:
-	GameHandle m_thisUnit;
-	GameHandle m_unitToAttack;
-};
+	void			Execute(Entity& thisUnit) const;
 
-//------------------------------------------------------------------------------------------------------------------------------
-class GatherTask : RTSTask
-{
 public:
-	GatherTask(const GameHandle& thisUnit, const GameHandle& unitToGather);
-	~GatherTask();
-	virtual void Execute();
-
-public:
-	GameHandle m_thisUnit;
-	GameHandle m_unitToGather;
+	TaskTypeT		m_taskType = MOVE;
+	GameHandle		m_target;						//FOLLOW, ATTACK, GATHER, REPAIR
+	Vec2			m_position = Vec2::ZERO;		//BUILD, MOVE
+	EntityTypeT		m_buildingType = HUT;			//BUILD
+	bool			m_isQueued = false;
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
-class BuildTask : RTSTask
+// Fixed capacity ring stored inline in the entity so issuing and running orders never touches the heap
+//------------------------------------------------------------------------------------------------------------------------------
+class RTSTaskQueue
 {
 public:
-	BuildTask(const GameHandle& thisUnit, const Vec2& buildLocation, EntityTypeT entityType);
-	~BuildTask();
-	virtual void Execute();
+	bool			Enqueue(const RTSTask& task);
+	bool			Dequeue(RTSTask* task);
+	const RTSTask*	PeekFront() const;
+	void			Clear();
 
-public:
-	GameHandle m_thisUnit;
-	Vec2 m_buildLocation;
-	EntityTypeT m_buildingType;
-};
\ No newline at end of file
+	inline int		GetCount() const { return m_count; }
+	inline bool		IsEmpty() const { return m_count == 0; }
+	inline bool		IsFull() const { return m_count == MAX_QUEUED_TASKS; }
+
+private:
+	RTSTask			m_tasks[MAX_QUEUED_TASKS];
+	int				m_head = 0;
+	int				m_count = 0;
+};
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RenderBackend.hpp"
+//Engine Systems
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderContextBackend::RenderContextBackend(RenderContext* renderContext)
+	:	m_renderContext(renderContext)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::BindShader(Shader* shader)
+{
+	m_renderContext->BindShader(shader);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::BindMaterial(Material* material)
+{
+	m_renderContext->BindMaterial(material);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::BindTextureView(uint slot, TextureView* texture)
+{
+	m_renderContext->BindTextureView(slot, texture);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::BindModelMatrix(const Matrix44& model)
+{
+	m_renderContext->BindModelMatrix(model);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::DrawMesh(GPUMesh* mesh)
+{
+	m_renderContext->DrawMesh(mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderContextBackend::DrawVertexArray(const std::vector<Vertex_PCU>& vertices)
+{
+	m_renderContext->DrawVertexArray(vertices);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderFrameStats::KeepWorst(const RenderFrameStats& other)
+{
+	m_numDrawCalls = other.m_numDrawCalls > m_numDrawCalls ? other.m_numDrawCalls : m_numDrawCalls;
+	m_numStateChanges = other.m_numStateChanges > m_numStateChanges ? other.m_numStateChanges : m_numStateChanges;
+	m_numRedundantBinds = other.m_numRedundantBinds > m_numRedundantBinds ? other.m_numRedundantBinds : m_numRedundantBinds;
+	m_numUploads = other.m_numUploads > m_numUploads ? other.m_numUploads : m_numUploads;
+	m_numBytesUploaded = other.m_numBytesUploaded > m_numBytesUploaded ? other.m_numBytesUploaded : m_numBytesUploaded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BeginFrame()
+{
+	m_commands.clear();
+	m_frameStats = RenderFrameStats();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::EndFrame()
+{
+	m_worstFrameStats.KeepWorst(m_frameStats);
+	m_numFrames++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindShader(Shader* shader)
+{
+	RecordBind(RENDER_COMMAND_BIND_SHADER, m_boundShader, shader, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindMaterial(Material* material)
+{
+	RecordBind(RENDER_COMMAND_BIND_MATERIAL, m_boundMaterial, material, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Slots past the tracked ones are rare enough to just count every bind as a change
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindTextureView(uint slot, TextureView* texture)
+{
+	if (slot < MAX_TRACKED_TEXTURE_SLOTS)
+	{
+		RecordBind(RENDER_COMMAND_BIND_TEXTURE, m_boundTextures[slot], texture, slot);
+		return;
+	}
+
+	const void* untracked = nullptr;
+	RecordBind(RENDER_COMMAND_BIND_TEXTURE, untracked, texture, slot);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every model bind rewrites the model constant buffer, so it always counts as a state change
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindModelMatrix(const Matrix44& model)
+{
+	UNUSED(model);
+
+	RenderCommand command;
+	command.m_type = RENDER_COMMAND_BIND_MODEL;
+	m_commands.push_back(command);
+	m_frameStats.m_numStateChanges++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawMesh(GPUMesh* mesh)
+{
+	RenderCommand command;
+	command.m_type = RENDER_COMMAND_DRAW_MESH;
+	command.m_resource = mesh;
+	m_commands.push_back(command);
+	m_frameStats.m_numDrawCalls++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawVertexArray(const std::vector<Vertex_PCU>& vertices)
+{
+	uint numBytes = (uint)(vertices.size() * sizeof(Vertex_PCU));
+
+	RenderCommand command;
+	command.m_type = RENDER_COMMAND_DRAW_VERTEX_ARRAY;
+	command.m_numBytes = numBytes;
+	m_commands.push_back(command);
+
+	m_frameStats.m_numDrawCalls++;
+	m_frameStats.m_numUploads++;
+	m_frameStats.m_numBytesUploaded += numBytes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::RecordBind(eRenderCommandType type, const void*& boundResource, const void* resource, uint slot)
+{
+	RenderCommand command;
+	command.m_type = type;
+	command.m_resource = resource;
+	command.m_slot = slot;
+	m_commands.push_back(command);
+
+	if (resource == boundResource)
+	{
+		m_frameStats.m_numRedundantBinds++;
+		return;
+	}
+
+	boundResource = resource;
+	m_frameStats.m_numStateChanges++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// <renderBudgets>
+//		<budget scenario="default" drawCalls="64" stateChanges="256" uploads="16" bytesUploaded="1048576"/>
+// </renderBudgets>
+//------------------------------------------------------------------------------------------------------------------------------
+bool RenderBudgetSet::LoadFromFile(const std::string& filePath)
+{
+	m_budgets.clear();
+
+	tinyxml2::XMLDocument budgetDoc;
+	budgetDoc.LoadFile(filePath.c_str());
+	if (budgetDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+		return false;
+
+	XMLElement* rootElement = budgetDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement("budget"); element != nullptr; element = element->NextSiblingElement("budget"))
+	{
+		RenderBudget budget;
+		budget.m_scenario = ParseXmlAttribute(*element, "scenario", "");
+		budget.m_maxDrawCalls = (uint)ParseXmlAttribute(*element, "drawCalls", 0);
+		budget.m_maxStateChanges = (uint)ParseXmlAttribute(*element, "stateChanges", 0);
+		budget.m_maxUploads = (uint)ParseXmlAttribute(*element, "uploads", 0);
+		budget.m_maxBytesUploaded = (uint64_t)ParseXmlAttribute(*element, "bytesUploaded", 0);
+		m_budgets.push_back(budget);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const RenderBudget* RenderBudgetSet::FindBudget(const std::string& scenario) const
+{
+	for (size_t budgetIndex = 0; budgetIndex < m_budgets.size(); budgetIndex++)
+	{
+		if (m_budgets[budgetIndex].m_scenario == scenario)
+			return &m_budgets[budgetIndex];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool RenderBudgetSet::CheckBudget(const RenderBudget& budget, const RenderFrameStats& stats, std::vector<std::string>& outFailures)
+{
+	outFailures.clear();
+
+	if (budget.m_maxDrawCalls > 0U && stats.m_numDrawCalls > budget.m_maxDrawCalls)
+	{
+		outFailures.push_back(Stringf("Draw calls %u over budget of %u", stats.m_numDrawCalls, budget.m_maxDrawCalls));
+	}
+
+	if (budget.m_maxStateChanges > 0U && stats.m_numStateChanges > budget.m_maxStateChanges)
+	{
+		outFailures.push_back(Stringf("State changes %u over budget of %u", stats.m_numStateChanges, budget.m_maxStateChanges));
+	}
+
+	if (budget.m_maxUploads > 0U && stats.m_numUploads > budget.m_maxUploads)
+	{
+		outFailures.push_back(Stringf("Buffer uploads %u over budget of %u", stats.m_numUploads, budget.m_maxUploads));
+	}
+
+	if (budget.m_maxBytesUploaded > 0U && stats.m_numBytesUploaded > budget.m_maxBytesUploaded)
+	{
+		outFailures.push_back(Stringf("Bytes uploaded %llu over budget of %llu", (unsigned long long)stats.m_numBytesUploaded, (unsigned long long)budget.m_maxBytesUploaded));
+	}
+
+	return outFailures.empty();
+}
@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GPUMesh;
+class Material;
+class RenderContext;
+class Shader;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The part of the render context the map's frame goes through. The render context one does the GPU work, the recording one
+// keeps the frame as a command stream and its counts so a frame can be measured on a machine with no device
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	virtual void		BindShader(Shader* shader) = 0;
+	virtual void		BindMaterial(Material* material) = 0;
+	virtual void		BindTextureView(uint slot, TextureView* texture) = 0;
+	virtual void		BindModelMatrix(const Matrix44& model) = 0;
+	virtual void		DrawMesh(GPUMesh* mesh) = 0;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices) = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderContextBackend : public RenderBackend
+{
+public:
+	explicit RenderContextBackend(RenderContext* renderContext);
+
+	virtual void		BindShader(Shader* shader) override;
+	virtual void		BindMaterial(Material* material) override;
+	virtual void		BindTextureView(uint slot, TextureView* texture) override;
+	virtual void		BindModelMatrix(const Matrix44& model) override;
+	virtual void		DrawMesh(GPUMesh* mesh) override;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices) override;
+
+private:
+	RenderContext*		m_renderContext = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eRenderCommandType
+{
+	RENDER_COMMAND_BIND_SHADER,
+	RENDER_COMMAND_BIND_MATERIAL,
+	RENDER_COMMAND_BIND_TEXTURE,
+	RENDER_COMMAND_BIND_MODEL,
+	RENDER_COMMAND_DRAW_MESH,
+	RENDER_COMMAND_DRAW_VERTEX_ARRAY,
+
+	NUM_RENDER_COMMAND_TYPES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderCommand
+{
+	eRenderCommandType	m_type = RENDER_COMMAND_DRAW_MESH;
+	const void*			m_resource = nullptr;		//What was bound or drawn, null for model binds and vertex arrays
+	uint				m_slot = 0U;				//Texture slot for texture binds
+	uint				m_numBytes = 0U;			//Bytes sent to the GPU by vertex arrays
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A bind only counts as a state change when it differs from what is already bound. Vertex arrays count as a draw and an
+// upload since the render context streams them through a dynamic buffer
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderFrameStats
+{
+	uint				m_numDrawCalls = 0U;
+	uint				m_numStateChanges = 0U;
+	uint				m_numRedundantBinds = 0U;
+	uint				m_numUploads = 0U;
+	uint64_t			m_numBytesUploaded = 0U;
+
+	void				KeepWorst(const RenderFrameStats& other);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	void				BeginFrame();
+	void				EndFrame();
+
+	virtual void		BindShader(Shader* shader) override;
+	virtual void		BindMaterial(Material* material) override;
+	virtual void		BindTextureView(uint slot, TextureView* texture) override;
+	virtual void		BindModelMatrix(const Matrix44& model) override;
+	virtual void		DrawMesh(GPUMesh* mesh) override;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices) override;
+
+	inline const std::vector<RenderCommand>&	GetCommands() const { return m_commands; }
+	inline const RenderFrameStats&	GetFrameStats() const { return m_frameStats; }
+	inline const RenderFrameStats&	GetWorstFrameStats() const { return m_worstFrameStats; }
+	inline uint			GetNumFrames() const { return m_numFrames; }
+
+private:
+	void				RecordBind(eRenderCommandType type, const void*& boundResource, const void* resource, uint slot);
+
+private:
+	static const uint	MAX_TRACKED_TEXTURE_SLOTS = 8U;
+
+	std::vector<RenderCommand>	m_commands;			//This frame, in submission order
+	RenderFrameStats	m_frameStats;
+	RenderFrameStats	m_worstFrameStats;
+	uint				m_numFrames = 0U;
+
+	//Bound state carries over between frames like it does on the device
+	const void*			m_boundShader = nullptr;
+	const void*			m_boundMaterial = nullptr;
+	const void*			m_boundTextures[MAX_TRACKED_TEXTURE_SLOTS] = {};
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Per frame limits for a named scenario. A zero limit is not checked
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderBudget
+{
+	std::string			m_scenario;
+	uint				m_maxDrawCalls = 0U;
+	uint				m_maxStateChanges = 0U;
+	uint				m_maxUploads = 0U;
+	uint64_t			m_maxBytesUploaded = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderBudgetSet
+{
+public:
+	bool				LoadFromFile(const std::string& filePath);
+	const RenderBudget*	FindBudget(const std::string& scenario) const;
+
+	static bool			CheckBudget(const RenderBudget& budget, const RenderFrameStats& stats, std::vector<std::string>& outFailures);
+
+private:
+	std::vector<RenderBudget>	m_budgets;
+};
@@ -0,0 +1,341 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RenderQueue.hpp"
+//Engine Systems
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Shader.hpp"
+//Game Systems
+#include "Game/RenderBackend.hpp"
+//Others
+#include <utility>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pointers hashed down to the width of their key field. Two states sharing an id only sort next to each other, binds are
+// still decided on the real pointers
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t GetRenderStateID(const void* state, uint numBits)
+{
+	if (state == nullptr)
+		return 0U;
+
+	uint64_t value = (uint64_t)(uintptr_t)state;
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 33;
+	return (value >> (64U - numBits)) | 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t MakeRenderSortKey(RenderPassT pass, const Shader* shader, const Material* material, const TextureView* texture, float depth)
+{
+	const uint64_t maxDepthValue = (1U << 24U) - 1U;
+
+	float clampedDepth = depth < 0.f ? 0.f : (depth > RENDER_SORT_MAX_DEPTH ? RENDER_SORT_MAX_DEPTH : depth);
+	uint64_t depthValue = (uint64_t)((clampedDepth / RENDER_SORT_MAX_DEPTH) * (float)maxDepthValue);
+	if (pass == RENDER_PASS_ALPHA)
+	{
+		depthValue = maxDepthValue - depthValue;
+	}
+
+	uint64_t stateValue = 0U;
+	stateValue |= GetRenderStateID(shader, 10U) << 26U;
+	stateValue |= GetRenderStateID(material, 12U) << 14U;
+	stateValue |= GetRenderStateID(texture, 14U);
+
+	uint64_t key = ((uint64_t)pass & 0xFU) << 60U;
+	if (pass == RENDER_PASS_ALPHA)
+	{
+		key |= depthValue << 36U;
+		key |= stateValue;
+	}
+	else
+	{
+		key |= stateValue << 24U;
+		key |= depthValue;
+	}
+	return key;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderPacketBuffer::Clear()
+{
+	m_packets.clear();
+	m_states.clear();
+	m_transforms.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint RenderPacketBuffer::AddState(const RenderDrawState& state)
+{
+	m_states.push_back(state);
+	return (uint)m_states.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint RenderPacketBuffer::AddTransform(const Matrix44& model)
+{
+	m_transforms.push_back(model);
+	return (uint)m_transforms.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderPacketBuffer::AddPacket(uint64_t sortKey, uint stateIndex, uint transformIndex)
+{
+	RenderPacket packet;
+	packet.m_sortKey = sortKey;
+	packet.m_stateIndex = stateIndex;
+	packet.m_transformIndex = transformIndex;
+	m_packets.push_back(packet);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ForwardingQueueBackend::ForwardingQueueBackend(RenderBackend* renderBackend)
+	:	m_renderBackend(renderBackend)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ForwardingQueueBackend::BindShader(Shader* shader)
+{
+	m_renderBackend->BindShader(shader);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ForwardingQueueBackend::BindMaterial(Material* material)
+{
+	m_renderBackend->BindMaterial(material);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ForwardingQueueBackend::BindTexture(TextureView* texture)
+{
+	m_renderBackend->BindTextureView(0U, texture);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ForwardingQueueBackend::DrawMesh(GPUMesh* mesh, const Matrix44& model)
+{
+	m_renderBackend->BindModelMatrix(model);
+	m_renderBackend->DrawMesh(mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ForwardingQueueBackend::DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model)
+{
+	m_renderBackend->BindModelMatrix(model);
+	m_renderBackend->DrawVertexArray(vertices);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderQueueBackend::BindShader(Shader* shader)
+{
+	UNUSED(shader);
+	m_numShaderBinds++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderQueueBackend::BindMaterial(Material* material)
+{
+	UNUSED(material);
+	m_numMaterialBinds++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderQueueBackend::BindTexture(TextureView* texture)
+{
+	UNUSED(texture);
+	m_numTextureBinds++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderQueueBackend::DrawMesh(GPUMesh* mesh, const Matrix44& model)
+{
+	UNUSED(model);
+	m_drawnMeshes.push_back(mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderQueueBackend::DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model)
+{
+	UNUSED(vertices);
+	UNUSED(model);
+	m_numVertexArrays++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderQueue::BeginFrame(uint numBuffers)
+{
+	if (numBuffers == 0U)
+	{
+		numBuffers = 1U;
+	}
+
+	m_buffers.resize(numBuffers);
+	for (uint bufferIndex = 0; bufferIndex < numBuffers; bufferIndex++)
+	{
+		m_buffers[bufferIndex].Clear();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderPacketBuffer& RenderQueue::GetBuffer(uint bufferIndex)
+{
+	return m_buffers[bufferIndex];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void RenderQueue::RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+	const uint numEntries = (uint)entries.size();
+	if (numEntries < 2U)
+		return;
+
+	//All eight histograms in one read of the keys
+	uint counts[8][256] = {};
+	for (uint entryIndex = 0; entryIndex < numEntries; entryIndex++)
+	{
+		uint64_t key = entries[entryIndex].m_key;
+		for (uint byteIndex = 0; byteIndex < 8U; byteIndex++)
+		{
+			counts[byteIndex][(key >> (byteIndex * 8U)) & 0xFFU]++;
+		}
+	}
+
+	scratch.resize(numEntries);
+	std::vector<SortEntry>* source = &entries;
+	std::vector<SortEntry>* destination = &scratch;
+
+	for (uint byteIndex = 0; byteIndex < 8U; byteIndex++)
+	{
+		uint shift = byteIndex * 8U;
+		uint firstByte = (uint)(((*source)[0].m_key >> shift) & 0xFFU);
+		if (counts[byteIndex][firstByte] == numEntries)
+			continue;
+
+		uint offsets[256];
+		uint runningOffset = 0U;
+		for (uint bucket = 0; bucket < 256U; bucket++)
+		{
+			offsets[bucket] = runningOffset;
+			runningOffset += counts[byteIndex][bucket];
+		}
+
+		for (uint entryIndex = 0; entryIndex < numEntries; entryIndex++)
+		{
+			const SortEntry& entry = (*source)[entryIndex];
+			(*destination)[offsets[(entry.m_key >> shift) & 0xFFU]++] = entry;
+		}
+
+		std::swap(source, destination);
+	}
+
+	if (source != &entries)
+	{
+		entries.swap(scratch);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderQueue::Submit(RenderQueueBackend& backend)
+{
+	//Merge, buffers are walked in index order so equal keys keep a stable order between runs
+	m_entries.clear();
+	for (size_t bufferIndex = 0; bufferIndex < m_buffers.size(); bufferIndex++)
+	{
+		const std::vector<RenderPacket>& packets = m_buffers[bufferIndex].m_packets;
+		for (size_t packetIndex = 0; packetIndex < packets.size(); packetIndex++)
+		{
+			SortEntry entry;
+			entry.m_key = packets[packetIndex].m_sortKey;
+			entry.m_bufferIndex = (uint)bufferIndex;
+			entry.m_packetIndex = (uint)packetIndex;
+			m_entries.push_back(entry);
+		}
+	}
+
+	RadixSort(m_entries, m_scratch);
+
+	//Nothing is assumed bound when the queue starts
+	Shader* boundShader = nullptr;
+	Material* boundMaterial = nullptr;
+	TextureView* boundTexture = nullptr;
+	bool isShaderBound = false;
+	bool isMaterialBound = false;
+	bool isTextureBound = false;
+	bool isMaterialTexture = false;		//Slot 0 holds what the bound material put there
+
+	uint numStateChanges = 0U;
+	uint numElided = 0U;
+
+	for (size_t entryIndex = 0; entryIndex < m_entries.size(); entryIndex++)
+	{
+		const RenderPacketBuffer& buffer = m_buffers[m_entries[entryIndex].m_bufferIndex];
+		const RenderPacket& packet = buffer.m_packets[m_entries[entryIndex].m_packetIndex];
+		const RenderDrawState& state = buffer.m_states[packet.m_stateIndex];
+		const Matrix44& model = buffer.m_transforms[packet.m_transformIndex];
+
+		if (state.m_material != nullptr)
+		{
+			//A packet without a texture override wants the material's own texture back in slot 0
+			bool needsMaterial = !isMaterialBound || boundMaterial != state.m_material || (state.m_texture == nullptr && !isMaterialTexture);
+			if (needsMaterial)
+			{
+				backend.BindMaterial(state.m_material);
+				boundMaterial = state.m_material;
+				isMaterialBound = true;
+				isShaderBound = false;
+				isTextureBound = false;
+				isMaterialTexture = true;
+				numStateChanges++;
+			}
+			else
+			{
+				numElided++;
+			}
+		}
+		else
+		{
+			if (!isShaderBound || boundShader != state.m_shader)
+			{
+				backend.BindShader(state.m_shader);
+				boundShader = state.m_shader;
+				isShaderBound = true;
+				isMaterialBound = false;
+				numStateChanges++;
+			}
+			else
+			{
+				numElided++;
+			}
+		}
+
+		if (state.m_texture != nullptr || state.m_material == nullptr)
+		{
+			if (!isTextureBound || boundTexture != state.m_texture)
+			{
+				backend.BindTexture(state.m_texture);
+				boundTexture = state.m_texture;
+				isTextureBound = true;
+				isMaterialTexture = false;
+				numStateChanges++;
+			}
+			else
+			{
+				numElided++;
+			}
+		}
+
+		if (state.m_vertices != nullptr)
+		{
+			backend.DrawVertexArray(*state.m_vertices, model);
+		}
+		else
+		{
+			backend.DrawMesh(state.m_mesh, model);
+		}
+	}
+
+	m_lastNumPackets = (uint)m_entries.size();
+	m_lastNumStateChanges = numStateChanges;
+	m_lastNumElided = numElided;
+}
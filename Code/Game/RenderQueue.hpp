@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Others
+#include <cstdint>
+#include <vector>
+
+class GPUMesh;
+class Material;
+class RenderBackend;
+class Shader;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum RenderPassT
+{
+	RENDER_PASS_OPAQUE,
+	RENDER_PASS_ALPHA,
+	RENDER_PASS_OVERLAY,
+
+	NUM_RENDER_PASSES
+};
+
+//Distances past this all land in the farthest depth bucket
+constexpr float RENDER_SORT_MAX_DEPTH = 512.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sort key layout, most significant first:
+//   opaque and overlay:	pass 4 | shader 10 | material 12 | texture 14 | depth 24
+//   alpha:					pass 4 | depth 24 | shader 10 | material 12 | texture 14
+// Opaque and overlay packets group by state and go front to back inside a group. Alpha packets have to blend in order so
+// they go back to front first and only group by state at equal depths
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t	MakeRenderSortKey(RenderPassT pass, const Shader* shader, const Material* material, const TextureView* texture, float depth);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a draw binds and what it draws. A state with a material binds that material (and its shader), a texture on top of
+// that overrides slot 0. A state without a material binds its shader and texture directly. It draws either the mesh or the
+// vertex array, which has to stay alive until the queue is submitted
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderDrawState
+{
+	Shader*							m_shader = nullptr;
+	Material*						m_material = nullptr;
+	TextureView*					m_texture = nullptr;
+	GPUMesh*						m_mesh = nullptr;
+	const std::vector<Vertex_PCU>*	m_vertices = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One draw: its sort key plus where its state and model matrix are in the buffer it was recorded into
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderPacket
+{
+	uint64_t			m_sortKey = 0U;
+	uint				m_stateIndex = 0U;
+	uint				m_transformIndex = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Packets written by a single recording job, with the frame's storage for the states and transforms they point at. Each
+// job owns its buffer for the frame so recording takes no locks. A state is added once and shared by every packet drawing
+// with it
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderPacketBuffer
+{
+public:
+	void				Clear();
+	uint				AddState(const RenderDrawState& state);
+	uint				AddTransform(const Matrix44& model);
+	void				AddPacket(uint64_t sortKey, uint stateIndex, uint transformIndex);
+
+public:
+	std::vector<RenderPacket>		m_packets;
+	std::vector<RenderDrawState>	m_states;
+	std::vector<Matrix44>			m_transforms;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderQueueBackend
+{
+public:
+	virtual ~RenderQueueBackend() {}
+
+	virtual void		BindShader(Shader* shader) = 0;
+	virtual void		BindMaterial(Material* material) = 0;
+	virtual void		BindTexture(TextureView* texture) = 0;
+	virtual void		DrawMesh(GPUMesh* mesh, const Matrix44& model) = 0;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model) = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class ForwardingQueueBackend : public RenderQueueBackend
+{
+public:
+	explicit ForwardingQueueBackend(RenderBackend* renderBackend);
+
+	virtual void		BindShader(Shader* shader) override;
+	virtual void		BindMaterial(Material* material) override;
+	virtual void		BindTexture(TextureView* texture) override;
+	virtual void		DrawMesh(GPUMesh* mesh, const Matrix44& model) override;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model) override;
+
+private:
+	RenderBackend*		m_renderBackend = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Draws nothing, counts the binds the queue issued and keeps the meshes in the order they were submitted. RenderQueueTests
+// checks sort order and bind elision with it
+//------------------------------------------------------------------------------------------------------------------------------
+class RecordingRenderQueueBackend : public RenderQueueBackend
+{
+public:
+	virtual void		BindShader(Shader* shader) override;
+	virtual void		BindMaterial(Material* material) override;
+	virtual void		BindTexture(TextureView* texture) override;
+	virtual void		DrawMesh(GPUMesh* mesh, const Matrix44& model) override;
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model) override;
+
+public:
+	uint					m_numShaderBinds = 0U;
+	uint					m_numMaterialBinds = 0U;
+	uint					m_numTextureBinds = 0U;
+	uint					m_numVertexArrays = 0U;
+	std::vector<GPUMesh*>	m_drawnMeshes;			//In submission order
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collects packets from any number of recording jobs, merges them, radix sorts on the key and submits them in order,
+// skipping binds that would not change the bound state
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderQueue
+{
+public:
+	void					BeginFrame(uint numBuffers);
+	RenderPacketBuffer&		GetBuffer(uint bufferIndex);
+	inline uint				GetNumBuffers() const { return (uint)m_buffers.size(); }
+
+	void					Submit(RenderQueueBackend& backend);
+
+	inline uint				GetNumPackets() const { return m_lastNumPackets; }
+	inline uint				GetNumStateChanges() const { return m_lastNumStateChanges; }
+	inline uint				GetNumElidedStateChanges() const { return m_lastNumElided; }
+
+public:
+	struct SortEntry
+	{
+		uint64_t			m_key = 0U;
+		uint				m_bufferIndex = 0U;
+		uint				m_packetIndex = 0U;
+	};
+
+	//LSD radix sort, 8 bits per pass. Passes where every key has the same byte are skipped
+	static void				RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+private:
+	std::vector<RenderPacketBuffer>		m_buffers;
+	std::vector<SortEntry>				m_entries;
+	std::vector<SortEntry>				m_scratch;
+
+	uint								m_lastNumPackets = 0U;
+	uint								m_lastNumStateChanges = 0U;
+	uint								m_lastNumElided = 0U;
+};
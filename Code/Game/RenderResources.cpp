@@ -0,0 +1,268 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RenderResources.hpp"
+//Engine Systems
+#include "Engine/Commons/ErrorWarningAssert.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Math/Vertex_Lit.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/TextureView.hpp"
+//Game Systems
+#include "Game/MeshCooker.hpp"
+//Others
+#include <algorithm>
+
+RenderResources* g_renderResources = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderResources::RenderResources(RenderContext* renderContext)
+	:	m_renderContext(renderContext)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderResources::~RenderResources()
+{
+	for (size_t meshIndex = 0; meshIndex < m_ownedMeshes.size(); meshIndex++)
+	{
+		delete m_ownedMeshes[meshIndex];
+	}
+	m_ownedMeshes.clear();
+
+	for (size_t textureIndex = 0; textureIndex < m_ownedTextures.size(); textureIndex++)
+	{
+		delete m_ownedTextures[textureIndex];
+	}
+	m_ownedTextures.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MeshHandle RenderResources::ResolveMesh(const std::string& path)
+{
+	MeshHandle handle = m_meshes.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	GPUMesh* mesh = CreateMeshFromCooked(path);
+	if (mesh == nullptr)
+	{
+		mesh = m_renderContext->CreateOrGetMeshFromFile(path);
+	}
+
+	return m_meshes.Add(path, mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// .mesh files are cooked once and mapped after that. Anything that can't be cooked is left to the render context's loader
+//------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* RenderResources::CreateMeshFromCooked(const std::string& path)
+{
+	if (path.size() < 5 || path.compare(path.size() - 5, 5, ".mesh") != 0)
+		return nullptr;
+
+	CPUMesh cpuMesh;
+	std::string error;
+	if (!CookedMesh::LoadIntoCPUMesh(MODEL_PATH, MODEL_PATH + path, cpuMesh, error))
+	{
+		DebuggerPrintf("%s, loading %s from source\n", error.c_str(), path.c_str());
+		return nullptr;
+	}
+
+	GPUMesh* mesh = new GPUMesh(m_renderContext);
+	mesh->CreateFromCPUMesh<Vertex_Lit>(&cpuMesh);
+	m_ownedMeshes.push_back(mesh);
+	return mesh;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A reserved slot that is still empty is filled rather than skipped
+//------------------------------------------------------------------------------------------------------------------------------
+MeshHandle RenderResources::CreateMesh(const std::string& path, CPUMesh& cpuMesh)
+{
+	MeshHandle handle = m_meshes.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+	{
+		if (m_meshes.Get(handle) == nullptr)
+		{
+			ReplaceMesh(handle, cpuMesh);
+		}
+		return handle;
+	}
+
+	GPUMesh* mesh = new GPUMesh(m_renderContext);
+	mesh->CreateFromCPUMesh<Vertex_Lit>(&cpuMesh);
+	m_ownedMeshes.push_back(mesh);
+	return m_meshes.Add(path, mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The view is registered with the render context as well, so CreateOrGetTextureViewFromFile and materials find it without
+// decoding the file again
+//------------------------------------------------------------------------------------------------------------------------------
+TextureHandle RenderResources::CreateTexture(const std::string& path, const Image& image)
+{
+	TextureHandle handle = m_textures.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	Texture2D* texture = new Texture2D(m_renderContext);
+	texture->LoadTextureFromImage(image);
+	TextureView* textureView = texture->CreateTextureView2D();
+	delete texture;
+
+	m_renderContext->RegisterTextureView(path, textureView);
+	return m_textures.Add(path, textureView);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MeshHandle RenderResources::ReserveMesh(const std::string& path)
+{
+	MeshHandle handle = m_meshes.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	handle = m_meshes.Add(path, nullptr);
+	m_isMeshReserved.resize(handle + 1U, false);
+	m_isMeshReserved[handle] = true;
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureHandle RenderResources::ReserveTexture(const std::string& path)
+{
+	TextureHandle handle = m_textures.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	handle = m_textures.Add(path, nullptr);
+	m_isTextureReserved.resize(handle + 1U, false);
+	m_isTextureReserved[handle] = true;
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Anything the render context made may be held by pointer elsewhere, so only what was made here can be freed
+//------------------------------------------------------------------------------------------------------------------------------
+bool RenderResources::IsMeshStreamable(MeshHandle handle) const
+{
+	if (handle >= (uint)m_meshes.m_resources.size())
+		return false;
+
+	if (handle < (uint)m_isMeshReserved.size() && m_isMeshReserved[handle])
+		return true;
+
+	GPUMesh* mesh = m_meshes.m_resources[handle];
+	return mesh != nullptr && std::find(m_ownedMeshes.begin(), m_ownedMeshes.end(), mesh) != m_ownedMeshes.end();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RenderResources::IsTextureStreamable(TextureHandle handle) const
+{
+	if (handle >= (uint)m_textures.m_resources.size())
+		return false;
+
+	if (handle < (uint)m_isTextureReserved.size() && m_isTextureReserved[handle])
+		return true;
+
+	TextureView* texture = m_textures.m_resources[handle];
+	return texture != nullptr && std::find(m_ownedTextures.begin(), m_ownedTextures.end(), texture) != m_ownedTextures.end();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResources::ReplaceMesh(MeshHandle handle, CPUMesh& cpuMesh)
+{
+	GPUMesh* mesh = new GPUMesh(m_renderContext);
+	mesh->CreateFromCPUMesh<Vertex_Lit>(&cpuMesh);
+
+	ReleaseMesh(handle);
+	m_meshes.m_resources[handle] = mesh;
+	m_ownedMeshes.push_back(mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Not registered with the render context, which would keep handing out the view after it is freed
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResources::ReplaceTexture(TextureHandle handle, const Image& image)
+{
+	Texture2D* texture = new Texture2D(m_renderContext);
+	texture->LoadTextureFromImage(image);
+	TextureView* textureView = texture->CreateTextureView2D();
+	delete texture;
+
+	ReleaseTexture(handle);
+	m_textures.m_resources[handle] = textureView;
+	m_ownedTextures.push_back(textureView);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResources::ReleaseMesh(MeshHandle handle)
+{
+	GPUMesh* mesh = m_meshes.m_resources[handle];
+	std::vector<GPUMesh*>::iterator owned = std::find(m_ownedMeshes.begin(), m_ownedMeshes.end(), mesh);
+	if (mesh != nullptr && owned != m_ownedMeshes.end())
+	{
+		m_ownedMeshes.erase(owned);
+		delete mesh;
+	}
+
+	m_meshes.m_resources[handle] = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResources::ReleaseTexture(TextureHandle handle)
+{
+	TextureView* texture = m_textures.m_resources[handle];
+	std::vector<TextureView*>::iterator owned = std::find(m_ownedTextures.begin(), m_ownedTextures.end(), texture);
+	if (texture != nullptr && owned != m_ownedTextures.end())
+	{
+		m_ownedTextures.erase(owned);
+		delete texture;
+	}
+
+	m_textures.m_resources[handle] = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MaterialHandle RenderResources::ResolveMaterial(const std::string& path)
+{
+	MaterialHandle handle = m_materials.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	return m_materials.Add(path, m_renderContext->CreateOrGetMaterialFromFile(path));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ShaderHandle RenderResources::ResolveShader(const std::string& path)
+{
+	ShaderHandle handle = m_shaders.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	return m_shaders.Add(path, m_renderContext->CreateOrGetShaderFromFile(path));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureHandle RenderResources::ResolveTexture(const std::string& path)
+{
+	TextureHandle handle = m_textures.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	return m_textures.Add(path, m_renderContext->CreateOrGetTextureViewFromFile(path));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+FontHandle RenderResources::ResolveFont(const std::string& path)
+{
+	FontHandle handle = m_fonts.Find(path);
+	if (handle != INVALID_RENDER_HANDLE)
+		return handle;
+
+	return m_fonts.Add(path, m_renderContext->CreateOrGetBitmapFontFromFile(path.c_str()));
+}
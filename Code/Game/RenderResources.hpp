@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <map>
+#include <string>
+#include <vector>
+
+class BitmapFont;
+class CPUMesh;
+class GPUMesh;
+class Image;
+class Material;
+class RenderContext;
+class Shader;
+class TextureView;
+
+//Indices into the RenderResources tables. Resolved from a path once at load, render loops only index with them
+typedef uint	MeshHandle;
+typedef uint	MaterialHandle;
+typedef uint	ShaderHandle;
+typedef uint	TextureHandle;
+typedef uint	FontHandle;
+
+constexpr uint INVALID_RENDER_HANDLE = 0xFFFFFFFFU;
+
+class RenderResources;
+extern RenderResources* g_renderResources;
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+struct RenderResourceTable
+{
+	std::vector<T*>					m_resources;
+	std::vector<std::string>		m_paths;
+	std::map<std::string, uint>		m_lookup;
+
+	inline T*	Get(uint handle) const { return handle < (uint)m_resources.size() ? m_resources[handle] : nullptr; }
+	uint		Find(const std::string& path) const;
+	uint		Add(const std::string& path, T* resource);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+uint RenderResourceTable<T>::Find(const std::string& path) const
+{
+	std::map<std::string, uint>::const_iterator itr = m_lookup.find(path);
+	return itr == m_lookup.end() ? INVALID_RENDER_HANDLE : itr->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+uint RenderResourceTable<T>::Add(const std::string& path, T* resource)
+{
+	uint handle = (uint)m_resources.size();
+	m_resources.push_back(resource);
+	m_paths.push_back(path);
+	m_lookup[path] = handle;
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Resolves asset paths through the render context once and hands back a handle. The Resolve calls do the string lookup
+// and belong in load or construction code; the Get calls are an array index and are what draw code should use.
+// Resources are still owned by the render context, this only caches the pointers. The exceptions are cooked meshes and
+// streamed textures, which are made here; their slots can be emptied and filled again by the asset residency, so a handle
+// stays valid while what it points at comes and goes
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderResources
+{
+public:
+	explicit RenderResources(RenderContext* renderContext);
+	~RenderResources();
+
+	MeshHandle				ResolveMesh(const std::string& path);
+	MaterialHandle			ResolveMaterial(const std::string& path);
+	ShaderHandle			ResolveShader(const std::string& path);
+	TextureHandle			ResolveTexture(const std::string& path);
+	FontHandle				ResolveFont(const std::string& path);
+
+	//For assets prepared elsewhere. Registered under the path so later resolves find them
+	MeshHandle				CreateMesh(const std::string& path, CPUMesh& cpuMesh);
+	TextureHandle			CreateTexture(const std::string& path, const Image& image);
+
+	//Only what is already resident, never loads
+	inline MeshHandle		FindMesh(const std::string& path) const { return m_meshes.Find(path); }
+
+	//An empty slot the asset residency streams into. Resolving the path after this gets the slot without loading anything
+	MeshHandle				ReserveMesh(const std::string& path);
+	TextureHandle			ReserveTexture(const std::string& path);
+
+	//Only for slots made here: reserved ones, cooked meshes and streamed textures
+	bool					IsMeshStreamable(MeshHandle handle) const;
+	bool					IsTextureStreamable(TextureHandle handle) const;
+	void					ReplaceMesh(MeshHandle handle, CPUMesh& cpuMesh);
+	void					ReplaceTexture(TextureHandle handle, const Image& image);
+	void					ReleaseMesh(MeshHandle handle);
+	void					ReleaseTexture(TextureHandle handle);
+
+	inline const std::string&	GetMeshPath(MeshHandle handle) const { return m_meshes.m_paths[handle]; }
+	inline const std::string&	GetTexturePath(TextureHandle handle) const { return m_textures.m_paths[handle]; }
+
+	inline GPUMesh*			GetMesh(MeshHandle handle) const { return m_meshes.Get(handle); }
+	inline Material*		GetMaterial(MaterialHandle handle) const { return m_materials.Get(handle); }
+	inline Shader*			GetShader(ShaderHandle handle) const { return m_shaders.Get(handle); }
+	inline TextureView*		GetTexture(TextureHandle handle) const { return m_textures.Get(handle); }
+	inline BitmapFont*		GetFont(FontHandle handle) const { return m_fonts.Get(handle); }
+
+private:
+	GPUMesh*				CreateMeshFromCooked(const std::string& path);
+
+private:
+	RenderContext*					m_renderContext = nullptr;
+	std::vector<GPUMesh*>			m_ownedMeshes;			//Made here rather than by the render context, so deleted here
+	std::vector<TextureView*>		m_ownedTextures;
+	std::vector<bool>				m_isMeshReserved;		//Indexed by handle, slots made by ReserveMesh
+	std::vector<bool>				m_isTextureReserved;
+
+	RenderResourceTable<GPUMesh>		m_meshes;
+	RenderResourceTable<Material>		m_materials;
+	RenderResourceTable<Shader>			m_shaders;
+	RenderResourceTable<TextureView>	m_textures;
+	RenderResourceTable<BitmapFont>		m_fonts;
+};
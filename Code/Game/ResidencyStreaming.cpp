@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/ResidencyStreaming.hpp"
+//Engine Systems
+#include "Engine/Core/Image.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/ObjectLoader.hpp"
+//Game Systems
+#include "Game/MeshCooker.hpp"
+#include "Game/RenderResources.hpp"
+#include "Game/TextureCooker.hpp"
+
+extern JobSystem* g_jobSystem;
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderResidencyBackend::~RenderResidencyBackend()
+{
+	//Workers write into the requests, so they all have to be done before anything is freed
+	g_jobSystem->WaitForCounter(&m_streamJobs);
+
+	ResidencyStreamRequest* request;
+	while (m_finishedQueue.dequeue(&request))
+	{
+		DeleteRequest(request);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+eResidencyDescribeResult RenderResidencyBackend::DescribeAsset(eResidencyAssetType type, uint resourceHandle, ResidencyAsset& outAsset)
+{
+	if (type == RESIDENCY_MESH)
+	{
+		if (!g_renderResources->IsMeshStreamable(resourceHandle))
+			return RESIDENCY_NOT_STREAMABLE;
+
+		eResidencyDescribeResult result = DescribeFromCooked(type, resourceHandle, g_renderResources->GetMeshPath(resourceHandle), outAsset);
+		outAsset.m_residentMip = g_renderResources->GetMesh(resourceHandle) != nullptr ? 0U : outAsset.m_numMips;
+		return result;
+	}
+
+	if (!g_renderResources->IsTextureStreamable(resourceHandle) || !TextureCooker::CanCook(g_renderResources->GetTexturePath(resourceHandle)))
+		return RESIDENCY_NOT_STREAMABLE;
+
+	eResidencyDescribeResult result = DescribeFromCooked(type, resourceHandle, g_renderResources->GetTexturePath(resourceHandle), outAsset);
+	outAsset.m_residentMip = g_renderResources->GetTexture(resourceHandle) != nullptr ? 0U : outAsset.m_numMips;
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only the cooked header is read here. With no blob to read, the cook goes to the job system and the asset stays untracked
+// until Update sees it finish; it is marked every frame it is drawn, so the cook is only started once and no file is
+// opened again while it runs
+//------------------------------------------------------------------------------------------------------------------------------
+eResidencyDescribeResult RenderResidencyBackend::DescribeFromCooked(eResidencyAssetType type, uint resourceHandle, const std::string& path, ResidencyAsset& outAsset)
+{
+	std::vector<eCookState>& cookStates = m_cookStates[type];
+	if (resourceHandle >= (uint)cookStates.size())
+	{
+		cookStates.resize(resourceHandle + 1U, COOK_NOT_STARTED);
+	}
+
+	eCookState& cookState = cookStates[resourceHandle];
+	if (cookState == COOK_RUNNING)
+		return RESIDENCY_DESCRIBE_LATER;
+
+	if (cookState == COOK_FAILED)
+		return RESIDENCY_NOT_STREAMABLE;
+
+	bool isRead = type == RESIDENCY_MESH ? ReadMeshHeader(path, outAsset) : ReadTextureHeader(path, outAsset);
+	if (isRead)
+		return RESIDENCY_DESCRIBED;
+
+	//Cooked and still unreadable, not worth another try
+	if (cookState == COOK_FINISHED)
+		return RESIDENCY_NOT_STREAMABLE;
+
+	ResidencyStreamRequest* request = new ResidencyStreamRequest();
+	request->m_type = type;
+	request->m_resourceHandle = resourceHandle;
+	request->m_path = path;
+
+	cookState = COOK_RUNNING;
+	g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, request]() { PrepareRequest(request); m_finishedQueue.enqueue(request); }, &m_streamJobs);
+	return RESIDENCY_DESCRIBE_LATER;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sized from the cooked header, the blob is not checked against its source here. A stale one is re-cooked when it streams in
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool RenderResidencyBackend::ReadMeshHeader(const std::string& path, ResidencyAsset& outAsset)
+{
+	CookedMesh cooked;
+	if (!cooked.Open(MeshCooker::GetCookedPath(MODEL_PATH + path)))
+		return false;
+
+	const CookedMeshHeader& header = cooked.GetHeader();
+	outAsset.m_path = path;
+	outAsset.m_numMips = 1U;
+	outAsset.m_mipBytes[0] = (uint64_t)header.m_numVertices * sizeof(CookedMeshVertex) + (uint64_t)header.m_numIndices * header.m_indexSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool RenderResidencyBackend::ReadTextureHeader(const std::string& path, ResidencyAsset& outAsset)
+{
+	CookedTexture cooked;
+	if (!cooked.Open(TextureCooker::GetCookedPath(path)))
+		return false;
+
+	const CookedTextureHeader& header = cooked.GetHeader();
+	outAsset.m_path = path;
+	outAsset.m_numMips = header.m_numMips;
+	for (uint mipIndex = 0; mipIndex < header.m_numMips; mipIndex++)
+	{
+		outAsset.m_mipBytes[mipIndex] = header.m_mips[mipIndex].m_numBytes;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResidencyBackend::BeginStreamIn(ResidencyID id, const ResidencyAsset& asset, uint mip)
+{
+	ResidencyStreamRequest* request = new ResidencyStreamRequest();
+	request->m_id = id;
+	request->m_type = asset.m_type;
+	request->m_resourceHandle = asset.m_resourceHandle;
+	request->m_path = asset.m_path;
+	request->m_mip = mip;
+
+	g_jobSystem->Run(JOB_CATEGORY_LOADING, [this, request]() { PrepareRequest(request); m_finishedQueue.enqueue(request); }, &m_streamJobs);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void RenderResidencyBackend::PrepareRequest(ResidencyStreamRequest* request)
+{
+	std::string error;
+	if (request->m_id == INVALID_RESIDENCY_ID)
+	{
+		if (request->m_type == RESIDENCY_MESH)
+		{
+			request->m_isCooked = MeshCooker::CookIfStale(MODEL_PATH, MODEL_PATH + request->m_path, error);
+		}
+		else
+		{
+			request->m_isCooked = TextureCooker::CookIfStale(request->m_path, error);
+		}
+		return;
+	}
+
+	if (request->m_type == RESIDENCY_MESH)
+	{
+		request->m_mesh = new CPUMesh();
+		if (!CookedMesh::LoadIntoCPUMesh(MODEL_PATH, MODEL_PATH + request->m_path, *request->m_mesh, error))
+		{
+			delete request->m_mesh;
+			request->m_mesh = nullptr;
+		}
+		return;
+	}
+
+	CookedTexture cooked;
+	if (TextureCooker::CookIfStale(request->m_path, error) && cooked.Open(TextureCooker::GetCookedPath(request->m_path)) && request->m_mip < cooked.GetHeader().m_numMips)
+	{
+		request->m_image = cooked.CreateImage(request->m_mip);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void RenderResidencyBackend::DeleteRequest(ResidencyStreamRequest* request)
+{
+	delete request->m_mesh;
+	delete request->m_image;
+	delete request;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only a few stream-ins start each frame, so everything that finished is made at once
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResidencyBackend::Update(ResidencyManager& manager)
+{
+	ResidencyStreamRequest* request;
+	while (m_finishedQueue.dequeue(&request))
+	{
+		if (request->m_id == INVALID_RESIDENCY_ID)
+		{
+			m_cookStates[request->m_type][request->m_resourceHandle] = request->m_isCooked ? COOK_FINISHED : COOK_FAILED;
+			DeleteRequest(request);
+			continue;
+		}
+
+		//A mesh slot filled some other way meanwhile, by the asset loader say, is kept as it is
+		bool succeeded = false;
+		if (request->m_mesh != nullptr)
+		{
+			if (g_renderResources->GetMesh(request->m_resourceHandle) == nullptr)
+			{
+				g_renderResources->ReplaceMesh(request->m_resourceHandle, *request->m_mesh);
+			}
+			succeeded = true;
+		}
+		else if (request->m_image != nullptr)
+		{
+			g_renderResources->ReplaceTexture(request->m_resourceHandle, *request->m_image);
+			succeeded = true;
+		}
+
+		if (!succeeded)
+		{
+			DebuggerPrintf("Could not stream in %s\n", request->m_path.c_str());
+		}
+
+		manager.FinishStreamIn(request->m_id, succeeded);
+		DeleteRequest(request);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderResidencyBackend::Evict(ResidencyID id, const ResidencyAsset& asset)
+{
+	UNUSED(id);
+
+	if (asset.m_type == RESIDENCY_MESH)
+	{
+		g_renderResources->ReleaseMesh(asset.m_resourceHandle);
+	}
+	else
+	{
+		g_renderResources->ReleaseTexture(asset.m_resourceHandle);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The coarser mips are a fraction of the size and already cooked, so this is read straight away. If it can't be, the finer
+// texture stays rather than leaving nothing to draw, and the manager is told so it keeps counting the finer mip
+//------------------------------------------------------------------------------------------------------------------------------
+bool RenderResidencyBackend::DropMips(ResidencyID id, const ResidencyAsset& asset, uint mip)
+{
+	UNUSED(id);
+
+	CookedTexture cooked;
+	if (!cooked.Open(TextureCooker::GetCookedPath(asset.m_path)) || mip >= cooked.GetHeader().m_numMips)
+	{
+		DebuggerPrintf("Could not drop %s to mip %u\n", asset.m_path.c_str(), mip);
+		return false;
+	}
+
+	Image* image = cooked.CreateImage(mip);
+	g_renderResources->ReplaceTexture(asset.m_resourceHandle, *image);
+	delete image;
+	return true;
+}
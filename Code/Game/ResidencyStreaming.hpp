@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Async/AsyncQueue.hpp"
+//Game Systems
+#include "Game/AssetResidency.hpp"
+#include "Game/JobSystem.hpp"
+//Others
+#include <string>
+#include <vector>
+
+class CPUMesh;
+class Image;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ResidencyStreamRequest
+{
+	ResidencyID				m_id = INVALID_RESIDENCY_ID;		//Invalid for a cook made so the asset can be described
+	eResidencyAssetType		m_type = RESIDENCY_MESH;
+	uint					m_resourceHandle = 0U;
+	std::string				m_path;
+	uint					m_mip = 0U;
+
+	CPUMesh*				m_mesh = nullptr;		//Filled in by the worker, null when it couldn't be read
+	Image*					m_image = nullptr;
+	bool					m_isCooked = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Streams the render resources' cooked meshes and textures. The blob is read on the job system and the GPU object made on
+// the main thread in Update, into the same handle slot. A texture streams in at a mip by building its view from that mip of
+// the cooked chain down, dropping mips rebuilds it from a coarser one on the spot. Only slots the render resources made
+// themselves are described, anything the render context owns may be held by pointer elsewhere and stays resident.
+// Assets are sized from their cooked header; one with no blob yet is cooked on the job system and described after that
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderResidencyBackend : public ResidencyBackend
+{
+public:
+	~RenderResidencyBackend();
+
+	virtual eResidencyDescribeResult	DescribeAsset(eResidencyAssetType type, uint resourceHandle, ResidencyAsset& outAsset) override;
+	virtual void		BeginStreamIn(ResidencyID id, const ResidencyAsset& asset, uint mip) override;
+	virtual void		Evict(ResidencyID id, const ResidencyAsset& asset) override;
+	virtual bool		DropMips(ResidencyID id, const ResidencyAsset& asset, uint mip) override;
+	virtual void		Update(ResidencyManager& manager) override;
+
+private:
+	enum eCookState : unsigned char
+	{
+		COOK_NOT_STARTED,
+		COOK_RUNNING,
+		COOK_FINISHED,
+		COOK_FAILED
+	};
+
+	eResidencyDescribeResult	DescribeFromCooked(eResidencyAssetType type, uint resourceHandle, const std::string& path, ResidencyAsset& outAsset);
+	static bool			ReadMeshHeader(const std::string& path, ResidencyAsset& outAsset);
+	static bool			ReadTextureHeader(const std::string& path, ResidencyAsset& outAsset);
+	static void			PrepareRequest(ResidencyStreamRequest* request);
+	static void			DeleteRequest(ResidencyStreamRequest* request);
+
+private:
+	std::vector<eCookState>					m_cookStates[NUM_RESIDENCY_ASSET_TYPES];		//Indexed by resource handle
+	JobCounter								m_streamJobs;
+	AsyncQueue<ResidencyStreamRequest*>		m_finishedQueue;		//Written by workers, drained by the main thread
+};
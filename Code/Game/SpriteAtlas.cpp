@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/SpriteAtlas.hpp"
+//Others
+#include <algorithm>
+#include <fstream>
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteAtlasPacker::AddImage(const std::string& sourcePath, const IntVec2& size)
+{
+	SpriteAtlasEntry entry;
+	entry.m_sourcePath = sourcePath;
+	entry.m_size = size;
+	m_entries.push_back(entry);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool SpriteAtlasPacker::AddImageFromFile(const std::string& sourcePath)
+{
+	IntVec2 size;
+	if (!ReadPNGDimensions(sourcePath, size))
+		return false;
+
+	AddImage(sourcePath, size);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Padding goes between images only, so images that exactly fill a page edge still fit. Returns false if an image is bigger
+// than a page
+//------------------------------------------------------------------------------------------------------------------------------
+bool SpriteAtlasPacker::Pack(const IntVec2& maxPageSize, int padding)
+{
+	m_pageSizes.clear();
+
+	std::vector<int> order(m_entries.size());
+	for (size_t entryIndex = 0; entryIndex < m_entries.size(); entryIndex++)
+	{
+		order[entryIndex] = (int)entryIndex;
+	}
+
+	//Tallest first, then widest, then by path so the layout does not depend on the order images were added
+	std::sort(order.begin(), order.end(), [this](int a, int b)
+	{
+		const SpriteAtlasEntry& entryA = m_entries[a];
+		const SpriteAtlasEntry& entryB = m_entries[b];
+		if (entryA.m_size.y != entryB.m_size.y)	return entryA.m_size.y > entryB.m_size.y;
+		if (entryA.m_size.x != entryB.m_size.x)	return entryA.m_size.x > entryB.m_size.x;
+		return entryA.m_sourcePath < entryB.m_sourcePath;
+	});
+
+	int page = -1;
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	int pageWidthUsed = 0;
+
+	for (size_t orderIndex = 0; orderIndex < order.size(); orderIndex++)
+	{
+		SpriteAtlasEntry& entry = m_entries[order[orderIndex]];
+		if (entry.m_size.x > maxPageSize.x || entry.m_size.y > maxPageSize.y)
+			return false;
+
+		//Next shelf if this row is full, next page if the shelf would run off the bottom
+		int x = shelfX > 0 ? shelfX + padding : 0;
+		if (page >= 0 && x + entry.m_size.x > maxPageSize.x)
+		{
+			shelfY += shelfHeight + padding;
+			shelfHeight = 0;
+			x = 0;
+		}
+
+		if (page < 0 || shelfY + entry.m_size.y > maxPageSize.y)
+		{
+			if (page >= 0)
+			{
+				m_pageSizes[page] = IntVec2(pageWidthUsed, shelfY - padding);
+			}
+
+			page++;
+			m_pageSizes.push_back(IntVec2(0, 0));
+			shelfY = 0;
+			shelfHeight = 0;
+			pageWidthUsed = 0;
+			x = 0;
+		}
+
+		entry.m_page = page;
+		entry.m_offset = IntVec2(x, shelfY);
+
+		shelfX = x + entry.m_size.x;
+		shelfHeight = std::max(shelfHeight, entry.m_size.y);
+		pageWidthUsed = std::max(pageWidthUsed, shelfX);
+	}
+
+	if (page >= 0)
+	{
+		m_pageSizes[page] = IntVec2(pageWidthUsed, shelfY + shelfHeight);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const SpriteAtlasEntry* SpriteAtlasPacker::FindEntry(const std::string& sourcePath) const
+{
+	for (size_t entryIndex = 0; entryIndex < m_entries.size(); entryIndex++)
+	{
+		if (m_entries[entryIndex].m_sourcePath == sourcePath)
+			return &m_entries[entryIndex];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Width and height sit big endian in the IHDR chunk right after the 8 byte signature
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool SpriteAtlasPacker::ReadPNGDimensions(const std::string& filePath, IntVec2& outDimensions)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	unsigned char header[24];
+	file.read((char*)header, sizeof(header));
+	if (file.gcount() != (std::streamsize)sizeof(header))
+		return false;
+
+	const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (!std::equal(signature, signature + 8, header) || !std::equal(header + 12, header + 16, "IHDR"))
+		return false;
+
+	outDimensions.x = (int)(((uint)header[16] << 24U) | ((uint)header[17] << 16U) | ((uint)header[18] << 8U) | (uint)header[19]);
+	outDimensions.y = (int)(((uint)header[20] << 24U) | ((uint)header[21] << 16U) | ((uint)header[22] << 8U) | (uint)header[23]);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Texel rows are copied in order, so a source UV and its atlas UV measure v from the same edge
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC SpriteAtlasRegion SpriteAtlas::MakeRegion(const SpriteAtlasEntry& entry, const IntVec2& pageSize)
+{
+	SpriteAtlasRegion region;
+	region.m_uvScale = Vec2((float)entry.m_size.x / (float)pageSize.x, (float)entry.m_size.y / (float)pageSize.y);
+	region.m_uvOffset = Vec2((float)entry.m_offset.x / (float)pageSize.x, (float)entry.m_offset.y / (float)pageSize.y);
+	return region;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string SpriteAtlas::GetPageName(const std::string& atlasName, int page)
+{
+	return atlasName + "." + std::to_string(page);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteAtlas::AddRegion(const SpriteAtlasRegion& region)
+{
+	m_regions.push_back(region);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const SpriteAtlasRegion* SpriteAtlas::FindRegion(const TextureView* source) const
+{
+	for (size_t regionIndex = 0; regionIndex < m_regions.size(); regionIndex++)
+	{
+		if (m_regions[regionIndex].m_source == source)
+			return &m_regions[regionIndex];
+	}
+	return nullptr;
+}
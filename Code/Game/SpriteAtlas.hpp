@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+//Others
+#include <string>
+#include <vector>
+
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Where a source image ended up in the atlas
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteAtlasEntry
+{
+	std::string		m_sourcePath;
+	IntVec2			m_size = IntVec2(0, 0);
+	int				m_page = -1;
+	IntVec2			m_offset = IntVec2(0, 0);		//Texel offset into the page, same row order as the source image
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Shelf packer over whole images. Images are sorted tallest first and laid left to right on shelves, a new page is started
+// when a shelf will not fit. Pages are trimmed to the height actually used. Nothing here touches pixels so a layout can be
+// planned from PNG headers alone
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteAtlasPacker
+{
+public:
+	void							AddImage(const std::string& sourcePath, const IntVec2& size);
+	bool							AddImageFromFile(const std::string& sourcePath);
+	bool							Pack(const IntVec2& maxPageSize, int padding);
+
+	inline int						GetNumPages() const { return (int)m_pageSizes.size(); }
+	inline const IntVec2&			GetPageSize(int page) const { return m_pageSizes[page]; }
+	inline const std::vector<SpriteAtlasEntry>&	GetEntries() const { return m_entries; }
+	const SpriteAtlasEntry*			FindEntry(const std::string& sourcePath) const;
+
+	static bool						ReadPNGDimensions(const std::string& filePath, IntVec2& outDimensions);
+
+private:
+	std::vector<SpriteAtlasEntry>	m_entries;
+	std::vector<IntVec2>			m_pageSizes;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Source UVs scale and offset into the page. Resolved to texture views once the pages are on the GPU
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteAtlasRegion
+{
+	TextureView*	m_source = nullptr;
+	TextureView*	m_page = nullptr;
+	Vec2			m_uvScale = Vec2(1.f, 1.f);
+	Vec2			m_uvOffset = Vec2(0.f, 0.f);
+
+	inline Vec2		RemapUV(const Vec2& sourceUV) const { return Vec2(m_uvOffset.x + sourceUV.x * m_uvScale.x, m_uvOffset.y + sourceUV.y * m_uvScale.y); }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteAtlas
+{
+public:
+	static SpriteAtlasRegion		MakeRegion(const SpriteAtlasEntry& entry, const IntVec2& pageSize);
+	static std::string				GetPageName(const std::string& atlasName, int page);
+
+	void							AddRegion(const SpriteAtlasRegion& region);
+	const SpriteAtlasRegion*		FindRegion(const TextureView* source) const;
+	inline int						GetNumRegions() const { return (int)m_regions.size(); }
+
+private:
+	std::vector<SpriteAtlasRegion>	m_regions;		//A handful of sheets, a linear search beats a map
+};
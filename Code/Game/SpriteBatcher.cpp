@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/SpriteBatcher.hpp"
+//Engine Systems
+#include "Engine/Math/Matrix44.hpp"
+//Others
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------------------------------------------------------
+QueueSpriteBackend::QueueSpriteBackend(RenderQueue* renderQueue, Shader* shader, RenderPassT pass)
+	:	m_renderQueue(renderQueue),
+		m_shader(shader),
+		m_pass(pass)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void QueueSpriteBackend::BeginFrame()
+{
+	m_nextBatch = 0U;
+	m_transformIndex = -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void QueueSpriteBackend::DrawBatch(const SpriteBatch& batch, const SpriteQuad* quads)
+{
+	if (m_nextBatch == (uint)m_batchVertices.size())
+	{
+		m_batchVertices.emplace_back();
+		m_batchDepths.push_back(0.f);
+	}
+
+	std::vector<Vertex_PCU>& vertices = m_batchVertices[m_nextBatch];
+	vertices.clear();
+	vertices.reserve(batch.m_numQuads * 6U);
+
+	// tl - tr
+	// |  / |
+	// bl - br
+	for (uint quadIndex = 0; quadIndex < batch.m_numQuads; quadIndex++)
+	{
+		const SpriteQuad& quad = quads[batch.m_firstQuad + quadIndex];
+
+		Vertex_PCU topLeft(quad.m_corners[0], quad.m_color, Vec2(quad.m_uvMins.x, quad.m_uvMaxs.y));
+		Vertex_PCU topRight(quad.m_corners[1], quad.m_color, quad.m_uvMaxs);
+		Vertex_PCU bottomLeft(quad.m_corners[2], quad.m_color, quad.m_uvMins);
+		Vertex_PCU bottomRight(quad.m_corners[3], quad.m_color, Vec2(quad.m_uvMaxs.x, quad.m_uvMins.y));
+
+		vertices.push_back(bottomLeft);
+		vertices.push_back(bottomRight);
+		vertices.push_back(topRight);
+
+		vertices.push_back(bottomLeft);
+		vertices.push_back(topRight);
+		vertices.push_back(topLeft);
+	}
+
+	//The batcher hands quads over back to front so the first is the furthest
+	m_batchDepths[m_nextBatch] = sqrtf(quads[batch.m_firstQuad].m_sortDepth);
+
+	RecordBatch(batch, m_nextBatch);
+	m_nextBatch++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Redraws are handed the batches of the last flush in the same order, so the next kept vertex list is this batch's
+//------------------------------------------------------------------------------------------------------------------------------
+void QueueSpriteBackend::RedrawBatch(const SpriteBatch& batch)
+{
+	if (m_nextBatch >= (uint)m_batchVertices.size())
+		return;
+
+	RecordBatch(batch, m_nextBatch);
+	m_nextBatch++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Quads are already in world space so every batch shares one identity transform
+//------------------------------------------------------------------------------------------------------------------------------
+void QueueSpriteBackend::RecordBatch(const SpriteBatch& batch, uint batchIndex)
+{
+	RenderPacketBuffer& buffer = m_renderQueue->GetBuffer(0U);
+	if (m_transformIndex < 0)
+	{
+		m_transformIndex = (int)buffer.AddTransform(Matrix44::IDENTITY);
+	}
+
+	RenderDrawState state;
+	state.m_shader = m_shader;
+	state.m_texture = batch.m_texture;
+	state.m_vertices = &m_batchVertices[batchIndex];
+
+	uint64_t sortKey = MakeRenderSortKey(m_pass, m_shader, nullptr, batch.m_texture, m_batchDepths[batchIndex]);
+	buffer.AddPacket(sortKey, buffer.AddState(state), (uint)m_transformIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingSpriteBackend::BeginFrame()
+{
+	m_numFrames++;
+	m_drawnTextures.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingSpriteBackend::DrawBatch(const SpriteBatch& batch, const SpriteQuad* quads)
+{
+	UNUSED(quads);
+
+	m_numDrawCalls++;
+	m_numUploads++;
+	m_numQuads += batch.m_numQuads;
+	m_drawnTextures.push_back(batch.m_texture);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingSpriteBackend::RedrawBatch(const SpriteBatch& batch)
+{
+	m_numDrawCalls++;
+	m_numQuads += batch.m_numQuads;
+	m_drawnTextures.push_back(batch.m_texture);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatcher::BeginFrame()
+{
+	m_quads.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatcher::AddQuad(const SpriteQuad& quad)
+{
+	m_quads.push_back(quad);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sorts the quads back to front and splits them wherever the texture changes. Equal depths keep the order the quads were
+// added in, so a status bar's fill still lands on top of its backing
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatcher::Flush(SpriteBatchBackend& backend)
+{
+	m_batches.clear();
+	m_lastNumQuads = (uint)m_quads.size();
+
+	m_sortKeys.resize(m_quads.size());
+	for (uint quadIndex = 0; quadIndex < (uint)m_quads.size(); quadIndex++)
+	{
+		m_sortKeys[quadIndex].m_depth = m_quads[quadIndex].m_sortDepth;
+		m_sortKeys[quadIndex].m_quadIndex = quadIndex;
+	}
+
+	std::sort(m_sortKeys.begin(), m_sortKeys.end(), [](const SortKey& a, const SortKey& b)
+	{
+		if (a.m_depth != b.m_depth)
+			return a.m_depth > b.m_depth;
+
+		return a.m_quadIndex < b.m_quadIndex;
+	});
+
+	m_sortedQuads.resize(m_quads.size());
+	for (uint sortedIndex = 0; sortedIndex < (uint)m_sortKeys.size(); sortedIndex++)
+	{
+		const SpriteQuad& quad = m_quads[m_sortKeys[sortedIndex].m_quadIndex];
+		m_sortedQuads[sortedIndex] = quad;
+
+		if (m_batches.empty() || m_batches.back().m_texture != quad.m_texture)
+		{
+			SpriteBatch batch;
+			batch.m_texture = quad.m_texture;
+			batch.m_firstQuad = sortedIndex;
+			m_batches.push_back(batch);
+		}
+
+		m_batches.back().m_numQuads++;
+	}
+
+	m_lastNumBatches = (uint)m_batches.size();
+
+	backend.BeginFrame();
+	for (uint batchIndex = 0; batchIndex < (uint)m_batches.size(); batchIndex++)
+	{
+		backend.DrawBatch(m_batches[batchIndex], m_sortedQuads.data());
+	}
+	backend.EndFrame();
+
+	m_quads.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatcher::Redraw(SpriteBatchBackend& backend) const
+{
+	backend.BeginFrame();
+	for (uint batchIndex = 0; batchIndex < (uint)m_batches.size(); batchIndex++)
+	{
+		backend.RedrawBatch(m_batches[batchIndex]);
+	}
+	backend.EndFrame();
+}
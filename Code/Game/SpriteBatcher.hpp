@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Game Systems
+#include "Game/RenderQueue.hpp"
+//Others
+#include <deque>
+#include <vector>
+
+class Shader;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A camera facing quad already placed in the world
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteQuad
+{
+	TextureView*		m_texture = nullptr;
+	Vec3				m_corners[4];			//tl, tr, bl, br
+	Vec2				m_uvMins = Vec2::ZERO;
+	Vec2				m_uvMaxs = Vec2::ZERO;
+	Rgba				m_color;
+	float				m_sortDepth = 0.f;		//Squared distance from the eye, further quads draw first
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A contiguous run of quads in the sorted list that share a texture
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteBatch
+{
+	TextureView*		m_texture = nullptr;
+	uint				m_firstQuad = 0U;
+	uint				m_numQuads = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Where batches end up. The queue one builds each batch's vertices and records a draw of them into the render queue, the
+// recording one only counts so the batching can be checked without a device
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteBatchBackend
+{
+public:
+	virtual ~SpriteBatchBackend() {}
+
+	virtual void		BeginFrame() = 0;
+	virtual void		DrawBatch(const SpriteBatch& batch, const SpriteQuad* quads) = 0;
+	virtual void		RedrawBatch(const SpriteBatch& batch) = 0;	//Draws what the matching DrawBatch built last flush again
+	virtual void		EndFrame() = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each batch becomes one vertex array packet in the queue's first buffer, so the queue has to be started for the frame
+// before a flush. The render context streams vertex arrays through its one dynamic vertex buffer with a discarding map;
+// nothing is created per batch, and each batch's vertices are kept in a list that is reused frame to frame and has to
+// outlive the queue's submit
+//------------------------------------------------------------------------------------------------------------------------------
+class QueueSpriteBackend : public SpriteBatchBackend
+{
+public:
+	QueueSpriteBackend(RenderQueue* renderQueue, Shader* shader, RenderPassT pass);
+
+	virtual void		BeginFrame() override;
+	virtual void		DrawBatch(const SpriteBatch& batch, const SpriteQuad* quads) override;
+	virtual void		RedrawBatch(const SpriteBatch& batch) override;
+	virtual void		EndFrame() override {}
+
+private:
+	void				RecordBatch(const SpriteBatch& batch, uint batchIndex);
+
+private:
+	RenderQueue*							m_renderQueue = nullptr;
+	Shader*									m_shader = nullptr;
+	RenderPassT								m_pass = RENDER_PASS_ALPHA;
+
+	std::deque<std::vector<Vertex_PCU>>		m_batchVertices;		//By batch index in the last flush, a deque so packets can point at them
+	std::vector<float>						m_batchDepths;			//Distance from the eye to each batch's furthest quad
+	uint									m_nextBatch = 0U;
+	int										m_transformIndex = -1;	//This frame's identity transform in the queue buffer
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RecordingSpriteBackend : public SpriteBatchBackend
+{
+public:
+	virtual void		BeginFrame() override;
+	virtual void		DrawBatch(const SpriteBatch& batch, const SpriteQuad* quads) override;
+	virtual void		RedrawBatch(const SpriteBatch& batch) override;
+	virtual void		EndFrame() override {}
+
+public:
+	uint				m_numFrames = 0U;
+	uint				m_numDrawCalls = 0U;
+	uint				m_numUploads = 0U;			//Batches whose vertices were rebuilt
+	uint				m_numQuads = 0U;
+	std::vector<TextureView*>	m_drawnTextures;		//Last frame, in submission order
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collects every billboarded unit quad for the frame, sorts them back to front and hands each run of one texture to the
+// backend as a single draw. Sprites are alpha blended so the order has to hold across textures too; units draw from the
+// shared atlas page, so in practice the whole frame is one run
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteBatcher
+{
+public:
+	void				BeginFrame();
+	void				AddQuad(const SpriteQuad& quad);
+	void				Flush(SpriteBatchBackend& backend);
+	void				Redraw(SpriteBatchBackend& backend) const;	//Draws the last flushed batches again without rebuilding them
+
+	inline uint			GetNumQuads() const { return m_lastNumQuads; }
+	inline uint			GetNumBatches() const { return m_lastNumBatches; }
+
+private:
+	struct SortKey
+	{
+		float			m_depth = 0.f;
+		uint			m_quadIndex = 0U;
+	};
+
+	std::vector<SpriteQuad>		m_quads;
+	std::vector<SpriteQuad>		m_sortedQuads;
+	std::vector<SpriteBatch>	m_batches;
+	std::vector<SortKey>		m_sortKeys;
+
+	uint						m_lastNumQuads = 0U;
+	uint						m_lastNumBatches = 0U;
+};
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/SpriteFacing.hpp"
+//Others
+#include <cmath>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const float	TWO_PI = 6.28318530718f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteFacingResolver::BeginFrame(const Matrix44& cameraModel, const Matrix44& cameraView, const Vec3& cameraForward)
+{
+	m_facingX.clear();
+	m_facingY.clear();
+	m_octants.clear();
+
+	//Same rotation every sprite used to rebuild for itself
+	Matrix44 billboard = Matrix44::IDENTITY;
+	billboard.SetRotationFromMatrix(billboard, cameraModel);
+	m_setup.m_billboardRight = billboard.TransformVector3D(Vec3::RIGHT);
+	m_setup.m_billboardUp = billboard.TransformVector3D(Vec3::UP);
+
+	float yaw = atan2f(cameraForward.y, cameraForward.x);
+	m_setup.m_yawRadians = yaw < 0.f ? yaw + TWO_PI : yaw;
+
+	for (int octant = 0; octant < NUM_SPRITE_FACINGS; octant++)
+	{
+		float octantYaw = m_setup.m_yawRadians + (float)octant * (TWO_PI / (float)NUM_SPRITE_FACINGS);
+		Vec3 worldDirection = Vec3(cosf(octantYaw), sinf(octantYaw), 0.f);
+		m_setup.m_octantLocalDirections[octant] = cameraView.TransformVector3D(worldDirection);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteFacingResolver::AddFacing(const Vec3& facing)
+{
+	m_facingX.push_back(facing.x);
+	m_facingY.push_back(facing.y);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteFacingResolver::ResolveOctants()
+{
+	m_octants.resize(m_facingX.size());
+	if (m_facingX.empty())
+		return;
+
+	ComputeOctants(m_facingX.data(), m_facingY.data(), (int)m_facingX.size(), m_setup.m_yawRadians, m_octants.data());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// No branches and no early outs so the compiler can vectorize the loop, atan2f included. The relative yaw in octants lands
+// in (-12, 4] for a camera yaw in [0, 2pi), so biasing by 16.5 before truncating rounds to the nearest octant without floor
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void SpriteFacingResolver::ComputeOctants(const float* facingX, const float* facingY, int count, float cameraYawRadians, uint8_t* outOctants)
+{
+	const float octantsPerRadian = (float)NUM_SPRITE_FACINGS / TWO_PI;
+	const float yawInOctants = cameraYawRadians * octantsPerRadian;
+
+	for (int index = 0; index < count; index++)
+	{
+		float relativeOctants = atan2f(facingY[index], facingX[index]) * octantsPerRadian - yawInOctants;
+		outOctants[index] = (uint8_t)((int)(relativeOctants + 16.5f) & (NUM_SPRITE_FACINGS - 1));
+	}
+}
@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Others
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr int	NUM_SPRITE_FACINGS = 8;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Camera state every billboarded sprite needs, worked out once per frame. Octant 0 faces along the camera's forward on the
+// ground and the rest step counter clockwise. Each octant keeps the camera local direction the iso sprite lookup expects,
+// so the lookup sees the same handful of vectors all frame
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteCameraSetup
+{
+	Vec3			m_billboardRight = Vec3::RIGHT;
+	Vec3			m_billboardUp = Vec3::UP;
+	float			m_yawRadians = 0.f;			//Camera forward on the ground, wrapped to [0, 2pi)
+	Vec3			m_octantLocalDirections[NUM_SPRITE_FACINGS];
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Facings are queued in draw order, resolved to octants in one pass and then read back by queue slot
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteFacingResolver
+{
+public:
+	void						BeginFrame(const Matrix44& cameraModel, const Matrix44& cameraView, const Vec3& cameraForward);
+	void						AddFacing(const Vec3& facing);
+	void						ResolveOctants();
+
+	inline const SpriteCameraSetup&	GetCameraSetup() const { return m_setup; }
+	inline int					GetNumFacings() const { return (int)m_facingX.size(); }
+	inline int					GetOctant(int slot) const { return (int)m_octants[slot]; }
+	inline const Vec3&			GetLocalDirection(int slot) const { return m_setup.m_octantLocalDirections[m_octants[slot]]; }
+
+	static void					ComputeOctants(const float* facingX, const float* facingY, int count, float cameraYawRadians, uint8_t* outOctants);
+
+private:
+	SpriteCameraSetup			m_setup;
+
+	//Kept apart rather than as Vec3s so the octant pass runs straight down contiguous floats
+	std::vector<float>			m_facingX;
+	std::vector<float>			m_facingY;
+	std::vector<uint8_t>		m_octants;
+};
@@ -0,0 +1,459 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/StartupProfiler.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+//Others
+#include <algorithm>
+#include <fstream>
+
+StartupProfiler* g_startupProfiler = nullptr;
+
+static thread_local uint64_t s_threadBytesRead = 0U;
+
+//Columns of the benchmark log, in order
+static const char* BENCHMARK_PHASES[] =
+{
+	"CreateWindowAndRenderContext",
+	"App::StartUp",
+	"LoadGameBlackBoard",
+	"GetandSetShaders",
+	"AsyncLoading",
+	"CreateMenuUIWidgets",
+	"Map::Load",
+	"AIController::Startup"
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string EscapeJson(const std::string& text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (size_t charIndex = 0; charIndex < text.size(); charIndex++)
+	{
+		char character = text[charIndex];
+		if (character == '"' || character == '\\')
+		{
+			escaped.push_back('\\');
+		}
+		escaped.push_back(character);
+	}
+	return escaped;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static long long ToMicroseconds(double seconds)
+{
+	return (long long)(seconds * 1000000.0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+StartupProfiler::StartupProfiler(bool isBenchmarking)
+	: m_isBenchmarking(isBenchmarking)
+{
+	m_startTime = GetCurrentTimeSeconds();
+	m_threads.push_back(std::this_thread::get_id());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool StartupProfiler::Command_StartupTrace(EventArgs& args)
+{
+	std::string filePath = args.GetValue("file", "Data/Logs/StartupTrace.json");
+
+	g_startupProfiler->PrintSummary();
+	if (!g_startupProfiler->WriteChromeTrace(filePath))
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("Could not write startup trace %s", filePath.c_str()));
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Wrote startup trace %s", filePath.c_str()));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+double StartupProfiler::ToProfilerTime(double time) const
+{
+	return time - m_startTime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Threads are numbered in the order they first record something. Caller holds the lock
+//------------------------------------------------------------------------------------------------------------------------------
+uint StartupProfiler::GetThreadIndex()
+{
+	std::thread::id threadId = std::this_thread::get_id();
+	for (size_t threadIndex = 0; threadIndex < m_threads.size(); threadIndex++)
+	{
+		if (m_threads[threadIndex] == threadId)
+			return (uint)threadIndex;
+	}
+
+	m_threads.push_back(threadId);
+	return (uint)m_threads.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint StartupProfiler::BeginPhase(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (!m_isRecording)
+		return INVALID_STARTUP_PHASE;
+
+	StartupEvent phase;
+	phase.m_type = STARTUP_EVENT_PHASE;
+	phase.m_name = name;
+	phase.m_category = "phase";
+	phase.m_threadIndex = GetThreadIndex();
+	phase.m_startSeconds = ToProfilerTime(GetCurrentTimeSeconds());
+	m_events.push_back(phase);
+	return (uint)m_events.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::EndPhase(uint phase)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (phase >= m_events.size())
+		return;
+
+	m_events[phase].m_endSeconds = ToProfilerTime(GetCurrentTimeSeconds());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::RecordAssetPrepare(const std::string& name, const std::string& category, double queuedTime, double startTime, double endTime, uint64_t bytesRead)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (!m_isRecording)
+		return;
+
+	StartupEvent asset;
+	asset.m_type = STARTUP_EVENT_ASSET_PREPARE;
+	asset.m_name = name;
+	asset.m_category = category;
+	asset.m_threadIndex = GetThreadIndex();
+	asset.m_startSeconds = ToProfilerTime(startTime);
+	asset.m_endSeconds = ToProfilerTime(endTime);
+	asset.m_queueWaitSeconds = startTime - queuedTime;
+	asset.m_bytesRead = bytesRead;
+	m_events.push_back(asset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::RecordAssetCreate(const std::string& name, const std::string& category, double startTime, double endTime)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (!m_isRecording)
+		return;
+
+	StartupEvent asset;
+	asset.m_type = STARTUP_EVENT_ASSET_CREATE;
+	asset.m_name = name;
+	asset.m_category = category;
+	asset.m_threadIndex = GetThreadIndex();
+	asset.m_startSeconds = ToProfilerTime(startTime);
+	asset.m_endSeconds = ToProfilerTime(endTime);
+	m_events.push_back(asset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::MarkMenuReady()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (m_menuReadySeconds >= 0.0)
+		return;
+
+	m_menuReadySeconds = ToProfilerTime(GetCurrentTimeSeconds());
+
+	StartupEvent marker;
+	marker.m_type = STARTUP_EVENT_MARKER;
+	marker.m_name = "MenuReady";
+	marker.m_category = "marker";
+	marker.m_threadIndex = GetThreadIndex();
+	marker.m_startSeconds = m_menuReadySeconds;
+	m_events.push_back(marker);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::MarkMapReady()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (m_mapReadySeconds >= 0.0)
+		return;
+
+	m_mapReadySeconds = ToProfilerTime(GetCurrentTimeSeconds());
+
+	StartupEvent marker;
+	marker.m_type = STARTUP_EVENT_MARKER;
+	marker.m_name = "MapReady";
+	marker.m_category = "marker";
+	marker.m_threadIndex = GetThreadIndex();
+	marker.m_startSeconds = m_mapReadySeconds;
+	m_events.push_back(marker);
+
+	m_isRecording = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sum of every closed phase with the name, a phase can run more than once (the map loads again from the editor)
+//------------------------------------------------------------------------------------------------------------------------------
+double StartupProfiler::GetPhaseSeconds(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	double seconds = 0.0;
+	for (size_t eventIndex = 0; eventIndex < m_events.size(); eventIndex++)
+	{
+		const StartupEvent& phase = m_events[eventIndex];
+		if (phase.m_type == STARTUP_EVENT_PHASE && phase.m_endSeconds >= 0.0 && phase.m_name == name)
+		{
+			seconds += phase.m_endSeconds - phase.m_startSeconds;
+		}
+	}
+	return seconds;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::GetAssetTotals(uint& outNumAssets, uint64_t& outBytesRead, double& outPrepareSeconds, double& outQueueWaitSeconds)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	outNumAssets = 0U;
+	outBytesRead = 0U;
+	outPrepareSeconds = 0.0;
+	outQueueWaitSeconds = 0.0;
+	for (size_t eventIndex = 0; eventIndex < m_events.size(); eventIndex++)
+	{
+		const StartupEvent& asset = m_events[eventIndex];
+		if (asset.m_type != STARTUP_EVENT_ASSET_PREPARE)
+			continue;
+
+		outNumAssets++;
+		outBytesRead += asset.m_bytesRead;
+		outPrepareSeconds += asset.m_endSeconds - asset.m_startSeconds;
+		outQueueWaitSeconds += asset.m_queueWaitSeconds;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Phases and asset work are complete ("X") events, the ready markers are instant ("i") events. Phases still open when this
+// is written end at the time of writing
+//------------------------------------------------------------------------------------------------------------------------------
+bool StartupProfiler::WriteChromeTrace(const std::string& filePath)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	std::ofstream file(filePath, std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	double now = ToProfilerTime(GetCurrentTimeSeconds());
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	for (size_t threadIndex = 0; threadIndex < m_threads.size(); threadIndex++)
+	{
+		std::string threadName = threadIndex == 0 ? "Main" : Stringf("Worker %u", (uint)threadIndex);
+		file << Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n", (uint)threadIndex, threadName.c_str());
+	}
+
+	for (size_t eventIndex = 0; eventIndex < m_events.size(); eventIndex++)
+	{
+		const StartupEvent& startupEvent = m_events[eventIndex];
+		std::string name = EscapeJson(startupEvent.m_name);
+		long long start = ToMicroseconds(startupEvent.m_startSeconds);
+
+		if (startupEvent.m_type == STARTUP_EVENT_MARKER)
+		{
+			file << Stringf("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%lld,\"pid\":1,\"tid\":%u}",
+				name.c_str(), startupEvent.m_category.c_str(), start, startupEvent.m_threadIndex);
+		}
+		else
+		{
+			double endSeconds = startupEvent.m_endSeconds >= 0.0 ? startupEvent.m_endSeconds : now;
+			long long duration = ToMicroseconds(endSeconds - startupEvent.m_startSeconds);
+			file << Stringf("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u",
+				name.c_str(), startupEvent.m_category.c_str(), start, duration, startupEvent.m_threadIndex);
+
+			if (startupEvent.m_type == STARTUP_EVENT_ASSET_PREPARE)
+			{
+				file << Stringf(",\"args\":{\"bytesRead\":%llu,\"queueWaitMs\":%.3f}", (unsigned long long)startupEvent.m_bytesRead, startupEvent.m_queueWaitSeconds * 1000.0);
+			}
+			file << "}";
+		}
+
+		file << (eventIndex + 1 < m_events.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+
+	return file.good();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One line per boot, the header is written when the file is new so runs from different builds can be lined up
+//------------------------------------------------------------------------------------------------------------------------------
+bool StartupProfiler::AppendBenchmarkRow(const std::string& filePath, const char* bootKind)
+{
+	uint numPhases = (uint)(sizeof(BENCHMARK_PHASES) / sizeof(BENCHMARK_PHASES[0]));
+
+	bool isNewFile = !std::ifstream(filePath).good();
+	std::ofstream file(filePath, std::ios::app);
+	if (!file.is_open())
+		return false;
+
+	if (isNewFile)
+	{
+		file << "boot,menuMs,mapMs,assets,bytesRead,prepareMs,queueWaitMs";
+		for (uint phaseIndex = 0; phaseIndex < numPhases; phaseIndex++)
+		{
+			file << "," << BENCHMARK_PHASES[phaseIndex] << "Ms";
+		}
+		file << "\n";
+	}
+
+	uint numAssets;
+	uint64_t bytesRead;
+	double prepareSeconds;
+	double queueWaitSeconds;
+	GetAssetTotals(numAssets, bytesRead, prepareSeconds, queueWaitSeconds);
+
+	file << Stringf("%s,%.2f,%.2f,%u,%llu,%.2f,%.2f", bootKind, m_menuReadySeconds * 1000.0, m_mapReadySeconds * 1000.0,
+		numAssets, (unsigned long long)bytesRead, prepareSeconds * 1000.0, queueWaitSeconds * 1000.0);
+	for (uint phaseIndex = 0; phaseIndex < numPhases; phaseIndex++)
+	{
+		file << Stringf(",%.2f", GetPhaseSeconds(BENCHMARK_PHASES[phaseIndex]) * 1000.0);
+	}
+	file << "\n";
+
+	return file.good();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StartupProfiler::PrintSummary()
+{
+	uint numPhases = (uint)(sizeof(BENCHMARK_PHASES) / sizeof(BENCHMARK_PHASES[0]));
+
+	std::vector<std::string> lines;
+	lines.push_back(Stringf("Menu ready at %.1f ms, map ready at %.1f ms", m_menuReadySeconds * 1000.0, m_mapReadySeconds * 1000.0));
+	for (uint phaseIndex = 0; phaseIndex < numPhases; phaseIndex++)
+	{
+		lines.push_back(Stringf("  %-30s %8.1f ms", BENCHMARK_PHASES[phaseIndex], GetPhaseSeconds(BENCHMARK_PHASES[phaseIndex]) * 1000.0));
+	}
+
+	uint numAssets;
+	uint64_t bytesRead;
+	double prepareSeconds;
+	double queueWaitSeconds;
+	GetAssetTotals(numAssets, bytesRead, prepareSeconds, queueWaitSeconds);
+	lines.push_back(Stringf("%u assets, %llu bytes read, %.1f ms preparing, %.1f ms queued", numAssets, (unsigned long long)bytesRead, prepareSeconds * 1000.0, queueWaitSeconds * 1000.0));
+
+	//The dev console is gone by the time a benchmark boot shuts down
+	for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
+	{
+		if (g_devConsole != nullptr)
+		{
+			g_devConsole->PrintString(Rgba::WHITE, lines[lineIndex]);
+		}
+		DebuggerPrintf("%s\n", lines[lineIndex].c_str());
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void StartupProfiler::CountBytesRead(uint64_t numBytes)
+{
+	s_threadBytesRead += numBytes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint64_t StartupProfiler::TakeBytesRead()
+{
+	uint64_t numBytes = s_threadBytesRead;
+	s_threadBytesRead = 0U;
+	return numBytes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+StartupPhaseScope::StartupPhaseScope(const char* name)
+{
+	m_phase = g_startupProfiler->BeginPhase(name);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+StartupPhaseScope::~StartupPhaseScope()
+{
+	g_startupProfiler->EndPhase(m_phase);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool BootBudgetSet::LoadFromFile(const std::string& filePath)
+{
+	m_budgets.clear();
+
+	tinyxml2::XMLDocument budgetDoc;
+	budgetDoc.LoadFile(filePath.c_str());
+	if (budgetDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+		return false;
+
+	XMLElement* rootElement = budgetDoc.RootElement();
+	for (XMLElement* element = rootElement->FirstChildElement("budget"); element != nullptr; element = element->NextSiblingElement("budget"))
+	{
+		BootBudget budget;
+		budget.m_boot = ParseXmlAttribute(*element, "boot", "");
+		budget.m_maxMenuMilliseconds = (double)ParseXmlAttribute(*element, "menuMs", 0.f);
+		budget.m_maxMapMilliseconds = (double)ParseXmlAttribute(*element, "mapMs", 0.f);
+
+		for (XMLElement* phaseElement = element->FirstChildElement("phase"); phaseElement != nullptr; phaseElement = phaseElement->NextSiblingElement("phase"))
+		{
+			BootPhaseBudget phase;
+			phase.m_phase = ParseXmlAttribute(*phaseElement, "name", "");
+			phase.m_maxMilliseconds = (double)ParseXmlAttribute(*phaseElement, "ms", 0.f);
+			budget.m_phases.push_back(phase);
+		}
+
+		m_budgets.push_back(budget);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const BootBudget* BootBudgetSet::FindBudget(const std::string& boot) const
+{
+	for (size_t budgetIndex = 0; budgetIndex < m_budgets.size(); budgetIndex++)
+	{
+		if (m_budgets[budgetIndex].m_boot == boot)
+			return &m_budgets[budgetIndex];
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool BootBudgetSet::CheckBudget(const BootBudget& budget, StartupProfiler& profiler, std::vector<std::string>& outFailures)
+{
+	outFailures.clear();
+
+	double menuMilliseconds = profiler.GetMenuReadySeconds() * 1000.0;
+	if (budget.m_maxMenuMilliseconds > 0.0 && menuMilliseconds > budget.m_maxMenuMilliseconds)
+	{
+		outFailures.push_back(Stringf("Menu ready at %.1f ms, over budget of %.1f ms", menuMilliseconds, budget.m_maxMenuMilliseconds));
+	}
+
+	double mapMilliseconds = profiler.GetMapReadySeconds() * 1000.0;
+	if (budget.m_maxMapMilliseconds > 0.0 && mapMilliseconds > budget.m_maxMapMilliseconds)
+	{
+		outFailures.push_back(Stringf("Map ready at %.1f ms, over budget of %.1f ms", mapMilliseconds, budget.m_maxMapMilliseconds));
+	}
+
+	for (size_t phaseIndex = 0; phaseIndex < budget.m_phases.size(); phaseIndex++)
+	{
+		const BootPhaseBudget& phase = budget.m_phases[phaseIndex];
+		double phaseMilliseconds = profiler.GetPhaseSeconds(phase.m_phase) * 1000.0;
+		if (phase.m_maxMilliseconds > 0.0 && phaseMilliseconds > phase.m_maxMilliseconds)
+		{
+			outFailures.push_back(Stringf("%s took %.1f ms, over budget of %.1f ms", phase.m_phase.c_str(), phaseMilliseconds, phase.m_maxMilliseconds));
+		}
+	}
+
+	return outFailures.empty();
+}
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr uint INVALID_STARTUP_PHASE = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eStartupEventType
+{
+	STARTUP_EVENT_PHASE,
+	STARTUP_EVENT_ASSET_PREPARE,
+	STARTUP_EVENT_ASSET_CREATE,
+	STARTUP_EVENT_MARKER
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Times are seconds since the profiler was created. A phase that is still open has no end yet
+//------------------------------------------------------------------------------------------------------------------------------
+struct StartupEvent
+{
+	eStartupEventType	m_type = STARTUP_EVENT_PHASE;
+	std::string			m_name;
+	std::string			m_category;
+	uint				m_threadIndex = 0U;			//0 is whichever thread created the profiler
+	double				m_startSeconds = 0.0;
+	double				m_endSeconds = -1.0;
+	double				m_queueWaitSeconds = 0.0;	//From the job being queued to a worker picking it up
+	uint64_t			m_bytesRead = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Timeline of one boot, from before the window exists until the first map is playable. Phases are recorded on the main
+// thread, asset events from any thread. Recording stops once the map is ready so a long session doesn't keep growing it.
+// Written out as a Chrome trace (chrome://tracing or ui.perfetto.dev)
+//------------------------------------------------------------------------------------------------------------------------------
+class StartupProfiler
+{
+public:
+	explicit StartupProfiler(bool isBenchmarking = false);
+
+	static bool				Command_StartupTrace(EventArgs& args);
+
+	uint					BeginPhase(const std::string& name);
+	void					EndPhase(uint phase);
+
+	void					RecordAssetPrepare(const std::string& name, const std::string& category, double queuedTime, double startTime, double endTime, uint64_t bytesRead);
+	void					RecordAssetCreate(const std::string& name, const std::string& category, double startTime, double endTime);
+
+	void					MarkMenuReady();
+	void					MarkMapReady();
+	inline bool				IsMenuReady() const { return m_menuReadySeconds >= 0.0; }
+	inline bool				IsMapReady() const { return m_mapReadySeconds >= 0.0; }
+	inline double			GetMenuReadySeconds() const { return m_menuReadySeconds; }
+	inline double			GetMapReadySeconds() const { return m_mapReadySeconds; }
+	inline bool				IsBenchmarking() const { return m_isBenchmarking; }
+
+	double					GetPhaseSeconds(const std::string& name);
+	void					GetAssetTotals(uint& outNumAssets, uint64_t& outBytesRead, double& outPrepareSeconds, double& outQueueWaitSeconds);
+
+	bool					WriteChromeTrace(const std::string& filePath);
+	bool					AppendBenchmarkRow(const std::string& filePath, const char* bootKind);
+	void					PrintSummary();
+
+	//Bytes read by file loads on the calling thread, taken by whoever records the asset that caused them
+	static void				CountBytesRead(uint64_t numBytes);
+	static uint64_t			TakeBytesRead();
+
+private:
+	double					ToProfilerTime(double time) const;
+	uint					GetThreadIndex();
+
+private:
+	std::mutex					m_lock;
+	std::vector<StartupEvent>	m_events;
+	std::vector<std::thread::id>	m_threads;
+
+	double					m_startTime = 0.0;
+	double					m_menuReadySeconds = -1.0;
+	double					m_mapReadySeconds = -1.0;
+	bool					m_isRecording = true;
+	bool					m_isBenchmarking = false;
+};
+
+extern StartupProfiler* g_startupProfiler;
+
+//------------------------------------------------------------------------------------------------------------------------------
+class StartupPhaseScope
+{
+public:
+	explicit StartupPhaseScope(const char* name);
+	~StartupPhaseScope();
+
+private:
+	uint					m_phase = INVALID_STARTUP_PHASE;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BootPhaseBudget
+{
+	std::string				m_phase;
+	double					m_maxMilliseconds = 0.0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Limits for a cold or warm boot. A zero limit is not checked
+//------------------------------------------------------------------------------------------------------------------------------
+struct BootBudget
+{
+	std::string				m_boot;
+	double					m_maxMenuMilliseconds = 0.0;
+	double					m_maxMapMilliseconds = 0.0;
+	std::vector<BootPhaseBudget>	m_phases;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class BootBudgetSet
+{
+public:
+	bool					LoadFromFile(const std::string& filePath);
+	const BootBudget*		FindBudget(const std::string& boot) const;
+
+	static bool				CheckBudget(const BootBudget& budget, StartupProfiler& profiler, std::vector<std::string>& outFailures);
+
+private:
+	std::vector<BootBudget>	m_budgets;
+};
@@ -0,0 +1,342 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/StateHash.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+//Game Systems
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+//Others
+#include <cstdio>
+#include <cstring>
+
+static const uint	HASH_PRIME_1 = 2654435761U;
+static const uint	HASH_PRIME_2 = 2246822519U;
+static const uint	HASH_PRIME_3 = 3266489917U;
+static const uint	HASH_PRIME_4 = 668265263U;
+
+static const char	TRACE_MAGIC[4] = { 'R', 'T', 'S', 'H' };
+static const uint	TRACE_VERSION = 2U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint RotateLeft(uint value, int bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint HashPackedWords(const uint* words, uint numWords, uint seed)
+{
+	uint lanes[STATE_HASH_LANES] = { seed + HASH_PRIME_1 + HASH_PRIME_2, seed + HASH_PRIME_2, seed, seed - HASH_PRIME_1 };
+
+	uint numBlocks = numWords / STATE_HASH_LANES;
+	for (uint blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		const uint* block = &words[blockIndex * STATE_HASH_LANES];
+		for (uint laneIndex = 0; laneIndex < STATE_HASH_LANES; ++laneIndex)
+		{
+			lanes[laneIndex] = RotateLeft(lanes[laneIndex] + block[laneIndex] * HASH_PRIME_2, 13) * HASH_PRIME_1;
+		}
+	}
+
+	uint hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+	hash += numWords * 4U;
+
+	//Whatever didn't fill a block
+	for (uint wordIndex = numBlocks * STATE_HASH_LANES; wordIndex < numWords; ++wordIndex)
+	{
+		hash = RotateLeft(hash + words[wordIndex] * HASH_PRIME_3, 17) * HASH_PRIME_4;
+	}
+
+	hash ^= hash >> 15;
+	hash *= HASH_PRIME_2;
+	hash ^= hash >> 13;
+	hash *= HASH_PRIME_3;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint GetStateHashFloatWord(float value)
+{
+	uint word = 0U;
+	memcpy(&word, &value, sizeof(word));
+	return word;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint GetStateHashHandleWord(const GameHandle& handle)
+{
+	return (handle.GetCyclicID() << 16) | handle.GetIndex();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint CombineStateHashEntry(uint hash, const StateHashEntry& entry)
+{
+	uint words[2] = { GetStateHashHandleWord(entry.m_handle), entry.m_hash };
+	return HashPackedWords(words, 2U, hash);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The per entity entries are only kept when the frame goes into a trace, the hash is the same either way
+//------------------------------------------------------------------------------------------------------------------------------
+void ComputeStateHashFrame(const Game& game, const Map& map, uint tick, bool keepEntities, StateHashFrame* frame)
+{
+	frame->m_tick = tick;
+	uint entityHash = map.ComputeEntityStateHash(keepEntities ? &frame->m_entities : nullptr);
+	if (!keepEntities)
+	{
+		frame->m_entities.clear();
+	}
+
+	uint teamWords[4];
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		frame->m_teamResource[teamIndex] = game.m_teamResource[teamIndex];
+		frame->m_teamCurrentSupply[teamIndex] = game.m_teamCurrentSupply[teamIndex];
+
+		teamWords[teamIndex * 2] = (uint)game.m_teamResource[teamIndex];
+		teamWords[teamIndex * 2 + 1] = (uint)game.m_teamCurrentSupply[teamIndex];
+	}
+
+	frame->m_hash = HashPackedWords(teamWords, 4U, entityHash);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool StateHashTrace::Command_HashTrace(EventArgs& args)
+{
+	Game* game = Game::s_gameReference;
+	StateHashTrace& trace = game->m_stateHashTrace;
+
+	if (trace.IsTracing())
+	{
+		return trace.Stop();
+	}
+
+	std::string filePath = args.GetValue("file", game->m_replayFolder + "/Run.hashtrace");
+	trace.Start(filePath);
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Tracing state hashes to %s, run HashTrace again to stop", filePath.c_str()));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool StateHashTrace::Command_HashBisect(EventArgs& args)
+{
+	std::string filePathA = args.GetValue("a", "");
+	std::string filePathB = args.GetValue("b", "");
+
+	StateHashTrace traceA;
+	StateHashTrace traceB;
+	if (!traceA.Load(filePathA) || !traceB.Load(filePathB))
+	{
+		g_devConsole->PrintString(Rgba::RED, "HashBisect needs two valid traces: HashBisect a=<file> b=<file>");
+		return false;
+	}
+
+	Bisect(traceA, traceB);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StateHashTrace::Start(const std::string& filePath)
+{
+	m_filePath = filePath;
+	m_frames.clear();
+	m_isTracing = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StateHashTrace::Stop()
+{
+	m_isTracing = false;
+
+	FILE* file = fopen(m_filePath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("Could not write state hash trace %s", m_filePath.c_str()));
+		return false;
+	}
+
+	uint frameCount = (uint)m_frames.size();
+	fwrite(TRACE_MAGIC, 1, 4, file);
+	fwrite(&TRACE_VERSION, sizeof(uint), 1, file);
+	fwrite(&frameCount, sizeof(uint), 1, file);
+
+	for (const StateHashFrame& frame : m_frames)
+	{
+		uint entityCount = (uint)frame.m_entities.size();
+		fwrite(&frame.m_tick, sizeof(uint), 1, file);
+		fwrite(&frame.m_hash, sizeof(uint), 1, file);
+		fwrite(frame.m_teamResource, sizeof(int), 2, file);
+		fwrite(frame.m_teamCurrentSupply, sizeof(int), 2, file);
+		fwrite(&entityCount, sizeof(uint), 1, file);
+		fwrite(frame.m_entities.data(), sizeof(StateHashEntry), entityCount, file);
+	}
+
+	fclose(file);
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Wrote %u state hash frames to %s", frameCount, m_filePath.c_str()));
+	m_frames.clear();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StateHashTrace::AddFrame(const StateHashFrame& frame)
+{
+	if(!m_isTracing)
+		return;
+
+	m_frames.push_back(frame);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StateHashTrace::Load(const std::string& filePath)
+{
+	m_frames.clear();
+	m_filePath = filePath;
+
+	FILE* file = fopen(filePath.c_str(), "rb");
+	if(file == nullptr)
+		return false;
+
+	char magic[4];
+	uint version = 0U;
+	uint frameCount = 0U;
+	bool result = fread(magic, 1, 4, file) == 4 && memcmp(magic, TRACE_MAGIC, 4) == 0;
+	result = result && fread(&version, sizeof(uint), 1, file) == 1 && version == TRACE_VERSION;
+	result = result && fread(&frameCount, sizeof(uint), 1, file) == 1;
+
+	for (uint frameIndex = 0; result && frameIndex < frameCount; ++frameIndex)
+	{
+		StateHashFrame frame;
+		uint entityCount = 0U;
+		result = fread(&frame.m_tick, sizeof(uint), 1, file) == 1;
+		result = result && fread(&frame.m_hash, sizeof(uint), 1, file) == 1;
+		result = result && fread(frame.m_teamResource, sizeof(int), 2, file) == 2;
+		result = result && fread(frame.m_teamCurrentSupply, sizeof(int), 2, file) == 2;
+		result = result && fread(&entityCount, sizeof(uint), 1, file) == 1;
+
+		if (result)
+		{
+			frame.m_entities.resize(entityCount);
+			result = fread(frame.m_entities.data(), sizeof(StateHashEntry), entityCount, file) == entityCount;
+		}
+
+		if (result)
+		{
+			m_frames.push_back(frame);
+		}
+	}
+
+	fclose(file);
+	return result && !m_frames.empty();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The tick counter starts over on a new map or a replay restart, so a trace can hold several runs. Returns the index of the
+// first frame of the last run of consecutive ticks
+//------------------------------------------------------------------------------------------------------------------------------
+static size_t FindLastTickRun(const std::vector<StateHashFrame>& frames)
+{
+	size_t runStart = frames.size() - 1U;
+	while (runStart > 0U && frames[runStart - 1U].m_tick + 1U == frames[runStart].m_tick)
+	{
+		--runStart;
+	}
+
+	return runStart;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Both traces record every tick, so frames in the last run of each line up by tick number. Once the runs diverge they stay
+// diverged, which lets us binary search for the first bad tick and then diff the entities there
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void StateHashTrace::Bisect(const StateHashTrace& traceA, const StateHashTrace& traceB)
+{
+	size_t runStartA = FindLastTickRun(traceA.m_frames);
+	size_t runStartB = FindLastTickRun(traceB.m_frames);
+	if (runStartA > 0U || runStartB > 0U)
+	{
+		g_devConsole->PrintString(Rgba::YELLOW, Stringf("Traces restart their ticks, comparing the last run of each (%u and %u frames skipped)", (uint)runStartA, (uint)runStartB));
+	}
+
+	uint firstTickA = traceA.m_frames[runStartA].m_tick;
+	uint firstTickB = traceB.m_frames[runStartB].m_tick;
+	uint firstTick = (firstTickA > firstTickB) ? firstTickA : firstTickB;
+	uint lastTick = traceA.m_frames.back().m_tick;
+	if (traceB.m_frames.back().m_tick < lastTick)
+	{
+		lastTick = traceB.m_frames.back().m_tick;
+	}
+
+	if (firstTick > lastTick)
+	{
+		g_devConsole->PrintString(Rgba::RED, "The traces don't cover any of the same ticks");
+		return;
+	}
+
+	auto frameA = [&](uint tick) -> const StateHashFrame& { return traceA.m_frames[runStartA + (tick - firstTickA)]; };
+	auto frameB = [&](uint tick) -> const StateHashFrame& { return traceB.m_frames[runStartB + (tick - firstTickB)]; };
+
+	if (frameA(lastTick).m_hash == frameB(lastTick).m_hash)
+	{
+		g_devConsole->PrintString(Rgba::GREEN, Stringf("No divergence between ticks %u and %u", firstTick, lastTick));
+		return;
+	}
+
+	//lastTick differs, find the earliest tick that does
+	uint lowTick = firstTick;
+	uint highTick = lastTick;
+	while (lowTick < highTick)
+	{
+		uint midTick = lowTick + (highTick - lowTick) / 2U;
+		if (frameA(midTick).m_hash == frameB(midTick).m_hash)
+		{
+			lowTick = midTick + 1U;
+		}
+		else
+		{
+			highTick = midTick;
+		}
+	}
+
+	const StateHashFrame& divergedA = frameA(lowTick);
+	const StateHashFrame& divergedB = frameB(lowTick);
+	g_devConsole->PrintString(Rgba::YELLOW, Stringf("First divergence at tick %u: %08x vs %08x", lowTick, divergedA.m_hash, divergedB.m_hash));
+
+	for (int teamIndex = 0; teamIndex < 2; ++teamIndex)
+	{
+		if (divergedA.m_teamResource[teamIndex] != divergedB.m_teamResource[teamIndex] || divergedA.m_teamCurrentSupply[teamIndex] != divergedB.m_teamCurrentSupply[teamIndex])
+		{
+			g_devConsole->PrintString(Rgba::WHITE, Stringf("  Team %d resource %d vs %d, supply %d vs %d", teamIndex + 1,
+				divergedA.m_teamResource[teamIndex], divergedB.m_teamResource[teamIndex], divergedA.m_teamCurrentSupply[teamIndex], divergedB.m_teamCurrentSupply[teamIndex]));
+		}
+	}
+
+	if (divergedA.m_entities.size() != divergedB.m_entities.size())
+	{
+		g_devConsole->PrintString(Rgba::WHITE, Stringf("  Entity count %u vs %u", (uint)divergedA.m_entities.size(), (uint)divergedB.m_entities.size()));
+	}
+
+	const int maxReported = 8;
+	int numReported = 0;
+	size_t numEntities = (divergedA.m_entities.size() < divergedB.m_entities.size()) ? divergedA.m_entities.size() : divergedB.m_entities.size();
+	for (size_t entityIndex = 0; entityIndex < numEntities && numReported < maxReported; ++entityIndex)
+	{
+		const StateHashEntry& entryA = divergedA.m_entities[entityIndex];
+		const StateHashEntry& entryB = divergedB.m_entities[entityIndex];
+
+		if (entryA.m_handle != entryB.m_handle)
+		{
+			g_devConsole->PrintString(Rgba::WHITE, Stringf("  Entity %u: handle %u:%u vs %u:%u", (uint)entityIndex,
+				entryA.m_handle.GetCyclicID(), entryA.m_handle.GetIndex(), entryB.m_handle.GetCyclicID(), entryB.m_handle.GetIndex()));
+			++numReported;
+		}
+		else if (entryA.m_hash != entryB.m_hash)
+		{
+			g_devConsole->PrintString(Rgba::WHITE, Stringf("  Entity %u:%u state differs", entryA.m_handle.GetCyclicID(), entryA.m_handle.GetIndex()));
+			++numReported;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/GameHandle.hpp"
+//Others
+#include <string>
+#include <vector>
+
+class Game;
+class Map;
+
+//Words each entity packs its simulation state into before hashing, a multiple of the lane count
+constexpr uint ENTITY_HASH_WORDS = 24U;
+constexpr uint STATE_HASH_LANES = 4U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct StateHashEntry
+{
+	GameHandle			m_handle;
+	uint				m_hash = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Hash of the whole simulation after one Map::Update, with the per entity hashes it was folded from so two runs can be
+// compared entity by entity once they disagree
+//------------------------------------------------------------------------------------------------------------------------------
+struct StateHashFrame
+{
+	uint							m_tick = 0U;
+	uint							m_hash = 0U;
+	int								m_teamResource[2] = { 0, 0 };
+	int								m_teamCurrentSupply[2] = { 0, 0 };
+	std::vector<StateHashEntry>		m_entities;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Four independent multiply-rotate lanes over packed 32 bit words. The lanes have no dependency on each other so the
+// loop pipelines and vectorizes, then they are folded into a single value
+//------------------------------------------------------------------------------------------------------------------------------
+uint	HashPackedWords(const uint* words, uint numWords, uint seed = 0U);
+uint	GetStateHashFloatWord(float value);
+uint	GetStateHashHandleWord(const GameHandle& handle);
+uint	CombineStateHashEntry(uint hash, const StateHashEntry& entry);
+
+void	ComputeStateHashFrame(const Game& game, const Map& map, uint tick, bool keepEntities, StateHashFrame* frame);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every tick's frame from one run, written out so two runs (live against replay, threaded against serial, before and after
+// a change) can be bisected for the first tick and entity that differ
+//------------------------------------------------------------------------------------------------------------------------------
+class StateHashTrace
+{
+public:
+	static bool				Command_HashTrace(EventArgs& args);
+	static bool				Command_HashBisect(EventArgs& args);
+
+	void					Start(const std::string& filePath);
+	bool					Stop();
+	inline bool				IsTracing() const { return m_isTracing; }
+
+	void					AddFrame(const StateHashFrame& frame);
+	bool					Load(const std::string& filePath);
+
+	static void				Bisect(const StateHashTrace& traceA, const StateHashTrace& traceB);
+
+private:
+	std::string						m_filePath;
+	bool							m_isTracing = false;
+	std::vector<StateHashFrame>		m_frames;
+};
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/StaticModelRenderer.hpp"
+//Engine Systems
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/Material.hpp"
+//Game Systems
+#include "Game/RenderQueue.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StaticModelGroupKey::operator==(const StaticModelGroupKey& other) const
+{
+	return m_mesh == other.m_mesh && m_material == other.m_material && m_textureOverride == other.m_textureOverride;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A new resource version means a mesh or texture the groups point at may have been streamed out or replaced, so every group
+// is dropped and whatever is in view is set again this sync
+//------------------------------------------------------------------------------------------------------------------------------
+void StaticModelRenderer::BeginSync(uint resourceVersion)
+{
+	m_syncIndex++;
+	if (resourceVersion == m_resourceVersion)
+		return;
+
+	m_resourceVersion = resourceVersion;
+	m_groups.clear();
+	for (size_t recordIndex = 0; recordIndex < m_records.size(); recordIndex++)
+	{
+		m_records[recordIndex].m_groupIndex = -1;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StaticModelRenderer::IsInstanceCurrent(const GameHandle& handle, uint stateID, const Vec3& position)
+{
+	uint index = handle.GetIndex();
+	if (index >= (uint)m_records.size())
+		return false;
+
+	InstanceRecord& record = m_records[index];
+	if (record.m_groupIndex < 0 || record.m_handle != handle || record.m_stateID != stateID)
+		return false;
+
+	if (record.m_position.x != position.x || record.m_position.y != position.y || record.m_position.z != position.z)
+		return false;
+
+	record.m_lastSeenSync = m_syncIndex;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StaticModelRenderer::SetInstance(const GameHandle& handle, uint stateID, const Vec3& position, const StaticModelGroupKey& key, const Matrix44& transform)
+{
+	uint index = handle.GetIndex();
+	if (index >= (uint)m_records.size())
+	{
+		m_records.resize(index + 1);
+	}
+
+	InstanceRecord& record = m_records[index];
+	if (record.m_groupIndex >= 0)
+	{
+		RemoveInstance(record);
+	}
+
+	int groupIndex = FindOrAddGroup(key);
+	StaticModelGroup& group = m_groups[groupIndex];
+
+	record.m_handle = handle;
+	record.m_stateID = stateID;
+	record.m_position = position;
+	record.m_groupIndex = groupIndex;
+	record.m_slot = (uint)group.m_transforms.size();
+	record.m_lastSeenSync = m_syncIndex;
+
+	group.m_transforms.push_back(transform);
+	group.m_positions.push_back(position);
+	group.m_owners.push_back(index);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Anything not synced this frame was killed or cleared
+//------------------------------------------------------------------------------------------------------------------------------
+void StaticModelRenderer::EndSync()
+{
+	for (size_t recordIndex = 0; recordIndex < m_records.size(); recordIndex++)
+	{
+		InstanceRecord& record = m_records[recordIndex];
+		if (record.m_groupIndex >= 0 && record.m_lastSeenSync != m_syncIndex)
+		{
+			RemoveInstance(record);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Instances are numbered across all groups in group order, so jobs can split the whole set into even slices
+//------------------------------------------------------------------------------------------------------------------------------
+void StaticModelRenderer::RecordPackets(RenderPacketBuffer& buffer, uint firstInstance, uint numInstances, const Vec3& eyePosition) const
+{
+	uint groupStart = 0U;
+	uint endInstance = firstInstance + numInstances;
+
+	for (size_t groupIndex = 0; groupIndex < m_groups.size() && groupStart < endInstance; groupIndex++)
+	{
+		const StaticModelGroup& group = m_groups[groupIndex];
+		uint groupSize = (uint)group.m_transforms.size();
+		uint groupEnd = groupStart + groupSize;
+
+		uint sliceStart = firstInstance > groupStart ? firstInstance : groupStart;
+		uint sliceEnd = endInstance < groupEnd ? endInstance : groupEnd;
+		if (sliceStart < sliceEnd)
+		{
+			RenderDrawState state;
+			state.m_material = group.m_key.m_material;
+			state.m_texture = group.m_key.m_textureOverride;
+			state.m_mesh = group.m_key.m_mesh;
+			uint stateIndex = buffer.AddState(state);
+
+			for (uint instance = sliceStart; instance < sliceEnd; instance++)
+			{
+				uint slot = instance - groupStart;
+				Vec3 toEye = group.m_positions[slot] - eyePosition;
+
+				uint64_t sortKey = MakeRenderSortKey(RENDER_PASS_OPAQUE, nullptr, state.m_material, state.m_texture, toEye.GetLength());
+				buffer.AddPacket(sortKey, stateIndex, buffer.AddTransform(group.m_transforms[slot]));
+			}
+		}
+
+		groupStart = groupEnd;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint StaticModelRenderer::GetNumInstances() const
+{
+	uint numInstances = 0U;
+	for (size_t groupIndex = 0; groupIndex < m_groups.size(); groupIndex++)
+	{
+		numInstances += (uint)m_groups[groupIndex].m_transforms.size();
+	}
+	return numInstances;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// There are only a few mesh and material pairs in a match so a linear search is fine. Groups are never removed, an empty
+// one is kept for when the next instance of it shows up
+//------------------------------------------------------------------------------------------------------------------------------
+int StaticModelRenderer::FindOrAddGroup(const StaticModelGroupKey& key)
+{
+	for (size_t groupIndex = 0; groupIndex < m_groups.size(); groupIndex++)
+	{
+		if (m_groups[groupIndex].m_key == key)
+			return (int)groupIndex;
+	}
+
+	StaticModelGroup group;
+	group.m_key = key;
+	m_groups.push_back(group);
+	return (int)m_groups.size() - 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StaticModelRenderer::RemoveInstance(InstanceRecord& record)
+{
+	StaticModelGroup& group = m_groups[record.m_groupIndex];
+
+	//Swap the last instance into the hole and point its owner at the new slot
+	uint lastSlot = (uint)group.m_transforms.size() - 1;
+	if (record.m_slot != lastSlot)
+	{
+		group.m_transforms[record.m_slot] = group.m_transforms[lastSlot];
+		group.m_positions[record.m_slot] = group.m_positions[lastSlot];
+		group.m_owners[record.m_slot] = group.m_owners[lastSlot];
+		m_records[group.m_owners[record.m_slot]].m_slot = record.m_slot;
+	}
+
+	group.m_transforms.pop_back();
+	group.m_positions.pop_back();
+	group.m_owners.pop_back();
+
+	record.m_groupIndex = -1;
+}
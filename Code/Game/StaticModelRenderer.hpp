@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Game Systems
+#include "Game/GameHandle.hpp"
+//Others
+#include <vector>
+
+class GPUMesh;
+class Material;
+class RenderPacketBuffer;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Everything that has to be bound once for a group of identical models
+//------------------------------------------------------------------------------------------------------------------------------
+struct StaticModelGroupKey
+{
+	GPUMesh*			m_mesh = nullptr;
+	Material*			m_material = nullptr;
+	TextureView*		m_textureOverride = nullptr;	//Bound over the material's diffuse, used for team colored buildings
+
+	bool operator==(const StaticModelGroupKey& other) const;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Instances of one (mesh, material) pair. m_transforms is kept across frames, it only changes when an instance is added,
+// removed or moved to another group
+//------------------------------------------------------------------------------------------------------------------------------
+struct StaticModelGroup
+{
+	StaticModelGroupKey		m_key;
+	std::vector<Matrix44>	m_transforms;
+	std::vector<Vec3>		m_positions;					//Translation of each transform, for depth sorting
+	std::vector<uint>		m_owners;						//Handle index that owns each transform, for swap removal
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Trees, huts and town centers grouped by what they draw with. The map syncs every static entity each frame; an entity
+// whose state id and position are unchanged costs one lookup and no resource resolution.
+// RecordPackets writes a slice of all instances into a render queue buffer and is safe to run from several jobs at once as
+// long as nothing is synced meanwhile. The queue's sort puts a group's packets next to each other, so its mesh and material
+// are bound once and each instance costs a model bind and a draw; the render context has no instanced draw to do better
+//------------------------------------------------------------------------------------------------------------------------------
+class StaticModelRenderer
+{
+public:
+	void				BeginSync(uint resourceVersion);
+	bool				IsInstanceCurrent(const GameHandle& handle, uint stateID, const Vec3& position);
+	void				SetInstance(const GameHandle& handle, uint stateID, const Vec3& position, const StaticModelGroupKey& key, const Matrix44& transform);
+	void				EndSync();
+
+	void				RecordPackets(RenderPacketBuffer& buffer, uint firstInstance, uint numInstances, const Vec3& eyePosition) const;
+
+	inline uint			GetNumGroups() const { return (uint)m_groups.size(); }
+	uint				GetNumInstances() const;
+
+private:
+	struct InstanceRecord
+	{
+		GameHandle		m_handle;
+		uint			m_stateID = 0U;
+		Vec3			m_position;
+		int				m_groupIndex = -1;
+		uint			m_slot = 0U;
+		uint			m_lastSeenSync = 0U;
+	};
+
+	int					FindOrAddGroup(const StaticModelGroupKey& key);
+	void				RemoveInstance(InstanceRecord& record);
+
+private:
+	std::vector<StaticModelGroup>	m_groups;
+	std::vector<InstanceRecord>		m_records;				//Indexed by handle index
+	uint							m_syncIndex = 0U;
+	uint							m_resourceVersion = 0U;
+};
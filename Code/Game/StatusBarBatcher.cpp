@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/StatusBarBatcher.hpp"
+//Others
+#include <cstring>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool AreVec3Equal(const Vec3& a, const Vec3& b)
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StatusBarBatcher::SetBarDimensions(float width, float height, const Vec2& pivot)
+{
+	m_width = width;
+	m_height = height;
+	m_pivot = pivot;
+	m_hasUpload = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StatusBarBatcher::BeginFrame(const Vec3& cameraRight, const Vec3& cameraUp)
+{
+	m_cameraRight = cameraRight;
+	m_cameraUp = cameraUp;
+	m_bars.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StatusBarBatcher::AddBar(const Vec3& anchor, float fillRatio, const Rgba& fillColor)
+{
+	BarKey bar;
+	bar.m_anchor = anchor;
+	bar.m_fillRatio = fillRatio;
+	bar.m_fillColor = fillColor;
+	m_bars.push_back(bar);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StatusBarBatcher::IsUnchanged() const
+{
+	if (!m_hasUpload || m_bars.size() != m_lastBars.size())
+		return false;
+
+	if (!AreVec3Equal(m_cameraRight, m_lastCameraRight) || !AreVec3Equal(m_cameraUp, m_lastCameraUp))
+		return false;
+
+	for (size_t barIndex = 0; barIndex < m_bars.size(); barIndex++)
+	{
+		const BarKey& bar = m_bars[barIndex];
+		const BarKey& lastBar = m_lastBars[barIndex];
+
+		if (!AreVec3Equal(bar.m_anchor, lastBar.m_anchor) || bar.m_fillRatio != lastBar.m_fillRatio)
+			return false;
+
+		if (memcmp(&bar.m_fillColor, &lastBar.m_fillColor, sizeof(Rgba)) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Same layout the single bar path used: the quad is width wide with the pivot scaled by its own width, so a partial fill
+// stays centered over the backing
+//------------------------------------------------------------------------------------------------------------------------------
+void StatusBarBatcher::AddBarQuad(const Vec3& anchor, float width, const Rgba& color)
+{
+	Vec2 localOffset = -1.f * (m_pivot * Vec2(width, m_height));
+	Vec3 bottomLeft = anchor + localOffset.x * m_cameraRight + localOffset.y * m_cameraUp;
+	Vec3 right = width * m_cameraRight;
+	Vec3 up = m_height * m_cameraUp;
+
+	SpriteQuad quad;
+	quad.m_corners[0] = bottomLeft + up;
+	quad.m_corners[1] = bottomLeft + up + right;
+	quad.m_corners[2] = bottomLeft;
+	quad.m_corners[3] = bottomLeft + right;
+	quad.m_color = color;
+
+	m_batcher.AddQuad(quad);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StatusBarBatcher::Flush(SpriteBatchBackend& backend)
+{
+	if (IsUnchanged())
+	{
+		m_wasRebuilt = false;
+		m_batcher.Redraw(backend);
+		return;
+	}
+
+	m_batcher.BeginFrame();
+	for (size_t barIndex = 0; barIndex < m_bars.size(); barIndex++)
+	{
+		const BarKey& bar = m_bars[barIndex];
+
+		AddBarQuad(bar.m_anchor, m_width, Rgba::BLACK);
+		AddBarQuad(bar.m_anchor, bar.m_fillRatio * m_width, bar.m_fillColor);
+	}
+	m_batcher.Flush(backend);
+
+	m_lastBars.swap(m_bars);
+	m_lastCameraRight = m_cameraRight;
+	m_lastCameraUp = m_cameraUp;
+	m_hasUpload = true;
+	m_wasRebuilt = true;
+}
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Game Systems
+#include "Game/SpriteBatcher.hpp"
+//Others
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Health and training bars for every entity in one camera facing quad stream. Each bar is a black backing quad with the
+// fill drawn over it, colors are per vertex so the whole stream is a single untextured draw.
+// When neither the bars nor the camera changed since last frame the previous vertices are drawn again without a rebuild
+//------------------------------------------------------------------------------------------------------------------------------
+class StatusBarBatcher
+{
+public:
+	void				SetBarDimensions(float width, float height, const Vec2& pivot);
+
+	void				BeginFrame(const Vec3& cameraRight, const Vec3& cameraUp);
+	void				AddBar(const Vec3& anchor, float fillRatio, const Rgba& fillColor);
+	void				Flush(SpriteBatchBackend& backend);
+
+	inline uint			GetNumBars() const { return (uint)m_lastBars.size(); }
+	inline bool			WasRebuiltLastFrame() const { return m_wasRebuilt; }
+
+private:
+	struct BarKey
+	{
+		Vec3			m_anchor;
+		float			m_fillRatio = 0.f;
+		Rgba			m_fillColor;
+	};
+
+	bool				IsUnchanged() const;
+	void				AddBarQuad(const Vec3& anchor, float width, const Rgba& color);
+
+private:
+	float				m_width = 1.f;
+	float				m_height = 0.1f;
+	Vec2				m_pivot = Vec2(0.5f, -2.f);
+
+	Vec3				m_cameraRight;
+	Vec3				m_cameraUp;
+	Vec3				m_lastCameraRight;
+	Vec3				m_lastCameraUp;
+
+	std::vector<BarKey>	m_bars;
+	std::vector<BarKey>	m_lastBars;
+
+	SpriteBatcher		m_batcher;
+	bool				m_hasUpload = false;
+	bool				m_wasRebuilt = false;
+};
@@ -0,0 +1,394 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/TerrainMesh.hpp"
+//Engine Systems
+#include "Engine/Math/Vertex_Lit.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+//Game Systems
+#include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/ViewCulling.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A point on the ring around a chunk's interior. Params run 0 to 4, one unit per side starting along the bottom, so the
+// outer and inner rings can be zipped together by walking both in param order
+//------------------------------------------------------------------------------------------------------------------------------
+struct TerrainRingPoint
+{
+	int		m_x = 0;
+	int		m_y = 0;
+	float	m_param = 0.f;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Grid lines at every step strictly inside (0, numQuads)
+//------------------------------------------------------------------------------------------------------------------------------
+static void GetInteriorLines(std::vector<int>& lines, int numQuads, int step)
+{
+	lines.clear();
+	for (int line = step; line < numQuads; line += step)
+	{
+		lines.push_back(line);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Grid lines at every step from 0 plus the far edge, so both chunks on a shared edge come up with the same list
+//------------------------------------------------------------------------------------------------------------------------------
+static void GetBorderLines(std::vector<int>& lines, int numQuads, int step)
+{
+	lines.clear();
+	for (int line = 0; line < numQuads; line += step)
+	{
+		lines.push_back(line);
+	}
+	lines.push_back(numQuads);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Walks a rectangle counter clockwise from its bottom left corner. xLines and yLines run from the rectangle's min to max
+// edge inclusive. A collapsed side only contributes its corner
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildRing(std::vector<TerrainRingPoint>& ring, const std::vector<int>& xLines, const std::vector<int>& yLines)
+{
+	ring.clear();
+
+	int minX = xLines.front();
+	int maxX = xLines.back();
+	int minY = yLines.front();
+	int maxY = yLines.back();
+	float width = (float)(maxX - minX);
+	float height = (float)(maxY - minY);
+
+	//Each side stops short of its end, which is the next side's first point. A collapsed side still gives its corner
+	size_t numX = xLines.size();
+	size_t numY = yLines.size();
+	size_t pointsPerSideX = numX > 1 ? numX - 1 : 1;
+	size_t pointsPerSideY = numY > 1 ? numY - 1 : 1;
+
+	TerrainRingPoint point;
+	for (size_t index = 0; index < pointsPerSideX; index++)
+	{
+		point.m_x = xLines[index];
+		point.m_y = minY;
+		point.m_param = width > 0.f ? (float)(point.m_x - minX) / width : 0.f;
+		ring.push_back(point);
+	}
+
+	for (size_t index = 0; index < pointsPerSideY; index++)
+	{
+		point.m_x = maxX;
+		point.m_y = yLines[index];
+		point.m_param = 1.f + (height > 0.f ? (float)(point.m_y - minY) / height : 0.f);
+		ring.push_back(point);
+	}
+
+	for (size_t index = 0; index < pointsPerSideX; index++)
+	{
+		point.m_x = xLines[numX - 1 - index];
+		point.m_y = maxY;
+		point.m_param = 2.f + (width > 0.f ? (float)(maxX - point.m_x) / width : 0.f);
+		ring.push_back(point);
+	}
+
+	for (size_t index = 0; index < pointsPerSideY; index++)
+	{
+		point.m_x = minX;
+		point.m_y = yLines[numY - 1 - index];
+		point.m_param = 3.f + (height > 0.f ? (float)(maxY - point.m_y) / height : 0.f);
+		ring.push_back(point);
+	}
+
+	//Close the loop
+	point = ring.front();
+	point.m_param = 4.f;
+	ring.push_back(point);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Maps chunk local grid points to mesh indices, adding each vertex the first time it is used
+//------------------------------------------------------------------------------------------------------------------------------
+class TerrainChunkVertices
+{
+public:
+	TerrainChunkVertices(CPUMesh& mesh, const IntVec2& gridQuads, const IntVec2& firstQuad, const IntVec2& numQuads)
+		:	m_mesh(mesh),
+			m_gridQuads(gridQuads),
+			m_firstQuad(firstQuad),
+			m_stride(numQuads.x + 1)
+	{
+		m_indices.resize((size_t)(numQuads.x + 1) * (size_t)(numQuads.y + 1), -1);
+	}
+
+	uint GetIndex(int localX, int localY)
+	{
+		int& index = m_indices[localX + localY * m_stride];
+		if (index < 0)
+		{
+			int gridX = m_firstQuad.x + localX;
+			int gridY = m_firstQuad.y + localY;
+
+			//Same UVs the single terrain mesh used, half a unit per grid line with v running down from the top
+			m_mesh.SetUV(Vec2(gridX * 0.5f, (float)(m_gridQuads.y + 1) - gridY * 0.5f));
+			m_mesh.AddVertex(TerrainMesh::GetGridPosition(gridX, gridY));
+			index = m_numVertices++;
+		}
+		return (uint)index;
+	}
+
+private:
+	CPUMesh&			m_mesh;
+	IntVec2				m_gridQuads;
+	IntVec2				m_firstQuad;
+	int					m_stride = 0;
+	int					m_numVertices = 0;
+	std::vector<int>	m_indices;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+TerrainMesh::~TerrainMesh()
+{
+	Destroy();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Chunks are built in batches so only a batch worth of CPU meshes is alive at once. Each chunk is a job, the GPU meshes
+// are created on the main thread once the batch is joined
+//------------------------------------------------------------------------------------------------------------------------------
+void TerrainMesh::Create(const IntVec2& tileDimensions)
+{
+	Destroy();
+
+	m_gridQuads = IntVec2(2 * tileDimensions.x, 2 * tileDimensions.y);
+
+	int numChunksX = m_gridQuads.x / TERRAIN_CHUNK_QUADS > 0 ? m_gridQuads.x / TERRAIN_CHUNK_QUADS : 1;
+	int numChunksY = m_gridQuads.y / TERRAIN_CHUNK_QUADS > 0 ? m_gridQuads.y / TERRAIN_CHUNK_QUADS : 1;
+
+	for (int chunkY = 0; chunkY < numChunksY; chunkY++)
+	{
+		for (int chunkX = 0; chunkX < numChunksX; chunkX++)
+		{
+			TerrainChunk chunk;
+			chunk.m_firstQuad = IntVec2(chunkX * TERRAIN_CHUNK_QUADS, chunkY * TERRAIN_CHUNK_QUADS);
+
+			//The last chunk on each axis takes the remainder rather than leaving a thin sliver
+			chunk.m_numQuads.x = chunkX == numChunksX - 1 ? m_gridQuads.x - chunk.m_firstQuad.x : TERRAIN_CHUNK_QUADS;
+			chunk.m_numQuads.y = chunkY == numChunksY - 1 ? m_gridQuads.y - chunk.m_firstQuad.y : TERRAIN_CHUNK_QUADS;
+
+			Vec3 minCorner = GetGridPosition(chunk.m_firstQuad.x, chunk.m_firstQuad.y);
+			Vec3 maxCorner = GetGridPosition(chunk.m_firstQuad.x + chunk.m_numQuads.x, chunk.m_firstQuad.y + chunk.m_numQuads.y);
+			chunk.m_bounds = AABB2(Vec2(minCorner.x, minCorner.y), Vec2(maxCorner.x, maxCorner.y));
+			chunk.m_center = Vec3((minCorner.x + maxCorner.x) * 0.5f, (minCorner.y + maxCorner.y) * 0.5f, 0.f);
+
+			//A LOD needs at least one interior line on both axes
+			int smallerSide = chunk.m_numQuads.x < chunk.m_numQuads.y ? chunk.m_numQuads.x : chunk.m_numQuads.y;
+			chunk.m_numLods = 1;
+			while (chunk.m_numLods < MAX_TERRAIN_LODS && (1 << chunk.m_numLods) < smallerSide)
+			{
+				chunk.m_numLods++;
+			}
+
+			m_chunks.push_back(chunk);
+		}
+	}
+
+	std::vector<CPUMesh*> meshes;
+	for (int firstChunk = 0; firstChunk < (int)m_chunks.size(); firstChunk += m_chunksPerBuildBatch)
+	{
+		int numChunks = (int)m_chunks.size() - firstChunk;
+		numChunks = numChunks < m_chunksPerBuildBatch ? numChunks : m_chunksPerBuildBatch;
+		CreateChunks(firstChunk, numChunks, meshes);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TerrainMesh::CreateChunks(int firstChunk, int numChunks, std::vector<CPUMesh*>& meshes)
+{
+	meshes.assign((size_t)numChunks * MAX_TERRAIN_LODS, nullptr);
+
+	JobCounter buildJobs;
+	for (int batchIndex = 0; batchIndex < numChunks; batchIndex++)
+	{
+		const TerrainChunk* chunk = &m_chunks[firstChunk + batchIndex];
+		CPUMesh** chunkMeshes = &meshes[(size_t)batchIndex * MAX_TERRAIN_LODS];
+		IntVec2 gridQuads = m_gridQuads;
+
+		g_jobSystem->Run(JOB_CATEGORY_LOADING, [chunk, chunkMeshes, gridQuads]()
+		{
+			for (int lod = 0; lod < chunk->m_numLods; lod++)
+			{
+				chunkMeshes[lod] = new CPUMesh();
+				BuildChunkLod(*chunkMeshes[lod], gridQuads, chunk->m_firstQuad, chunk->m_numQuads, 1 << lod);
+			}
+		}, &buildJobs);
+	}
+
+	g_jobSystem->WaitForCounter(&buildJobs);
+
+	for (int batchIndex = 0; batchIndex < numChunks; batchIndex++)
+	{
+		TerrainChunk& chunk = m_chunks[firstChunk + batchIndex];
+		for (int lod = 0; lod < chunk.m_numLods; lod++)
+		{
+			CPUMesh*& mesh = meshes[(size_t)batchIndex * MAX_TERRAIN_LODS + lod];
+			chunk.m_lods[lod] = new GPUMesh(g_renderContext);
+			chunk.m_lods[lod]->CreateFromCPUMesh<Vertex_Lit>(mesh, GPU_MEMORY_USAGE_STATIC);
+
+			delete mesh;
+			mesh = nullptr;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TerrainMesh::Destroy()
+{
+	for (size_t chunkIndex = 0; chunkIndex < m_chunks.size(); chunkIndex++)
+	{
+		TerrainChunk& chunk = m_chunks[chunkIndex];
+		for (int lod = 0; lod < chunk.m_numLods; lod++)
+		{
+			delete chunk.m_lods[lod];
+			chunk.m_lods[lod] = nullptr;
+		}
+	}
+	m_chunks.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One opaque packet per visible chunk at its LOD, each carrying the terrain material in its state and sort key so the queue
+// binds it once for the whole terrain
+//------------------------------------------------------------------------------------------------------------------------------
+void TerrainMesh::RecordPackets(RenderPacketBuffer& buffer, Material* material, const ViewFootprint& view, const Vec3& eyePosition)
+{
+	m_lastNumChunksDrawn = 0U;
+	for (int lod = 0; lod < MAX_TERRAIN_LODS; lod++)
+	{
+		m_lastNumChunksAtLod[lod] = 0U;
+	}
+
+	//Chunks are built in world space so they all share one identity transform
+	int transformIndex = -1;
+	for (size_t chunkIndex = 0; chunkIndex < m_chunks.size(); chunkIndex++)
+	{
+		const TerrainChunk& chunk = m_chunks[chunkIndex];
+		if (!view.OverlapsBox(chunk.m_bounds))
+			continue;
+
+		if (transformIndex < 0)
+		{
+			transformIndex = (int)buffer.AddTransform(Matrix44::IDENTITY);
+		}
+
+		int lod = SelectLod(chunk, eyePosition);
+
+		RenderDrawState state;
+		state.m_material = material;
+		state.m_mesh = chunk.m_lods[lod];
+
+		float depth = (chunk.m_center - eyePosition).GetLength();
+		buffer.AddPacket(MakeRenderSortKey(RENDER_PASS_OPAQUE, nullptr, material, nullptr, depth), buffer.AddState(state), (uint)transformIndex);
+
+		m_lastNumChunksDrawn++;
+		m_lastNumChunksAtLod[lod]++;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int TerrainMesh::SelectLod(const TerrainChunk& chunk, const Vec3& eyePosition) const
+{
+	float distance = (chunk.m_center - eyePosition).GetLength();
+
+	int lod = 0;
+	float lodDistance = m_lodBaseDistance;
+	while (lod < chunk.m_numLods - 1 && distance > lodDistance)
+	{
+		lod++;
+		lodDistance *= 2.f;
+	}
+	return lod;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The interior is a regular grid every step lines. The ring between it and the chunk edge is zipped from the interior's
+// outermost lines to the border lines, which are the same at every LOD
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void TerrainMesh::BuildChunkLod(CPUMesh& mesh, const IntVec2& gridQuads, const IntVec2& firstQuad, const IntVec2& numQuads, int step)
+{
+	mesh.Clear();
+	mesh.SetLayout<Vertex_Lit>();
+	mesh.SetColor(Rgba::WHITE);
+	mesh.SetNormal(Vec3(0.f, 0.f, -1.f));
+	mesh.SetTangent(Vec3(1.f, 0.f, 0.f));
+	mesh.SetBiTangent(Vec3(0.f, 1.f, 0.f));
+
+	TerrainChunkVertices vertices(mesh, gridQuads, firstQuad, numQuads);
+
+	std::vector<int> innerX;
+	std::vector<int> innerY;
+	GetInteriorLines(innerX, numQuads.x, step);
+	GetInteriorLines(innerY, numQuads.y, step);
+
+	for (size_t yIndex = 0; yIndex + 1 < innerY.size(); yIndex++)
+	{
+		for (size_t xIndex = 0; xIndex + 1 < innerX.size(); xIndex++)
+		{
+			uint botLeft = vertices.GetIndex(innerX[xIndex], innerY[yIndex]);
+			uint botRight = vertices.GetIndex(innerX[xIndex + 1], innerY[yIndex]);
+			uint topLeft = vertices.GetIndex(innerX[xIndex], innerY[yIndex + 1]);
+			uint topRight = vertices.GetIndex(innerX[xIndex + 1], innerY[yIndex + 1]);
+
+			mesh.AddIndexedQuad(topLeft, topRight, botLeft, botRight);
+		}
+	}
+
+	std::vector<int> borderX;
+	std::vector<int> borderY;
+	GetBorderLines(borderX, numQuads.x, TERRAIN_BORDER_STEP);
+	GetBorderLines(borderY, numQuads.y, TERRAIN_BORDER_STEP);
+
+	std::vector<TerrainRingPoint> innerRing;
+	std::vector<TerrainRingPoint> outerRing;
+	BuildRing(innerRing, innerX, innerY);
+	BuildRing(outerRing, borderX, borderY);
+
+	//Advance whichever ring's next point comes first, emitting a triangle counter clockwise each time
+	size_t innerIndex = 0;
+	size_t outerIndex = 0;
+	size_t lastInner = innerRing.size() - 1;
+	size_t lastOuter = outerRing.size() - 1;
+	while (innerIndex < lastInner || outerIndex < lastOuter)
+	{
+		bool advanceOuter = innerIndex == lastInner || (outerIndex < lastOuter && outerRing[outerIndex + 1].m_param <= innerRing[innerIndex + 1].m_param);
+
+		const TerrainRingPoint& inner = innerRing[innerIndex];
+		const TerrainRingPoint& outer = outerRing[outerIndex];
+		uint innerVertex = vertices.GetIndex(inner.m_x, inner.m_y);
+		uint outerVertex = vertices.GetIndex(outer.m_x, outer.m_y);
+
+		if (advanceOuter)
+		{
+			const TerrainRingPoint& nextOuter = outerRing[outerIndex + 1];
+			mesh.AddIndexedTriangle(outerVertex, vertices.GetIndex(nextOuter.m_x, nextOuter.m_y), innerVertex);
+			outerIndex++;
+		}
+		else
+		{
+			//A collapsed inner side repeats its corner, nothing to draw for that step
+			const TerrainRingPoint& nextInner = innerRing[innerIndex + 1];
+			if (nextInner.m_x != inner.m_x || nextInner.m_y != inner.m_y)
+			{
+				mesh.AddIndexedTriangle(outerVertex, vertices.GetIndex(nextInner.m_x, nextInner.m_y), innerVertex);
+			}
+			innerIndex++;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC Vec3 TerrainMesh::GetGridPosition(int gridX, int gridY)
+{
+	return Vec3(gridX * 0.5f - 0.5f, gridY * 0.5f - 0.5f, 0.f);
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Others
+#include <vector>
+
+class CPUMesh;
+class GPUMesh;
+class Material;
+class RenderPacketBuffer;
+class ViewFootprint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The terrain grid has 2x2 quads per tile. A chunk covers TERRAIN_CHUNK_QUADS quads a side (the last chunk on each axis
+// takes the remainder), and LOD n samples every (1 << n)th grid line inside it. Chunk borders are always sampled every
+// TERRAIN_BORDER_STEP lines whatever the LOD, so any two neighbouring LODs share the same edge verts and never crack
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr int	TERRAIN_CHUNK_QUADS = 32;
+constexpr int	MAX_TERRAIN_LODS = 4;
+constexpr int	TERRAIN_BORDER_STEP = 1 << (MAX_TERRAIN_LODS - 1);
+
+//Biggest chunk is a full one plus a remainder just short of another, its local indices have to fit in 16 bits
+constexpr int	MAX_TERRAIN_CHUNK_VERTS = (2 * TERRAIN_CHUNK_QUADS) * (2 * TERRAIN_CHUNK_QUADS);
+static_assert(MAX_TERRAIN_CHUNK_VERTS <= 0xFFFF, "Terrain chunk local indices no longer fit in 16 bits");
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct TerrainChunk
+{
+	IntVec2		m_firstQuad;		//Grid coordinates of the chunk's bottom left corner
+	IntVec2		m_numQuads;
+	AABB2		m_bounds;
+	Vec3		m_center;
+	int			m_numLods = 0;
+	GPUMesh*	m_lods[MAX_TERRAIN_LODS] = {};
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Flat terrain split into culled chunks with a mesh per LOD. Vertices are never stored, positions and UVs come straight
+// from the grid coordinates when a chunk is built
+//------------------------------------------------------------------------------------------------------------------------------
+class TerrainMesh
+{
+public:
+	~TerrainMesh();
+
+	void				Create(const IntVec2& tileDimensions);
+	void				Destroy();
+
+	void				RecordPackets(RenderPacketBuffer& buffer, Material* material, const ViewFootprint& view, const Vec3& eyePosition);
+	int					SelectLod(const TerrainChunk& chunk, const Vec3& eyePosition) const;
+
+	static void			BuildChunkLod(CPUMesh& mesh, const IntVec2& gridQuads, const IntVec2& firstQuad, const IntVec2& numQuads, int step);
+	static Vec3			GetGridPosition(int gridX, int gridY);
+
+	inline int			GetNumChunks() const { return (int)m_chunks.size(); }
+	inline uint			GetNumChunksDrawn() const { return m_lastNumChunksDrawn; }
+	inline uint			GetNumChunksDrawnAtLod(int lod) const { return m_lastNumChunksAtLod[lod]; }
+
+private:
+	void				CreateChunks(int firstChunk, int numChunks, std::vector<CPUMesh*>& meshes);
+
+public:
+	float				m_lodBaseDistance = 48.f;		//LOD n is used out to m_lodBaseDistance * 2^n
+	int					m_chunksPerBuildBatch = 64;		//CPU meshes held at once while building
+
+private:
+	IntVec2						m_gridQuads = IntVec2(0, 0);
+	std::vector<TerrainChunk>	m_chunks;
+
+	uint				m_lastNumChunksDrawn = 0U;
+	uint				m_lastNumChunksAtLod[MAX_TERRAIN_LODS] = {};
+};
@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/TextureCooker.hpp"
+//Engine Systems
+#include "Engine/Commons/ErrorWarningAssert.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Math/IntVec2.hpp"
+//Game Systems
+#include "Game/MeshCooker.hpp"
+#include "Game/SpriteAtlas.hpp"
+#include "Game/StartupProfiler.hpp"
+//Others
+#include <cstring>
+#include <fstream>
+
+static const char		COOKED_TEXTURE_MAGIC[4] = { 'R', 'T', 'S', 'T' };
+static const uint		COOKED_MIP_ALIGNMENT = 16U;
+static const uint		TEXEL_BYTES = 4U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static unsigned char ToByte(float value)
+{
+	value = value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+	return (unsigned char)(value * 255.f + 0.5f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// For the startup profiler's byte counts when the decoder reads a file itself
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t GetFileSize(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	return file.is_open() ? (uint64_t)file.tellg() : 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string TextureCooker::GetCookedPath(const std::string& sourcePath)
+{
+	return sourcePath + ".cooked";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool TextureCooker::CanCook(const std::string& sourcePath)
+{
+	return sourcePath.size() >= 4 && sourcePath.compare(sourcePath.size() - 4, 4, ".png") == 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool TextureCooker::CookIfStale(const std::string& sourcePath, std::string& outError)
+{
+	CookedTexture existing;
+	bool hasCooked = existing.Open(GetCookedPath(sourcePath));
+
+	MappedFile source;
+	if (!source.Open(sourcePath))
+	{
+		//Shipped without the source, whatever was cooked is what we have
+		outError = "Could not read texture source " + sourcePath;
+		return hasCooked;
+	}
+
+	StartupProfiler::CountBytesRead(source.GetSize());
+	uint64_t sourceHash = MeshCooker::HashBytes(source.GetData(), source.GetSize(), COOKED_HASH_BASIS ^ COOKED_TEXTURE_VERSION);
+	if (hasCooked && existing.GetHeader().m_sourceHash == sourceHash)
+		return true;
+
+	existing.Close();
+	source.Close();
+
+	if (!CanCook(sourcePath))
+	{
+		outError = "No cooker for " + sourcePath;
+		return false;
+	}
+
+	return CookFromSource(sourcePath, sourceHash, outError);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each mip halves the last, rounding down but never below 1. Odd edges clamp so the last row or column is averaged with
+// itself rather than read past the end. Returns the number of mips, inOutMips holds mip 0 on the way in
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint TextureCooker::BuildMipChain(uint width, uint height, std::vector<std::vector<unsigned char>>& inOutMips)
+{
+	inOutMips.resize(1);
+
+	while ((width > 1U || height > 1U) && inOutMips.size() < MAX_COOKED_TEXTURE_MIPS)
+	{
+		uint mipWidth = width > 1U ? width / 2U : 1U;
+		uint mipHeight = height > 1U ? height / 2U : 1U;
+
+		inOutMips.push_back(std::vector<unsigned char>(mipWidth * mipHeight * TEXEL_BYTES));
+		const std::vector<unsigned char>& parent = inOutMips[inOutMips.size() - 2];
+		std::vector<unsigned char>& mip = inOutMips.back();
+
+		for (uint y = 0; y < mipHeight; y++)
+		{
+			uint parentY0 = y * 2U < height ? y * 2U : height - 1U;
+			uint parentY1 = y * 2U + 1U < height ? y * 2U + 1U : height - 1U;
+
+			for (uint x = 0; x < mipWidth; x++)
+			{
+				uint parentX0 = x * 2U < width ? x * 2U : width - 1U;
+				uint parentX1 = x * 2U + 1U < width ? x * 2U + 1U : width - 1U;
+
+				const unsigned char* texel00 = &parent[(parentY0 * width + parentX0) * TEXEL_BYTES];
+				const unsigned char* texel10 = &parent[(parentY0 * width + parentX1) * TEXEL_BYTES];
+				const unsigned char* texel01 = &parent[(parentY1 * width + parentX0) * TEXEL_BYTES];
+				const unsigned char* texel11 = &parent[(parentY1 * width + parentX1) * TEXEL_BYTES];
+
+				unsigned char* texel = &mip[(y * mipWidth + x) * TEXEL_BYTES];
+				for (uint channel = 0; channel < TEXEL_BYTES; channel++)
+				{
+					texel[channel] = (unsigned char)((texel00[channel] + texel10[channel] + texel01[channel] + texel11[channel] + 2U) / 4U);
+				}
+			}
+		}
+
+		width = mipWidth;
+		height = mipHeight;
+	}
+
+	return (uint)inOutMips.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool TextureCooker::CookFromSource(const std::string& sourcePath, uint64_t sourceHash, std::string& outError)
+{
+	IntVec2 dimensions;
+	if (!SpriteAtlasPacker::ReadPNGDimensions(sourcePath, dimensions) || dimensions.x <= 0 || dimensions.y <= 0)
+	{
+		outError = "Could not read PNG header of " + sourcePath;
+		return false;
+	}
+
+	//The only decode this source gets until it changes
+	Image image(sourcePath.c_str());
+	StartupProfiler::CountBytesRead(GetFileSize(sourcePath));
+
+	uint width = (uint)dimensions.x;
+	uint height = (uint)dimensions.y;
+	std::vector<std::vector<unsigned char>> mips(1, std::vector<unsigned char>(width * height * TEXEL_BYTES));
+	unsigned char* texel = mips[0].data();
+	for (uint y = 0; y < height; y++)
+	{
+		for (uint x = 0; x < width; x++)
+		{
+			Rgba color = image.GetTexelColor((int)x, (int)y);
+			texel[0] = ToByte(color.r);
+			texel[1] = ToByte(color.g);
+			texel[2] = ToByte(color.b);
+			texel[3] = ToByte(color.a);
+			texel += TEXEL_BYTES;
+		}
+	}
+
+	CookedTextureHeader header;
+	memcpy(header.m_magic, COOKED_TEXTURE_MAGIC, sizeof(header.m_magic));
+	header.m_version = COOKED_TEXTURE_VERSION;
+	header.m_sourceHash = sourceHash;
+	header.m_format = COOKED_TEXTURE_RGBA8;
+	header.m_numMips = BuildMipChain(width, height, mips);
+
+	//Smallest first, so the offsets are handed out from the back of the chain
+	uint offset = (uint)sizeof(CookedTextureHeader);
+	for (uint mipIndex = header.m_numMips; mipIndex-- > 0U; )
+	{
+		CookedTextureMip& mip = header.m_mips[mipIndex];
+		mip.m_width = width;
+		mip.m_height = height;
+		for (uint level = 0; level < mipIndex; level++)
+		{
+			mip.m_width = mip.m_width > 1U ? mip.m_width / 2U : 1U;
+			mip.m_height = mip.m_height > 1U ? mip.m_height / 2U : 1U;
+		}
+
+		offset = (offset + COOKED_MIP_ALIGNMENT - 1U) & ~(COOKED_MIP_ALIGNMENT - 1U);
+		mip.m_offset = offset;
+		mip.m_numBytes = (uint)mips[mipIndex].size();
+		offset += mip.m_numBytes;
+	}
+	header.m_fileSize = offset;
+
+	std::vector<unsigned char> blob(header.m_fileSize, 0U);
+	memcpy(blob.data(), &header, sizeof(header));
+	for (uint mipIndex = 0; mipIndex < header.m_numMips; mipIndex++)
+	{
+		memcpy(blob.data() + header.m_mips[mipIndex].m_offset, mips[mipIndex].data(), mips[mipIndex].size());
+	}
+
+	std::string cookedPath = GetCookedPath(sourcePath);
+	if (!WriteFileReplacing(cookedPath, blob.data(), blob.size()))
+	{
+		outError = "Could not write cooked texture " + cookedPath;
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool CookedTexture::Open(const std::string& cookedPath)
+{
+	Close();
+
+	if (!m_file.Open(cookedPath))
+		return false;
+
+	size_t size = m_file.GetSize();
+	const CookedTextureHeader* header = (const CookedTextureHeader*)m_file.GetData();
+
+	bool isValid = size >= sizeof(CookedTextureHeader)
+		&& memcmp(header->m_magic, COOKED_TEXTURE_MAGIC, sizeof(COOKED_TEXTURE_MAGIC)) == 0
+		&& header->m_version == COOKED_TEXTURE_VERSION
+		&& header->m_format == COOKED_TEXTURE_RGBA8
+		&& header->m_fileSize == size
+		&& header->m_numMips > 0U && header->m_numMips <= MAX_COOKED_TEXTURE_MIPS;
+
+	for (uint mipIndex = 0; isValid && mipIndex < header->m_numMips; mipIndex++)
+	{
+		const CookedTextureMip& mip = header->m_mips[mipIndex];
+		isValid = mip.m_offset % COOKED_MIP_ALIGNMENT == 0U
+			&& (uint64_t)mip.m_width * mip.m_height * TEXEL_BYTES == mip.m_numBytes
+			&& (uint64_t)mip.m_offset + mip.m_numBytes <= size;
+	}
+
+	if (!isValid)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_header = header;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void CookedTexture::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const unsigned char* CookedTexture::GetMipPixels(uint mip) const
+{
+	return m_file.GetData() + m_header->m_mips[mip].m_offset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Texture2D only takes an Image, so the mapped texels are copied into one. Both are tightly packed RGBA8, so it is a single
+// memcpy and nothing is decoded or converted
+//------------------------------------------------------------------------------------------------------------------------------
+Image* CookedTexture::CreateImage(uint mip) const
+{
+	const CookedTextureMip& mipInfo = m_header->m_mips[mip];
+	Image* image = new Image(IntVec2((int)mipInfo.m_width, (int)mipInfo.m_height), Rgba(0.f, 0.f, 0.f, 0.f));
+
+	memcpy(image->GetImageBuffer(), GetMipPixels(mip), mipInfo.m_numBytes);
+	StartupProfiler::CountBytesRead(mipInfo.m_numBytes);
+	return image;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Drop in for new Image(sourcePath). Falls back to decoding the source when it can't be cooked
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC Image* CookedTexture::CreateImageFromSource(const std::string& sourcePath)
+{
+	if (!TextureCooker::CanCook(sourcePath))
+	{
+		StartupProfiler::CountBytesRead(GetFileSize(sourcePath));
+		return new Image(sourcePath.c_str());
+	}
+
+	std::string error;
+	CookedTexture cooked;
+	if (TextureCooker::CookIfStale(sourcePath, error) && cooked.Open(TextureCooker::GetCookedPath(sourcePath)))
+		return cooked.CreateImage(0U);
+
+	DebuggerPrintf("%s, decoding %s\n", error.c_str(), sourcePath.c_str());
+	StartupProfiler::CountBytesRead(GetFileSize(sourcePath));
+	return new Image(sourcePath.c_str());
+}
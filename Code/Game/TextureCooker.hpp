@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Others
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Image;
+
+//Bump whenever the cooked layout or the mip filter changes, every texture is re-cooked on the next load
+constexpr uint COOKED_TEXTURE_VERSION = 1U;
+constexpr uint MAX_COOKED_TEXTURE_MIPS = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eCookedTextureFormat
+{
+	COOKED_TEXTURE_RGBA8 = 0
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedTextureMip
+{
+	uint			m_width = 0U;
+	uint			m_height = 0U;
+	uint			m_offset = 0U;
+	uint			m_numBytes = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Header, then the mips. Mip 0 is full size, but the pixel data is stored smallest mip first so reading any prefix of the
+// file past the header gives a complete, lower resolution chain. Each mip starts 16 byte aligned
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedTextureHeader
+{
+	char				m_magic[4];
+	uint				m_version = 0U;
+	uint64_t			m_sourceHash = 0U;		//The image file bytes this was cooked from
+	uint				m_format = COOKED_TEXTURE_RGBA8;
+	uint				m_numMips = 0U;
+	uint				m_fileSize = 0U;
+	uint				m_padding = 0U;
+	CookedTextureMip	m_mips[MAX_COOKED_TEXTURE_MIPS];
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Decodes an image once and keeps its pixels and box filtered mip chain next to the source. The decoder only runs again
+// when the source's hash changes, and a cooked texture with no source left is trusted as is. Only PNG sources are cooked,
+// their size comes from the header without decoding; anything else keeps going through the decoder.
+// Loading at startup only reads mip 0. Residency streaming uploads the coarser mips: a streamed texture comes in at the
+// mip its budget allows and is swapped for a coarser one under memory pressure
+//------------------------------------------------------------------------------------------------------------------------------
+class TextureCooker
+{
+public:
+	static std::string		GetCookedPath(const std::string& sourcePath);
+	static bool				CanCook(const std::string& sourcePath);
+	static bool				CookIfStale(const std::string& sourcePath, std::string& outError);
+
+	static uint				BuildMipChain(uint width, uint height, std::vector<std::vector<unsigned char>>& inOutMips);
+
+private:
+	static bool				CookFromSource(const std::string& sourcePath, uint64_t sourceHash, std::string& outError);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A cooked texture mapped straight from disk, the pixels are read in place
+//------------------------------------------------------------------------------------------------------------------------------
+class CookedTexture
+{
+public:
+	bool						Open(const std::string& cookedPath);
+	void						Close();
+
+	Image*						CreateImage(uint mip) const;
+	static Image*				CreateImageFromSource(const std::string& sourcePath);
+
+	inline const CookedTextureHeader&	GetHeader() const { return *m_header; }
+	const unsigned char*		GetMipPixels(uint mip) const;
+
+private:
+	MappedFile					m_file;
+	const CookedTextureHeader*	m_header = nullptr;
+};
@@ -16,7 +16,9 @@ UIWidget::UIWidget(Game* game, UIWidget* parent)
 {
 	m_parent = parent;
 	m_game = game;
-	m_font = g_renderContext->CreateOrGetBitmapFontFromFile("SquirrelFixedFont");
+	m_fontHandle = g_renderResources->ResolveFont("SquirrelFixedFont");
+	m_shaderHandle = g_renderResources->ResolveShader(m_defaultShaderName);
+	m_font = g_renderResources->GetFont(m_fontHandle);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -78,8 +80,8 @@ void UIWidget::ProcessInput( InputEvent &evt )
 //------------------------------------------------------------------------------------------------------------------------------
 void UIWidget::Render()
 {
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile(m_defaultShaderName));
-	m_font = g_renderContext->CreateOrGetBitmapFontFromFile("SquirrelFixedFont");
+	g_renderContext->BindShader(g_renderResources->GetShader(m_shaderHandle));
+	m_font = g_renderResources->GetFont(m_fontHandle);
 
 	g_renderContext->BindTextureViewWithSampler(0U, nullptr);
 	g_renderContext->SetModelMatrix(Matrix44::IDENTITY);
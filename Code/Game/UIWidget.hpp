@@ -6,6 +6,7 @@
 #include "Engine/Math//AABB2.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vec4.hpp"
+#include "Game/RenderResources.hpp"
 #include <vector>
 #include <string>
 
@@ -132,6 +133,8 @@ private:
 
 	eWidgetType m_widgetType = DEFAULT_WIDGET;
 	BitmapFont* m_font = nullptr;
+	FontHandle	m_fontHandle = INVALID_RENDER_HANDLE;
+	ShaderHandle m_shaderHandle = INVALID_RENDER_HANDLE;
 }; 
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/ViewCulling.hpp"
+//Game Systems
+#include "Game/Entity.hpp"
+//Others
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float DotProduct2D(const Vec2& a, const Vec2& b)
+{
+	return a.x * b.x + a.y * b.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static int ClampCell(int cell, int numCells)
+{
+	return std::min(std::max(cell, 0), numCells - 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ViewFootprint::SetGroundCorners(const Vec2* corners, float margin)
+{
+	m_isUnbounded = false;
+	m_margin = margin;
+
+	//Signed area tells us which way the corners wind so the edge normals can be made to point out
+	float doubleArea = 0.f;
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		const Vec2& a = corners[cornerIndex];
+		const Vec2& b = corners[(cornerIndex + 1) % 4];
+		doubleArea += a.x * b.y - b.x * a.y;
+	}
+	float outwardSign = doubleArea >= 0.f ? 1.f : -1.f;
+
+	Vec2 minBounds = corners[0];
+	Vec2 maxBounds = corners[0];
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		const Vec2& a = corners[cornerIndex];
+		const Vec2& b = corners[(cornerIndex + 1) % 4];
+		m_corners[cornerIndex] = a;
+
+		//A collapsed edge gets a zero normal, which never separates anything
+		Vec2 edge = Vec2(b.x - a.x, b.y - a.y);
+		float length = sqrtf(edge.x * edge.x + edge.y * edge.y);
+		m_edgeNormals[cornerIndex] = length > 0.f ? Vec2(outwardSign * edge.y / length, -outwardSign * edge.x / length) : Vec2(0.f, 0.f);
+
+		minBounds.x = std::min(minBounds.x, a.x);
+		minBounds.y = std::min(minBounds.y, a.y);
+		maxBounds.x = std::max(maxBounds.x, a.x);
+		maxBounds.y = std::max(maxBounds.y, a.y);
+	}
+
+	m_bounds = AABB2(Vec2(minBounds.x - margin, minBounds.y - margin), Vec2(maxBounds.x + margin, maxBounds.y + margin));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ViewFootprint::SetUnbounded()
+{
+	m_isUnbounded = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Separating axis test between the box and the footprint grown by the margin. The box axes are covered by the bounds
+// check, the footprint edges by projecting the box onto each outward normal
+//------------------------------------------------------------------------------------------------------------------------------
+bool ViewFootprint::OverlapsBox(const AABB2& box) const
+{
+	if (m_isUnbounded)
+		return true;
+
+	if (box.m_minBounds.x > m_bounds.m_maxBounds.x || box.m_maxBounds.x < m_bounds.m_minBounds.x)
+		return false;
+
+	if (box.m_minBounds.y > m_bounds.m_maxBounds.y || box.m_maxBounds.y < m_bounds.m_minBounds.y)
+		return false;
+
+	for (int edgeIndex = 0; edgeIndex < 4; edgeIndex++)
+	{
+		const Vec2& normal = m_edgeNormals[edgeIndex];
+
+		//The box corner furthest against the normal
+		Vec2 nearestCorner;
+		nearestCorner.x = normal.x >= 0.f ? box.m_minBounds.x : box.m_maxBounds.x;
+		nearestCorner.y = normal.y >= 0.f ? box.m_minBounds.y : box.m_maxBounds.y;
+
+		if (DotProduct2D(normal, nearestCorner) > DotProduct2D(normal, m_corners[edgeIndex]) + m_margin)
+			return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ViewFootprint::OverlapsPoint(const Vec2& point) const
+{
+	return OverlapsBox(AABB2(point, point));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityCellGrid::Rebuild(const std::vector<Entity*>& entities, const AABB2& bounds, float cellSize)
+{
+	m_bounds = bounds;
+	m_cellSize = cellSize;
+	m_numCells.x = std::max(1, (int)ceilf((bounds.m_maxBounds.x - bounds.m_minBounds.x) / cellSize));
+	m_numCells.y = std::max(1, (int)ceilf((bounds.m_maxBounds.y - bounds.m_minBounds.y) / cellSize));
+
+	uint numCells = GetNumCells();
+	m_cellStarts.assign(numCells + 1U, 0U);
+	m_entityCells.resize(entities.size());
+
+	//Count, prefix sum, then scatter. Walking the entities in order keeps each cell's list ascending
+	uint numPlaced = 0U;
+	for (size_t entityIndex = 0; entityIndex < entities.size(); entityIndex++)
+	{
+		if (entities[entityIndex] == nullptr)
+		{
+			m_entityCells[entityIndex] = -1;
+			continue;
+		}
+
+		int cellIndex = GetCellIndex(entities[entityIndex]->GetPosition());
+		m_entityCells[entityIndex] = cellIndex;
+		m_cellStarts[cellIndex + 1]++;
+		numPlaced++;
+	}
+
+	for (uint cellIndex = 0; cellIndex < numCells; cellIndex++)
+	{
+		m_cellStarts[cellIndex + 1] += m_cellStarts[cellIndex];
+	}
+
+	m_cellEntities.resize(numPlaced);
+	std::vector<uint> writeOffsets(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	for (size_t entityIndex = 0; entityIndex < entities.size(); entityIndex++)
+	{
+		int cellIndex = m_entityCells[entityIndex];
+		if (cellIndex < 0)
+			continue;
+
+		m_cellEntities[writeOffsets[cellIndex]++] = (int)entityIndex;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only the cells under the footprint's bounds are tested. The result is sorted so entities still draw in index order
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityCellGrid::GatherVisible(const ViewFootprint& view)
+{
+	m_visibleEntities.clear();
+	m_numVisibleCells = 0U;
+
+	int minCellX = 0;
+	int minCellY = 0;
+	int maxCellX = m_numCells.x - 1;
+	int maxCellY = m_numCells.y - 1;
+
+	if (!view.IsUnbounded())
+	{
+		//Clamped both ways so a view off the edge of the map still tests the border cells
+		const AABB2& viewBounds = view.GetBounds();
+		minCellX = ClampCell((int)floorf((viewBounds.m_minBounds.x - m_bounds.m_minBounds.x) / m_cellSize), m_numCells.x);
+		minCellY = ClampCell((int)floorf((viewBounds.m_minBounds.y - m_bounds.m_minBounds.y) / m_cellSize), m_numCells.y);
+		maxCellX = ClampCell((int)floorf((viewBounds.m_maxBounds.x - m_bounds.m_minBounds.x) / m_cellSize), m_numCells.x);
+		maxCellY = ClampCell((int)floorf((viewBounds.m_maxBounds.y - m_bounds.m_minBounds.y) / m_cellSize), m_numCells.y);
+	}
+
+	for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+	{
+		for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+		{
+			if (!view.OverlapsBox(GetCellBounds(cellX, cellY)))
+				continue;
+
+			int cellIndex = cellX + cellY * m_numCells.x;
+			m_visibleEntities.insert(m_visibleEntities.end(), m_cellEntities.begin() + m_cellStarts[cellIndex], m_cellEntities.begin() + m_cellStarts[cellIndex + 1]);
+			m_numVisibleCells++;
+		}
+	}
+
+	std::sort(m_visibleEntities.begin(), m_visibleEntities.end());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Positions off the map are clamped into the border cells so nothing is ever dropped from the grid
+//------------------------------------------------------------------------------------------------------------------------------
+int EntityCellGrid::GetCellIndex(const Vec2& position) const
+{
+	int cellX = (int)floorf((position.x - m_bounds.m_minBounds.x) / m_cellSize);
+	int cellY = (int)floorf((position.y - m_bounds.m_minBounds.y) / m_cellSize);
+
+	cellX = ClampCell(cellX, m_numCells.x);
+	cellY = ClampCell(cellY, m_numCells.y);
+	return cellX + cellY * m_numCells.x;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Border cells reach out far past the map to match the clamping above. Kept finite so the separating axis products stay
+// clear of infinity times zero
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2 EntityCellGrid::GetCellBounds(int cellX, int cellY) const
+{
+	const float borderReach = 1.0e6f;
+
+	Vec2 minBounds = Vec2(m_bounds.m_minBounds.x + cellX * m_cellSize, m_bounds.m_minBounds.y + cellY * m_cellSize);
+	Vec2 maxBounds = Vec2(minBounds.x + m_cellSize, minBounds.y + m_cellSize);
+
+	if (cellX == 0)					minBounds.x = -borderReach;
+	if (cellY == 0)					minBounds.y = -borderReach;
+	if (cellX == m_numCells.x - 1)	maxBounds.x = borderReach;
+	if (cellY == m_numCells.y - 1)	maxBounds.y = borderReach;
+
+	return AABB2(minBounds, maxBounds);
+}
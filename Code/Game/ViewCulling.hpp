@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+//Others
+#include <vector>
+
+class Entity;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The part of the ground the camera frustum can see: the convex quad where the four corner rays of the view meet the
+// terrain plane. Everything the RTS camera draws stands on the terrain, so testing against this footprint (padded by how
+// far models and sprites stick up off the ground) is the same as testing against the frustum
+//------------------------------------------------------------------------------------------------------------------------------
+class ViewFootprint
+{
+public:
+	void				SetGroundCorners(const Vec2* corners, float margin);	//4 corners, in winding order
+	void				SetUnbounded();
+
+	bool				OverlapsBox(const AABB2& box) const;
+	bool				OverlapsPoint(const Vec2& point) const;
+
+	inline bool			IsUnbounded() const { return m_isUnbounded; }
+	inline const AABB2&	GetBounds() const { return m_bounds; }		//Includes the margin
+
+private:
+	Vec2				m_corners[4];
+	Vec2				m_edgeNormals[4];
+	AABB2				m_bounds;
+	float				m_margin = 0.f;
+	bool				m_isUnbounded = true;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Entity indices bucketed by a coarse grid over the map, rebuilt every frame with a counting sort so culling only visits
+// the cells the footprint touches
+//------------------------------------------------------------------------------------------------------------------------------
+class EntityCellGrid
+{
+public:
+	void				Rebuild(const std::vector<Entity*>& entities, const AABB2& bounds, float cellSize);
+	void				GatherVisible(const ViewFootprint& view);
+
+	inline const std::vector<int>&	GetVisibleEntities() const { return m_visibleEntities; }		//Ascending entity indices
+	inline uint			GetNumCells() const { return (uint)(m_numCells.x * m_numCells.y); }
+	inline uint			GetNumVisibleCells() const { return m_numVisibleCells; }
+
+private:
+	int					GetCellIndex(const Vec2& position) const;
+	AABB2				GetCellBounds(int cellX, int cellY) const;
+
+private:
+	AABB2				m_bounds;
+	float				m_cellSize = 8.f;
+	IntVec2				m_numCells = IntVec2(0, 0);
+
+	std::vector<uint>	m_cellStarts;		//Cell i owns m_cellEntities[m_cellStarts[i], m_cellStarts[i + 1])
+	std::vector<int>	m_cellEntities;
+	std::vector<int>	m_entityCells;		//Scratch, cell of each entity this rebuild
+
+	std::vector<int>	m_visibleEntities;
+	uint				m_numVisibleCells = 0U;
+};
@@ -0,0 +1,373 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Drives the residency manager with a stand-in backend that keeps no data. Stream-ins finish a few updates after they
+// start, so budgets, evictions and mip drops are checked without a device or any files
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/AssetResidency.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <algorithm>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Assets are described from the sizes handed to AddAsset. One added as pending is described later until SetDescribable
+//------------------------------------------------------------------------------------------------------------------------------
+class StandInResidencyBackend : public ResidencyBackend
+{
+public:
+	void				AddAsset(eResidencyAssetType type, uint resourceHandle, const std::string& path, const uint64_t* mipBytes, uint numMips, bool isResident, bool isPending = false);
+	void				SetDescribable(eResidencyAssetType type, uint resourceHandle);
+
+	virtual eResidencyDescribeResult	DescribeAsset(eResidencyAssetType type, uint resourceHandle, ResidencyAsset& outAsset) override;
+	virtual void		BeginStreamIn(ResidencyID id, const ResidencyAsset& asset, uint mip) override;
+	virtual void		Evict(ResidencyID id, const ResidencyAsset& asset) override;
+	virtual bool		DropMips(ResidencyID id, const ResidencyAsset& asset, uint mip) override;
+	virtual void		Update(ResidencyManager& manager) override;
+
+public:
+	uint				m_latencyFrames = 2U;
+	uint				m_numDescribes = 0U;
+	uint				m_numStreamIns = 0U;
+	uint				m_numEvictions = 0U;
+	uint				m_numMipDrops = 0U;							//Attempts, failed ones included
+	bool				m_isFailingMipDrops = false;
+
+private:
+	struct StandInAsset
+	{
+		ResidencyAsset	m_asset;
+		bool			m_isPending = false;
+	};
+
+	struct PendingStreamIn
+	{
+		ResidencyID		m_id = INVALID_RESIDENCY_ID;
+		uint			m_framesLeft = 0U;
+	};
+
+	std::vector<StandInAsset>		m_assets;
+	std::vector<PendingStreamIn>	m_pending;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StandInResidencyBackend::AddAsset(eResidencyAssetType type, uint resourceHandle, const std::string& path, const uint64_t* mipBytes, uint numMips, bool isResident, bool isPending)
+{
+	StandInAsset standIn;
+	ResidencyAsset& asset = standIn.m_asset;
+	asset.m_path = path;
+	asset.m_type = type;
+	asset.m_resourceHandle = resourceHandle;
+	asset.m_numMips = std::min(numMips, MAX_COOKED_TEXTURE_MIPS);
+	for (uint mipIndex = 0; mipIndex < asset.m_numMips; mipIndex++)
+	{
+		asset.m_mipBytes[mipIndex] = mipBytes[mipIndex];
+	}
+	asset.m_residentMip = isResident ? 0U : asset.m_numMips;
+	standIn.m_isPending = isPending;
+
+	m_assets.push_back(standIn);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StandInResidencyBackend::SetDescribable(eResidencyAssetType type, uint resourceHandle)
+{
+	for (size_t assetIndex = 0; assetIndex < m_assets.size(); assetIndex++)
+	{
+		if (m_assets[assetIndex].m_asset.m_type == type && m_assets[assetIndex].m_asset.m_resourceHandle == resourceHandle)
+		{
+			m_assets[assetIndex].m_isPending = false;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+eResidencyDescribeResult StandInResidencyBackend::DescribeAsset(eResidencyAssetType type, uint resourceHandle, ResidencyAsset& outAsset)
+{
+	m_numDescribes++;
+
+	for (size_t assetIndex = 0; assetIndex < m_assets.size(); assetIndex++)
+	{
+		const StandInAsset& standIn = m_assets[assetIndex];
+		if (standIn.m_asset.m_type != type || standIn.m_asset.m_resourceHandle != resourceHandle)
+			continue;
+
+		if (standIn.m_isPending)
+			return RESIDENCY_DESCRIBE_LATER;
+
+		outAsset = standIn.m_asset;
+		return RESIDENCY_DESCRIBED;
+	}
+	return RESIDENCY_NOT_STREAMABLE;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StandInResidencyBackend::BeginStreamIn(ResidencyID id, const ResidencyAsset& asset, uint mip)
+{
+	UNUSED(asset);
+	UNUSED(mip);
+
+	PendingStreamIn pending;
+	pending.m_id = id;
+	pending.m_framesLeft = m_latencyFrames;
+	m_pending.push_back(pending);
+	m_numStreamIns++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StandInResidencyBackend::Evict(ResidencyID id, const ResidencyAsset& asset)
+{
+	UNUSED(id);
+	UNUSED(asset);
+	m_numEvictions++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool StandInResidencyBackend::DropMips(ResidencyID id, const ResidencyAsset& asset, uint mip)
+{
+	UNUSED(id);
+	UNUSED(asset);
+	UNUSED(mip);
+	m_numMipDrops++;
+	return !m_isFailingMipDrops;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void StandInResidencyBackend::Update(ResidencyManager& manager)
+{
+	size_t pendingIndex = 0;
+	while (pendingIndex < m_pending.size())
+	{
+		if (m_pending[pendingIndex].m_framesLeft > 0U)
+		{
+			m_pending[pendingIndex].m_framesLeft--;
+			pendingIndex++;
+			continue;
+		}
+
+		manager.FinishStreamIn(m_pending[pendingIndex].m_id, true);
+		m_pending[pendingIndex] = m_pending.back();
+		m_pending.pop_back();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A pan across a map. Budgets hold whenever what is on screen fits in them, everything used ends up resident, and large
+// textures drop mips before going over
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestPanAcrossMap()
+{
+	const uint numMeshes = 12U;
+	const uint numTextures = 3U;
+	const uint64_t meshBytes = 1ULL << 20;
+
+	StandInResidencyBackend backend;
+	for (uint meshIndex = 0; meshIndex < numMeshes; meshIndex++)
+	{
+		backend.AddAsset(RESIDENCY_MESH, meshIndex, Stringf("mesh%u", meshIndex), &meshBytes, 1U, meshIndex < 2U);
+	}
+
+	//1024 square RGBA8, about 5.3MB with its chain
+	uint64_t mipBytes[11];
+	for (uint mipIndex = 0; mipIndex < 11U; mipIndex++)
+	{
+		uint size = 1024U >> mipIndex;
+		mipBytes[mipIndex] = (uint64_t)size * size * 4U;
+	}
+	for (uint textureIndex = 0; textureIndex < numTextures; textureIndex++)
+	{
+		backend.AddAsset(RESIDENCY_TEXTURE, textureIndex, Stringf("texture%u", textureIndex), mipBytes, 11U, false);
+	}
+
+	ResidencyBudget budget;
+	budget.m_maxBytes[RESIDENCY_MESH] = 6U * meshBytes;
+	budget.m_maxBytes[RESIDENCY_TEXTURE] = 6ULL << 20;
+	budget.m_evictAfterFrames = 8U;
+	budget.m_maxStreamInsPerFrame = 2U;
+
+	ResidencyManager manager(&backend);
+	manager.SetBudget(budget);
+
+	//Four meshes in view at a time, sliding one along every 20 frames; two of the textures always, the third every other step
+	const uint numSteps = 9U;
+	const uint framesPerStep = 20U;
+	for (uint step = 0; step < numSteps; step++)
+	{
+		uint numTexturesUsed = (step % 2U == 0U) ? numTextures : 2U;
+		for (uint frameIndex = 0; frameIndex < framesPerStep; frameIndex++)
+		{
+			for (uint meshIndex = step; meshIndex < step + 4U; meshIndex++)
+			{
+				manager.MarkMeshUsed(meshIndex);
+			}
+
+			for (uint textureIndex = 0; textureIndex < numTexturesUsed; textureIndex++)
+			{
+				manager.MarkTextureUsed(textureIndex);
+			}
+
+			manager.Update();
+
+			const ResidencyStats& stats = manager.GetStats();
+			if (stats.m_residentBytes[RESIDENCY_MESH] > budget.m_maxBytes[RESIDENCY_MESH])
+			{
+				FailTest(Stringf("Step %u frame %u: %llu mesh bytes resident, budget %llu", step, frameIndex,
+					(unsigned long long)stats.m_residentBytes[RESIDENCY_MESH], (unsigned long long)budget.m_maxBytes[RESIDENCY_MESH]));
+			}
+			if (stats.m_residentBytes[RESIDENCY_TEXTURE] > budget.m_maxBytes[RESIDENCY_TEXTURE])
+			{
+				FailTest(Stringf("Step %u frame %u: %llu texture bytes resident, budget %llu", step, frameIndex,
+					(unsigned long long)stats.m_residentBytes[RESIDENCY_TEXTURE], (unsigned long long)budget.m_maxBytes[RESIDENCY_TEXTURE]));
+			}
+		}
+
+		for (uint meshIndex = step; meshIndex < step + 4U; meshIndex++)
+		{
+			ResidencyID id = manager.FindAsset(RESIDENCY_MESH, meshIndex);
+			if (id == INVALID_RESIDENCY_ID || !manager.GetAsset(id).IsResident())
+			{
+				FailTest(Stringf("Step %u: mesh%u on screen but not resident", step, meshIndex));
+			}
+		}
+
+		//Once settled the textures in use share the budget to within a mip of each other
+		uint finestMip = MAX_COOKED_TEXTURE_MIPS;
+		uint coarsestMip = 0U;
+		for (uint textureIndex = 0; textureIndex < numTexturesUsed; textureIndex++)
+		{
+			ResidencyID id = manager.FindAsset(RESIDENCY_TEXTURE, textureIndex);
+			if (id == INVALID_RESIDENCY_ID || !manager.GetAsset(id).IsResident())
+			{
+				FailTest(Stringf("Step %u: texture%u used but not resident", step, textureIndex));
+				continue;
+			}
+
+			finestMip = std::min(finestMip, manager.GetAsset(id).m_residentMip);
+			coarsestMip = std::max(coarsestMip, manager.GetAsset(id).m_residentMip);
+		}
+
+		if (coarsestMip > finestMip + 1U)
+		{
+			FailTest(Stringf("Step %u: textures in use resident from mip %u to mip %u", step, finestMip, coarsestMip));
+		}
+	}
+
+	//Meshes left the view, and three full textures don't fit the texture budget
+	const ResidencyStats& stats = manager.GetStats();
+	TEST_CHECK(stats.m_numEvictions > 0U);
+	TEST_CHECK(stats.m_numMipDrops > 0U);
+
+	//Anything still in flight at the end is the only difference allowed
+	uint numInFlight = 0U;
+	for (ResidencyID id = 0; id < manager.GetNumAssets(); id++)
+	{
+		numInFlight += manager.GetAsset(id).m_state == RESIDENCY_STREAMING ? 1U : 0U;
+	}
+	TEST_CHECK(backend.m_numStreamIns == stats.m_numStreamIns + stats.m_numFailedStreamIns + numInFlight);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// An asset the backend can't size yet stays untracked and is asked about again; one it never can is asked about once
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestDescribeLater()
+{
+	const uint64_t meshBytes = 1ULL << 20;
+
+	StandInResidencyBackend backend;
+	backend.AddAsset(RESIDENCY_MESH, 0U, "pending", &meshBytes, 1U, false, true);
+
+	ResidencyManager manager(&backend);
+	for (uint frameIndex = 0; frameIndex < 3U; frameIndex++)
+	{
+		manager.MarkMeshUsed(0U);
+		manager.MarkMeshUsed(1U);
+		manager.Update();
+	}
+
+	TEST_CHECK(manager.FindAsset(RESIDENCY_MESH, 0U) == INVALID_RESIDENCY_ID);
+	TEST_CHECK(manager.FindAsset(RESIDENCY_MESH, 1U) == INVALID_RESIDENCY_ID);
+	TEST_CHECK(backend.m_numDescribes == 4U);
+	TEST_CHECK(backend.m_numStreamIns == 0U);
+
+	//Once it can be described it is tracked and streamed in like any other
+	backend.SetDescribable(RESIDENCY_MESH, 0U);
+	for (uint frameIndex = 0; frameIndex < 5U; frameIndex++)
+	{
+		manager.MarkMeshUsed(0U);
+		manager.Update();
+	}
+
+	ResidencyID id = manager.FindAsset(RESIDENCY_MESH, 0U);
+	TEST_CHECK(id != INVALID_RESIDENCY_ID);
+	TEST_CHECK(id != INVALID_RESIDENCY_ID && manager.GetAsset(id).IsResident());
+	TEST_CHECK(backend.m_numDescribes == 5U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Two textures in use are over budget but the backend can't read their coarser mips. Both keep their finest mip and nothing
+// is counted as freed; once the drops work they go through and the budget holds
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestFailedMipDrop()
+{
+	uint64_t mipBytes[11];
+	for (uint mipIndex = 0; mipIndex < 11U; mipIndex++)
+	{
+		uint size = 1024U >> mipIndex;
+		mipBytes[mipIndex] = (uint64_t)size * size * 4U;
+	}
+
+	StandInResidencyBackend backend;
+	backend.AddAsset(RESIDENCY_TEXTURE, 0U, "texture0", mipBytes, 11U, true);
+	backend.AddAsset(RESIDENCY_TEXTURE, 1U, "texture1", mipBytes, 11U, true);
+	backend.m_isFailingMipDrops = true;
+
+	ResidencyBudget budget;
+	budget.m_maxBytes[RESIDENCY_TEXTURE] = 6ULL << 20;
+
+	ResidencyManager manager(&backend);
+	manager.SetBudget(budget);
+
+	for (uint frameIndex = 0; frameIndex < 3U; frameIndex++)
+	{
+		manager.MarkTextureUsed(0U);
+		manager.MarkTextureUsed(1U);
+		manager.Update();
+	}
+
+	//Each is tried once per update and the loop gives up instead of spinning
+	const ResidencyStats& stats = manager.GetStats();
+	TEST_CHECK(backend.m_numMipDrops == 6U);
+	TEST_CHECK(stats.m_numFailedMipDrops == 6U);
+	TEST_CHECK(stats.m_numMipDrops == 0U);
+	TEST_CHECK(stats.m_bytesEvicted == 0U);
+
+	uint64_t residentBytes = 0U;
+	for (uint textureIndex = 0; textureIndex < 2U; textureIndex++)
+	{
+		ResidencyID id = manager.FindAsset(RESIDENCY_TEXTURE, textureIndex);
+		if (!TEST_CHECK(id != INVALID_RESIDENCY_ID))
+			continue;
+
+		TEST_CHECK(manager.GetAsset(id).m_residentMip == 0U);
+		TEST_CHECK(manager.GetAsset(id).m_numMipDrops == 0U);
+		residentBytes += manager.GetAsset(id).GetResidentBytes();
+	}
+	TEST_CHECK(stats.m_residentBytes[RESIDENCY_TEXTURE] == residentBytes);
+
+	backend.m_isFailingMipDrops = false;
+	manager.MarkTextureUsed(0U);
+	manager.MarkTextureUsed(1U);
+	manager.Update();
+
+	TEST_CHECK(stats.m_numMipDrops == 2U);
+	TEST_CHECK(stats.m_bytesEvicted == 2U * mipBytes[0]);
+	TEST_CHECK(stats.m_residentBytes[RESIDENCY_TEXTURE] <= budget.m_maxBytes[RESIDENCY_TEXTURE]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestPanAcrossMap();
+	TestDescribeLater();
+	TestFailedMipDrop();
+
+	return FinishTests("AssetResidencyTests");
+}
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// A battle's worth of impacts against a small voice pool, played through a backend that only records what it was asked
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/AudioVoiceManager.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Playback IDs count up from 1, so a voice's ID is one more than its index in m_plays
+//------------------------------------------------------------------------------------------------------------------------------
+class RecordingAudioVoiceBackend : public AudioVoiceBackend
+{
+public:
+	virtual SoundPlaybackID	PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel) override;
+	virtual void			StopVoice(SoundPlaybackID playback) override;
+
+public:
+	struct PlayedVoice
+	{
+		SoundID				m_sound;
+		Vec2				m_position;
+	};
+
+	std::vector<PlayedVoice>		m_plays;
+	std::vector<SoundPlaybackID>	m_stops;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+SoundPlaybackID RecordingAudioVoiceBackend::PlayVoice(SoundID sound, const Vec2& position, ChannelGroupID channel)
+{
+	UNUSED(channel);
+
+	PlayedVoice played;
+	played.m_sound = sound;
+	played.m_position = position;
+	m_plays.push_back(played);
+	return (SoundPlaybackID)m_plays.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingAudioVoiceBackend::StopVoice(SoundPlaybackID playback)
+{
+	m_stops.push_back(playback);
+}
+
+static const SoundID ATTACK_SOUND = (SoundID)1;
+static const SoundID DEATH_SOUND = (SoundID)2;
+static const float FRAME_SECONDS = 1.f / 60.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static AudioVoiceSettings MakeSmallPoolSettings()
+{
+	AudioVoiceSettings settings;
+	settings.m_maxVoices = 4U;
+	settings.m_voiceSeconds = 0.5f;
+	settings.m_mergeWindowSeconds = 0.1f;
+	settings.m_mergeRadius = 2.f;
+	settings.m_maxDistance = 30.f;
+	return settings;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A burst at one spot plays once, the far side of the map is never heard, the nearest sounds win the pool and every voice
+// finishes
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestBattleAgainstSmallPool()
+{
+	const ChannelGroupID channel = ChannelGroupID();
+	const Vec3 listener = Vec3(0.f, 0.f, 0.f);
+	AudioVoiceSettings settings = MakeSmallPoolSettings();
+
+	RecordingAudioVoiceBackend backend;
+	AudioVoiceManager manager(&backend);
+	manager.SetSettings(settings);
+
+	//Fifty units hitting the same target, then again two frames later while the first is still in its window
+	for (uint unitIndex = 0; unitIndex < 50U; unitIndex++)
+	{
+		manager.PlayOneShot(ATTACK_SOUND, Vec2(10.f + (float)(unitIndex % 5U) * 0.2f, 0.f), channel);
+	}
+	manager.PlayOneShot(ATTACK_SOUND, Vec2(100.f, 0.f), channel);
+	manager.Update(FRAME_SECONDS, listener);
+	manager.Update(FRAME_SECONDS, listener);
+
+	for (uint unitIndex = 0; unitIndex < 10U; unitIndex++)
+	{
+		manager.PlayOneShot(ATTACK_SOUND, Vec2(10.f, 0.5f), channel);
+	}
+	manager.Update(FRAME_SECONDS, listener);
+
+	TEST_CHECK(backend.m_plays.size() == 1U);
+	TEST_CHECK(manager.GetStats().m_numCulled == 1U);
+
+	//Eight deaths spread out from the listener, too far apart to merge; only the nearest fit the pool with the attack still playing
+	for (uint deathIndex = 0; deathIndex < 8U; deathIndex++)
+	{
+		manager.PlayOneShot(DEATH_SOUND, Vec2(0.f, 2.f + (float)deathIndex * 2.5f), channel);
+	}
+	manager.Update(FRAME_SECONDS, listener);
+
+	TEST_CHECK(manager.GetNumVoices() == settings.m_maxVoices);
+
+	//The attack 10 out is further than the deaths from 2 to 9.5, so it is stolen for the fourth nearest
+	TEST_CHECK(backend.m_plays.size() == 5U);
+	for (size_t playIndex = 1; playIndex < backend.m_plays.size(); playIndex++)
+	{
+		const RecordingAudioVoiceBackend::PlayedVoice& played = backend.m_plays[playIndex];
+		TEST_CHECK(played.m_sound == DEATH_SOUND);
+		if (played.m_position.GetLength() > 9.5f + 0.001f)
+		{
+			FailTest(Stringf("A voice %.1f away plays while nearer sounds were dropped", played.m_position.GetLength()));
+		}
+	}
+	TEST_CHECK(manager.GetStats().m_numStolen == 1U);
+	TEST_CHECK(backend.m_stops.size() == 1U && backend.m_stops[0] == (SoundPlaybackID)1);
+
+	//Quiet for longer than a voice lasts empties the pool
+	for (uint frameIndex = 0; frameIndex < 60U; frameIndex++)
+	{
+		manager.Update(FRAME_SECONDS, listener);
+	}
+
+	TEST_CHECK(manager.GetNumVoices() == 0U);
+
+	const AudioVoiceStats& stats = manager.GetStats();
+	TEST_CHECK(stats.m_peakVoices <= settings.m_maxVoices);
+	TEST_CHECK(stats.m_numRequested == stats.m_numMerged + stats.m_numCulled + stats.m_numDropped + stats.m_numStarted);
+	TEST_CHECK(backend.m_plays.size() == stats.m_numStarted);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The null backend the game runs headless with counts what the manager asked of it
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestNullBackendCounts()
+{
+	NullAudioVoiceBackend backend;
+	AudioVoiceManager manager(&backend);
+	manager.SetSettings(MakeSmallPoolSettings());
+
+	for (uint deathIndex = 0; deathIndex < 6U; deathIndex++)
+	{
+		manager.PlayOneShot(DEATH_SOUND, Vec2(0.f, 2.f + (float)deathIndex * 2.5f), ChannelGroupID());
+	}
+	manager.Update(FRAME_SECONDS, Vec3(0.f, 0.f, 0.f));
+
+	TEST_CHECK(backend.m_numPlays == 4U);
+	TEST_CHECK(backend.m_numStops == 0U);
+	TEST_CHECK(manager.GetStats().m_numDropped == 2U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestBattleAgainstSmallPool();
+	TestNullBackendCounts();
+
+	return FinishTests("AudioVoiceManagerTests");
+}
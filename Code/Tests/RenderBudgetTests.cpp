@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Records stand-in map frames through the render queue into the recording backend and checks the worst frame against every
+// scenario in render_budgets.xml. Each scenario's frame is built the way Map::Render builds one: terrain chunks and static
+// models as opaque mesh packets, units as alpha sprites on the shared atlas page and their bars as an overlay stream
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/SpriteBatcher.hpp"
+#include "Game/StaticModelRenderer.hpp"
+#include "Game/StatusBarBatcher.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <cstdint>
+#include <cstdio>
+
+static const char* RENDER_BUDGET_PATH = "Data/Gameplay/render_budgets.xml";
+static const int NUM_BUDGET_FRAMES = 4;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BudgetScene
+{
+	const char*			m_scenario = "";
+	uint				m_numTerrainChunks = 0U;
+	uint				m_numStaticModels = 0U;
+	uint				m_numUnits = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static T* MakeFakeResource(uintptr_t id)
+{
+	return reinterpret_cast<T*>(id * 16U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One frame of the scene into the queue and out through the backend. Units and statics are spread over a 64x64 patch of
+// ground in front of the eye
+//------------------------------------------------------------------------------------------------------------------------------
+static void RecordSceneFrame(const BudgetScene& scene, RenderQueue& queue, StaticModelRenderer& staticModels, SpriteBatcher& spriteBatcher, StatusBarBatcher& statusBars,
+	QueueSpriteBackend& spriteBackend, QueueSpriteBackend& statusBarBackend, RenderQueueBackend& queueBackend)
+{
+	Vec3 eyePosition(32.f, -24.f, 40.f);
+	queue.BeginFrame(1U);
+	RenderPacketBuffer& buffer = queue.GetBuffer(0U);
+
+	Material* terrainMaterial = MakeFakeResource<Material>(1U);
+	uint identityIndex = buffer.AddTransform(Matrix44::IDENTITY);
+	for (uint chunkIndex = 0; chunkIndex < scene.m_numTerrainChunks; chunkIndex++)
+	{
+		RenderDrawState state;
+		state.m_material = terrainMaterial;
+		state.m_mesh = MakeFakeResource<GPUMesh>(100U + chunkIndex);
+
+		Vec3 chunkCenter((float)(chunkIndex % 4U) * 16.f + 8.f, (float)(chunkIndex / 4U) * 16.f + 8.f, 0.f);
+		float depth = (chunkCenter - eyePosition).GetLength();
+		buffer.AddPacket(MakeRenderSortKey(RENDER_PASS_OPAQUE, nullptr, terrainMaterial, nullptr, depth), buffer.AddState(state), identityIndex);
+	}
+
+	staticModels.RecordPackets(buffer, 0U, staticModels.GetNumInstances(), eyePosition);
+
+	TextureView* atlasPage = MakeFakeResource<TextureView>(2U);
+	spriteBatcher.BeginFrame();
+	statusBars.BeginFrame(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 0.f, 1.f));
+	for (uint unitIndex = 0; unitIndex < scene.m_numUnits; unitIndex++)
+	{
+		Vec3 position((float)(unitIndex % 16U) * 4.f, (float)(unitIndex / 16U) * 4.f, 0.f);
+
+		SpriteQuad quad;
+		quad.m_texture = atlasPage;
+		quad.m_corners[0] = position + Vec3(-0.5f, 0.f, 1.f);
+		quad.m_corners[1] = position + Vec3(0.5f, 0.f, 1.f);
+		quad.m_corners[2] = position + Vec3(-0.5f, 0.f, 0.f);
+		quad.m_corners[3] = position + Vec3(0.5f, 0.f, 0.f);
+		quad.m_uvMins = Vec2::ZERO;
+		quad.m_uvMaxs = Vec2::ONE;
+		Vec3 toEye = position - eyePosition;
+		quad.m_sortDepth = toEye.x * toEye.x + toEye.y * toEye.y + toEye.z * toEye.z;
+		spriteBatcher.AddQuad(quad);
+
+		statusBars.AddBar(position + Vec3(0.f, 0.f, 1.f), 0.75f, Rgba::GREEN);
+	}
+	spriteBatcher.Flush(spriteBackend);
+	statusBars.Flush(statusBarBackend);
+
+	queue.Submit(queueBackend);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static RenderFrameStats RecordScene(const BudgetScene& scene)
+{
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+
+	//Trees, huts and both teams' town centers
+	StaticModelGroupKey groupKeys[4];
+	for (uint groupIndex = 0; groupIndex < 4U; groupIndex++)
+	{
+		groupKeys[groupIndex].m_mesh = MakeFakeResource<GPUMesh>(10U + (groupIndex < 3U ? groupIndex : 2U));
+		groupKeys[groupIndex].m_material = MakeFakeResource<Material>(20U + (groupIndex < 3U ? groupIndex : 2U));
+		groupKeys[groupIndex].m_textureOverride = groupIndex >= 2U ? MakeFakeResource<TextureView>(30U + groupIndex) : nullptr;
+	}
+
+	for (uint modelIndex = 0; modelIndex < scene.m_numStaticModels; modelIndex++)
+	{
+		Vec3 position((float)(modelIndex % 8U) * 8.f + 2.f, (float)(modelIndex / 8U) * 8.f + 2.f, 0.f);
+		staticModels.SetInstance(GameHandle(1U, modelIndex), 0U, position, groupKeys[modelIndex % 4U], Matrix44::IDENTITY);
+	}
+	staticModels.EndSync();
+
+	RenderQueue queue;
+	SpriteBatcher spriteBatcher;
+	StatusBarBatcher statusBars;
+	Shader* spriteShader = MakeFakeResource<Shader>(3U);
+	QueueSpriteBackend spriteBackend(&queue, spriteShader, RENDER_PASS_ALPHA);
+	QueueSpriteBackend statusBarBackend(&queue, spriteShader, RENDER_PASS_OVERLAY);
+
+	RecordingRenderBackend recorder;
+	ForwardingQueueBackend queueBackend(&recorder);
+	for (int frameIndex = 0; frameIndex < NUM_BUDGET_FRAMES; frameIndex++)
+	{
+		recorder.BeginFrame();
+		RecordSceneFrame(scene, queue, staticModels, spriteBatcher, statusBars, spriteBackend, statusBarBackend, queueBackend);
+		recorder.EndFrame();
+	}
+
+	TEST_CHECK(recorder.GetNumFrames() == (uint)NUM_BUDGET_FRAMES);
+	return recorder.GetWorstFrameStats();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestScenesFitBudgets()
+{
+	RenderBudgetSet budgets;
+	if (!TEST_CHECK(budgets.LoadFromFile(RENDER_BUDGET_PATH)))
+		return;
+
+	BudgetScene scenes[2];
+	scenes[0].m_scenario = "default";
+	scenes[0].m_numTerrainChunks = 16U;
+	scenes[0].m_numStaticModels = 40U;
+	scenes[0].m_numUnits = 60U;
+
+	scenes[1].m_scenario = "battle";
+	scenes[1].m_numTerrainChunks = 16U;
+	scenes[1].m_numStaticModels = 48U;
+	scenes[1].m_numUnits = 240U;
+
+	for (int sceneIndex = 0; sceneIndex < 2; sceneIndex++)
+	{
+		const BudgetScene& scene = scenes[sceneIndex];
+		const RenderBudget* budget = budgets.FindBudget(scene.m_scenario);
+		if (!TEST_CHECK(budget != nullptr))
+			continue;
+
+		RenderFrameStats stats = RecordScene(scene);
+		printf("%s: %u draws, %u state changes (%u redundant binds), %u uploads, %llu bytes\n", scene.m_scenario, stats.m_numDrawCalls,
+			stats.m_numStateChanges, stats.m_numRedundantBinds, stats.m_numUploads, (unsigned long long)stats.m_numBytesUploaded);
+
+		//Every terrain chunk and static model is its own draw, units and bars are one stream each
+		TEST_CHECK(stats.m_numDrawCalls == scene.m_numTerrainChunks + scene.m_numStaticModels + 2U);
+		TEST_CHECK(stats.m_numUploads == 2U);
+
+		std::vector<std::string> failures;
+		if (!RenderBudgetSet::CheckBudget(*budget, stats, failures))
+		{
+			for (size_t failureIndex = 0; failureIndex < failures.size(); failureIndex++)
+			{
+				FailTest(std::string(scene.m_scenario) + ": " + failures[failureIndex]);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestOverBudgetReportsEachLimit()
+{
+	BudgetScene scene;
+	scene.m_numTerrainChunks = 16U;
+	scene.m_numStaticModels = 40U;
+	scene.m_numUnits = 60U;
+	RenderFrameStats stats = RecordScene(scene);
+
+	RenderBudget tightBudget;
+	tightBudget.m_maxDrawCalls = 8U;
+	tightBudget.m_maxStateChanges = 8U;
+	tightBudget.m_maxUploads = 1U;
+	tightBudget.m_maxBytesUploaded = 64U;
+
+	std::vector<std::string> failures;
+	TEST_CHECK(!RenderBudgetSet::CheckBudget(tightBudget, stats, failures));
+	TEST_CHECK(failures.size() == 4U);
+
+	//Zero limits are not checked
+	TEST_CHECK(RenderBudgetSet::CheckBudget(RenderBudget(), stats, failures));
+	TEST_CHECK(failures.empty());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestMissingBudgets()
+{
+	RenderBudgetSet budgets;
+	TEST_CHECK(!budgets.LoadFromFile("Data/Gameplay/NoSuchBudgets.xml"));
+
+	TEST_CHECK(budgets.LoadFromFile(RENDER_BUDGET_PATH));
+	TEST_CHECK(budgets.FindBudget("NoSuchScenario") == nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestScenesFitBudgets();
+	TestOverBudgetReportsEachLimit();
+	TestMissingBudgets();
+
+	return FinishTests("RenderBudgetTests");
+}
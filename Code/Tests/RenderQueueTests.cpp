@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Records packets into several buffers and submits them to the recording queue backend, checking the order they reach it
+// and how many binds the queue issued. States are fake pointers, the queue never looks behind them
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/RenderQueue.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <algorithm>
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static T* MakeFake(uintptr_t id)
+{
+	return (T*)(id * 0x100U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every packet draws its own mesh so the submission order can be read back from the meshes drawn
+//------------------------------------------------------------------------------------------------------------------------------
+static GPUMesh* AddPacket(RenderPacketBuffer& buffer, RenderPassT pass, Shader* shader, Material* material, TextureView* texture, float depth, uintptr_t meshID)
+{
+	RenderDrawState state;
+	state.m_shader = shader;
+	state.m_material = material;
+	state.m_texture = texture;
+	state.m_mesh = MakeFake<GPUMesh>(meshID);
+
+	uint64_t sortKey = MakeRenderSortKey(pass, shader, material, texture, depth);
+	buffer.AddPacket(sortKey, buffer.AddState(state), buffer.AddTransform(Matrix44::IDENTITY));
+	return state.m_mesh;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Keys that share their high bytes skip those passes; the result still matches a stable comparison sort
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestRadixSortMatchesStableSort()
+{
+	std::vector<RenderQueue::SortEntry> entries;
+	uint64_t seed = 12345U;
+	for (uint entryIndex = 0; entryIndex < 500U; entryIndex++)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+		RenderQueue::SortEntry entry;
+		entry.m_key = (entryIndex % 3U == 0U) ? (seed >> 20) : ((seed >> 48) & 0xFFU);
+		entry.m_packetIndex = entryIndex;
+		entries.push_back(entry);
+	}
+
+	std::vector<RenderQueue::SortEntry> expected = entries;
+	std::stable_sort(expected.begin(), expected.end(), [](const RenderQueue::SortEntry& lhs, const RenderQueue::SortEntry& rhs) { return lhs.m_key < rhs.m_key; });
+
+	std::vector<RenderQueue::SortEntry> scratch;
+	RenderQueue::RadixSort(entries, scratch);
+
+	bool isMatching = entries.size() == expected.size();
+	for (size_t entryIndex = 0; isMatching && entryIndex < entries.size(); entryIndex++)
+	{
+		isMatching = entries[entryIndex].m_key == expected[entryIndex].m_key && entries[entryIndex].m_packetIndex == expected[entryIndex].m_packetIndex;
+	}
+	TEST_CHECK(isMatching);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Packets spread over three buffers in no particular order come out by pass, opaque front to back within its state and
+// alpha back to front
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestSubmitOrder()
+{
+	Shader* spriteShader = MakeFake<Shader>(1U);
+	Material* terrain = MakeFake<Material>(2U);
+	Material* building = MakeFake<Material>(3U);
+	TextureView* goblin = MakeFake<TextureView>(4U);
+	TextureView* atlas = MakeFake<TextureView>(5U);
+
+	RenderQueue queue;
+	queue.BeginFrame(3U);
+
+	GPUMesh* overlay = AddPacket(queue.GetBuffer(0U), RENDER_PASS_OVERLAY, spriteShader, nullptr, atlas, 1.f, 1U);
+	GPUMesh* alphaNear = AddPacket(queue.GetBuffer(0U), RENDER_PASS_ALPHA, spriteShader, nullptr, atlas, 5.f, 2U);
+	GPUMesh* terrainFar = AddPacket(queue.GetBuffer(0U), RENDER_PASS_OPAQUE, nullptr, terrain, nullptr, 80.f, 3U);
+
+	GPUMesh* alphaFar = AddPacket(queue.GetBuffer(1U), RENDER_PASS_ALPHA, spriteShader, nullptr, atlas, 60.f, 4U);
+	GPUMesh* terrainNear = AddPacket(queue.GetBuffer(1U), RENDER_PASS_OPAQUE, nullptr, terrain, nullptr, 10.f, 5U);
+	GPUMesh* buildingGoblin = AddPacket(queue.GetBuffer(1U), RENDER_PASS_OPAQUE, nullptr, building, goblin, 30.f, 6U);
+
+	GPUMesh* alphaMiddle = AddPacket(queue.GetBuffer(2U), RENDER_PASS_ALPHA, spriteShader, nullptr, goblin, 20.f, 7U);
+	GPUMesh* buildingOwn = AddPacket(queue.GetBuffer(2U), RENDER_PASS_OPAQUE, nullptr, building, nullptr, 40.f, 8U);
+
+	RecordingRenderQueueBackend backend;
+	queue.Submit(backend);
+
+	const std::vector<GPUMesh*>& drawn = backend.m_drawnMeshes;
+	TEST_CHECK(queue.GetNumPackets() == 8U);
+	if (!TEST_CHECK(drawn.size() == 8U))
+		return;
+
+	//The four opaque packets first, in whatever order their states hash to but front to back within one
+	std::vector<GPUMesh*> opaque(drawn.begin(), drawn.begin() + 4);
+	TEST_CHECK(std::find(opaque.begin(), opaque.end(), terrainNear) != opaque.end());
+	TEST_CHECK(std::find(opaque.begin(), opaque.end(), terrainFar) != opaque.end());
+	TEST_CHECK(std::find(opaque.begin(), opaque.end(), buildingGoblin) != opaque.end());
+	TEST_CHECK(std::find(opaque.begin(), opaque.end(), buildingOwn) != opaque.end());
+	TEST_CHECK(std::find(opaque.begin(), opaque.end(), terrainNear) + 1 == std::find(opaque.begin(), opaque.end(), terrainFar));
+
+	TEST_CHECK(drawn[4] == alphaFar);
+	TEST_CHECK(drawn[5] == alphaMiddle);
+	TEST_CHECK(drawn[6] == alphaNear);
+	TEST_CHECK(drawn[7] == overlay);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Runs of the same state bind once. A material drawn without an override after one drawn with it binds again to get its
+// own texture back into slot 0
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestSubmitElidesBinds()
+{
+	Shader* spriteShader = MakeFake<Shader>(1U);
+	Material* terrain = MakeFake<Material>(2U);
+	Material* building = MakeFake<Material>(3U);
+	TextureView* goblin = MakeFake<TextureView>(4U);
+	TextureView* atlas = MakeFake<TextureView>(5U);
+	TextureView* bars = MakeFake<TextureView>(6U);
+
+	RenderQueue queue;
+	queue.BeginFrame(2U);
+
+	//Opaque: three terrain chunks and two buildings, one material bind each
+	for (uint chunkIndex = 0; chunkIndex < 3U; chunkIndex++)
+	{
+		AddPacket(queue.GetBuffer(chunkIndex % 2U), RENDER_PASS_OPAQUE, nullptr, terrain, nullptr, 10.f + (float)chunkIndex * 10.f, 10U + chunkIndex);
+	}
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OPAQUE, nullptr, building, nullptr, 15.f, 20U);
+	AddPacket(queue.GetBuffer(1U), RENDER_PASS_OPAQUE, nullptr, building, nullptr, 25.f, 21U);
+
+	//Overlay: the shader once, then one bind per texture run
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OVERLAY, spriteShader, nullptr, atlas, 1.f, 30U);
+	AddPacket(queue.GetBuffer(1U), RENDER_PASS_OVERLAY, spriteShader, nullptr, atlas, 2.f, 31U);
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OVERLAY, spriteShader, nullptr, bars, 3.f, 32U);
+
+	RecordingRenderQueueBackend backend;
+	queue.Submit(backend);
+
+	TEST_CHECK(backend.m_drawnMeshes.size() == 8U);
+	TEST_CHECK(backend.m_numMaterialBinds == 2U);
+	TEST_CHECK(backend.m_numShaderBinds == 1U);
+	TEST_CHECK(backend.m_numTextureBinds == 2U);
+	TEST_CHECK(backend.m_numVertexArrays == 0U);
+	TEST_CHECK(queue.GetNumStateChanges() == 5U);
+	TEST_CHECK(queue.GetNumElidedStateChanges() == 6U);
+
+	//Alpha packets alternating textures at different depths can't be grouped, every one rebinds its texture
+	queue.BeginFrame(1U);
+	for (uint spriteIndex = 0; spriteIndex < 4U; spriteIndex++)
+	{
+		AddPacket(queue.GetBuffer(0U), RENDER_PASS_ALPHA, spriteShader, nullptr, (spriteIndex % 2U == 0U) ? atlas : goblin, 40.f - (float)spriteIndex * 10.f, 40U + spriteIndex);
+	}
+
+	RecordingRenderQueueBackend alphaBackend;
+	queue.Submit(alphaBackend);
+
+	TEST_CHECK(alphaBackend.m_numShaderBinds == 1U);
+	TEST_CHECK(alphaBackend.m_numTextureBinds == 4U);
+
+	//Within a pass the material's own texture sorts first and the override only binds the texture on top. A later pass
+	//drawing the material without it has to bind the material again
+	queue.BeginFrame(1U);
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OPAQUE, nullptr, building, goblin, 10.f, 50U);
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OPAQUE, nullptr, building, nullptr, 20.f, 51U);
+	AddPacket(queue.GetBuffer(0U), RENDER_PASS_OVERLAY, nullptr, building, nullptr, 1.f, 52U);
+
+	RecordingRenderQueueBackend overrideBackend;
+	queue.Submit(overrideBackend);
+
+	TEST_CHECK(overrideBackend.m_numMaterialBinds == 2U);
+	TEST_CHECK(overrideBackend.m_numTextureBinds == 1U);
+	TEST_CHECK(overrideBackend.m_drawnMeshes.size() == 3U && overrideBackend.m_drawnMeshes[0] == MakeFake<GPUMesh>(51U));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestRadixSortMatchesStableSort();
+	TestSubmitOrder();
+	TestSubmitElidesBinds();
+
+	return FinishTests("RenderQueueTests");
+}
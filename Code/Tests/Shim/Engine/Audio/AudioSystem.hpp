@@ -0,0 +1,22 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: the FMOD audio system's IDs and the calls the engine voice backend forwards. Tests play through their own
+// backend, so nothing here makes a sound
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Math/Vec2.hpp"
+//Others
+#include <cstddef>
+
+typedef size_t SoundID;
+typedef size_t SoundPlaybackID;
+typedef size_t ChannelGroupID;
+
+class AudioSystem
+{
+public:
+	SoundPlaybackID				Play3DSound(SoundID sound, const Vec2& position, ChannelGroupID channel) { (void)sound; (void)position; (void)channel; return 0U; }
+	void						StopSound(SoundPlaybackID playback) { (void)playback; }
+};
+
+extern AudioSystem* g_audio;
@@ -0,0 +1,20 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: the slice of the engine's common header the game code under test uses
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/ErrorWarningAssert.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/Rgba.hpp"
+//Others
+#include <string>
+
+#define STATIC
+#define UNUSED(x) (void)(x)
+
+typedef unsigned int uint;
+typedef NamedStrings EventArgs;
+
+std::string Stringf(const char* format, ...);
+
+extern NamedStrings g_gameConfigBlackboard;
@@ -0,0 +1,18 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: recoverable errors are counted so a test can check it hit one, fatal ones abort
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Others
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+extern int g_numRecoverableErrors;
+
+void							ReportRecoverableError(const std::string& message);
+void							DebuggerPrintf(const char* format, ...);
+
+#define ERROR_RECOVERABLE(message)				ReportRecoverableError(message)
+#define ERROR_AND_DIE(message)					do { fprintf(stderr, "%s\n", std::string(message).c_str()); abort(); } while (false)
+#define ASSERT_RECOVERABLE(condition, message)	do { if (!(condition)) { ReportRecoverableError(message); } } while (false)
+#define GUARANTEE_OR_DIE(condition, message)	do { if (!(condition)) { ERROR_AND_DIE(message); } } while (false)
@@ -0,0 +1,17 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: console output goes to stdout so a failing test's log still shows what the game code printed
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Others
+#include <cstdio>
+#include <string>
+
+class DevConsole
+{
+public:
+	void						PrintString(const Rgba& color, const std::string& text) { UNUSED(color); printf("%s\n", text.c_str()); }
+};
+
+extern DevConsole* g_devConsole;
@@ -0,0 +1,23 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: key value pairs, parsed on read like the engine's
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Others
+#include <map>
+#include <string>
+
+class NamedStrings
+{
+public:
+	void						SetValue(const std::string& key, const std::string& value) { m_keyValuePairs[key] = value; }
+
+	std::string					GetValue(const std::string& key, const std::string& defaultValue) const;
+	std::string					GetValue(const std::string& key, const char* defaultValue) const;
+	bool						GetValue(const std::string& key, bool defaultValue) const;
+	int							GetValue(const std::string& key, int defaultValue) const;
+	unsigned int				GetValue(const std::string& key, unsigned int defaultValue) const;
+	float						GetValue(const std::string& key, float defaultValue) const;
+
+private:
+	std::map<std::string, std::string>	m_keyValuePairs;
+};
@@ -0,0 +1,23 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+struct Rgba
+{
+	Rgba() {}
+	Rgba(float red, float green, float blue, float alpha = 1.f) : r(red), g(green), b(blue), a(alpha) {}
+
+	float						r = 1.f;
+	float						g = 1.f;
+	float						b = 1.f;
+	float						a = 1.f;
+
+	static const Rgba			WHITE;
+	static const Rgba			BLACK;
+	static const Rgba			RED;
+	static const Rgba			GREEN;
+	static const Rgba			BLUE;
+	static const Rgba			YELLOW;
+	static const Rgba			ORANGE;
+};
@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim definitions
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+//Others
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace tinyxml2
+{
+	//------------------------------------------------------------------------------------------------------------------------------
+	const char* XMLElement::Attribute(const char* name) const
+	{
+		for (size_t attributeIndex = 0; attributeIndex < m_attributes.size(); attributeIndex++)
+		{
+			if (m_attributes[attributeIndex].first == name)
+				return m_attributes[attributeIndex].second.c_str();
+		}
+		return nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	XMLElement* XMLElement::FirstChildElement(const char* name) const
+	{
+		for (size_t childIndex = 0; childIndex < m_children.size(); childIndex++)
+		{
+			if (name == nullptr || m_children[childIndex]->m_name == name)
+				return m_children[childIndex];
+		}
+		return nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	XMLElement* XMLElement::NextSiblingElement(const char* name) const
+	{
+		if (m_parent == nullptr)
+			return nullptr;
+
+		const std::vector<XMLElement*>& siblings = m_parent->m_children;
+		for (size_t siblingIndex = m_indexInParent + 1; siblingIndex < siblings.size(); siblingIndex++)
+		{
+			if (name == nullptr || siblings[siblingIndex]->m_name == name)
+				return siblings[siblingIndex];
+		}
+		return nullptr;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	XMLDocument::~XMLDocument()
+	{
+		Clear();
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	void XMLDocument::Clear()
+	{
+		std::vector<XMLElement*> pending = m_root.m_children;
+		m_root.m_children.clear();
+		while (!pending.empty())
+		{
+			XMLElement* element = pending.back();
+			pending.pop_back();
+			pending.insert(pending.end(), element->m_children.begin(), element->m_children.end());
+			element->m_children.clear();
+			delete element;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	XMLError XMLDocument::LoadFile(const char* filePath)
+	{
+		Clear();
+
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file)
+		{
+			m_error = XML_ERROR_FILE_NOT_FOUND;
+			return m_error;
+		}
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+
+		size_t position = 0U;
+		m_error = ParseChildren(m_root, contents.str(), position) && !m_root.m_children.empty() ? XML_SUCCESS : XML_ERROR_PARSING;
+		return m_error;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	static void SkipSpace(const std::string& text, size_t& position)
+	{
+		while (position < text.size() && isspace((unsigned char)text[position]))
+		{
+			position++;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	static bool ReadName(const std::string& text, size_t& position, std::string& outName)
+	{
+		size_t start = position;
+		while (position < text.size() && (isalnum((unsigned char)text[position]) || strchr("_-.:", text[position]) != nullptr))
+		{
+			position++;
+		}
+		outName = text.substr(start, position - start);
+		return !outName.empty();
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	// Reads elements up to the parent's closing tag, or the end of the text for the document
+	//------------------------------------------------------------------------------------------------------------------------------
+	bool XMLDocument::ParseChildren(XMLElement& parent, const std::string& text, size_t& position)
+	{
+		while (true)
+		{
+			position = text.find('<', position);
+			if (position == std::string::npos)
+				return &parent == &m_root;
+
+			if (text.compare(position, 4, "<!--") == 0)
+			{
+				position = text.find("-->", position);
+				if (position == std::string::npos)
+					return false;
+				position += 3;
+				continue;
+			}
+
+			if (text.compare(position, 2, "<?") == 0 || text.compare(position, 2, "<!") == 0)
+			{
+				position = text.find('>', position);
+				if (position == std::string::npos)
+					return false;
+				position++;
+				continue;
+			}
+
+			if (text.compare(position, 2, "</") == 0)
+			{
+				position += 2;
+				std::string name;
+				if (&parent == &m_root || !ReadName(text, position, name) || name != parent.m_name)
+					return false;
+
+				position = text.find('>', position);
+				if (position == std::string::npos)
+					return false;
+				position++;
+				return true;
+			}
+
+			position++;
+			XMLElement* element = new XMLElement();
+			element->m_parent = &parent;
+			element->m_indexInParent = parent.m_children.size();
+			parent.m_children.push_back(element);
+			if (!ReadName(text, position, element->m_name))
+				return false;
+
+			while (true)
+			{
+				SkipSpace(text, position);
+				if (position >= text.size())
+					return false;
+
+				if (text.compare(position, 2, "/>") == 0)
+				{
+					position += 2;
+					break;
+				}
+
+				if (text[position] == '>')
+				{
+					position++;
+					if (!ParseChildren(*element, text, position))
+						return false;
+					break;
+				}
+
+				std::string attributeName;
+				if (!ReadName(text, position, attributeName))
+					return false;
+
+				SkipSpace(text, position);
+				if (position >= text.size() || text[position] != '=')
+					return false;
+				position++;
+				SkipSpace(text, position);
+
+				if (position >= text.size() || (text[position] != '"' && text[position] != '\''))
+					return false;
+				char quote = text[position];
+				size_t valueEnd = text.find(quote, position + 1);
+				if (valueEnd == std::string::npos)
+					return false;
+
+				element->m_attributes.push_back(std::make_pair(attributeName, text.substr(position + 1, valueEnd - position - 1)));
+				position = valueEnd + 1;
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string ParseXmlAttribute(const XMLElement& element, const char* attributeName, const char* defaultValue)
+{
+	const char* value = element.Attribute(attributeName);
+	return value != nullptr ? std::string(value) : std::string(defaultValue);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string ParseXmlAttribute(const XMLElement& element, const char* attributeName, const std::string& defaultValue)
+{
+	const char* value = element.Attribute(attributeName);
+	return value != nullptr ? std::string(value) : defaultValue;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int ParseXmlAttribute(const XMLElement& element, const char* attributeName, int defaultValue)
+{
+	const char* value = element.Attribute(attributeName);
+	return value != nullptr ? atoi(value) : defaultValue;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+float ParseXmlAttribute(const XMLElement& element, const char* attributeName, float defaultValue)
+{
+	const char* value = element.Attribute(attributeName);
+	return value != nullptr ? (float)atof(value) : defaultValue;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ParseXmlAttribute(const XMLElement& element, const char* attributeName, bool defaultValue)
+{
+	const char* value = element.Attribute(attributeName);
+	return value != nullptr ? (strcmp(value, "true") == 0 || strcmp(value, "1") == 0) : defaultValue;
+}
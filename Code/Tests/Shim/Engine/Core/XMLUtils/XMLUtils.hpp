@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: enough of tinyxml2 to read data files made of elements and attributes. Comments and declarations are skipped,
+// text content is ignored
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Others
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tinyxml2
+{
+	enum XMLError
+	{
+		XML_SUCCESS,
+		XML_ERROR_FILE_NOT_FOUND,
+		XML_ERROR_PARSING
+	};
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	class XMLElement
+	{
+		friend class XMLDocument;
+
+	public:
+		const char*					Name() const { return m_name.c_str(); }
+		const char*					Attribute(const char* name) const;
+
+		XMLElement*					FirstChildElement(const char* name = nullptr) const;
+		XMLElement*					NextSiblingElement(const char* name = nullptr) const;
+
+	private:
+		std::string					m_name;
+		std::vector<std::pair<std::string, std::string>>	m_attributes;
+		std::vector<XMLElement*>	m_children;
+		XMLElement*					m_parent = nullptr;
+		size_t						m_indexInParent = 0U;
+	};
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	class XMLDocument
+	{
+	public:
+		~XMLDocument();
+
+		XMLError					LoadFile(const char* filePath);
+		XMLError					ErrorID() const { return m_error; }
+		XMLElement*					RootElement() const { return m_root.m_children.empty() ? nullptr : m_root.m_children[0]; }
+
+	private:
+		void						Clear();
+		bool						ParseChildren(XMLElement& parent, const std::string& text, size_t& position);
+
+	private:
+		XMLElement					m_root;
+		XMLError					m_error = XML_SUCCESS;
+	};
+}
+
+typedef tinyxml2::XMLElement XMLElement;
+
+std::string		ParseXmlAttribute(const XMLElement& element, const char* attributeName, const char* defaultValue);
+std::string		ParseXmlAttribute(const XMLElement& element, const char* attributeName, const std::string& defaultValue);
+int				ParseXmlAttribute(const XMLElement& element, const char* attributeName, int defaultValue);
+float			ParseXmlAttribute(const XMLElement& element, const char* attributeName, float defaultValue);
+bool			ParseXmlAttribute(const XMLElement& element, const char* attributeName, bool defaultValue);
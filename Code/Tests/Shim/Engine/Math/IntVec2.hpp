@@ -0,0 +1,19 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+struct IntVec2
+{
+	IntVec2() {}
+	IntVec2(int initialX, int initialY) : x(initialX), y(initialY) {}
+
+	bool						operator==(const IntVec2& other) const { return x == other.x && y == other.y; }
+	bool						operator!=(const IntVec2& other) const { return x != other.x || y != other.y; }
+
+	int							x = 0;
+	int							y = 0;
+
+	static const IntVec2		ZERO;
+	static const IntVec2		ONE;
+};
@@ -0,0 +1,11 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: only ever bound, never multiplied, by the code under test
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+struct Matrix44
+{
+	float						m_values[16] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+
+	static const Matrix44		IDENTITY;
+};
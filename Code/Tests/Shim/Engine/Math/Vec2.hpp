@@ -0,0 +1,29 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Others
+#include <cmath>
+
+struct Vec2
+{
+	Vec2() {}
+	Vec2(float initialX, float initialY) : x(initialX), y(initialY) {}
+
+	Vec2						operator+(const Vec2& other) const { return Vec2(x + other.x, y + other.y); }
+	Vec2						operator-(const Vec2& other) const { return Vec2(x - other.x, y - other.y); }
+	Vec2						operator*(const Vec2& other) const { return Vec2(x * other.x, y * other.y); }
+	Vec2						operator*(float scale) const { return Vec2(x * scale, y * scale); }
+	Vec2&						operator+=(const Vec2& other) { x += other.x; y += other.y; return *this; }
+	bool						operator==(const Vec2& other) const { return x == other.x && y == other.y; }
+
+	float						GetLength() const { return sqrtf(x * x + y * y); }
+
+	float						x = 0.f;
+	float						y = 0.f;
+
+	static const Vec2			ZERO;
+	static const Vec2			ONE;
+};
+
+inline Vec2						operator*(float scale, const Vec2& vec) { return vec * scale; }
@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Math/Vec2.hpp"
+//Others
+#include <cmath>
+
+struct Vec3
+{
+	Vec3() {}
+	Vec3(float initialX, float initialY, float initialZ) : x(initialX), y(initialY), z(initialZ) {}
+	explicit Vec3(const Vec2& vec, float initialZ = 0.f) : x(vec.x), y(vec.y), z(initialZ) {}
+
+	Vec3						operator+(const Vec3& other) const { return Vec3(x + other.x, y + other.y, z + other.z); }
+	Vec3						operator-(const Vec3& other) const { return Vec3(x - other.x, y - other.y, z - other.z); }
+	Vec3						operator*(float scale) const { return Vec3(x * scale, y * scale, z * scale); }
+	bool						operator==(const Vec3& other) const { return x == other.x && y == other.y && z == other.z; }
+
+	float						GetLength() const { return sqrtf(x * x + y * y + z * z); }
+
+	float						x = 0.f;
+	float						y = 0.f;
+	float						z = 0.f;
+
+	static const Vec3			ZERO;
+	static const Vec3			RIGHT;
+	static const Vec3			UP;
+	static const Vec3			FORWARD;
+};
+
+inline Vec3						operator*(float scale, const Vec3& vec) { return vec * scale; }
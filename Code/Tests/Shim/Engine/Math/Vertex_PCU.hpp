@@ -0,0 +1,17 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+struct Vertex_PCU
+{
+	Vertex_PCU() {}
+	Vertex_PCU(const Vec3& position, const Rgba& color, const Vec2& uvTexCoords) : m_position(position), m_color(color), m_uvTexCoords(uvTexCoords) {}
+
+	Vec3						m_position;
+	Rgba						m_color;
+	Vec2						m_uvTexCoords;
+};
@@ -0,0 +1,27 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: the calls the live render backend forwards. Tests never make one, they record through the recording backend
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Others
+#include <vector>
+
+class GPUMesh;
+class Material;
+class Shader;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderContext
+{
+public:
+	void						BindShader(Shader* shader) { UNUSED(shader); }
+	void						BindMaterial(Material* material) { UNUSED(material); }
+	void						BindTextureView(uint slot, TextureView* texture) { UNUSED(slot); UNUSED(texture); }
+	void						BindModelMatrix(const Matrix44& model) { UNUSED(model); }
+	void						DrawMesh(GPUMesh* mesh) { UNUSED(mesh); }
+	void						DrawVertexArray(const std::vector<Vertex_PCU>& vertices) { UNUSED(vertices); }
+};
@@ -0,0 +1,6 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim: only handled by pointer by the code under test
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+class Shader;
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Test shim definitions
+//------------------------------------------------------------------------------------------------------------------------------
+//Engine Systems
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Others
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+NamedStrings	g_gameConfigBlackboard;
+static DevConsole	s_devConsole;
+DevConsole*		g_devConsole = &s_devConsole;
+AudioSystem*	g_audio = nullptr;
+int				g_numRecoverableErrors = 0;
+
+const Rgba Rgba::WHITE(1.f, 1.f, 1.f, 1.f);
+const Rgba Rgba::BLACK(0.f, 0.f, 0.f, 1.f);
+const Rgba Rgba::RED(1.f, 0.f, 0.f, 1.f);
+const Rgba Rgba::GREEN(0.f, 1.f, 0.f, 1.f);
+const Rgba Rgba::BLUE(0.f, 0.f, 1.f, 1.f);
+const Rgba Rgba::YELLOW(1.f, 1.f, 0.f, 1.f);
+const Rgba Rgba::ORANGE(1.f, 0.5f, 0.f, 1.f);
+
+const Vec2 Vec2::ZERO(0.f, 0.f);
+const Vec2 Vec2::ONE(1.f, 1.f);
+
+const IntVec2 IntVec2::ZERO(0, 0);
+const IntVec2 IntVec2::ONE(1, 1);
+
+const Vec3 Vec3::ZERO(0.f, 0.f, 0.f);
+const Vec3 Vec3::RIGHT(1.f, 0.f, 0.f);
+const Vec3 Vec3::UP(0.f, 1.f, 0.f);
+const Vec3 Vec3::FORWARD(0.f, 0.f, 1.f);
+
+const Matrix44 Matrix44::IDENTITY;
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ReportRecoverableError(const std::string& message)
+{
+	g_numRecoverableErrors++;
+	fprintf(stderr, "Recoverable error: %s\n", message.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebuggerPrintf(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string Stringf(const char* format, ...)
+{
+	char text[2048];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	return std::string(text);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string NamedStrings::GetValue(const std::string& key, const std::string& defaultValue) const
+{
+	std::map<std::string, std::string>::const_iterator itr = m_keyValuePairs.find(key);
+	return itr == m_keyValuePairs.end() ? defaultValue : itr->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string NamedStrings::GetValue(const std::string& key, const char* defaultValue) const
+{
+	return GetValue(key, std::string(defaultValue));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool NamedStrings::GetValue(const std::string& key, bool defaultValue) const
+{
+	std::map<std::string, std::string>::const_iterator itr = m_keyValuePairs.find(key);
+	return itr == m_keyValuePairs.end() ? defaultValue : (itr->second == "true" || itr->second == "1");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int NamedStrings::GetValue(const std::string& key, int defaultValue) const
+{
+	std::map<std::string, std::string>::const_iterator itr = m_keyValuePairs.find(key);
+	return itr == m_keyValuePairs.end() ? defaultValue : atoi(itr->second.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+unsigned int NamedStrings::GetValue(const std::string& key, unsigned int defaultValue) const
+{
+	std::map<std::string, std::string>::const_iterator itr = m_keyValuePairs.find(key);
+	return itr == m_keyValuePairs.end() ? defaultValue : (unsigned int)strtoul(itr->second.c_str(), nullptr, 10);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+float NamedStrings::GetValue(const std::string& key, float defaultValue) const
+{
+	std::map<std::string, std::string>::const_iterator itr = m_keyValuePairs.find(key);
+	return itr == m_keyValuePairs.end() ? defaultValue : (float)atof(itr->second.c_str());
+}
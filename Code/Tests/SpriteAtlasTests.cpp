@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Plans the unit atlas from the real sheets' PNG headers and checks the layout. Nothing is decoded
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/SpriteAtlas.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <algorithm>
+
+static const char* UNIT_SHEET_PATHS[] =
+{
+	"Data/Images/peon.walkdeath.png",
+	"Data/Images/peon.attack.png",
+	"Data/Images/warrior.walkdeath.png",
+	"Data/Images/warrior.attack.png",
+	"Data/Images/goblin.walkdeath.png",
+	"Data/Images/goblin.attack.png",
+};
+static const int NUM_UNIT_SHEETS = (int)(sizeof(UNIT_SHEET_PATHS) / sizeof(UNIT_SHEET_PATHS[0]));
+
+//Game::m_unitAtlasMaxPageSize and Game::m_unitAtlasPadding
+static const IntVec2 GAME_MAX_PAGE_SIZE = IntVec2(4096, 4096);
+static const int GAME_PADDING = 2;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool AddUnitSheets(SpriteAtlasPacker& packer, bool isReversed)
+{
+	bool isAdded = true;
+	for (int sheetIndex = 0; sheetIndex < NUM_UNIT_SHEETS; sheetIndex++)
+	{
+		int pathIndex = isReversed ? NUM_UNIT_SHEETS - 1 - sheetIndex : sheetIndex;
+		isAdded = TEST_CHECK(packer.AddImageFromFile(UNIT_SHEET_PATHS[pathIndex])) && isAdded;
+	}
+	return isAdded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every image sits inside its page, and no two on a page come closer than the padding
+//------------------------------------------------------------------------------------------------------------------------------
+static void CheckLayout(const SpriteAtlasPacker& packer, const IntVec2& maxPageSize, int padding)
+{
+	const std::vector<SpriteAtlasEntry>& entries = packer.GetEntries();
+	for (size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		const SpriteAtlasEntry& entry = entries[entryIndex];
+		TEST_CHECK(entry.m_page >= 0 && entry.m_page < packer.GetNumPages());
+		if (entry.m_page < 0 || entry.m_page >= packer.GetNumPages())
+			continue;
+
+		const IntVec2& pageSize = packer.GetPageSize(entry.m_page);
+		TEST_CHECK(pageSize.x <= maxPageSize.x && pageSize.y <= maxPageSize.y);
+		TEST_CHECK(entry.m_offset.x >= 0 && entry.m_offset.y >= 0);
+		TEST_CHECK(entry.m_offset.x + entry.m_size.x <= pageSize.x);
+		TEST_CHECK(entry.m_offset.y + entry.m_size.y <= pageSize.y);
+
+		for (size_t otherIndex = entryIndex + 1; otherIndex < entries.size(); otherIndex++)
+		{
+			const SpriteAtlasEntry& other = entries[otherIndex];
+			if (other.m_page != entry.m_page)
+				continue;
+
+			bool isApart = entry.m_offset.x + entry.m_size.x + padding <= other.m_offset.x
+				|| other.m_offset.x + other.m_size.x + padding <= entry.m_offset.x
+				|| entry.m_offset.y + entry.m_size.y + padding <= other.m_offset.y
+				|| other.m_offset.y + other.m_size.y + padding <= entry.m_offset.y;
+
+			if (!isApart)
+			{
+				FailTest(entry.m_sourcePath + " overlaps " + other.m_sourcePath);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestUnitSheetHeaders()
+{
+	for (int sheetIndex = 0; sheetIndex < NUM_UNIT_SHEETS; sheetIndex++)
+	{
+		IntVec2 dimensions;
+		TEST_CHECK(SpriteAtlasPacker::ReadPNGDimensions(UNIT_SHEET_PATHS[sheetIndex], dimensions));
+		TEST_CHECK(dimensions.x > 0 && dimensions.y > 0);
+	}
+
+	IntVec2 dimensions;
+	TEST_CHECK(!SpriteAtlasPacker::ReadPNGDimensions("Data/Images/NoSuchSheet.png", dimensions));
+	TEST_CHECK(!SpriteAtlasPacker::ReadPNGDimensions("Data/Gameplay/render_budgets.xml", dimensions));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The game's settings put every unit sheet on one page, which is what lets units draw in a single batch
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestUnitSheetsPackOnOnePage()
+{
+	SpriteAtlasPacker packer;
+	if (!AddUnitSheets(packer, false))
+		return;
+
+	TEST_CHECK(packer.Pack(GAME_MAX_PAGE_SIZE, GAME_PADDING));
+	TEST_CHECK(packer.GetNumPages() == 1);
+	CheckLayout(packer, GAME_MAX_PAGE_SIZE, GAME_PADDING);
+
+	//Same layout whatever order the sheets were added in
+	SpriteAtlasPacker reversedPacker;
+	AddUnitSheets(reversedPacker, true);
+	TEST_CHECK(reversedPacker.Pack(GAME_MAX_PAGE_SIZE, GAME_PADDING));
+
+	for (int sheetIndex = 0; sheetIndex < NUM_UNIT_SHEETS; sheetIndex++)
+	{
+		const SpriteAtlasEntry* entry = packer.FindEntry(UNIT_SHEET_PATHS[sheetIndex]);
+		const SpriteAtlasEntry* reversedEntry = reversedPacker.FindEntry(UNIT_SHEET_PATHS[sheetIndex]);
+		TEST_CHECK(entry != nullptr && reversedEntry != nullptr);
+		if (entry == nullptr || reversedEntry == nullptr)
+			continue;
+
+		TEST_CHECK(entry->m_page == reversedEntry->m_page);
+		TEST_CHECK(entry->m_offset == reversedEntry->m_offset);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pages just big enough for the largest sheet force the packer onto several pages and shelves
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestSmallPagesSpill()
+{
+	SpriteAtlasPacker packer;
+	if (!AddUnitSheets(packer, false))
+		return;
+
+	IntVec2 largest(0, 0);
+	const std::vector<SpriteAtlasEntry>& entries = packer.GetEntries();
+	for (size_t entryIndex = 0; entryIndex < entries.size(); entryIndex++)
+	{
+		largest.x = std::max(largest.x, entries[entryIndex].m_size.x);
+		largest.y = std::max(largest.y, entries[entryIndex].m_size.y);
+	}
+
+	TEST_CHECK(packer.Pack(largest, GAME_PADDING));
+	TEST_CHECK(packer.GetNumPages() > 1);
+	CheckLayout(packer, largest, GAME_PADDING);
+
+	TEST_CHECK(!packer.Pack(IntVec2(largest.x - 1, largest.y), GAME_PADDING));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A region maps the source's UV corners onto the corners of where it was placed
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestRegionRemapsIntoPage()
+{
+	SpriteAtlasEntry entry;
+	entry.m_size = IntVec2(64, 32);
+	entry.m_page = 0;
+	entry.m_offset = IntVec2(128, 64);
+
+	SpriteAtlasRegion region = SpriteAtlas::MakeRegion(entry, IntVec2(256, 128));
+	Vec2 mins = region.RemapUV(Vec2(0.f, 0.f));
+	Vec2 maxs = region.RemapUV(Vec2(1.f, 1.f));
+
+	TEST_CHECK(mins.x == 0.5f && mins.y == 0.5f);
+	TEST_CHECK(maxs.x == 0.75f && maxs.y == 0.75f);
+	TEST_CHECK(SpriteAtlas::GetPageName("Data/Images/units.atlas", 1) == "Data/Images/units.atlas.1");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestUnitSheetHeaders();
+	TestUnitSheetsPackOnOnePage();
+	TestSmallPagesSpill();
+	TestRegionRemapsIntoPage();
+
+	return FinishTests("SpriteAtlasTests");
+}
@@ -0,0 +1,265 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Drives the sprite and status bar batchers against the recording sprite backend, and the queue one through a render queue
+// into a queue backend that keeps every vertex array it is handed
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/RenderQueue.hpp"
+#include "Game/SpriteBatcher.hpp"
+#include "Game/StatusBarBatcher.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <cstdint>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class VertexArrayQueueBackend : public RenderQueueBackend
+{
+public:
+	virtual void		BindShader(Shader* shader) override { UNUSED(shader); }
+	virtual void		BindMaterial(Material* material) override { UNUSED(material); }
+	virtual void		BindTexture(TextureView* texture) override { m_boundTexture = texture; }
+	virtual void		DrawMesh(GPUMesh* mesh, const Matrix44& model) override { UNUSED(mesh); UNUSED(model); m_numMeshDraws++; }
+	virtual void		DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model) override;
+
+public:
+	TextureView*							m_boundTexture = nullptr;
+	std::vector<TextureView*>				m_drawnTextures;
+	std::vector<std::vector<Vertex_PCU>>	m_drawnArrays;
+	uint									m_numMeshDraws = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+void VertexArrayQueueBackend::DrawVertexArray(const std::vector<Vertex_PCU>& vertices, const Matrix44& model)
+{
+	UNUSED(model);
+	m_drawnTextures.push_back(m_boundTexture);
+	m_drawnArrays.push_back(vertices);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static TextureView* MakeFakeTexture(uintptr_t id)
+{
+	return reinterpret_cast<TextureView*>(id * 16U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static SpriteQuad MakeQuad(TextureView* texture, float x, float sortDepth)
+{
+	SpriteQuad quad;
+	quad.m_texture = texture;
+	quad.m_corners[0] = Vec3(x, 1.f, 0.f);
+	quad.m_corners[1] = Vec3(x + 1.f, 1.f, 0.f);
+	quad.m_corners[2] = Vec3(x, 0.f, 0.f);
+	quad.m_corners[3] = Vec3(x + 1.f, 0.f, 0.f);
+	quad.m_uvMins = Vec2::ZERO;
+	quad.m_uvMaxs = Vec2::ONE;
+	quad.m_sortDepth = sortDepth;
+	return quad;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every quad on one texture, as units on the shared atlas page are, goes out as one draw whatever the depths
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestOneTextureIsOneDraw()
+{
+	TextureView* atlasPage = MakeFakeTexture(1U);
+
+	SpriteBatcher batcher;
+	RecordingSpriteBackend recording;
+
+	batcher.BeginFrame();
+	for (uint quadIndex = 0; quadIndex < 200U; quadIndex++)
+	{
+		batcher.AddQuad(MakeQuad(atlasPage, (float)quadIndex, (float)((quadIndex * 37U) % 101U)));
+	}
+	batcher.Flush(recording);
+
+	TEST_CHECK(recording.m_numFrames == 1U);
+	TEST_CHECK(recording.m_numDrawCalls == 1U);
+	TEST_CHECK(recording.m_numUploads == 1U);
+	TEST_CHECK(recording.m_numQuads == 200U);
+	TEST_CHECK(batcher.GetNumBatches() == 1U);
+	TEST_CHECK(batcher.GetNumQuads() == 200U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Textures that don't overlap in depth draw once each, furthest first
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestSeparateTexturesDrawBackToFront()
+{
+	TextureView* near = MakeFakeTexture(1U);
+	TextureView* far = MakeFakeTexture(2U);
+
+	SpriteBatcher batcher;
+	RecordingSpriteBackend recording;
+
+	batcher.BeginFrame();
+	batcher.AddQuad(MakeQuad(near, 0.f, 1.f));
+	batcher.AddQuad(MakeQuad(far, 1.f, 10.f));
+	batcher.AddQuad(MakeQuad(near, 2.f, 2.f));
+	batcher.AddQuad(MakeQuad(far, 3.f, 11.f));
+	batcher.Flush(recording);
+
+	TEST_CHECK(recording.m_numDrawCalls == 2U);
+	TEST_CHECK(recording.m_drawnTextures.size() == 2U);
+	TEST_CHECK(recording.m_drawnTextures.size() == 2U && recording.m_drawnTextures[0] == far && recording.m_drawnTextures[1] == near);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Blending needs the far sprite under the near one even when it means drawing a texture twice
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestInterleavedTexturesKeepDepthOrder()
+{
+	TextureView* first = MakeFakeTexture(1U);
+	TextureView* second = MakeFakeTexture(2U);
+
+	SpriteBatcher batcher;
+	RecordingSpriteBackend recording;
+
+	batcher.BeginFrame();
+	batcher.AddQuad(MakeQuad(first, 0.f, 1.f));
+	batcher.AddQuad(MakeQuad(second, 1.f, 5.f));
+	batcher.AddQuad(MakeQuad(first, 2.f, 9.f));
+	batcher.Flush(recording);
+
+	TEST_CHECK(recording.m_numDrawCalls == 3U);
+	TEST_CHECK(recording.m_drawnTextures.size() == 3U);
+	if (recording.m_drawnTextures.size() == 3U)
+	{
+		TEST_CHECK(recording.m_drawnTextures[0] == first);
+		TEST_CHECK(recording.m_drawnTextures[1] == second);
+		TEST_CHECK(recording.m_drawnTextures[2] == first);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each batch is one vertex array of two triangles per quad, in back to front order, with equal depths left in add order
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestQueueBackendRecordsVertexArrays()
+{
+	TextureView* texture = MakeFakeTexture(3U);
+
+	RenderQueue queue;
+	VertexArrayQueueBackend queueBackend;
+	QueueSpriteBackend spriteBackend(&queue, nullptr, RENDER_PASS_ALPHA);
+	SpriteBatcher batcher;
+
+	queue.BeginFrame(1U);
+	batcher.BeginFrame();
+	batcher.AddQuad(MakeQuad(texture, 0.f, 1.f));
+	batcher.AddQuad(MakeQuad(texture, 5.f, 9.f));
+	batcher.AddQuad(MakeQuad(texture, 10.f, 9.f));
+	batcher.Flush(spriteBackend);
+	queue.Submit(queueBackend);
+
+	TEST_CHECK(queue.GetNumPackets() == 1U);
+	TEST_CHECK(queueBackend.m_numMeshDraws == 0U);
+	TEST_CHECK(queueBackend.m_drawnArrays.size() == 1U);
+	if (queueBackend.m_drawnArrays.size() != 1U)
+		return;
+
+	const std::vector<Vertex_PCU>& vertices = queueBackend.m_drawnArrays[0];
+	TEST_CHECK(queueBackend.m_drawnTextures[0] == texture);
+	TEST_CHECK(vertices.size() == 18U);
+	if (vertices.size() != 18U)
+		return;
+
+	//The x of each quad's bottom left corner gives away which one it is
+	TEST_CHECK(vertices[0].m_position.x == 5.f);
+	TEST_CHECK(vertices[6].m_position.x == 10.f);
+	TEST_CHECK(vertices[12].m_position.x == 0.f);
+
+	//Bottom left, bottom right, top right then bottom left, top right, top left
+	TEST_CHECK(vertices[1].m_position == Vec3(6.f, 0.f, 0.f));
+	TEST_CHECK(vertices[2].m_position == Vec3(6.f, 1.f, 0.f));
+	TEST_CHECK(vertices[5].m_position == Vec3(5.f, 1.f, 0.f));
+	TEST_CHECK(vertices[0].m_uvTexCoords == Vec2::ZERO);
+	TEST_CHECK(vertices[2].m_uvTexCoords == Vec2::ONE);
+
+	//Redrawing records the kept vertices again without rebuilding them
+	queue.BeginFrame(1U);
+	batcher.Redraw(spriteBackend);
+	queue.Submit(queueBackend);
+	TEST_CHECK(queueBackend.m_drawnArrays.size() == 2U);
+	TEST_CHECK(queueBackend.m_drawnArrays.size() == 2U && queueBackend.m_drawnArrays[1].size() == 18U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The queue sorts alpha packets on depth before state, so batches that alternate textures still reach the device back to front
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestQueueKeepsAlphaBatchOrder()
+{
+	TextureView* first = MakeFakeTexture(1U);
+	TextureView* second = MakeFakeTexture(2U);
+
+	RenderQueue queue;
+	VertexArrayQueueBackend queueBackend;
+	QueueSpriteBackend spriteBackend(&queue, nullptr, RENDER_PASS_ALPHA);
+	SpriteBatcher batcher;
+
+	queue.BeginFrame(1U);
+	batcher.BeginFrame();
+	for (uint quadIndex = 0; quadIndex < 8U; quadIndex++)
+	{
+		float distance = 4.f + 8.f * (float)quadIndex;
+		batcher.AddQuad(MakeQuad((quadIndex & 1U) ? second : first, (float)quadIndex, distance * distance));
+	}
+	batcher.Flush(spriteBackend);
+	queue.Submit(queueBackend);
+
+	TEST_CHECK(queueBackend.m_drawnArrays.size() == 8U);
+	for (uint drawIndex = 0; drawIndex < (uint)queueBackend.m_drawnArrays.size(); drawIndex++)
+	{
+		uint quadIndex = 7U - drawIndex;
+		TEST_CHECK(queueBackend.m_drawnArrays[drawIndex][0].m_position.x == (float)quadIndex);
+		TEST_CHECK(queueBackend.m_drawnTextures[drawIndex] == ((quadIndex & 1U) ? second : first));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Bars that didn't move under a camera that didn't move are redrawn, anything changing rebuilds them
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestStatusBarsAreCached()
+{
+	StatusBarBatcher bars;
+	RecordingSpriteBackend recording;
+
+	for (uint frameIndex = 0; frameIndex < 3U; frameIndex++)
+	{
+		bars.BeginFrame(Vec3::RIGHT, Vec3::UP);
+		bars.AddBar(Vec3(1.f, 2.f, 0.f), 0.5f, Rgba::GREEN);
+		bars.AddBar(Vec3(4.f, 2.f, 0.f), 1.f, Rgba::RED);
+		bars.Flush(recording);
+
+		TEST_CHECK(bars.WasRebuiltLastFrame() == (frameIndex == 0U));
+	}
+
+	TEST_CHECK(recording.m_numFrames == 3U);
+	TEST_CHECK(recording.m_numUploads == 1U);
+	TEST_CHECK(recording.m_numDrawCalls == 3U);
+
+	bars.BeginFrame(Vec3::RIGHT, Vec3::UP);
+	bars.AddBar(Vec3(1.f, 2.f, 0.f), 0.25f, Rgba::GREEN);
+	bars.AddBar(Vec3(4.f, 2.f, 0.f), 1.f, Rgba::RED);
+	bars.Flush(recording);
+	TEST_CHECK(bars.WasRebuiltLastFrame());
+
+	bars.BeginFrame(Vec3::FORWARD, Vec3::UP);
+	bars.AddBar(Vec3(1.f, 2.f, 0.f), 0.25f, Rgba::GREEN);
+	bars.AddBar(Vec3(4.f, 2.f, 0.f), 1.f, Rgba::RED);
+	bars.Flush(recording);
+	TEST_CHECK(bars.WasRebuiltLastFrame());
+	TEST_CHECK(recording.m_numUploads == 3U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestOneTextureIsOneDraw();
+	TestSeparateTexturesDrawBackToFront();
+	TestInterleavedTexturesKeepDepthOrder();
+	TestQueueBackendRecordsVertexArrays();
+	TestQueueKeepsAlphaBatchOrder();
+	TestStatusBarsAreCached();
+
+	return FinishTests("SpriteBatcherTests");
+}
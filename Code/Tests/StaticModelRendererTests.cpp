@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Syncs trees and buildings into the persistent static groups and reads back what they would draw. Meshes and materials are
+// fake pointers, each instance is told apart by a tag written into its transform's translation
+//------------------------------------------------------------------------------------------------------------------------------
+//Game Systems
+#include "Game/GameHandle.hpp"
+#include "Game/RenderQueue.hpp"
+#include "Game/StaticModelRenderer.hpp"
+//Others
+#include "TestCommon.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static T* MakeFake(uintptr_t id)
+{
+	return (T*)(id * 0x100U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static StaticModelGroupKey MakeKey(uintptr_t meshID, uintptr_t materialID)
+{
+	StaticModelGroupKey key;
+	key.m_mesh = MakeFake<GPUMesh>(meshID);
+	key.m_material = MakeFake<Material>(materialID);
+	return key;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Matrix44 MakeTaggedTransform(uint tag)
+{
+	Matrix44 transform;
+	transform.m_values[12] = (float)tag;
+	return transform;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Vec3 GetPosition(uint tag)
+{
+	return Vec3((float)tag * 4.f, 0.f, 0.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void SetTagged(StaticModelRenderer& staticModels, uint tag, uint stateID, const StaticModelGroupKey& key)
+{
+	staticModels.SetInstance(GameHandle(1U, tag), stateID, GetPosition(tag), key, MakeTaggedTransform(tag));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The tags drawn with the given mesh, sorted so the checks don't depend on slot order
+//------------------------------------------------------------------------------------------------------------------------------
+static std::vector<uint> GetTagsDrawnWith(const StaticModelRenderer& staticModels, GPUMesh* mesh)
+{
+	RenderPacketBuffer buffer;
+	staticModels.RecordPackets(buffer, 0U, staticModels.GetNumInstances(), Vec3(0.f, 0.f, 0.f));
+
+	std::vector<uint> tags;
+	for (size_t packetIndex = 0; packetIndex < buffer.m_packets.size(); packetIndex++)
+	{
+		const RenderPacket& packet = buffer.m_packets[packetIndex];
+		if (buffer.m_states[packet.m_stateIndex].m_mesh == mesh)
+		{
+			tags.push_back((uint)buffer.m_transforms[packet.m_transformIndex].m_values[12]);
+		}
+	}
+
+	std::sort(tags.begin(), tags.end());
+	return tags;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One group per mesh and material pair, and one draw state per group however many instances it holds
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestGroupsByMeshAndMaterial()
+{
+	StaticModelGroupKey tree = MakeKey(1U, 10U);
+	StaticModelGroupKey hut = MakeKey(2U, 10U);
+	StaticModelGroupKey hutOtherMaterial = MakeKey(2U, 11U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 6U; tag++)
+	{
+		SetTagged(staticModels, tag, 0U, tree);
+	}
+	SetTagged(staticModels, 6U, 0U, hut);
+	SetTagged(staticModels, 7U, 0U, hut);
+	SetTagged(staticModels, 8U, 0U, hutOtherMaterial);
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumGroups() == 3U);
+	TEST_CHECK(staticModels.GetNumInstances() == 9U);
+
+	RenderPacketBuffer buffer;
+	staticModels.RecordPackets(buffer, 0U, staticModels.GetNumInstances(), Vec3(0.f, 0.f, 0.f));
+	TEST_CHECK(buffer.m_packets.size() == 9U);
+	TEST_CHECK(buffer.m_states.size() == 3U);
+
+	TEST_CHECK(GetTagsDrawnWith(staticModels, tree.m_mesh) == std::vector<uint>({ 0U, 1U, 2U, 3U, 4U, 5U }));
+	TEST_CHECK(GetTagsDrawnWith(staticModels, hut.m_mesh) == std::vector<uint>({ 6U, 7U, 8U }));
+
+	//A slice across the group boundary adds a state for each group it touches
+	RenderPacketBuffer slice;
+	staticModels.RecordPackets(slice, 4U, 3U, Vec3(0.f, 0.f, 0.f));
+	TEST_CHECK(slice.m_packets.size() == 3U);
+	TEST_CHECK(slice.m_states.size() == 2U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A tree chopped down to its weak mesh moves groups. The last tree in its old group is swapped into the hole and keeps
+// drawing, and can still be found by its handle afterwards
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestStateChangeSwapRemoves()
+{
+	StaticModelGroupKey fullTree = MakeKey(1U, 10U);
+	StaticModelGroupKey weakTree = MakeKey(3U, 10U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 4U; tag++)
+	{
+		SetTagged(staticModels, tag, 0U, fullTree);
+	}
+	staticModels.EndSync();
+
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 4U; tag++)
+	{
+		if (tag == 1U)
+		{
+			TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, tag), 1U, GetPosition(tag)));
+			SetTagged(staticModels, tag, 1U, weakTree);
+		}
+		else
+		{
+			TEST_CHECK(staticModels.IsInstanceCurrent(GameHandle(1U, tag), 0U, GetPosition(tag)));
+		}
+	}
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumInstances() == 4U);
+	TEST_CHECK(GetTagsDrawnWith(staticModels, fullTree.m_mesh) == std::vector<uint>({ 0U, 2U, 3U }));
+	TEST_CHECK(GetTagsDrawnWith(staticModels, weakTree.m_mesh) == std::vector<uint>({ 1U }));
+
+	//Tree 3 now sits in tree 1's old slot; changing it again must remove it from there and not whatever is last
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 4U; tag++)
+	{
+		if (tag == 3U)
+		{
+			SetTagged(staticModels, tag, 1U, weakTree);
+		}
+		else
+		{
+			staticModels.IsInstanceCurrent(GameHandle(1U, tag), tag == 1U ? 1U : 0U, GetPosition(tag));
+		}
+	}
+	staticModels.EndSync();
+
+	TEST_CHECK(GetTagsDrawnWith(staticModels, fullTree.m_mesh) == std::vector<uint>({ 0U, 2U }));
+	TEST_CHECK(GetTagsDrawnWith(staticModels, weakTree.m_mesh) == std::vector<uint>({ 1U, 3U }));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only the same handle, state and exact position is current. A reused index with a new cyclic ID is a different entity
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestIsInstanceCurrent()
+{
+	StaticModelGroupKey tree = MakeKey(1U, 10U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	SetTagged(staticModels, 2U, 0U, tree);
+	staticModels.EndSync();
+
+	staticModels.BeginSync(1U);
+	TEST_CHECK(staticModels.IsInstanceCurrent(GameHandle(1U, 2U), 0U, GetPosition(2U)));
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, 2U), 1U, GetPosition(2U)));
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, 2U), 0U, GetPosition(2U) + Vec3(0.f, 0.01f, 0.f)));
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(2U, 2U), 0U, GetPosition(2U)));
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, 0U), 0U, GetPosition(0U)));
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, 50U), 0U, GetPosition(50U)));
+	staticModels.EndSync();
+
+	//The hit marked it seen, so it survived the sync
+	TEST_CHECK(staticModels.GetNumInstances() == 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Trees that weren't synced were cut down or left view; the rest keep drawing
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestEndSyncRemovesUntouched()
+{
+	StaticModelGroupKey tree = MakeKey(1U, 10U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 5U; tag++)
+	{
+		SetTagged(staticModels, tag, 0U, tree);
+	}
+	staticModels.EndSync();
+
+	staticModels.BeginSync(1U);
+	staticModels.IsInstanceCurrent(GameHandle(1U, 0U), 0U, GetPosition(0U));
+	staticModels.IsInstanceCurrent(GameHandle(1U, 3U), 0U, GetPosition(3U));
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumInstances() == 2U);
+	TEST_CHECK(GetTagsDrawnWith(staticModels, tree.m_mesh) == std::vector<uint>({ 0U, 3U }));
+
+	//An empty sync clears the rest but keeps the group for the next tree
+	staticModels.BeginSync(1U);
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumInstances() == 0U);
+	TEST_CHECK(staticModels.GetNumGroups() == 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A new resource version drops every group, so nothing is current until it is set again
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestResourceVersionClears()
+{
+	StaticModelGroupKey tree = MakeKey(1U, 10U);
+	StaticModelGroupKey hut = MakeKey(2U, 10U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	SetTagged(staticModels, 0U, 0U, tree);
+	SetTagged(staticModels, 1U, 0U, hut);
+	staticModels.EndSync();
+
+	staticModels.BeginSync(2U);
+	TEST_CHECK(staticModels.GetNumGroups() == 0U);
+	TEST_CHECK(staticModels.GetNumInstances() == 0U);
+	TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, 0U), 0U, GetPosition(0U)));
+
+	SetTagged(staticModels, 0U, 0U, tree);
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumGroups() == 1U);
+	TEST_CHECK(GetTagsDrawnWith(staticModels, tree.m_mesh) == std::vector<uint>({ 0U }));
+	TEST_CHECK(GetTagsDrawnWith(staticModels, hut.m_mesh).empty());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Trees are synced with their model handle as the state id, the way the map does. Reloading the resource definition with a
+// new mesh requests a new handle, so the next sync misses and the tree moves to the new mesh's group even though its health
+// state and position didn't change
+//------------------------------------------------------------------------------------------------------------------------------
+static void TestReloadedModelReplacesInstance()
+{
+	const uint oldModelHandle = 4U;
+	const uint newModelHandle = 9U;
+	StaticModelGroupKey oldTree = MakeKey(1U, 10U);
+	StaticModelGroupKey newTree = MakeKey(5U, 10U);
+
+	StaticModelRenderer staticModels;
+	staticModels.BeginSync(1U);
+	SetTagged(staticModels, 0U, oldModelHandle, oldTree);
+	SetTagged(staticModels, 1U, oldModelHandle, oldTree);
+	staticModels.EndSync();
+
+	//The reload only swaps handles, the resource version is unchanged
+	staticModels.BeginSync(1U);
+	for (uint tag = 0; tag < 2U; tag++)
+	{
+		if (!TEST_CHECK(!staticModels.IsInstanceCurrent(GameHandle(1U, tag), newModelHandle, GetPosition(tag))))
+			continue;
+
+		SetTagged(staticModels, tag, newModelHandle, newTree);
+	}
+	staticModels.EndSync();
+
+	TEST_CHECK(staticModels.GetNumInstances() == 2U);
+	TEST_CHECK(GetTagsDrawnWith(staticModels, oldTree.m_mesh).empty());
+	TEST_CHECK(GetTagsDrawnWith(staticModels, newTree.m_mesh) == std::vector<uint>({ 0U, 1U }));
+
+	staticModels.BeginSync(1U);
+	TEST_CHECK(staticModels.IsInstanceCurrent(GameHandle(1U, 0U), newModelHandle, GetPosition(0U)));
+	staticModels.EndSync();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main()
+{
+	TestGroupsByMeshAndMaterial();
+	TestStateChangeSwapRemoves();
+	TestIsInstanceCurrent();
+	TestEndSyncRemovesUntouched();
+	TestResourceVersionClears();
+	TestReloadedModelReplacesInstance();
+
+	return FinishTests("StaticModelRendererTests");
+}
@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "TestCommon.hpp"
+//Others
+#include <cstdio>
+
+static int s_numFailures = 0;
+static int s_numChecks = 0;
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool CheckTest(bool condition, const char* text, const char* file, int line)
+{
+	s_numChecks++;
+
+	if (!condition)
+	{
+		s_numFailures++;
+		fprintf(stderr, "%s(%d): check failed: %s\n", file, line, text);
+	}
+
+	return condition;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FailTest(const std::string& message)
+{
+	s_numChecks++;
+	s_numFailures++;
+	fprintf(stderr, "%s\n", message.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int FinishTests(const char* testName)
+{
+	printf("%s: %d checks, %d failed\n", testName, s_numChecks, s_numFailures);
+	return s_numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Others
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Failed checks print where they are and are counted, a test's main returns the count so ctest sees any failure
+//------------------------------------------------------------------------------------------------------------------------------
+#define TEST_CHECK(condition)	CheckTest((condition), #condition, __FILE__, __LINE__)
+
+bool						CheckTest(bool condition, const char* text, const char* file, int line);
+void						FailTest(const std::string& message);
+int							FinishTests(const char* testName);